@@ -164,6 +164,46 @@ class Pool:
         return Pool.pools[self.pool].get('mba')
 
 
+    def socket_cbm_set(self, socket_cbm):
+        """
+        Set per socket cbm masks for the pool
+
+        Parameters:
+            socket_cbm: socket ID to cbm mask dictionary
+        """
+        Pool.pools[self.pool]['socket_cbm'] = socket_cbm
+
+
+    def socket_cbm_get(self):
+        """
+        Get per socket cbm masks for the pool
+
+        Returns:
+            socket ID to cbm mask dictionary, None if not configured
+        """
+        return Pool.pools[self.pool].get('socket_cbm')
+
+
+    def socket_mba_set(self, socket_mba):
+        """
+        Set per socket mba values for the pool
+
+        Parameters:
+            socket_mba: socket ID to mba value dictionary
+        """
+        Pool.pools[self.pool]['socket_mba'] = socket_mba
+
+
+    def socket_mba_get(self):
+        """
+        Get per socket mba values for the pool
+
+        Returns:
+            socket ID to mba value dictionary, None if not configured
+        """
+        return Pool.pools[self.pool].get('socket_mba')
+
+
     def configure(self):
         """
         Configure Pool, based on config content.
@@ -175,10 +215,14 @@ class Pool:
         if caps.cat_supported():
             cbm = config.get_pool_attr('cbm', self.pool)
             self.cbm_set(cbm)
+            socket_cbm = config.get_pool_attr('socket_cbm', self.pool)
+            self.socket_cbm_set(socket_cbm)
 
         if caps.mba_supported():
             mba = config.get_pool_attr('mba', self.pool)
             self.mba_set(mba)
+            socket_mba = config.get_pool_attr('socket_mba', self.pool)
+            self.socket_mba_set(socket_mba)
 
         apps = config.get_pool_attr('apps', self.pool)
         if apps is not None:
@@ -307,6 +351,31 @@ class Pool:
         return Pool.pools[self.pool].get('cores')
 
 
+    @staticmethod
+    def socket_values(sockets, value, socket_values):
+        """
+        Groups sockets by RDT value to be configured on them
+
+        Parameters:
+            sockets: sockets to configure
+            value: value for sockets not present in socket_values
+            socket_values: socket ID to value dictionary or None
+
+        Returns:
+            value to sockets list dictionary
+        """
+        result = {}
+
+        for socket in sockets:
+            socket_value = value
+            if socket_values and str(socket) in socket_values:
+                socket_value = socket_values[str(socket)]
+            if socket_value:
+                result.setdefault(socket_value, []).append(socket)
+
+        return result
+
+
     @staticmethod
     def apply(pool_id):
         """
@@ -326,22 +395,29 @@ class Pool:
         pool = Pool(pool_id)
         cbm = pool.cbm_get()
         mba = pool.mba_get()
+        socket_cbm = pool.socket_cbm_get()
+        socket_mba = pool.socket_mba_get()
         cores = pool.cores_get()
 
-        # Apply same RDT configuration on all sockets in the system
-        sockets = common.PQOS_API.get_sockets()
+        # Apply RDT configuration only on sockets of Pool's cores and sockets
+        # configured explicitly for given resource, COS on other sockets is
+        # left to pools there
+        sockets = common.PQOS_API.get_core_sockets(cores) if cores else []
         if sockets is None:
             log.error("Failed to get sockets info!")
             return -1
 
+        cat_sockets = sorted(set(sockets) | {int(s) for s in socket_cbm or {}})
+        mba_sockets = sorted(set(sockets) | {int(s) for s in socket_mba or {}})
+
         # pool id to COS, 1:1 mapping
-        if cbm:
-            if common.PQOS_API.l3ca_set(sockets, pool_id, cbm) != 0:
+        for value, value_sockets in Pool.socket_values(cat_sockets, cbm, socket_cbm).items():
+            if common.PQOS_API.l3ca_set(value_sockets, pool_id, value) != 0:
                 log.error("Failed to apply CAT configuration!")
                 return -1
 
-        if mba:
-            if common.PQOS_API.mba_set(sockets, pool_id, mba) != 0:
+        for value, value_sockets in Pool.socket_values(mba_sockets, mba, socket_mba).items():
+            if common.PQOS_API.mba_set(value_sockets, pool_id, value) != 0:
                 log.error("Failed to apply MBA configuration!")
                 return -1
 
@@ -262,22 +262,36 @@ class ConfigStore:
                 for app_id in pool['apps']:
                     ConfigStore.get_app(data, app_id)
 
-            if 'cbm' in pool:
-                result = re.search('1{1,32}0{1,32}1{1,32}', bin(pool['cbm']))
-                if result or pool['cbm'] == 0:
+            cbms = [pool['cbm']] if 'cbm' in pool else []
+            cbms.extend(pool.get('socket_cbm', {}).values())
+            for cbm in cbms:
+                result = re.search('1{1,32}0{1,32}1{1,32}', bin(cbm))
+                if result or cbm == 0:
                     raise ValueError("Pool {}, CBM {}/{} is not contiguous."\
-                    .format(pool['id'], hex(pool['cbm']), bin(pool['cbm'])))
+                    .format(pool['id'], hex(cbm), bin(cbm)))
                 if not caps.cat_supported():
                     raise ValueError("Pool {}, CBM {}/{}, CAT is not supported."\
-                    .format(pool['id'], hex(pool['cbm']), bin(pool['cbm'])))
+                    .format(pool['id'], hex(cbm), bin(cbm)))
 
-            if 'mba' in pool:
-                if pool['mba'] > 100 or pool['mba'] <= 0:
+            mbas = [pool['mba']] if 'mba' in pool else []
+            mbas.extend(pool.get('socket_mba', {}).values())
+            for mba in mbas:
+                if mba > 100 or mba <= 0:
                     raise ValueError("Pool {}, MBA rate {} out of range! (1-100)."\
-                    .format(pool['id'], pool['mba']))
+                    .format(pool['id'], mba))
                 if not caps.mba_supported():
                     raise ValueError("Pool {}, MBA rate {}, MBA is not supported."\
-                    .format(pool['id'], pool['mba']))
+                    .format(pool['id'], mba))
+
+            # per socket configuration
+            for attr in ['socket_cbm', 'socket_mba']:
+                if attr not in pool:
+                    continue
+                sockets = common.PQOS_API.get_sockets()
+                for socket in pool[attr]:
+                    if sockets is None or int(socket) not in sockets:
+                        raise ValueError("Pool {}, Invalid socket {} in {}."\
+                        .format(pool['id'], socket, attr))
 
             # check power profile reference
             if 'power_profile' in pool:
@@ -406,6 +420,9 @@ class ConfigStore:
             for pool in data['pools']:
                 if 'cbm' in pool and not isinstance(pool['cbm'], int):
                     pool['cbm'] = int(pool['cbm'], 16)
+                for socket, cbm in pool.get('socket_cbm', {}).items():
+                    if not isinstance(cbm, int):
+                        pool['socket_cbm'][socket] = int(cbm, 16)
 
             return data
 
@@ -570,9 +587,9 @@ class ConfigStore:
         """
         # get max cos id for combination of allocation technologies
         alloc_type = []
-        if 'mba' in new_pool_data:
+        if 'mba' in new_pool_data or 'socket_mba' in new_pool_data:
             alloc_type.append(common.MBA_CAP)
-        if 'cbm' in new_pool_data:
+        if 'cbm' in new_pool_data or 'socket_cbm' in new_pool_data:
             alloc_type.append(common.CAT_CAP)
         max_cos_id = common.PQOS_API.get_max_cos_id(alloc_type)
 
@@ -281,6 +281,25 @@ class PqosApi:
             return None
 
 
+    def get_core_sockets(self, cores):
+        """
+        Gets sockets of given cores
+
+        Parameters:
+            cores: list of core IDs
+
+        Returns:
+            sorted list of sockets,
+            None otherwise
+        """
+
+        try:
+            return sorted({self.cpuinfo.get_socketid(core) for core in cores})
+        except Exception as ex:
+            log.error(str(ex))
+            return None
+
+
     def get_l3ca_num_cos(self):
         """
         Gets number of COS for L3 CAT
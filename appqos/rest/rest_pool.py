@@ -139,13 +139,13 @@ class Pool(Resource):
             response, status code
         """
         def check_alloc_tech(pool_id, json_data):
-            if 'cbm' in json_data:
+            if 'cbm' in json_data or 'socket_cbm' in json_data:
                 if not caps.cat_supported():
                     raise BadRequest("System does not support CAT!")
                 if pool_id > common.PQOS_API.get_max_cos_id([common.CAT_CAP]):
                     raise BadRequest("Pool {} does not support CAT".format(pool_id))
 
-            if 'mba' in json_data:
+            if 'mba' in json_data or 'socket_mba' in json_data:
                 if not caps.mba_supported():
                     raise BadRequest("System does not support MBA!")
                 if pool_id > common.PQOS_API.get_max_cos_id([common.MBA_CAP]):
@@ -185,6 +185,18 @@ class Pool(Resource):
             if 'mba' in json_data:
                 pool['mba'] = json_data['mba']
 
+            # set new per socket cbm and mba
+            if 'socket_cbm' in json_data:
+                pool['socket_cbm'] = {}
+                for socket, cbm in json_data['socket_cbm'].items():
+                    if not isinstance(cbm, int):
+                        cbm = int(cbm, 16)
+
+                    pool['socket_cbm'][socket] = cbm
+
+            if 'socket_mba' in json_data:
+                pool['socket_mba'] = json_data['socket_mba']
+
             # set new cores
             if 'cores' in json_data:
                 pool['cores'] = json_data['cores']
@@ -280,6 +292,16 @@ class Pools(Resource):
 
             post_data['cbm'] = cbm
 
+        if 'socket_cbm' in post_data:
+            socket_cbm = {}
+            for socket, cbm in post_data['socket_cbm'].items():
+                if not isinstance(cbm, int):
+                    cbm = int(cbm, 16)
+
+                socket_cbm[socket] = cbm
+
+            post_data['socket_cbm'] = socket_cbm
+
         # ignore 'power_profile' if SST-BF is enabled
         if sstbf.is_sstbf_configured():
             post_data.pop('power_profile', None)
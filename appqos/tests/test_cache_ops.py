@@ -224,7 +224,7 @@ class TestPools(object):
     @mock.patch('common.PQOS_API.mba_set')
     @mock.patch('common.PQOS_API.l3ca_set')
     @mock.patch('common.PQOS_API.alloc_assoc_set')
-    @mock.patch('common.PQOS_API.get_sockets')
+    @mock.patch('common.PQOS_API.get_core_sockets')
     def test_apply(self, mock_get_socket, mock_alloc_assoc_set, mock_l3ca_set, mock_mba_set):
         Pool.pools[2] = {}
         Pool.pools[2]['cores'] = [1]
@@ -290,6 +290,61 @@ class TestPools(object):
         assert result != 0
 
 
+    @mock.patch('common.PQOS_API.mba_set', mock.MagicMock(return_value=0))
+    @mock.patch('common.PQOS_API.l3ca_set', mock.MagicMock(return_value=0))
+    @mock.patch('common.PQOS_API.alloc_assoc_set', mock.MagicMock(return_value=0))
+    def test_apply_per_socket(self):
+        Pool.pools[1] = {}
+        Pool.pools[1]['cores'] = [2, 3]
+        Pool.pools[1]['cbm'] = 0x300
+        Pool.pools[1]['socket_cbm'] = {'1': 0xf}
+        Pool.pools[1]['mba'] = 50
+        Pool.pools[1]['socket_mba'] = {'3': 20}
+
+        # cores on sockets 0 and 1 only
+        with mock.patch('common.PQOS_API.get_core_sockets', return_value=[0, 1]):
+            result = Pool.apply(1)
+        assert result == 0
+
+        # socket 3 is configured explicitly for MBA only, its CBM and
+        # socket 2 are left untouched
+        common.PQOS_API.l3ca_set.assert_any_call([0], 1, 0x300)
+        common.PQOS_API.l3ca_set.assert_any_call([1], 1, 0xf)
+        assert common.PQOS_API.l3ca_set.call_count == 2
+
+        common.PQOS_API.mba_set.assert_any_call([0, 1], 1, 50)
+        common.PQOS_API.mba_set.assert_any_call([3], 1, 20)
+        assert common.PQOS_API.mba_set.call_count == 2
+
+
+    @mock.patch('common.PQOS_API.mba_set', mock.MagicMock(return_value=0))
+    @mock.patch('common.PQOS_API.l3ca_set', mock.MagicMock(return_value=0))
+    @mock.patch('common.PQOS_API.alloc_assoc_set', mock.MagicMock(return_value=0))
+    def test_apply_per_socket_cbm_only(self):
+        Pool.pools[1] = {}
+        Pool.pools[1]['cores'] = [2]
+        Pool.pools[1]['cbm'] = 0x300
+        Pool.pools[1]['socket_cbm'] = {'2': 0xf}
+        Pool.pools[1]['mba'] = 50
+
+        with mock.patch('common.PQOS_API.get_core_sockets', return_value=[0]):
+            result = Pool.apply(1)
+        assert result == 0
+
+        # socket 2 gets its CBM only, pool MBA rate stays on socket 0
+        common.PQOS_API.l3ca_set.assert_any_call([0], 1, 0x300)
+        common.PQOS_API.l3ca_set.assert_any_call([2], 1, 0xf)
+        assert common.PQOS_API.l3ca_set.call_count == 2
+        common.PQOS_API.mba_set.assert_called_once_with([0], 1, 50)
+
+
+    def test_socket_values(self):
+        assert Pool.socket_values([0, 1], 0xf, None) == {0xf: [0, 1]}
+        assert Pool.socket_values([0, 1], 0xf, {'1': 0x3}) == {0xf: [0], 0x3: [1]}
+        assert Pool.socket_values([0, 1], None, {'1': 0x3}) == {0x3: [1]}
+        assert not Pool.socket_values([0, 1], None, None)
+
+
     def test_reset(self):
         Pool.pools[2] = {}
         Pool.pools[2]['cores'] = [1]
@@ -570,6 +570,44 @@ class TestConfigValidate:
             ConfigStore.validate(data)
 
 
+    @mock.patch("common.PQOS_API.check_core", mock.MagicMock(return_value=True))
+    @mock.patch("common.PQOS_API.get_sockets", mock.MagicMock(return_value=[0, 1]))
+    @mock.patch("caps.cat_supported", mock.MagicMock(return_value=True))
+    @mock.patch("caps.mba_supported", mock.MagicMock(return_value=True))
+    def test_pool_per_socket(self):
+        data = {
+            "auth": {
+                "password": "password",
+                "username": "admin"
+            },
+            "pools": [
+                {
+                    "cbm": 0xf0,
+                    "socket_cbm": {"1": 0xf},
+                    "socket_mba": {"0": 50},
+                    "cores": [1, 3],
+                    "id": 1,
+                    "name": "pool 1"
+                }
+            ]
+        }
+
+        ConfigStore.validate(data)
+
+        data['pools'][0]['socket_cbm']['1'] = 0x5
+        with pytest.raises(ValueError, match="not contiguous"):
+            ConfigStore.validate(data)
+
+        data['pools'][0]['socket_cbm'] = {"2": 0xf}
+        with pytest.raises(ValueError, match="Invalid socket 2"):
+            ConfigStore.validate(data)
+
+        data['pools'][0]['socket_cbm'] = {"1": 0xf}
+        data['pools'][0]['socket_mba']['0'] = 101
+        with pytest.raises(ValueError, match="out of range"):
+            ConfigStore.validate(data)
+
+
     @mock.patch("common.PQOS_API.check_core", mock.MagicMock(return_value=True))
     @mock.patch("caps.mba_supported", mock.MagicMock(return_value=False))
     def test_pool_mba_not_supported(self):
@@ -35,6 +35,9 @@
 #include <stdint.h>   /* uint64_t etc. */
 #include <stdlib.h>   /* malloc() */
 #include <string.h>   /* memcpy() */
+#include <fcntl.h>    /* open() */
+#include <unistd.h>   /* pread() */
+#include <sys/mman.h> /* mmap() */
 #include <types.h>    /* ASSERT() */
 #include <pqos.h>
 #ifdef __linux__
@@ -45,10 +48,26 @@
 #include <sys/cpuset.h>  /* sched affinity */
 #endif
 #include "dlock.h"
+#include "tsc.h"
 
 #define MAX_L3CAT_NUM 16
 #define DIM(x) (sizeof(x) / sizeof(x[0]))
 
+#define CACHE_LINE_SIZE 64
+#define PAGE_SIZE_4K (4 * 1024)
+#define PAGE_SIZE_2M (2 * 1024 * 1024)
+#define PAGE_POOL_FACTOR 4   /**< candidate 4K pages per allocated page */
+#define PAGE_COLORS_DEFAULT 32
+#define MAX_ALLOC_NUM 16
+
+/**
+ * Memory blocks allocated with dlock_alloc()
+ */
+static struct {
+        void *ptr;
+        size_t size;      /**< mapped size, 0 if allocated with malloc() */
+} m_alloc_tab[MAX_ALLOC_NUM];
+
 static int m_is_chunk_allocated = 0;
 static char *m_chunk_start = NULL;
 static size_t m_chunk_size = 0;
@@ -134,6 +153,273 @@ static void mem_init(void *p, const size_t s)
                 cp[i] = (char) rand();
 }
 
+/**
+ * @brief Measures access latency of each cache line of the memory block
+ *
+ * Cache lines are accessed in a scattered order to keep hardware
+ * prefetchers from hiding memory latency.
+ *
+ * @param p pointer to memory block
+ * @param s size of memory block in bytes
+ * @param lat table to store latency of each cache line in cycles
+ */
+static void mem_latency(const void *p, const size_t s, uint64_t *lat)
+{
+        const size_t num_lines = s / CACHE_LINE_SIZE;
+        const volatile char *cp = (const volatile char *)p;
+        size_t step = 1031, i, j;
+
+        if (p == NULL || num_lines == 0)
+                return;
+
+        /* step has to be co-prime with number of lines to visit all */
+        while (num_lines % step == 0)
+                step += 2;
+
+        for (i = 0, j = 0; i < num_lines; i++, j = (j + step) % num_lines) {
+                const uint64_t start = __tsc_start();
+
+                (void)cp[j * CACHE_LINE_SIZE];
+                lat[j] = __tsc_end() - start;
+        }
+}
+
+/**
+ * @brief Compares latencies for qsort()
+ *
+ * @param a latency
+ * @param b latency
+ *
+ * @return comparison result
+ */
+static int lat_cmp(const void *a, const void *b)
+{
+        const uint64_t la = *(const uint64_t *)a;
+        const uint64_t lb = *(const uint64_t *)b;
+
+        return (la > lb) - (la < lb);
+}
+
+/**
+ * @brief Calculates median of cache line latencies
+ *
+ * @param lat table of latencies, gets sorted
+ * @param num number of entries in \a lat
+ *
+ * @return median latency
+ */
+static uint64_t lat_median(uint64_t *lat, const size_t num)
+{
+        if (num == 0)
+                return 0;
+
+        qsort(lat, num, sizeof(lat[0]), lat_cmp);
+        return lat[num / 2];
+}
+
+#ifdef __linux__
+/**
+ * @brief Retrieves number of LLC page colors
+ *
+ * 4K pages of the same color map onto the same LLC sets. Number of
+ * colors is rounded down to power of 2, so pages distributed evenly
+ * across colors are also evenly distributed across LLC slices
+ * addressed by fewer set index bits.
+ *
+ * @return number of page colors
+ */
+static unsigned page_colors(void)
+{
+        const struct pqos_cpuinfo *p_cpu = NULL;
+        const struct pqos_cap *p_cap = NULL;
+        const struct pqos_capability *p_l3ca_cap = NULL;
+        unsigned colors, n = 1;
+
+        if (pqos_cap_get(&p_cap, &p_cpu) != PQOS_RETVAL_OK ||
+            pqos_cap_get_type(p_cap, PQOS_CAP_TYPE_L3CA,
+                              &p_l3ca_cap) != PQOS_RETVAL_OK)
+                return PAGE_COLORS_DEFAULT;
+
+        colors = p_l3ca_cap->u.l3ca->way_size / PAGE_SIZE_4K;
+        while (n * 2 <= colors)
+                n *= 2;
+
+        return n;
+}
+
+/**
+ * @brief Allocates memory block backed by 2MB huge pages
+ *
+ * Huge page is physically contiguous so its cache lines are spread
+ * evenly across LLC sets.
+ *
+ * @param size size of memory block, multiple of 2MB
+ *
+ * @return pointer to memory block
+ * @retval NULL on error
+ */
+static void *mem_alloc_huge(const size_t size)
+{
+        void *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                       MAP_POPULATE, -1, 0);
+
+        return p == MAP_FAILED ? NULL : p;
+}
+
+/**
+ * @brief Allocates memory block of 4K pages with even LLC set distribution
+ *
+ * A pool of pages is faulted in and their physical frames are read from
+ * /proc/self/pagemap (requires CAP_SYS_ADMIN). Pages are picked from the
+ * pool so that consecutive pages of the block take consecutive colors
+ * and are moved into the block with mremap().
+ *
+ * @param size size of memory block, multiple of 4K
+ *
+ * @return pointer to memory block
+ * @retval NULL on error
+ */
+static void *mem_alloc_colored(const size_t size)
+{
+        const size_t num_pages = size / PAGE_SIZE_4K;
+        const size_t pool_pages = num_pages * PAGE_POOL_FACTOR;
+        const unsigned colors = page_colors();
+        char *block = NULL, *pool = NULL;
+        uint64_t *pfn = NULL;
+        size_t i, j;
+        int fd = -1, ok = 0;
+
+        block = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        pool = mmap(NULL, pool_pages * PAGE_SIZE_4K, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        pfn = malloc(pool_pages * sizeof(pfn[0]));
+        if (block == MAP_FAILED || pool == MAP_FAILED || pfn == NULL)
+                goto mem_alloc_colored_exit;
+
+        fd = open("/proc/self/pagemap", O_RDONLY);
+        if (fd < 0)
+                goto mem_alloc_colored_exit;
+
+        for (i = 0; i < pool_pages; i++) {
+                const off_t off = (off_t)(((uintptr_t)pool / PAGE_SIZE_4K) +
+                                          i) * (off_t)sizeof(pfn[0]);
+
+                /* write fault to get a private page frame */
+                pool[i * PAGE_SIZE_4K] = 0;
+                if (pread(fd, &pfn[i], sizeof(pfn[i]), off) !=
+                    (ssize_t)sizeof(pfn[i]))
+                        goto mem_alloc_colored_exit;
+                /* bit 63 - page present, bits 0-54 - page frame number */
+                if (!(pfn[i] >> 63) || (pfn[i] & ((1ULL << 55) - 1)) == 0)
+                        goto mem_alloc_colored_exit;
+                pfn[i] &= (1ULL << 55) - 1;
+        }
+
+        for (i = 0; i < num_pages; i++) {
+                const uint64_t color = i % colors;
+                size_t pick = pool_pages;
+                void *p;
+
+                for (j = 0; j < pool_pages; j++) {
+                        if (pfn[j] == 0)
+                                continue;
+                        if (pick == pool_pages)
+                                pick = j;
+                        if (pfn[j] % colors == color) {
+                                pick = j;
+                                break;
+                        }
+                }
+                if (pick == pool_pages)
+                        goto mem_alloc_colored_exit;
+
+                p = mremap(pool + pick * PAGE_SIZE_4K, PAGE_SIZE_4K,
+                           PAGE_SIZE_4K, MREMAP_MAYMOVE | MREMAP_FIXED,
+                           block + i * PAGE_SIZE_4K);
+                if (p == MAP_FAILED)
+                        goto mem_alloc_colored_exit;
+                pfn[pick] = 0;
+        }
+        ok = 1;
+
+        /* page migration would change the colors */
+        (void) mlock(block, size);
+
+ mem_alloc_colored_exit:
+        if (fd >= 0)
+                close(fd);
+        if (pool != MAP_FAILED && pool != NULL)
+                munmap(pool, pool_pages * PAGE_SIZE_4K);
+        free(pfn);
+        if (!ok && block != MAP_FAILED && block != NULL) {
+                munmap(block, size);
+                block = NULL;
+        }
+        return ok ? block : NULL;
+}
+#endif /* __linux__ */
+
+void *dlock_alloc(const size_t size)
+{
+        void *p = NULL;
+        size_t map_size = 0;
+        unsigned i;
+
+        if (size == 0)
+                return NULL;
+
+        for (i = 0; i < DIM(m_alloc_tab); i++)
+                if (m_alloc_tab[i].ptr == NULL)
+                        break;
+        if (i >= DIM(m_alloc_tab))
+                return NULL;
+
+#ifdef __linux__
+        map_size = (size + PAGE_SIZE_2M - 1) & ~((size_t)PAGE_SIZE_2M - 1);
+        p = mem_alloc_huge(map_size);
+        if (p == NULL) {
+                map_size = (size + PAGE_SIZE_4K - 1) &
+                           ~((size_t)PAGE_SIZE_4K - 1);
+                p = mem_alloc_colored(map_size);
+        }
+#endif
+        if (p == NULL) {
+                printf("Physically aware allocation failed, "
+                       "data may not get locked in full!\n");
+                map_size = 0;
+                p = malloc(size);
+                if (p == NULL)
+                        return NULL;
+        }
+
+        m_alloc_tab[i].ptr = p;
+        m_alloc_tab[i].size = map_size;
+        return p;
+}
+
+void dlock_free(void *ptr)
+{
+        unsigned i;
+
+        if (ptr == NULL)
+                return;
+
+        for (i = 0; i < DIM(m_alloc_tab); i++) {
+                if (m_alloc_tab[i].ptr != ptr)
+                        continue;
+
+                if (m_alloc_tab[i].size > 0)
+                        munmap(ptr, m_alloc_tab[i].size);
+                else
+                        free(ptr);
+                m_alloc_tab[i].ptr = NULL;
+                m_alloc_tab[i].size = 0;
+                return;
+        }
+}
+
 /**
  * @brief Calculates number of cache ways required to fit a number of \a bytes
  *
@@ -184,6 +470,8 @@ int dlock_init(void *ptr, const size_t size, const int clos, const int cpuid)
         size_t num_cache_ways = 0;
         unsigned clos_save = 0;
         char err_buf[64];
+        const size_t num_lines = size / CACHE_LINE_SIZE;
+        uint64_t *lat = NULL, miss_lat = 0;
 
 #ifdef __linux__
         cpu_set_t cpuset_save, cpuset;
@@ -203,12 +491,11 @@ int dlock_init(void *ptr, const size_t size, const int clos, const int cpuid)
                 m_is_chunk_allocated = 0;
         } else {
                 /**
-                 * For best results allocated memory should be physically
-                 * contiguous. Yet this would require allocating memory in
-                 * kernel space or using huge pages.
-                 * Let's use malloc() and 4K pages for simplicity.
+                 * For best results allocated memory should be spread
+                 * evenly across LLC sets. Use huge pages or colored
+                 * 4K pages where possible.
                  */
-                m_chunk_start = malloc(size);
+                m_chunk_start = dlock_alloc(size);
                 if (m_chunk_start == NULL)
                         return -3;
                 m_is_chunk_allocated = 1;
@@ -389,6 +676,16 @@ int dlock_init(void *ptr, const size_t size, const int clos, const int cpuid)
                 goto dlock_init_error2;
         }
 
+        /**
+         * Measure memory access latency of the buffer for reference
+         */
+        lat = malloc((num_lines + 1) * sizeof(lat[0]));
+        if (lat != NULL) {
+                mem_flush(m_chunk_start, m_chunk_size);
+                mem_latency(m_chunk_start, m_chunk_size, lat);
+                miss_lat = lat_median(lat, num_lines);
+        }
+
         /**
          * Remove buffer data from cache hierarchy and read it back into
          * selected cache ways.
@@ -417,7 +714,37 @@ int dlock_init(void *ptr, const size_t size, const int clos, const int cpuid)
                 goto dlock_init_error2;
         }
 
+        /**
+         * Evict everything but locked ways and count cache lines that
+         * still hit in LLC, at less than half of the memory latency
+         */
+        if (lat != NULL && miss_lat > 0) {
+                const struct pqos_cap_l3ca *cat = p_l3ca_cap->u.l3ca;
+                const size_t evict_size = 2 * cat->way_size * cat->num_ways;
+                void *evict = malloc(evict_size);
+                size_t locked = 0;
+
+                if (evict != NULL) {
+                        mem_init(evict, evict_size);
+                        mem_read(evict, evict_size);
+                        free(evict);
+
+                        mem_latency(m_chunk_start, m_chunk_size, lat);
+                        for (i = 0; i < num_lines; i++)
+                                if (lat[i] < miss_lat / 2)
+                                        locked++;
+                        printf("Pseudo locked %zu of %zu cache lines "
+                               "(%.1f%%), median latency %llu cycles "
+                               "vs %llu cycles before locking\n",
+                               locked, num_lines,
+                               num_lines ? 100.0 * locked / num_lines : 0.0,
+                               (unsigned long long)lat_median(lat, num_lines),
+                               (unsigned long long)miss_lat);
+                }
+        }
+
  dlock_init_error2:
+        free(lat);
         for (i = 0; (i < DIM(m_l3cat_cos)) && (ret != 0); i++)
                 if (m_l3cat_cos[i].cos_tab != NULL)
                         free(m_l3cat_cos[i].cos_tab);
@@ -437,7 +764,7 @@ int dlock_init(void *ptr, const size_t size, const int clos, const int cpuid)
 
  dlock_init_error1:
         if (m_is_chunk_allocated && ret != 0)
-                free(m_chunk_start);
+                dlock_free(m_chunk_start);
 
         if (ret != 0) {
                 m_chunk_start = NULL;
@@ -473,7 +800,7 @@ int dlock_exit(void)
         }
 
         if (m_is_chunk_allocated)
-                free(m_chunk_start);
+                dlock_free(m_chunk_start);
 
         m_chunk_start = NULL;
         m_chunk_size = 0;
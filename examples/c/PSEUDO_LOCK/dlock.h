@@ -42,6 +42,27 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Allocates memory block suitable for data pseudo locking
+ *
+ * Memory is backed by huge pages or, if these are not available,
+ * by 4K pages selected through /proc/self/pagemap so that the block
+ * is spread evenly across LLC sets. Falls back to malloc().
+ *
+ * @param size size of memory block
+ *
+ * @return pointer to memory block
+ * @retval NULL on error
+ */
+void *dlock_alloc(const size_t size);
+
+/**
+ * @brief Frees memory block allocated with dlock_alloc()
+ *
+ * @param ptr pointer to memory block
+ */
+void dlock_free(void *ptr);
+
 /**
  * @brief Initializes data pseudo lock module
  *
@@ -53,9 +74,12 @@ extern "C" {
  *       the bit mask.
  * @note It is not allowed to initialize the module multiple times for
  *       different memory blocks.
+ * @note Fraction of the memory block that got locked is measured and
+ *       reported by comparing cache line access latency before and after
+ *       locking.
  *
  * @param ptr pointer to memory block to be locked.
- *            If NULL then memory block is allocated.
+ *            If NULL then memory block is allocated with dlock_alloc().
  * @param size size of memory block to be locked
  * @param clos CAT class of service to be used for data locking
  * @param cpuid CPU ID to be used for data locking
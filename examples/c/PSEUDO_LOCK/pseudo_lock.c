@@ -69,14 +69,13 @@ static timer_t timerid;
  * This is to avoid any page faults or copy-on-write exceptions later on
  * when measuring cycles.
  *
- * For simplicity, malloc() is used to allocate memory. Ideally special
- * allocator should be used that allocates physically contiguous memory block.
- *
  * @param sz size of memory block in bytes
+ * @param dlock_mem allocate memory suitable for pseudo locking with
+ *        dlock_alloc() rather than with malloc()
  *
  * @return Pointer to allocated memory block
  */
-static void *init_memory(const size_t sz)
+static void *init_memory(const size_t sz, const int dlock_mem)
 {
         char *p = NULL;
         size_t i;
@@ -84,7 +83,10 @@ static void *init_memory(const size_t sz)
         if (sz <= 0)
                 return NULL;
 
-        p = (char *) malloc(sz);
+        if (dlock_mem)
+                p = (char *) dlock_alloc(sz);
+        else
+                p = (char *) malloc(sz);
         if (p == NULL)
                 return NULL;
 
@@ -369,21 +371,21 @@ int main(int argc, char *argv[])
         core_id = atoi(argv[1]);
         lock_data = (strcasecmp(argv[2], "nolock") == 0) ? 0 : 1;
 
+        /* initialize PQoS, cache topology is used for timer data placement */
+        if (lock_data && init_pqos() != 0) {
+                exit_val = EXIT_FAILURE;
+                goto error_exit1;
+        }
+
         /* allocate memory blocks */
-        main_data_ptr = init_memory(main_data_size);
-        timer_data_ptr = init_memory(timer_data_size);
+        main_data_ptr = init_memory(main_data_size, 0);
+        timer_data_ptr = init_memory(timer_data_size, 1);
         if (main_data_ptr == NULL || timer_data_ptr == NULL) {
                 exit_val = EXIT_FAILURE;
                 goto error_exit1;
         }
 
         if (lock_data) {
-                /* initialize PQoS and lock the data */
-                if (init_pqos() != 0) {
-                        exit_val = EXIT_FAILURE;
-                        goto error_exit1;
-                }
-
                 /* lock the timer data */
                 if (dlock_init(timer_data_ptr,
                                timer_data_size, 1 /* CLOS */, core_id) != 0) {
@@ -418,6 +420,6 @@ int main(int argc, char *argv[])
         if (main_data_ptr != NULL)
                 free(main_data_ptr);
         if (timer_data_ptr != NULL)
-                free(timer_data_ptr);
+                dlock_free(timer_data_ptr);
         return exit_val;
 }
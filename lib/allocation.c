@@ -1184,6 +1184,80 @@ hw_alloc_assoc_get(const unsigned lcore, unsigned *class_id)
         return ret;
 }
 
+/**
+ * @brief Checks if hardware prefetcher control is available on \a lcore
+ *
+ * @param [in] lcore CPU logical core id
+ *
+ * @return Operation status
+ */
+static int
+prefetch_check(const unsigned lcore)
+{
+        int ret;
+
+        ASSERT(m_cpu != NULL);
+        ret = pqos_cpu_check_core(m_cpu, lcore);
+        if (ret != PQOS_RETVAL_OK)
+                return PQOS_RETVAL_PARAM;
+
+        if (m_cpu->vendor != PQOS_VENDOR_INTEL) {
+                LOG_ERROR("Prefetcher control not supported on this "
+                          "platform!\n");
+                return PQOS_RETVAL_RESOURCE;
+        }
+
+        return PQOS_RETVAL_OK;
+}
+
+int
+hw_prefetch_set(const unsigned lcore, const unsigned enabled)
+{
+        const uint32_t reg = PQOS_MSR_MISC_FEATURE_CONTROL;
+        uint64_t val = 0;
+        int ret;
+
+        if (enabled & ~PQOS_PREFETCH_ALL)
+                return PQOS_RETVAL_PARAM;
+
+        ret = prefetch_check(lcore);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        if (msr_read(lcore, reg, &val) != MACHINE_RETVAL_OK)
+                return PQOS_RETVAL_RESOURCE;
+
+        /* register holds disable bits */
+        val &= ~PQOS_MSR_MISC_FEATURE_CONTROL_MASK;
+        val |= (~(uint64_t)enabled) & PQOS_MSR_MISC_FEATURE_CONTROL_MASK;
+
+        if (msr_write(lcore, reg, val) != MACHINE_RETVAL_OK)
+                return PQOS_RETVAL_ERROR;
+
+        return PQOS_RETVAL_OK;
+}
+
+int
+hw_prefetch_get(const unsigned lcore, unsigned *enabled)
+{
+        const uint32_t reg = PQOS_MSR_MISC_FEATURE_CONTROL;
+        uint64_t val = 0;
+        int ret;
+
+        ASSERT(enabled != NULL);
+
+        ret = prefetch_check(lcore);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        if (msr_read(lcore, reg, &val) != MACHINE_RETVAL_OK)
+                return PQOS_RETVAL_RESOURCE;
+
+        *enabled = (unsigned)(~val & PQOS_MSR_MISC_FEATURE_CONTROL_MASK);
+
+        return PQOS_RETVAL_OK;
+}
+
 int
 hw_alloc_assign(const unsigned technology,
                 const unsigned *core_array,
@@ -88,6 +88,28 @@ int hw_alloc_assoc_set(const unsigned lcore, const unsigned class_id);
  */
 int hw_alloc_assoc_get(const unsigned lcore, unsigned *class_id);
 
+/**
+ * @brief Hardware interface to enable selected prefetchers on \a lcore
+ *
+ * @param [in] lcore CPU logical core id
+ * @param [in] enabled mask of prefetchers to enable
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_prefetch_set(const unsigned lcore, const unsigned enabled);
+
+/**
+ * @brief Hardware interface to read prefetchers enabled on \a lcore
+ *
+ * @param [in] lcore CPU logical core id
+ * @param [out] enabled mask of enabled prefetchers
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_prefetch_get(const unsigned lcore, unsigned *enabled);
+
 /**
  * @brief Hardware interface to assign first available
  *        COS to cores in \a core_array
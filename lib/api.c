@@ -32,6 +32,7 @@
  *
  */
 
+#include <stdlib.h>
 #include <string.h>
 
 #include "pqos.h"
@@ -45,6 +46,7 @@
 #include "log.h"
 #include "types.h"
 #include "cpuinfo.h"
+#include "trace.h"
 
 /**
  * Value marking monitoring group structure as "valid".
@@ -124,6 +126,240 @@ api_init(int interface, enum pqos_vendor vendor)
         return PQOS_RETVAL_OK;
 }
 
+/*
+ * =======================================
+ * Configuration change trace
+ * =======================================
+ */
+
+/**
+ * @brief Reads class of \a lcore or \a task for the trace
+ *
+ * @param [in] lcore core id, used if \a tasks is NULL
+ * @param [in] tasks table of tasks
+ * @param [in] i index in \a tasks
+ *
+ * @return class of service, 0 on error
+ */
+static unsigned
+trace_assoc_get(const unsigned lcore, const pid_t *tasks, const unsigned i)
+{
+        unsigned class_id = 0;
+
+        if (tasks != NULL) {
+#ifdef __linux__
+                (void)os_alloc_assoc_get_pid(tasks[i], &class_id);
+#endif
+        } else if (m_interface == PQOS_INTER_MSR)
+                (void)hw_alloc_assoc_get(lcore, &class_id);
+#ifdef __linux__
+        else
+                (void)os_alloc_assoc_get(lcore, &class_id);
+#endif
+        return class_id;
+}
+
+/**
+ * @brief Saves classes of cores or tasks before association change
+ *
+ * @param [in] cores table of cores, used if \a tasks is NULL
+ * @param [in] tasks table of tasks
+ * @param [in] num number of cores or tasks
+ *
+ * @return table of classes, NULL on error
+ */
+static unsigned *
+trace_assoc_save(const unsigned *cores, const pid_t *tasks, const unsigned num)
+{
+        unsigned *old = malloc(num * sizeof(old[0]));
+        unsigned i;
+
+        if (old == NULL)
+                return NULL;
+
+        for (i = 0; i < num; i++)
+                old[i] = trace_assoc_get(tasks == NULL ? cores[i] : 0, tasks,
+                                         i);
+
+        return old;
+}
+
+/**
+ * @brief Records association change of cores or tasks
+ *
+ * @param [in] cores table of cores, used if \a tasks is NULL
+ * @param [in] tasks table of tasks
+ * @param [in] num number of cores or tasks
+ * @param [in] old classes saved by trace_assoc_save(), freed here
+ * @param [in] class_id class of service after the change
+ */
+static void
+trace_assoc(const unsigned *cores,
+            const pid_t *tasks,
+            const unsigned num,
+            unsigned *old,
+            const unsigned class_id)
+{
+        unsigned i;
+
+        for (i = 0; i < num; i++) {
+                const unsigned prev = old != NULL ? old[i] : 0;
+
+                if (old != NULL && prev == class_id)
+                        continue;
+                if (tasks != NULL)
+                        trace_add(PQOS_TRACE_ASSOC_PID, (unsigned)tasks[i],
+                                  class_id, prev, class_id);
+                else
+                        trace_add(PQOS_TRACE_ASSOC, cores[i], class_id, prev,
+                                  class_id);
+        }
+        free(old);
+}
+
+/**
+ * @brief Records class definition change unless the value is unchanged
+ *
+ * @param [in] type type of change
+ * @param [in] id resource id
+ * @param [in] class_id class of service
+ * @param [in] known set if \a old_value was read from the resource
+ * @param [in] old_value value before the change
+ * @param [in] new_value value after the change
+ */
+static void
+trace_cos(const enum pqos_trace_type type,
+          const unsigned id,
+          const unsigned class_id,
+          const int known,
+          const uint64_t old_value,
+          const uint64_t new_value)
+{
+        if (known && old_value == new_value)
+                return;
+
+        trace_add(type, id, class_id, old_value, new_value);
+}
+
+/**
+ * @brief Records L3 CAT class definition changes
+ *
+ * @param [in] id L3 CAT id
+ * @param [in] num_old number of classes in \a old
+ * @param [in] old class definitions read before the change
+ * @param [in] num_cos number of classes in \a ca
+ * @param [in] ca new class definitions
+ */
+static void
+trace_l3ca(const unsigned id,
+           const unsigned num_old,
+           const struct pqos_l3ca *old,
+           const unsigned num_cos,
+           const struct pqos_l3ca *ca)
+{
+        unsigned i, j;
+
+        for (i = 0; i < num_cos; i++) {
+                const struct pqos_l3ca *prev = NULL;
+                uint64_t data = 0, code = 0;
+
+                for (j = 0; j < num_old; j++)
+                        if (old[j].class_id == ca[i].class_id) {
+                                prev = &old[j];
+                                data = prev->cdp ? prev->u.s.data_mask
+                                                 : prev->u.ways_mask;
+                                code = prev->cdp ? prev->u.s.code_mask
+                                                 : prev->u.ways_mask;
+                                break;
+                        }
+
+                if (ca[i].cdp) {
+                        trace_cos(PQOS_TRACE_L3CA_DATA, id, ca[i].class_id,
+                                  prev != NULL, data, ca[i].u.s.data_mask);
+                        trace_cos(PQOS_TRACE_L3CA_CODE, id, ca[i].class_id,
+                                  prev != NULL, code, ca[i].u.s.code_mask);
+                } else
+                        trace_cos(PQOS_TRACE_L3CA, id, ca[i].class_id,
+                                  prev != NULL, data, ca[i].u.ways_mask);
+        }
+}
+
+/**
+ * @brief Records L2 CAT class definition changes
+ *
+ * @param [in] id L2 id
+ * @param [in] num_old number of classes in \a old
+ * @param [in] old class definitions read before the change
+ * @param [in] num_cos number of classes in \a ca
+ * @param [in] ca new class definitions
+ */
+static void
+trace_l2ca(const unsigned id,
+           const unsigned num_old,
+           const struct pqos_l2ca *old,
+           const unsigned num_cos,
+           const struct pqos_l2ca *ca)
+{
+        unsigned i, j;
+
+        for (i = 0; i < num_cos; i++) {
+                const struct pqos_l2ca *prev = NULL;
+                uint64_t data = 0, code = 0;
+
+                for (j = 0; j < num_old; j++)
+                        if (old[j].class_id == ca[i].class_id) {
+                                prev = &old[j];
+                                data = prev->cdp ? prev->u.s.data_mask
+                                                 : prev->u.ways_mask;
+                                code = prev->cdp ? prev->u.s.code_mask
+                                                 : prev->u.ways_mask;
+                                break;
+                        }
+
+                if (ca[i].cdp) {
+                        trace_cos(PQOS_TRACE_L2CA_DATA, id, ca[i].class_id,
+                                  prev != NULL, data, ca[i].u.s.data_mask);
+                        trace_cos(PQOS_TRACE_L2CA_CODE, id, ca[i].class_id,
+                                  prev != NULL, code, ca[i].u.s.code_mask);
+                } else
+                        trace_cos(PQOS_TRACE_L2CA, id, ca[i].class_id,
+                                  prev != NULL, data, ca[i].u.ways_mask);
+        }
+}
+
+/**
+ * @brief Records MBA class definition changes
+ *
+ * @param [in] id MBA id
+ * @param [in] num_old number of classes in \a old
+ * @param [in] old class definitions read before the change
+ * @param [in] num_cos number of classes in \a mba
+ * @param [in] mba new class definitions
+ */
+static void
+trace_mba(const unsigned id,
+          const unsigned num_old,
+          const struct pqos_mba *old,
+          const unsigned num_cos,
+          const struct pqos_mba *mba)
+{
+        unsigned i, j;
+
+        for (i = 0; i < num_cos; i++) {
+                int known = 0;
+                uint64_t prev = 0;
+
+                for (j = 0; j < num_old; j++)
+                        if (old[j].class_id == mba[i].class_id) {
+                                known = 1;
+                                prev = old[j].mb_max;
+                                break;
+                        }
+                trace_cos(PQOS_TRACE_MBA, id, mba[i].class_id, known, prev,
+                          mba[i].mb_max);
+        }
+}
+
 /*
  * =======================================
  * Allocation Technology
@@ -132,16 +368,21 @@ api_init(int interface, enum pqos_vendor vendor)
 int
 pqos_alloc_assoc_set(const unsigned lcore, const unsigned class_id)
 {
+        unsigned *old;
         int ret;
 
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC | PQOS_TECH_ASSOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
         }
 
+        old = trace_assoc_save(&lcore, NULL, 1);
+
         if (m_interface == PQOS_INTER_MSR)
                 ret = hw_alloc_assoc_set(lcore, class_id);
         else {
@@ -152,6 +393,10 @@ pqos_alloc_assoc_set(const unsigned lcore, const unsigned class_id)
                 ret = PQOS_RETVAL_RESOURCE;
 #endif
         }
+        if (ret == PQOS_RETVAL_OK)
+                trace_assoc(&lcore, NULL, 1, old, class_id);
+        else
+                free(old);
         _pqos_api_unlock();
 
         return ret;
@@ -168,6 +413,8 @@ pqos_alloc_assoc_get(const unsigned lcore, unsigned *class_id)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -192,10 +439,15 @@ int
 pqos_alloc_assoc_set_pid(const pid_t task, const unsigned class_id)
 {
         int ret;
+#ifdef __linux__
+        unsigned *old;
+#endif
 
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC | PQOS_TECH_ASSOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -210,7 +462,12 @@ pqos_alloc_assoc_set_pid(const pid_t task, const unsigned class_id)
         }
 
 #ifdef __linux__
+        old = trace_assoc_save(NULL, &task, 1);
         ret = os_alloc_assoc_set_pid(task, class_id);
+        if (ret == PQOS_RETVAL_OK)
+                trace_assoc(NULL, &task, 1, old, class_id);
+        else
+                free(old);
 #else
         UNUSED_PARAM(task);
         UNUSED_PARAM(class_id);
@@ -233,6 +490,8 @@ pqos_alloc_assoc_get_pid(const pid_t task, unsigned *class_id)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -265,6 +524,7 @@ pqos_alloc_assign(const unsigned technology,
                   const unsigned core_num,
                   unsigned *class_id)
 {
+        unsigned *old;
         int ret;
         const int l2_req = ((technology & (1 << PQOS_CAP_TYPE_L2CA)) != 0);
         const int l3_req = ((technology & (1 << PQOS_CAP_TYPE_L3CA)) != 0);
@@ -277,11 +537,15 @@ pqos_alloc_assign(const unsigned technology,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC | PQOS_TECH_ASSOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
         }
 
+        old = trace_assoc_save(core_array, NULL, core_num);
+
         if (api.alloc_assign != NULL)
                 ret = api.alloc_assign(technology, core_array, core_num,
                                        class_id);
@@ -289,6 +553,10 @@ pqos_alloc_assign(const unsigned technology,
                 LOG_INFO("Interface not supported!\n");
                 ret = PQOS_RETVAL_RESOURCE;
         }
+        if (ret == PQOS_RETVAL_OK)
+                trace_assoc(core_array, NULL, core_num, old, *class_id);
+        else
+                free(old);
         _pqos_api_unlock();
 
         return ret;
@@ -297,6 +565,7 @@ pqos_alloc_assign(const unsigned technology,
 int
 pqos_alloc_release(const unsigned *core_array, const unsigned core_num)
 {
+        unsigned *old;
         int ret;
 
         if (core_num == 0 || core_array == NULL)
@@ -305,11 +574,15 @@ pqos_alloc_release(const unsigned *core_array, const unsigned core_num)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC | PQOS_TECH_ASSOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
         }
 
+        old = trace_assoc_save(core_array, NULL, core_num);
+
         if (m_interface == PQOS_INTER_MSR)
                 ret = hw_alloc_release(core_array, core_num);
         else {
@@ -320,6 +593,10 @@ pqos_alloc_release(const unsigned *core_array, const unsigned core_num)
                 ret = PQOS_RETVAL_RESOURCE;
 #endif
         }
+        if (ret == PQOS_RETVAL_OK)
+                trace_assoc(core_array, NULL, core_num, old, 0);
+        else
+                free(old);
         _pqos_api_unlock();
 
         return ret;
@@ -332,6 +609,9 @@ pqos_alloc_assign_pid(const unsigned technology,
                       unsigned *class_id)
 {
         int ret;
+#ifdef __linux__
+        unsigned *old;
+#endif
 
         if (task_array == NULL || task_num == 0 || class_id == NULL)
                 return PQOS_RETVAL_PARAM;
@@ -339,6 +619,8 @@ pqos_alloc_assign_pid(const unsigned technology,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC | PQOS_TECH_ASSOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -353,7 +635,12 @@ pqos_alloc_assign_pid(const unsigned technology,
         }
 
 #ifdef __linux__
+        old = trace_assoc_save(NULL, task_array, task_num);
         ret = os_alloc_assign_pid(technology, task_array, task_num, class_id);
+        if (ret == PQOS_RETVAL_OK)
+                trace_assoc(NULL, task_array, task_num, old, *class_id);
+        else
+                free(old);
 #else
         UNUSED_PARAM(technology);
         LOG_INFO("OS interface not supported!\n");
@@ -368,6 +655,9 @@ int
 pqos_alloc_release_pid(const pid_t *task_array, const unsigned task_num)
 {
         int ret;
+#ifdef __linux__
+        unsigned *old;
+#endif
 
         if (task_array == NULL || task_num == 0)
                 return PQOS_RETVAL_PARAM;
@@ -375,6 +665,8 @@ pqos_alloc_release_pid(const pid_t *task_array, const unsigned task_num)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC | PQOS_TECH_ASSOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -389,7 +681,12 @@ pqos_alloc_release_pid(const pid_t *task_array, const unsigned task_num)
         }
 
 #ifdef __linux__
+        old = trace_assoc_save(NULL, task_array, task_num);
         ret = os_alloc_release_pid(task_array, task_num);
+        if (ret == PQOS_RETVAL_OK)
+                trace_assoc(NULL, task_array, task_num, old, 0);
+        else
+                free(old);
 #else
         LOG_INFO("OS interface not supported!\n");
         ret = PQOS_RETVAL_RESOURCE;
@@ -432,6 +729,8 @@ pqos_alloc_reset(const enum pqos_cdp_config l3_cdp_cfg,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC | PQOS_TECH_ASSOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -447,6 +746,10 @@ pqos_alloc_reset(const enum pqos_cdp_config l3_cdp_cfg,
                 ret = PQOS_RETVAL_RESOURCE;
 #endif
         }
+        if (ret == PQOS_RETVAL_OK)
+                trace_add(PQOS_TRACE_RESET, 0, 0, 0,
+                          (uint64_t)l3_cdp_cfg | (uint64_t)l2_cdp_cfg << 8 |
+                              (uint64_t)mba_cfg << 16);
         _pqos_api_unlock();
 
         return ret;
@@ -470,6 +773,8 @@ pqos_pid_get_pid_assoc(const unsigned class_id, unsigned *count)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return NULL;
@@ -529,6 +834,8 @@ pqos_l3ca_set(const unsigned l3cat_id,
               const unsigned num_cos,
               const struct pqos_l3ca *ca)
 {
+        struct pqos_l3ca old[PQOS_MAX_L3CA_COS];
+        unsigned num_old = 0;
         int ret;
         unsigned i;
 
@@ -538,6 +845,8 @@ pqos_l3ca_set(const unsigned l3cat_id,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_L3CA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -563,16 +872,25 @@ pqos_l3ca_set(const unsigned l3cat_id,
                 }
         }
 
-        if (m_interface == PQOS_INTER_MSR)
+        if (m_interface == PQOS_INTER_MSR) {
+                /* read under the lock, other processes may change it */
+                if (hw_l3ca_get(l3cat_id, PQOS_MAX_L3CA_COS, &num_old, old) !=
+                    PQOS_RETVAL_OK)
+                        num_old = 0;
                 ret = hw_l3ca_set(l3cat_id, num_cos, ca);
-        else {
+        } else {
 #ifdef __linux__
+                if (os_l3ca_get(l3cat_id, PQOS_MAX_L3CA_COS, &num_old, old) !=
+                    PQOS_RETVAL_OK)
+                        num_old = 0;
                 ret = os_l3ca_set(l3cat_id, num_cos, ca);
 #else
                 LOG_INFO("OS interface not supported!\n");
                 ret = PQOS_RETVAL_RESOURCE;
 #endif
         }
+        if (ret == PQOS_RETVAL_OK)
+                trace_l3ca(l3cat_id, num_old, old, num_cos, ca);
         _pqos_api_unlock();
 
         return ret;
@@ -592,6 +910,8 @@ pqos_l3ca_get(const unsigned l3cat_id,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_L3CA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -622,6 +942,8 @@ pqos_l3ca_get_min_cbm_bits(unsigned *min_cbm_bits)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_L3CA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -654,6 +976,8 @@ pqos_l2ca_set(const unsigned l2id,
               const unsigned num_cos,
               const struct pqos_l2ca *ca)
 {
+        struct pqos_l2ca old[PQOS_MAX_L2CA_COS];
+        unsigned num_old = 0;
         int ret;
         unsigned i;
 
@@ -663,6 +987,8 @@ pqos_l2ca_set(const unsigned l2id,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_L2CA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -687,16 +1013,25 @@ pqos_l2ca_set(const unsigned l2id,
                         return PQOS_RETVAL_PARAM;
                 }
         }
-        if (m_interface == PQOS_INTER_MSR)
+        if (m_interface == PQOS_INTER_MSR) {
+                /* read under the lock, other processes may change it */
+                if (hw_l2ca_get(l2id, PQOS_MAX_L2CA_COS, &num_old, old) !=
+                    PQOS_RETVAL_OK)
+                        num_old = 0;
                 ret = hw_l2ca_set(l2id, num_cos, ca);
-        else {
+        } else {
 #ifdef __linux__
+                if (os_l2ca_get(l2id, PQOS_MAX_L2CA_COS, &num_old, old) !=
+                    PQOS_RETVAL_OK)
+                        num_old = 0;
                 ret = os_l2ca_set(l2id, num_cos, ca);
 #else
                 LOG_INFO("OS interface not supported!\n");
                 ret = PQOS_RETVAL_RESOURCE;
 #endif
         }
+        if (ret == PQOS_RETVAL_OK)
+                trace_l2ca(l2id, num_old, old, num_cos, ca);
         _pqos_api_unlock();
 
         return ret;
@@ -716,6 +1051,8 @@ pqos_l2ca_get(const unsigned l2id,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_L2CA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -747,6 +1084,8 @@ pqos_l2ca_get_min_cbm_bits(unsigned *min_cbm_bits)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_L2CA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -780,6 +1119,8 @@ pqos_mba_set(const unsigned mba_id,
              const struct pqos_mba *requested,
              struct pqos_mba *actual)
 {
+        struct pqos_mba old[PQOS_MAX_COS];
+        unsigned num_old = 0;
         int ret;
         unsigned i;
 
@@ -789,6 +1130,8 @@ pqos_mba_set(const unsigned mba_id,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MBA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -811,6 +1154,11 @@ pqos_mba_set(const unsigned mba_id,
                 }
         }
 
+        /* read under the lock, other processes may change it */
+        if (api.mba_get == NULL ||
+            api.mba_get(mba_id, PQOS_MAX_COS, &num_old, old) != PQOS_RETVAL_OK)
+                num_old = 0;
+
         if (api.mba_set != NULL)
                 ret = api.mba_set(mba_id, num_cos, requested, actual);
         else {
@@ -818,6 +1166,10 @@ pqos_mba_set(const unsigned mba_id,
                 ret = PQOS_RETVAL_RESOURCE;
         }
 
+        if (ret == PQOS_RETVAL_OK)
+                trace_mba(mba_id, num_old, old, num_cos,
+                          actual != NULL ? actual : requested);
+
         _pqos_api_unlock();
 
         return ret;
@@ -837,6 +1189,8 @@ pqos_mba_get(const unsigned mba_id,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MBA);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -854,6 +1208,116 @@ pqos_mba_get(const unsigned mba_id,
         return ret;
 }
 
+/*
+ * =======================================
+ * Hardware prefetcher control
+ * =======================================
+ */
+
+int
+pqos_prefetch_set(const unsigned lcore, const unsigned enabled)
+{
+        unsigned prev;
+        int ret;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        /* prefetcher MSR is accessed directly on both interfaces */
+        if (hw_prefetch_get(lcore, &prev) != PQOS_RETVAL_OK)
+                prev = 0;
+        ret = hw_prefetch_set(lcore, enabled);
+        if (ret == PQOS_RETVAL_OK)
+                trace_add(PQOS_TRACE_PREFETCH, lcore, 0, prev, enabled);
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_prefetch_get(const unsigned lcore, unsigned *enabled)
+{
+        int ret;
+
+        if (enabled == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        ret = hw_prefetch_get(lcore, enabled);
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_prefetch_cos_set(const unsigned class_id, const unsigned enabled)
+{
+        const struct pqos_cpuinfo *cpu = NULL;
+        unsigned i;
+        int ret;
+
+        if (enabled & ~PQOS_PREFETCH_ALL)
+                return PQOS_RETVAL_PARAM;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_ALLOC);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        _pqos_cap_get(NULL, &cpu);
+
+        for (i = 0; i < cpu->num_cores; i++) {
+                const unsigned lcore = cpu->cores[i].lcore;
+                unsigned cos = 0, prev;
+
+                if (m_interface == PQOS_INTER_MSR)
+                        ret = hw_alloc_assoc_get(lcore, &cos);
+                else {
+#ifdef __linux__
+                        ret = os_alloc_assoc_get(lcore, &cos);
+#else
+                        LOG_INFO("OS interface not supported!\n");
+                        ret = PQOS_RETVAL_RESOURCE;
+#endif
+                }
+                if (ret != PQOS_RETVAL_OK)
+                        break;
+
+                if (cos != class_id)
+                        continue;
+
+                if (hw_prefetch_get(lcore, &prev) != PQOS_RETVAL_OK)
+                        prev = 0;
+                ret = hw_prefetch_set(lcore, enabled);
+                if (ret != PQOS_RETVAL_OK)
+                        break;
+                trace_add(PQOS_TRACE_PREFETCH, lcore, class_id, prev, enabled);
+        }
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
 /*
  * =======================================
  * Monitoring
@@ -868,6 +1332,8 @@ pqos_mon_reset(void)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -897,6 +1363,8 @@ pqos_mon_assoc_get(const unsigned lcore, pqos_rmid_t *rmid)
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -947,6 +1415,8 @@ pqos_mon_start(const unsigned num_cores,
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -971,54 +1441,95 @@ pqos_mon_start(const unsigned num_cores,
 }
 
 int
-pqos_mon_stop(struct pqos_mon_data *group)
+pqos_mon_start_remainder(const unsigned cluster,
+                         const enum pqos_mon_event event,
+                         void *context,
+                         struct pqos_mon_data *group)
 {
         int ret;
 
-        if (group == NULL)
+        if (group == NULL || event == 0)
                 return PQOS_RETVAL_PARAM;
 
-        if (group->valid != GROUP_VALID_MARKER)
+        if (group->valid == GROUP_VALID_MARKER)
+                return PQOS_RETVAL_PARAM;
+
+        /**
+         * Only PQoS events can be monitored for the remainder
+         */
+        if (event & (~(PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
+                       PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW)))
                 return PQOS_RETVAL_PARAM;
 
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
         }
 
         if (m_interface == PQOS_INTER_MSR)
-                ret = hw_mon_stop(group);
+                ret = hw_mon_start_remainder(cluster, event, context, group);
         else {
 #ifdef __linux__
-                ret = os_mon_stop(group);
+                ret = os_mon_start_remainder(cluster, event, context, group);
 #else
                 LOG_INFO("OS interface not supported!\n");
                 ret = PQOS_RETVAL_RESOURCE;
 #endif
         }
+        if (ret == PQOS_RETVAL_OK)
+                group->valid = GROUP_VALID_MARKER;
+
         _pqos_api_unlock();
 
         return ret;
 }
 
+/**
+ * @brief Validates core monitoring group for core membership change
+ *
+ * @param [in] group monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK if cores can be added/removed
+ */
+static int
+mon_cores_check(const struct pqos_mon_data *group)
+{
+        if (group->valid != GROUP_VALID_MARKER)
+                return PQOS_RETVAL_PARAM;
+
+        if (group->num_cores == 0 || group->num_pids > 0) {
+                LOG_ERROR("Cores can be added to or removed from "
+                          "core monitoring groups only\n");
+                return PQOS_RETVAL_PARAM;
+        }
+
+        if (group->set != NULL) {
+                LOG_ERROR("Cannot change cores of group set member\n");
+                return PQOS_RETVAL_PARAM;
+        }
+
+        return PQOS_RETVAL_OK;
+}
+
 int
-pqos_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups)
+pqos_mon_add_cores(const unsigned num_cores,
+                   const unsigned *cores,
+                   struct pqos_mon_data *group)
 {
         int ret;
-        unsigned i;
 
-        if (groups == NULL || num_groups == 0 || *groups == NULL)
+        if (num_cores == 0 || cores == NULL || group == NULL)
                 return PQOS_RETVAL_PARAM;
 
-        for (i = 0; i < num_groups; i++) {
-                if (groups[i] == NULL)
-                        return PQOS_RETVAL_PARAM;
-                if (groups[i]->valid != GROUP_VALID_MARKER)
-                        return PQOS_RETVAL_PARAM;
-        }
+        ret = mon_cores_check(group);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
 
         _pqos_api_lock();
 
@@ -1029,34 +1540,377 @@ pqos_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups)
         }
 
         if (m_interface == PQOS_INTER_MSR)
-                ret = hw_mon_poll(groups, num_groups);
+                ret = hw_mon_add_cores(num_cores, cores, group);
         else {
 #ifdef __linux__
-                ret = os_mon_poll(groups, num_groups);
+                ret = os_mon_add_cores(num_cores, cores, group);
 #else
                 LOG_INFO("OS interface not supported!\n");
                 ret = PQOS_RETVAL_RESOURCE;
 #endif
         }
+
         _pqos_api_unlock();
 
         return ret;
 }
 
 int
-pqos_mon_start_pid(const pid_t pid,
-                   const enum pqos_mon_event event,
-                   void *context,
-                   struct pqos_mon_data *group)
+pqos_mon_remove_cores(const unsigned num_cores,
+                      const unsigned *cores,
+                      struct pqos_mon_data *group)
 {
-        return pqos_mon_start_pids(1, &pid, event, context, group);
-}
+        int ret;
 
-int
-pqos_mon_start_pids(const unsigned num_pids,
-                    const pid_t *pids,
-                    const enum pqos_mon_event event,
-                    void *context,
+        if (num_cores == 0 || cores == NULL || group == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        ret = mon_cores_check(group);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        if (m_interface == PQOS_INTER_MSR)
+                ret = hw_mon_remove_cores(num_cores, cores, group);
+        else {
+#ifdef __linux__
+                ret = os_mon_remove_cores(num_cores, cores, group);
+#else
+                LOG_INFO("OS interface not supported!\n");
+                ret = PQOS_RETVAL_RESOURCE;
+#endif
+        }
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_stop(struct pqos_mon_data *group)
+{
+        int ret;
+
+        if (group == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        if (group->valid != GROUP_VALID_MARKER)
+                return PQOS_RETVAL_PARAM;
+
+        if (group->set != NULL) {
+                LOG_ERROR("Group belongs to a group set, "
+                          "use pqos_mon_set_destroy()\n");
+                return PQOS_RETVAL_PARAM;
+        }
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        if (m_interface == PQOS_INTER_MSR)
+                ret = hw_mon_stop(group);
+        else {
+#ifdef __linux__
+                ret = os_mon_stop(group);
+#else
+                LOG_INFO("OS interface not supported!\n");
+                ret = PQOS_RETVAL_RESOURCE;
+#endif
+        }
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups)
+{
+        int ret;
+        unsigned i;
+
+        if (groups == NULL || num_groups == 0 || *groups == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        for (i = 0; i < num_groups; i++) {
+                if (groups[i] == NULL)
+                        return PQOS_RETVAL_PARAM;
+                if (groups[i]->valid != GROUP_VALID_MARKER)
+                        return PQOS_RETVAL_PARAM;
+        }
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        if (m_interface == PQOS_INTER_MSR)
+                ret = hw_mon_poll(groups, num_groups);
+        else {
+#ifdef __linux__
+                ret = os_mon_poll(groups, num_groups);
+#else
+                LOG_INFO("OS interface not supported!\n");
+                ret = PQOS_RETVAL_RESOURCE;
+#endif
+        }
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_poll_snapshot(struct pqos_mon_data **groups,
+                       const unsigned num_groups,
+                       struct pqos_mon_snapshot *snapshot)
+{
+        struct pqos_mon_snapshot snap;
+        int ret;
+        unsigned i;
+
+        if (groups == NULL || num_groups == 0 || *groups == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        for (i = 0; i < num_groups; i++) {
+                if (groups[i] == NULL)
+                        return PQOS_RETVAL_PARAM;
+                if (groups[i]->valid != GROUP_VALID_MARKER)
+                        return PQOS_RETVAL_PARAM;
+        }
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        memset(&snap, 0, sizeof(snap));
+
+        if (m_interface == PQOS_INTER_MSR)
+                ret = hw_mon_poll_snapshot(groups, num_groups, &snap);
+        else {
+#ifdef __linux__
+                ret = os_mon_poll_snapshot(groups, num_groups, &snap);
+#else
+                LOG_INFO("OS interface not supported!\n");
+                ret = PQOS_RETVAL_RESOURCE;
+#endif
+        }
+        if (ret == PQOS_RETVAL_OK && snapshot != NULL)
+                *snapshot = snap;
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_set_create(const unsigned max_groups,
+                    const unsigned max_cores,
+                    struct pqos_mon_set **set)
+{
+        int ret;
+
+        if (set == NULL || max_groups == 0 || max_cores == 0)
+                return PQOS_RETVAL_PARAM;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        *set = mon_set_alloc(max_groups, max_cores);
+        if (*set == NULL)
+                ret = PQOS_RETVAL_RESOURCE;
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_set_start(struct pqos_mon_set *set,
+                   const unsigned num_cores,
+                   const unsigned *cores,
+                   const enum pqos_mon_event event,
+                   void *context,
+                   struct pqos_mon_data **group)
+{
+        struct pqos_mon_data *grp = NULL;
+        int ret;
+
+        if (set == NULL || group == NULL || cores == NULL || num_cores == 0 ||
+            event == 0)
+                return PQOS_RETVAL_PARAM;
+
+        /**
+         * Validate event parameter
+         * - only combinations of events allowed
+         * - do not allow non-PQoS events to be monitored on its own
+         */
+        if (event & (~(PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
+                       PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW |
+                       PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS)))
+                return PQOS_RETVAL_PARAM;
+
+        if ((event & (PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
+                      PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW)) == 0 &&
+            (event & (PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS)) != 0)
+                return PQOS_RETVAL_PARAM;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        if (m_interface == PQOS_INTER_MSR)
+                ret = hw_mon_set_start(set, num_cores, cores, event, context,
+                                       &grp);
+        else {
+#ifdef __linux__
+                if (set->num_groups >= set->max_groups) {
+                        LOG_ERROR("Monitoring group set is full\n");
+                        ret = PQOS_RETVAL_RESOURCE;
+                } else {
+                        grp = &set->groups[set->num_groups];
+                        ret = os_mon_start(num_cores, cores, event, context,
+                                           grp);
+                }
+                if (ret == PQOS_RETVAL_OK) {
+                        grp->set = set;
+                        set->group_ptrs[set->num_groups] = grp;
+                        set->num_groups++;
+                }
+#else
+                LOG_INFO("OS interface not supported!\n");
+                ret = PQOS_RETVAL_RESOURCE;
+#endif
+        }
+        if (ret == PQOS_RETVAL_OK) {
+                grp->valid = GROUP_VALID_MARKER;
+                *group = grp;
+        }
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_set_poll(struct pqos_mon_set *set)
+{
+        int ret;
+
+        if (set == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        if (set->num_groups == 0)
+                ret = PQOS_RETVAL_OK;
+        else if (m_interface == PQOS_INTER_MSR)
+                ret = hw_mon_set_poll(set);
+        else {
+#ifdef __linux__
+                ret = os_mon_poll(set->group_ptrs, set->num_groups);
+#else
+                LOG_INFO("OS interface not supported!\n");
+                ret = PQOS_RETVAL_RESOURCE;
+#endif
+        }
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_set_destroy(struct pqos_mon_set *set)
+{
+        int ret;
+        unsigned i;
+
+        if (set == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        for (i = 0; i < set->num_groups; i++) {
+                struct pqos_mon_data *group = &set->groups[i];
+                int retval;
+
+                if (group->valid != GROUP_VALID_MARKER)
+                        continue;
+
+                if (m_interface == PQOS_INTER_MSR)
+                        retval = hw_mon_stop(group);
+                else {
+#ifdef __linux__
+                        retval = os_mon_stop(group);
+#else
+                        retval = PQOS_RETVAL_RESOURCE;
+#endif
+                }
+                if (retval != PQOS_RETVAL_OK)
+                        ret = retval;
+        }
+
+        mon_set_free(set);
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
+int
+pqos_mon_start_pid(const pid_t pid,
+                   const enum pqos_mon_event event,
+                   void *context,
+                   struct pqos_mon_data *group)
+{
+        return pqos_mon_start_pids(1, &pid, event, context, group);
+}
+
+int
+pqos_mon_start_pids(const unsigned num_pids,
+                    const pid_t *pids,
+                    const enum pqos_mon_event event,
+                    void *context,
                     struct pqos_mon_data *group)
 {
         int ret;
@@ -1081,17 +1935,21 @@ pqos_mon_start_pids(const unsigned num_pids,
          */
         if (event & (~(PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
                        PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW |
-                       PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS)))
+                       PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS |
+                       PQOS_PERF_EVENT_LLC_MISS_SAMPLE)))
                 return PQOS_RETVAL_PARAM;
 
         if ((event & (PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
                       PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW)) == 0 &&
-            (event & (PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS)) != 0)
+            (event & (PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS |
+                      PQOS_PERF_EVENT_LLC_MISS_SAMPLE)) != 0)
                 return PQOS_RETVAL_PARAM;
 
         _pqos_api_lock();
 
         ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
         if (ret != PQOS_RETVAL_OK) {
                 _pqos_api_unlock();
                 return ret;
@@ -1113,6 +1971,74 @@ pqos_mon_start_pids(const unsigned num_pids,
         return ret;
 }
 
+int
+pqos_mon_start_named(const unsigned num_groups,
+                     const struct pqos_mon_named *cfg,
+                     struct pqos_mon_data **groups)
+{
+        int ret;
+        unsigned i;
+
+        if (num_groups == 0 || cfg == NULL || groups == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        for (i = 0; i < num_groups; i++) {
+                const struct pqos_mon_named *c = &cfg[i];
+                size_t len;
+
+                if (groups[i] == NULL || c->name == NULL || c->event == 0)
+                        return PQOS_RETVAL_PARAM;
+                if (groups[i]->valid == GROUP_VALID_MARKER)
+                        return PQOS_RETVAL_PARAM;
+
+                /* either cores or pids */
+                if ((c->num_cores == 0) == (c->num_pids == 0) ||
+                    (c->num_cores > 0 && c->cores == NULL) ||
+                    (c->num_pids > 0 && c->pids == NULL))
+                        return PQOS_RETVAL_PARAM;
+
+                /* name is a single path component */
+                len = strnlen(c->name, PQOS_MON_NAME_MAX);
+                if (len == 0 || len == PQOS_MON_NAME_MAX ||
+                    c->name[0] == '.' || strchr(c->name, '/') != NULL) {
+                        LOG_ERROR("Invalid monitoring group name\n");
+                        return PQOS_RETVAL_PARAM;
+                }
+        }
+
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
+        if (ret != PQOS_RETVAL_OK) {
+                _pqos_api_unlock();
+                return ret;
+        }
+
+        if (m_interface != PQOS_INTER_OS &&
+            m_interface != PQOS_INTER_OS_RESCTRL_MON) {
+                LOG_ERROR("Named monitoring groups require OS interface!\n");
+                _pqos_api_unlock();
+                return PQOS_RETVAL_RESOURCE;
+        }
+
+#ifdef __linux__
+        ret = os_mon_start_named(num_groups, cfg, groups);
+#else
+        LOG_INFO("OS interface not supported!\n");
+        ret = PQOS_RETVAL_RESOURCE;
+#endif
+
+        if (ret == PQOS_RETVAL_OK)
+                for (i = 0; i < num_groups; i++)
+                        groups[i]->valid = GROUP_VALID_MARKER;
+
+        _pqos_api_unlock();
+
+        return ret;
+}
+
 int
 pqos_mon_add_pids(const unsigned num_pids,
                   const pid_t *pids,
@@ -1192,3 +2118,28 @@ pqos_mon_remove_pids(const unsigned num_pids,
 
         return ret;
 }
+
+/*
+ * =======================================
+ * Configuration change trace
+ * =======================================
+ */
+
+int
+pqos_trace_get(const unsigned max_num,
+               unsigned *num,
+               struct pqos_trace_entry *entries)
+{
+        int ret;
+
+        /* trace ring is unmapped by pqos_fini() */
+        _pqos_api_lock();
+
+        ret = _pqos_check_init(1);
+        if (ret == PQOS_RETVAL_OK)
+                ret = trace_get(max_num, num, entries);
+
+        _pqos_api_unlock();
+
+        return ret;
+}
@@ -70,6 +70,7 @@
 #include "api.h"
 #include "utils.h"
 #include "resctrl.h"
+#include "trace.h"
 
 /**
  * ---------------------------------------
@@ -107,6 +108,33 @@
  */
 static struct pqos_cap *m_cap = NULL;
 
+/**
+ * Size of \a m_cap allocation, room for all capability types
+ */
+static size_t m_cap_size = 0;
+
+/**
+ * Technologies discovered so far, PQOS_TECH_* mask
+ */
+static unsigned m_tech_discovered = 0;
+
+/**
+ * Allocation and monitoring module initialization status
+ */
+static int m_alloc_init = 0;
+static int m_mon_init = 0;
+
+/**
+ * Error of failed module initialization, returned on each later use
+ */
+static int m_alloc_init_err = PQOS_RETVAL_OK;
+static int m_mon_init_err = PQOS_RETVAL_OK;
+
+/**
+ * Copy of library configuration for on demand initialization
+ */
+static struct pqos_config m_config;
+
 /**
  * This gets allocated and initialized in this module.
  * This hold information about CPU topology in PQoS format.
@@ -244,191 +272,216 @@ _pqos_check_init(const int expect)
         return PQOS_RETVAL_OK;
 }
 
+/**
+ * @brief Adds discovered capability to \a cap
+ *
+ * Capabilities are kept sorted by type, so the order is the same
+ * regardless of the order technologies got discovered in.
+ *
+ * @param [in,out] cap capabilities structure with room for all types
+ * @param [in] type capability type
+ * @param [in] item capability details
+ */
+static void
+cap_add(struct pqos_cap *cap, const enum pqos_cap_type type, void *item)
+{
+        unsigned i = cap->num_cap;
+
+        while (i > 0 && cap->capabilities[i - 1].type > type) {
+                cap->capabilities[i] = cap->capabilities[i - 1];
+                i--;
+        }
+
+        cap->capabilities[i].type = type;
+        cap->capabilities[i].u.generic_ptr = item;
+        cap->num_cap++;
+        cap->mem_size = sizeof(struct pqos_cap) +
+                        cap->num_cap * sizeof(struct pqos_capability);
+}
+
 /**
  * @brief Runs detection of platform monitoring and allocation capabilities
  *
- * @param p_cap place to store allocated capabilities structure
- * @param cpu detected cpu topology
- * @param inter selected pqos interface
+ * Detected capabilities are added to \a m_cap.
+ *
+ * @param technology PQOS_TECH_* mask of technologies to discover
  *
  * @return Operation status
  * @retval PQOS_RETVAL_OK success
  */
 static int
-discover_capabilities(struct pqos_cap **p_cap,
-                      const struct pqos_cpuinfo *cpu,
-                      enum pqos_interface inter)
+discover_capabilities(const unsigned technology)
 {
+        const struct pqos_cpuinfo *cpu = m_cpu;
+        const enum pqos_interface inter = m_config.interface;
         struct pqos_cap_mon *det_mon = NULL;
         struct pqos_cap_l3ca *det_l3ca = NULL;
         struct pqos_cap_l2ca *det_l2ca = NULL;
         struct pqos_cap_mba *det_mba = NULL;
         struct pqos_cap *_cap = NULL;
-        unsigned sz = 0;
-        int ret = PQOS_RETVAL_RESOURCE;
+        int ret = PQOS_RETVAL_OK;
+
+        ASSERT(m_cap != NULL);
 
         /**
          * Monitoring init
          */
-        if (inter == PQOS_INTER_MSR)
-                ret = hw_cap_mon_discover(&det_mon, cpu);
+        if (technology & PQOS_TECH_MON) {
+                ret = PQOS_RETVAL_RESOURCE;
+                if (inter == PQOS_INTER_MSR)
+                        ret = hw_cap_mon_discover(&det_mon, cpu);
 #ifdef __linux__
-        else if (inter == PQOS_INTER_OS || inter == PQOS_INTER_OS_RESCTRL_MON)
-                ret = os_cap_mon_discover(&det_mon, cpu);
+                else if (inter == PQOS_INTER_OS ||
+                         inter == PQOS_INTER_OS_RESCTRL_MON)
+                        ret = os_cap_mon_discover(&det_mon, cpu);
 #endif
-        switch (ret) {
-        case PQOS_RETVAL_OK:
-                LOG_INFO("Monitoring capability detected\n");
-                sz += sizeof(struct pqos_capability);
-                break;
-        case PQOS_RETVAL_RESOURCE:
-                LOG_INFO("Monitoring capability not detected\n");
-                break;
-        default:
-                LOG_ERROR("Error encounter in monitoring discovery!\n");
-                ret = PQOS_RETVAL_ERROR;
-                goto error_exit;
+                switch (ret) {
+                case PQOS_RETVAL_OK:
+                        LOG_INFO("Monitoring capability detected\n");
+                        break;
+                case PQOS_RETVAL_RESOURCE:
+                        LOG_INFO("Monitoring capability not detected\n");
+                        break;
+                default:
+                        LOG_ERROR("Error encounter in monitoring discovery!\n");
+                        ret = PQOS_RETVAL_ERROR;
+                        goto error_exit;
+                }
         }
 
         /**
          * L3 Cache allocation init
          */
-        if (inter == PQOS_INTER_MSR)
-                ret = hw_cap_l3ca_discover(&det_l3ca, cpu);
+        if (technology & PQOS_TECH_L3CA) {
+                ret = PQOS_RETVAL_RESOURCE;
+                if (inter == PQOS_INTER_MSR)
+                        ret = hw_cap_l3ca_discover(&det_l3ca, cpu);
 #ifdef __linux__
-        else if (inter == PQOS_INTER_OS || inter == PQOS_INTER_OS_RESCTRL_MON)
-                ret = os_cap_l3ca_discover(&det_l3ca, cpu);
+                else if (inter == PQOS_INTER_OS ||
+                         inter == PQOS_INTER_OS_RESCTRL_MON)
+                        ret = os_cap_l3ca_discover(&det_l3ca, cpu);
 #endif
-        switch (ret) {
-        case PQOS_RETVAL_OK:
-                LOG_INFO("L3CA capability detected\n");
-                LOG_INFO("L3 CAT details: CDP support=%d, CDP on=%d, "
-                         "#COS=%u, #ways=%u, ways contention bit-mask 0x%lx\n",
-                         det_l3ca->cdp, det_l3ca->cdp_on, det_l3ca->num_classes,
-                         det_l3ca->num_ways,
-                         (unsigned long)det_l3ca->way_contention);
-                LOG_INFO("L3 CAT details: cache size %u bytes, "
-                         "way size %u bytes\n",
-                         det_l3ca->way_size * det_l3ca->num_ways,
-                         det_l3ca->way_size);
-                sz += sizeof(struct pqos_capability);
-                break;
-        case PQOS_RETVAL_RESOURCE:
-                LOG_INFO("L3CA capability not detected\n");
-                break;
-        default:
-                LOG_ERROR("Fatal error encounter in L3 CAT discovery!\n");
-                ret = PQOS_RETVAL_ERROR;
-                goto error_exit;
+                switch (ret) {
+                case PQOS_RETVAL_OK:
+                        LOG_INFO("L3CA capability detected\n");
+                        LOG_INFO("L3 CAT details: CDP support=%d, CDP on=%d, "
+                                 "#COS=%u, #ways=%u, ways contention bit-mask "
+                                 "0x%lx\n",
+                                 det_l3ca->cdp, det_l3ca->cdp_on,
+                                 det_l3ca->num_classes, det_l3ca->num_ways,
+                                 (unsigned long)det_l3ca->way_contention);
+                        LOG_INFO("L3 CAT details: cache size %u bytes, "
+                                 "way size %u bytes\n",
+                                 det_l3ca->way_size * det_l3ca->num_ways,
+                                 det_l3ca->way_size);
+                        break;
+                case PQOS_RETVAL_RESOURCE:
+                        LOG_INFO("L3CA capability not detected\n");
+                        break;
+                default:
+                        LOG_ERROR("Fatal error encounter in L3 CAT "
+                                  "discovery!\n");
+                        ret = PQOS_RETVAL_ERROR;
+                        goto error_exit;
+                }
         }
 
         /**
          * L2 Cache allocation init
          */
-        if (inter == PQOS_INTER_MSR)
-                ret = hw_cap_l2ca_discover(&det_l2ca, cpu);
+        if (technology & PQOS_TECH_L2CA) {
+                ret = PQOS_RETVAL_RESOURCE;
+                if (inter == PQOS_INTER_MSR)
+                        ret = hw_cap_l2ca_discover(&det_l2ca, cpu);
 #ifdef __linux__
-        else if (inter == PQOS_INTER_OS || inter == PQOS_INTER_OS_RESCTRL_MON)
-                ret = os_cap_l2ca_discover(&det_l2ca, cpu);
+                else if (inter == PQOS_INTER_OS ||
+                         inter == PQOS_INTER_OS_RESCTRL_MON)
+                        ret = os_cap_l2ca_discover(&det_l2ca, cpu);
 #endif
-        switch (ret) {
-        case PQOS_RETVAL_OK:
-                LOG_INFO("L2CA capability detected\n");
-                LOG_INFO("L2 CAT details: CDP support=%d, CDP on=%d, "
-                         "#COS=%u, #ways=%u, ways contention bit-mask 0x%lx\n",
-                         det_l2ca->cdp, det_l2ca->cdp_on, det_l2ca->num_classes,
-                         det_l2ca->num_ways,
-                         (unsigned long)det_l2ca->way_contention);
-                LOG_INFO("L2 CAT details: cache size %u bytes, way size %u "
-                         "bytes\n",
-                         det_l2ca->way_size * det_l2ca->num_ways,
-                         det_l2ca->way_size);
-                sz += sizeof(struct pqos_capability);
-                break;
-        case PQOS_RETVAL_RESOURCE:
-                LOG_INFO("L2CA capability not detected\n");
-                break;
-        default:
-                LOG_ERROR("Fatal error encounter in L2 CAT discovery!\n");
-                ret = PQOS_RETVAL_ERROR;
-                goto error_exit;
+                switch (ret) {
+                case PQOS_RETVAL_OK:
+                        LOG_INFO("L2CA capability detected\n");
+                        LOG_INFO("L2 CAT details: CDP support=%d, CDP on=%d, "
+                                 "#COS=%u, #ways=%u, ways contention bit-mask "
+                                 "0x%lx\n",
+                                 det_l2ca->cdp, det_l2ca->cdp_on,
+                                 det_l2ca->num_classes, det_l2ca->num_ways,
+                                 (unsigned long)det_l2ca->way_contention);
+                        LOG_INFO("L2 CAT details: cache size %u bytes, way "
+                                 "size %u bytes\n",
+                                 det_l2ca->way_size * det_l2ca->num_ways,
+                                 det_l2ca->way_size);
+                        break;
+                case PQOS_RETVAL_RESOURCE:
+                        LOG_INFO("L2CA capability not detected\n");
+                        break;
+                default:
+                        LOG_ERROR("Fatal error encounter in L2 CAT "
+                                  "discovery!\n");
+                        ret = PQOS_RETVAL_ERROR;
+                        goto error_exit;
+                }
         }
 
         /**
          * Memory bandwidth allocation init
          */
-        if (inter == PQOS_INTER_MSR) {
-                if (cpu->vendor == PQOS_VENDOR_AMD)
-                        ret = amd_cap_mba_discover(&det_mba, cpu);
-                else
-                        ret = hw_cap_mba_discover(&det_mba, cpu);
-        }
+        if (technology & PQOS_TECH_MBA) {
+                ret = PQOS_RETVAL_RESOURCE;
+                if (inter == PQOS_INTER_MSR) {
+                        if (cpu->vendor == PQOS_VENDOR_AMD)
+                                ret = amd_cap_mba_discover(&det_mba, cpu);
+                        else
+                                ret = hw_cap_mba_discover(&det_mba, cpu);
+                }
 #ifdef __linux__
-        else if (inter == PQOS_INTER_OS || inter == PQOS_INTER_OS_RESCTRL_MON)
-                ret = os_cap_mba_discover(&det_mba, cpu);
+                else if (inter == PQOS_INTER_OS ||
+                         inter == PQOS_INTER_OS_RESCTRL_MON)
+                        ret = os_cap_mba_discover(&det_mba, cpu);
 #endif
-        switch (ret) {
-        case PQOS_RETVAL_OK:
-                LOG_INFO("MBA capability detected\n");
-                LOG_INFO("MBA details: "
-                         "#COS=%u, %slinear, max=%u, step=%u\n",
-                         det_mba->num_classes, det_mba->is_linear ? "" : "non-",
-                         det_mba->throttle_max, det_mba->throttle_step);
-                sz += sizeof(struct pqos_capability);
-                break;
-        case PQOS_RETVAL_RESOURCE:
-                LOG_INFO("MBA capability not detected\n");
-                break;
-        default:
-                LOG_ERROR("Fatal error encounter in MBA discovery!\n");
-                ret = PQOS_RETVAL_ERROR;
-                goto error_exit;
-        }
-
-        if (sz == 0) {
-                LOG_ERROR("No Platform QoS capability discovered\n");
-                ret = PQOS_RETVAL_ERROR;
-                goto error_exit;
+                switch (ret) {
+                case PQOS_RETVAL_OK:
+                        LOG_INFO("MBA capability detected\n");
+                        LOG_INFO("MBA details: "
+                                 "#COS=%u, %slinear, max=%u, step=%u\n",
+                                 det_mba->num_classes,
+                                 det_mba->is_linear ? "" : "non-",
+                                 det_mba->throttle_max, det_mba->throttle_step);
+                        break;
+                case PQOS_RETVAL_RESOURCE:
+                        LOG_INFO("MBA capability not detected\n");
+                        break;
+                default:
+                        LOG_ERROR("Fatal error encounter in MBA discovery!\n");
+                        ret = PQOS_RETVAL_ERROR;
+                        goto error_exit;
+                }
         }
 
-        sz += sizeof(struct pqos_cap);
-        _cap = (struct pqos_cap *)malloc(sz);
+        /**
+         * Build updated capabilities aside, so \a m_cap stays intact
+         * if MBA CTRL detection below fails
+         */
+        _cap = (struct pqos_cap *)malloc(m_cap_size);
         if (_cap == NULL) {
                 LOG_ERROR("Allocation error in %s()\n", __func__);
                 ret = PQOS_RETVAL_ERROR;
                 goto error_exit;
         }
+        memcpy(_cap, m_cap, m_cap_size);
+        ret = PQOS_RETVAL_OK;
 
-        memset(_cap, 0, sz);
-        _cap->mem_size = sz;
-        _cap->version = PQOS_VERSION;
+        if (det_mon != NULL)
+                cap_add(_cap, PQOS_CAP_TYPE_MON, det_mon);
 
-        if (det_mon != NULL) {
-                _cap->capabilities[_cap->num_cap].type = PQOS_CAP_TYPE_MON;
-                _cap->capabilities[_cap->num_cap].u.mon = det_mon;
-                _cap->num_cap++;
-                ret = PQOS_RETVAL_OK;
-        }
+        if (det_l3ca != NULL)
+                cap_add(_cap, PQOS_CAP_TYPE_L3CA, det_l3ca);
 
-        if (det_l3ca != NULL) {
-                _cap->capabilities[_cap->num_cap].type = PQOS_CAP_TYPE_L3CA;
-                _cap->capabilities[_cap->num_cap].u.l3ca = det_l3ca;
-                _cap->num_cap++;
-                ret = PQOS_RETVAL_OK;
-        }
-
-        if (det_l2ca != NULL) {
-                _cap->capabilities[_cap->num_cap].type = PQOS_CAP_TYPE_L2CA;
-                _cap->capabilities[_cap->num_cap].u.l2ca = det_l2ca;
-                _cap->num_cap++;
-                ret = PQOS_RETVAL_OK;
-        }
+        if (det_l2ca != NULL)
+                cap_add(_cap, PQOS_CAP_TYPE_L2CA, det_l2ca);
 
         if (det_mba != NULL) {
-                _cap->capabilities[_cap->num_cap].type = PQOS_CAP_TYPE_MBA;
-                _cap->capabilities[_cap->num_cap].u.mba = det_mba;
-                _cap->num_cap++;
-                ret = PQOS_RETVAL_OK;
+                cap_add(_cap, PQOS_CAP_TYPE_MBA, det_mba);
 #ifdef __linux__
                 /**
                  * Check status of MBA CTRL
@@ -443,7 +496,8 @@ discover_capabilities(struct pqos_cap **p_cap,
 #endif
         }
 
-        (*p_cap) = _cap;
+        memcpy(m_cap, _cap, m_cap_size);
+        m_tech_discovered |= technology;
 
 error_exit:
         if (ret != PQOS_RETVAL_OK) {
@@ -455,13 +509,90 @@ error_exit:
                         free(det_l2ca);
                 if (det_mba != NULL)
                         free(det_mba);
-                if (_cap != NULL)
-                        free(_cap);
         }
+        if (_cap != NULL)
+                free(_cap);
 
         return ret;
 }
 
+int
+_pqos_cap_init(unsigned technology)
+{
+        int ret;
+
+        if (m_config.interface != PQOS_INTER_MSR) {
+                /* resctrl monitoring groups follow their allocation group */
+                if (technology & PQOS_TECH_ASSOC)
+                        technology |= PQOS_TECH_MON;
+                /**
+                 * Number of resctrl groups depends on all allocation
+                 * technologies and allocation init mounts resctrl
+                 */
+                if (technology & PQOS_TECH_ALL)
+                        technology |= PQOS_TECH_ALLOC;
+        }
+        technology &= PQOS_TECH_ALL;
+
+        if ((technology & ~m_tech_discovered) != 0) {
+                ret = discover_capabilities(technology & ~m_tech_discovered);
+                if (ret != PQOS_RETVAL_OK) {
+                        LOG_ERROR("discover_capabilities() error %d\n", ret);
+                        return ret;
+                }
+        }
+
+        if ((technology & PQOS_TECH_ALLOC) && !m_alloc_init) {
+                if (m_alloc_init_err != PQOS_RETVAL_OK)
+                        return m_alloc_init_err;
+
+                ret = pqos_alloc_init(m_cpu, m_cap, &m_config);
+                switch (ret) {
+                case PQOS_RETVAL_BUSY:
+                        /* not cached, resctrl may be released later */
+                        LOG_ERROR("OS allocation init error!\n");
+                        return ret;
+                case PQOS_RETVAL_OK:
+                        LOG_DEBUG("allocation init OK\n");
+                        break;
+                default:
+                        LOG_ERROR("allocation init error %d\n", ret);
+                        m_alloc_init_err = ret;
+                        return ret;
+                }
+                m_alloc_init = 1;
+        }
+
+        /**
+         * If monitoring capability has been discovered
+         * then get max RMID supported by a CPU socket
+         * and allocate memory for RMID table
+         */
+        if ((technology & PQOS_TECH_MON) && !m_mon_init) {
+                if (m_mon_init_err != PQOS_RETVAL_OK)
+                        return m_mon_init_err;
+
+                ret = pqos_mon_init(m_cpu, m_cap, &m_config);
+                switch (ret) {
+                case PQOS_RETVAL_RESOURCE:
+                        LOG_DEBUG("monitoring init aborted: "
+                                  "feature not present\n");
+                        break;
+                case PQOS_RETVAL_OK:
+                        LOG_DEBUG("monitoring init OK\n");
+                        break;
+                case PQOS_RETVAL_ERROR:
+                default:
+                        LOG_ERROR("monitoring init error %d\n", ret);
+                        m_mon_init_err = ret;
+                        return ret;
+                }
+                m_mon_init = 1;
+        }
+
+        return PQOS_RETVAL_OK;
+}
+
 /*
  * =======================================
  * =======================================
@@ -476,7 +607,6 @@ pqos_init(const struct pqos_config *config)
 {
         int ret = PQOS_RETVAL_OK;
         unsigned i = 0, max_core = 0;
-        int cat_init = 0, mon_init = 0;
         char *environment = NULL;
 
         if (config == NULL)
@@ -575,11 +705,22 @@ pqos_init(const struct pqos_config *config)
                          "and cause unexpected behaviour\n");
 #endif
 
-        ret = discover_capabilities(&m_cap, m_cpu, config->interface);
-        if (ret != PQOS_RETVAL_OK) {
-                LOG_ERROR("discover_capabilities() error %d\n", ret);
+        /**
+         * Capabilities are discovered on first use,
+         * reserve space for all of them up front
+         */
+        m_cap_size = sizeof(struct pqos_cap) +
+                     PQOS_CAP_TYPE_NUMOF * sizeof(struct pqos_capability);
+        m_cap = (struct pqos_cap *)malloc(m_cap_size);
+        if (m_cap == NULL) {
+                LOG_ERROR("Allocation error in %s()\n", __func__);
+                ret = PQOS_RETVAL_ERROR;
                 goto machine_init_error;
         }
+        memset(m_cap, 0, m_cap_size);
+        m_cap->mem_size = sizeof(struct pqos_cap);
+        m_cap->version = PQOS_VERSION;
+        m_config = *config;
 
         ret = _pqos_utils_init(config->interface);
         if (ret != PQOS_RETVAL_OK) {
@@ -595,50 +736,26 @@ pqos_init(const struct pqos_config *config)
 #ifdef __linux__
         m_interface = config->interface;
 #endif
-        ret = pqos_alloc_init(m_cpu, m_cap, config);
-        switch (ret) {
-        case PQOS_RETVAL_BUSY:
-                LOG_ERROR("OS allocation init error!\n");
-                goto machine_init_error;
-        case PQOS_RETVAL_OK:
-                LOG_DEBUG("allocation init OK\n");
-                cat_init = 1;
-                break;
-        default:
-                LOG_ERROR("allocation init error %d\n", ret);
-                break;
-        }
-
-        /**
-         * If monitoring capability has been discovered
-         * then get max RMID supported by a CPU socket
-         * and allocate memory for RMID table
-         */
-        ret = pqos_mon_init(m_cpu, m_cap, config);
-        switch (ret) {
-        case PQOS_RETVAL_RESOURCE:
-                LOG_DEBUG("monitoring init aborted: feature not present\n");
-                ret = PQOS_RETVAL_OK;
-                break;
-        case PQOS_RETVAL_OK:
-                LOG_DEBUG("monitoring init OK\n");
-                mon_init = 1;
-                break;
-        case PQOS_RETVAL_ERROR:
-        default:
-                LOG_ERROR("monitoring init error %d\n", ret);
-                break;
-        }
-
-        if (cat_init == 0 && mon_init == 0) {
-                LOG_ERROR("None of detected capabilities could be "
-                          "initialized!\n");
-                ret = PQOS_RETVAL_ERROR;
-        }
+        /* configuration changes are not traced without memory */
+        if (trace_init() != PQOS_RETVAL_OK)
+                LOG_WARN("Configuration change trace not available\n");
+
+#ifdef PQOS_RMID_CUSTOM
+        /* custom RMID map is copied from config, it may not outlive init */
+        if (config->rmid_cfg.type == PQOS_RMID_TYPE_MAP)
+                ret = _pqos_cap_init(PQOS_TECH_MON);
+#endif
 
 machine_init_error:
-        if (ret != PQOS_RETVAL_OK)
+        if (ret != PQOS_RETVAL_OK) {
+                if (m_mon_init)
+                        pqos_mon_fini();
+                if (m_alloc_init)
+                        pqos_alloc_fini();
+                (void)trace_fini();
+                (void)_pqos_utils_fini();
                 (void)machine_fini();
+        }
 cpuinfo_init_error:
         if (ret != PQOS_RETVAL_OK)
                 (void)cpuinfo_fini();
@@ -654,6 +771,11 @@ init_error:
                 }
                 m_cpu = NULL;
                 m_cap = NULL;
+                m_tech_discovered = 0;
+                m_alloc_init = 0;
+                m_mon_init = 0;
+                m_alloc_init_err = PQOS_RETVAL_OK;
+                m_mon_init_err = PQOS_RETVAL_OK;
         }
 
         if (ret == PQOS_RETVAL_OK)
@@ -683,8 +805,10 @@ pqos_fini(void)
                 return ret;
         }
 
-        pqos_mon_fini();
-        pqos_alloc_fini();
+        if (m_mon_init)
+                pqos_mon_fini();
+        if (m_alloc_init)
+                pqos_alloc_fini();
 
         ret = cpuinfo_fini();
         if (ret != 0) {
@@ -698,6 +822,9 @@ pqos_fini(void)
                 LOG_ERROR("machine_fini() error %d\n", ret);
         }
 
+        (void)trace_fini();
+        (void)_pqos_utils_fini();
+
         ret = log_fini();
         if (ret != PQOS_RETVAL_OK)
                 retval = ret;
@@ -709,6 +836,11 @@ pqos_fini(void)
         free((void *)m_cap);
         m_cap = NULL;
 
+        m_tech_discovered = 0;
+        m_alloc_init = 0;
+        m_mon_init = 0;
+        m_alloc_init_err = PQOS_RETVAL_OK;
+        m_mon_init_err = PQOS_RETVAL_OK;
         m_init_done = 0;
 
         _pqos_api_unlock();
@@ -745,6 +877,19 @@ pqos_cap_get(const struct pqos_cap **cap, const struct pqos_cpuinfo **cpu)
                 return ret;
         }
 
+        /* complete capability set, modules are still initialized on use */
+        if (cap != NULL && m_tech_discovered != PQOS_TECH_ALL) {
+                ret = discover_capabilities(PQOS_TECH_ALL & ~m_tech_discovered);
+                if (ret == PQOS_RETVAL_OK && m_cap->num_cap == 0) {
+                        LOG_ERROR("No Platform QoS capability discovered\n");
+                        ret = PQOS_RETVAL_ERROR;
+                }
+                if (ret != PQOS_RETVAL_OK) {
+                        _pqos_api_unlock();
+                        return ret;
+                }
+        }
+
         _pqos_cap_get(cap, cpu);
 
         _pqos_api_unlock();
@@ -45,6 +45,18 @@ extern "C" {
 
 #include "pqos.h"
 
+/**
+ * Technology masks for _pqos_cap_init()
+ */
+#define PQOS_TECH_MON   (1 << PQOS_CAP_TYPE_MON)
+#define PQOS_TECH_L3CA  (1 << PQOS_CAP_TYPE_L3CA)
+#define PQOS_TECH_L2CA  (1 << PQOS_CAP_TYPE_L2CA)
+#define PQOS_TECH_MBA   (1 << PQOS_CAP_TYPE_MBA)
+#define PQOS_TECH_ALLOC (PQOS_TECH_L3CA | PQOS_TECH_L2CA | PQOS_TECH_MBA)
+#define PQOS_TECH_ALL   (PQOS_TECH_MON | PQOS_TECH_ALLOC)
+/** allocation association change, may need to move monitoring groups */
+#define PQOS_TECH_ASSOC (1 << PQOS_CAP_TYPE_NUMOF)
+
 /**
  * @brief Modifies L3 CAT capability structure upon CDP config change
  *
@@ -99,6 +111,23 @@ void _pqos_api_unlock(void);
  */
 int _pqos_check_init(const int expect);
 
+/**
+ * @brief Discovers and initializes technologies on first use
+ *
+ * Capability discovery and allocation/monitoring module initialization
+ * are deferred from pqos_init() until a technology is first needed.
+ * Technologies already initialized are skipped, so this is cheap to
+ * call on every API entry. Must be called with the API lock held.
+ *
+ * @param [in] technology PQOS_TECH_* mask of required technologies
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success, also when technology is not present
+ * @retval other module initialization error, failed initialization is
+ *         not retried and its error is returned on each call
+ */
+int _pqos_cap_init(unsigned technology);
+
 /**
  * @brief Internal API to retrie PQoS capabilities data
  *
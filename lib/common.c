@@ -35,13 +35,59 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <libgen.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
 
 #include "pqos.h"
 #include "common.h"
 #include "log.h"
+#include "types.h"
+
+#ifdef __linux__
+#ifndef SYS_openat2
+#define SYS_openat2 437
+#endif
+#ifndef RESOLVE_NO_SYMLINKS
+#define RESOLVE_NO_SYMLINKS 0x04
+#endif
+#ifndef RESOLVE_BENEATH
+#define RESOLVE_BENEATH 0x08
+#endif
+
+/**
+ * openat2() how argument, see linux/openat2.h
+ */
+struct pqos_open_how {
+        uint64_t flags;
+        uint64_t mode;
+        uint64_t resolve;
+};
+
+/**
+ * Root directories opened once and used as a base for openat2() lookups.
+ * Lookups from a directory fd cross mount points, so resctrl may be
+ * mounted and unmounted below a cached /sys.
+ */
+static struct {
+        const char *prefix; /**< root path with trailing slash */
+        size_t len;         /**< length of the prefix */
+        int fd;             /**< cached directory fd, -1 if not open yet */
+} m_roots[] = {
+    {"/sys/", 5, -1},
+    {"/proc/", 6, -1},
+    {"/", 1, -1},
+};
+
+/**
+ * Set when kernel does not implement openat2() and O_NOFOLLOW walk is used
+ */
+static int m_openat2_unsupported = 0;
+#endif /* __linux__ */
 
 /**
  * @brief Checks if a path to a file contains any symbolic links.
@@ -86,14 +132,146 @@ check_symlink(const char *name)
         return PQOS_RETVAL_OK;
 }
 
+#ifdef __linux__
+/**
+ * @brief Converts fopen() mode to open() flags
+ *
+ * @param [in] mode file access mode
+ *
+ * @return open() flags
+ */
+static int
+mode_to_flags(const char *mode)
+{
+        int flags;
+
+        switch (mode[0]) {
+        /* no O_CREAT, like check_symlink() nonexistent paths are refused */
+        case 'w':
+                flags = O_WRONLY | O_TRUNC;
+                break;
+        case 'a':
+                flags = O_WRONLY | O_APPEND;
+                break;
+        default:
+                flags = O_RDONLY;
+                break;
+        }
+
+        if (strchr(mode, '+') != NULL)
+                flags = (flags & ~(O_RDONLY | O_WRONLY)) | O_RDWR;
+
+        return flags | O_CLOEXEC;
+}
+
+/**
+ * @brief Opens a file with openat2() refusing any symbolic link in the path
+ *
+ * Absolute paths are resolved beneath a cached root directory fd, so
+ * opening a file costs a single syscall.
+ *
+ * @param [in] name a path to a file
+ * @param [in] flags open() flags
+ *
+ * @return file descriptor
+ * @retval -1 on error, errno is set to ENOSYS if openat2() is not supported
+ * and to EPERM if it is blocked e.g. by seccomp filter
+ */
+static int
+open_no_symlinks(const char *name, const int flags)
+{
+        struct pqos_open_how how;
+        const char *path = name;
+        int dirfd = AT_FDCWD;
+        unsigned i;
+
+        memset(&how, 0, sizeof(how));
+        how.flags = (uint64_t)flags;
+        how.resolve = RESOLVE_NO_SYMLINKS | RESOLVE_BENEATH;
+
+        if (name[0] == '/') {
+                for (i = 0; i < DIM(m_roots); i++)
+                        if (strncmp(name, m_roots[i].prefix, m_roots[i].len) ==
+                            0)
+                                break;
+
+                /* "/" entry matches any absolute path */
+                if (m_roots[i].fd < 0) {
+                        struct pqos_open_how root_how;
+                        int fd;
+
+                        memset(&root_how, 0, sizeof(root_how));
+                        root_how.flags = O_PATH | O_DIRECTORY | O_CLOEXEC;
+                        root_how.resolve = RESOLVE_NO_SYMLINKS;
+                        fd = (int)syscall(SYS_openat2, AT_FDCWD,
+                                          m_roots[i].prefix, &root_how,
+                                          sizeof(root_how));
+                        if (fd < 0)
+                                return -1;
+                        if (!__sync_bool_compare_and_swap(&m_roots[i].fd, -1,
+                                                          fd))
+                                close(fd);
+                }
+                dirfd = m_roots[i].fd;
+                path = name + m_roots[i].len;
+                if (*path == '\0')
+                        path = ".";
+        }
+
+        return (int)syscall(SYS_openat2, dirfd, path, &how, sizeof(how));
+}
+#endif /* __linux__ */
+
 FILE *
 fopen_check_symlink(const char *name, const char *mode)
 {
         int ret;
+#ifdef __linux__
+        FILE *fp;
+        int fd;
 
+        if (!m_openat2_unsupported) {
+                fd = open_no_symlinks(name, mode_to_flags(mode));
+                if (fd < 0 && errno == ENOSYS) {
+                        LOG_DEBUG("openat2() not available, "
+                                  "using O_NOFOLLOW path walk\n");
+                        m_openat2_unsupported = 1;
+                } else if (fd < 0 && errno == EPERM) {
+                        /* seccomp filter may block some calls only */
+                        LOG_DEBUG("openat2() not permitted for %s, "
+                                  "using O_NOFOLLOW path walk\n",
+                                  name);
+                } else if (fd < 0) {
+                        if (errno == ELOOP)
+                                LOG_ERROR("Path %s contains a symlink\n",
+                                          name);
+                        return NULL;
+                } else {
+                        fp = fdopen(fd, mode);
+                        if (fp == NULL)
+                                close(fd);
+                        return fp;
+                }
+        }
+#endif
         ret = check_symlink(name);
         if (ret != PQOS_RETVAL_OK)
                 return NULL;
 
         return fopen(name, mode);
 }
+
+void
+fopen_check_symlink_fini(void)
+{
+#ifdef __linux__
+        unsigned i;
+
+        for (i = 0; i < DIM(m_roots); i++) {
+                const int fd = __sync_lock_test_and_set(&m_roots[i].fd, -1);
+
+                if (fd >= 0)
+                        close(fd);
+        }
+#endif
+}
@@ -49,6 +49,10 @@ extern "C" {
  * @brief Wrapper around fopen() that additionally checks if a given path
  * contains any symbolic links and fails if it does.
  *
+ * On Linux the path is resolved with openat2() and RESOLVE_NO_SYMLINKS
+ * in a single syscall. Kernels without openat2() fall back to checking
+ * each path component with O_NOFOLLOW.
+ *
  * @param [in] name a path to a file
  * @param [in] mode a file access mode
  *
@@ -60,6 +64,11 @@ extern "C" {
 FILE * fopen_check_symlink(const char *name, const char *mode);
 /* clang-format on */
 
+/**
+ * @brief Closes directories cached by fopen_check_symlink()
+ */
+void fopen_check_symlink_fini(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -76,6 +76,16 @@ extern "C" {
 #define PQOS_MSR_L2_QOS_CFG        0xC82 /**< L2 CAT config register */
 #define PQOS_MSR_L2_QOS_CFG_CDP_EN 1ULL  /**< L2 CDP enable bit */
 
+/**
+ * Hardware prefetcher control MSR register
+ * - bit 0 L2 hardware prefetcher disable
+ * - bit 1 L2 adjacent cache line prefetcher disable
+ * - bit 2 DCU next line prefetcher disable
+ * - bit 3 DCU IP prefetcher disable
+ */
+#define PQOS_MSR_MISC_FEATURE_CONTROL      0x1A4
+#define PQOS_MSR_MISC_FEATURE_CONTROL_MASK 0xFULL
+
 /**
  * MBA linear max value
  */
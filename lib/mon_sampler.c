@@ -0,0 +1,385 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * @brief Adaptive sampling of monitoring groups.
+ *
+ * Each group has its own sampling interval. The interval shrinks when
+ * variance of the group's memory bandwidth or LLC occupancy rises or when
+ * a threshold is approached, and stretches when the group is stable.
+ * Intervals are kept within configured bounds and are scaled together so
+ * that total number of group reads per second stays within the budget.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "pqos.h"
+#include "types.h"
+#include "log.h"
+#include "monitoring.h"
+
+/**
+ * Weight of the newest sample in moving average and variance
+ */
+#define SAMPLER_ALPHA 0.25
+/**
+ * Squared coefficient of variation above which the interval shrinks
+ */
+#define SAMPLER_CV2_HIGH (0.25 * 0.25)
+/**
+ * Squared coefficient of variation below which the interval stretches
+ */
+#define SAMPLER_CV2_LOW (0.05 * 0.05)
+/**
+ * Fraction of the threshold considered as approaching it
+ */
+#define SAMPLER_THRESHOLD_NEAR 0.9
+
+/**
+ * Moving statistics of a single signal
+ */
+struct sampler_stat {
+        double mean;
+        double var;
+};
+
+/**
+ * Sampling state of a single monitoring group
+ */
+struct sampler_group {
+        struct pqos_mon_data *group;
+        unsigned interval;    /**< adapted interval [us] */
+        uint64_t next;        /**< time of the next read [ns] */
+        int num_reads;        /**< number of reads so far, saturated */
+        struct sampler_stat mbm;
+        struct sampler_stat llc;
+};
+
+struct pqos_mon_sampler {
+        struct pqos_mon_sampler_config cfg;
+        unsigned num_groups;
+        struct sampler_group *groups;
+        struct pqos_mon_data **due; /**< groups to be read in one poll */
+        int over_budget; /**< budget exceeded due to max interval limit */
+};
+
+/**
+ * @brief Updates moving statistics with new sample
+ *
+ * @param [in,out] stat signal statistics
+ * @param [in] value new sample
+ * @param [in] first non-zero if this is the first sample
+ */
+static void
+sampler_stat_update(struct sampler_stat *stat,
+                    const double value,
+                    const int first)
+{
+        double diff;
+
+        if (first) {
+                stat->mean = value;
+                stat->var = 0;
+                return;
+        }
+
+        diff = value - stat->mean;
+        stat->mean += SAMPLER_ALPHA * diff;
+        stat->var = (1 - SAMPLER_ALPHA) * (stat->var +
+                                           SAMPLER_ALPHA * diff * diff);
+}
+
+/**
+ * @brief Checks if signal is volatile
+ *
+ * @param [in] stat signal statistics
+ *
+ * @return 1 if variance is high compared to mean, 0 otherwise
+ */
+static int
+sampler_stat_volatile(const struct sampler_stat *stat)
+{
+        return stat->var > SAMPLER_CV2_HIGH * stat->mean * stat->mean;
+}
+
+/**
+ * @brief Checks if signal is stable
+ *
+ * @param [in] stat signal statistics
+ *
+ * @return 1 if variance is low compared to mean, 0 otherwise
+ */
+static int
+sampler_stat_stable(const struct sampler_stat *stat)
+{
+        return stat->var <= SAMPLER_CV2_LOW * stat->mean * stat->mean;
+}
+
+/**
+ * @brief Adapts sampling interval of the group after a read
+ *
+ * @param [in] cfg sampler configuration
+ * @param [in,out] sg group sampling state
+ */
+static void
+sampler_group_adapt(const struct pqos_mon_sampler_config *cfg,
+                    struct sampler_group *sg)
+{
+        const struct pqos_mon_data *group = sg->group;
+        const int has_mbm = (group->event & (PQOS_MON_EVENT_LMEM_BW |
+                                             PQOS_MON_EVENT_TMEM_BW |
+                                             PQOS_MON_EVENT_RMEM_BW)) != 0;
+        const int has_llc = (group->event & PQOS_MON_EVENT_L3_OCCUP) != 0;
+        const double llc = (double)group->values.llc;
+        double mbm = group->mbm_total_rate;
+        int near = 0;
+        int volatile_signal = 0;
+        int stable = 1;
+
+        if (!(group->event & (PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW)))
+                mbm = group->mbm_local_rate;
+
+        if (sg->num_reads < 2)
+                sg->num_reads++;
+
+        /* first read gives no rates */
+        if (has_mbm && sg->num_reads > 1) {
+                sampler_stat_update(&sg->mbm, mbm, sg->num_reads == 2);
+                volatile_signal |= sampler_stat_volatile(&sg->mbm);
+                stable &= sampler_stat_stable(&sg->mbm);
+                if (cfg->mbm_threshold > 0 &&
+                    mbm >= SAMPLER_THRESHOLD_NEAR * cfg->mbm_threshold)
+                        near = 1;
+        }
+        if (has_llc) {
+                sampler_stat_update(&sg->llc, llc, sg->num_reads == 1);
+                volatile_signal |= sampler_stat_volatile(&sg->llc);
+                stable &= sampler_stat_stable(&sg->llc);
+                if (cfg->llc_threshold > 0 &&
+                    llc >= SAMPLER_THRESHOLD_NEAR * cfg->llc_threshold)
+                        near = 1;
+        }
+
+        if (near)
+                sg->interval = cfg->min_interval;
+        else if (volatile_signal)
+                sg->interval /= 2;
+        else if (stable) {
+                const unsigned step = (sg->interval > 1) ? sg->interval / 2 : 1;
+
+                /* stop at max_interval, do not wrap around */
+                if (sg->interval < cfg->max_interval - step)
+                        sg->interval += step;
+                else
+                        sg->interval = cfg->max_interval;
+        }
+
+        if (sg->interval < cfg->min_interval)
+                sg->interval = cfg->min_interval;
+        if (sg->interval > cfg->max_interval)
+                sg->interval = cfg->max_interval;
+}
+
+/**
+ * @brief Computes interval scaling needed to keep the read budget
+ *
+ * @param [in] sampler sampler
+ *
+ * @return Factor to multiply group intervals with, at least 1
+ */
+static double
+sampler_budget_scale(const struct pqos_mon_sampler *sampler)
+{
+        double reads = 0;
+        unsigned i;
+
+        if (sampler->cfg.read_budget == 0)
+                return 1;
+
+        for (i = 0; i < sampler->num_groups; i++)
+                reads += 1000000.0 / (double)sampler->groups[i].interval;
+
+        if (reads <= (double)sampler->cfg.read_budget)
+                return 1;
+
+        return reads / (double)sampler->cfg.read_budget;
+}
+
+int
+pqos_mon_sampler_create(const struct pqos_mon_sampler_config *cfg,
+                        struct pqos_mon_data **groups,
+                        const unsigned num_groups,
+                        struct pqos_mon_sampler **sampler)
+{
+        struct pqos_mon_sampler *s;
+        unsigned i;
+
+        if (cfg == NULL || groups == NULL || num_groups == 0 ||
+            sampler == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        if (cfg->min_interval == 0 || cfg->min_interval > cfg->max_interval)
+                return PQOS_RETVAL_PARAM;
+
+        for (i = 0; i < num_groups; i++)
+                if (groups[i] == NULL)
+                        return PQOS_RETVAL_PARAM;
+
+        s = calloc(1, sizeof(*s));
+        if (s == NULL)
+                return PQOS_RETVAL_RESOURCE;
+
+        s->groups = calloc(num_groups, sizeof(s->groups[0]));
+        s->due = calloc(num_groups, sizeof(s->due[0]));
+        if (s->groups == NULL || s->due == NULL) {
+                free(s->groups);
+                free(s->due);
+                free(s);
+                return PQOS_RETVAL_RESOURCE;
+        }
+
+        s->cfg = *cfg;
+        s->num_groups = num_groups;
+        for (i = 0; i < num_groups; i++) {
+                s->groups[i].group = groups[i];
+                s->groups[i].interval = cfg->min_interval;
+        }
+
+        *sampler = s;
+
+        return PQOS_RETVAL_OK;
+}
+
+int
+pqos_mon_sampler_poll(struct pqos_mon_sampler *sampler,
+                      unsigned *num_polled,
+                      unsigned *next_poll)
+{
+        uint64_t now;
+        uint64_t next = UINT64_MAX;
+        unsigned num_due = 0;
+        double scale;
+        unsigned i;
+        int clamped = 0;
+        int ret = PQOS_RETVAL_OK;
+
+        if (sampler == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        now = mon_timestamp();
+
+        for (i = 0; i < sampler->num_groups; i++)
+                if (sampler->groups[i].next <= now)
+                        sampler->due[num_due++] = sampler->groups[i].group;
+
+        if (num_due > 0) {
+                ret = pqos_mon_poll_snapshot(sampler->due, num_due, NULL);
+                if (ret != PQOS_RETVAL_OK)
+                        return ret;
+
+                for (i = 0; i < sampler->num_groups; i++)
+                        if (sampler->groups[i].next <= now)
+                                sampler_group_adapt(&sampler->cfg,
+                                                    &sampler->groups[i]);
+        }
+
+        /**
+         * Schedule due groups with intervals scaled down to the budget
+         */
+        scale = sampler_budget_scale(sampler);
+        for (i = 0; i < sampler->num_groups; i++) {
+                struct sampler_group *sg = &sampler->groups[i];
+                double interval = (double)sg->interval * scale;
+
+                if (interval > (double)sampler->cfg.max_interval) {
+                        interval = (double)sampler->cfg.max_interval;
+                        clamped = 1;
+                }
+                if (sg->next <= now)
+                        sg->next = now + (uint64_t)(interval * 1000.0);
+                if (sg->next < next)
+                        next = sg->next;
+        }
+
+        /**
+         * Intervals of the whole round limited to max_interval read more
+         * often than the budget allows, report it once until the budget
+         * is met again
+         */
+        if (clamped && !sampler->over_budget)
+                LOG_WARN("Sampler read budget of %u reads/s exceeded, "
+                         "intervals limited to %u us\n",
+                         sampler->cfg.read_budget, sampler->cfg.max_interval);
+        sampler->over_budget = clamped;
+
+        if (num_polled != NULL)
+                *num_polled = num_due;
+        if (next_poll != NULL)
+                *next_poll = (unsigned)((next - now) / 1000);
+
+        return ret;
+}
+
+int
+pqos_mon_sampler_get_interval(const struct pqos_mon_sampler *sampler,
+                              const struct pqos_mon_data *group,
+                              unsigned *interval)
+{
+        unsigned i;
+
+        if (sampler == NULL || group == NULL || interval == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        for (i = 0; i < sampler->num_groups; i++)
+                if (sampler->groups[i].group == group) {
+                        *interval = sampler->groups[i].interval;
+                        return PQOS_RETVAL_OK;
+                }
+
+        return PQOS_RETVAL_PARAM;
+}
+
+int
+pqos_mon_sampler_destroy(struct pqos_mon_sampler *sampler)
+{
+        if (sampler == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        free(sampler->groups);
+        free(sampler->due);
+        free(sampler);
+
+        return PQOS_RETVAL_OK;
+}
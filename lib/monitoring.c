@@ -40,11 +40,18 @@
 
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
 #include <pthread.h>
 #include <dirent.h>
+#include <limits.h>
+#include <time.h>
+#ifdef __linux__
+#include <sched.h> /* sched affinity */
+#endif
 
 #include "pqos.h"
 #include "cap.h"
+#include "common.h"
 #include "monitoring.h"
 #include "os_monitoring.h"
 
@@ -73,12 +80,31 @@
  */
 #define MBM_MAX_VALUE (1 << 24)
 
+/**
+ * Alignment of tables carved out of the group set memory block
+ */
+#define MON_SET_ALIGN 64
+
+/**
+ * Environment variable with cores used to read RMID counters
+ */
+#define MON_READ_CORES_ENV "RDT_MON_READ_CORES"
+
 /**
  * ---------------------------------------
  * Local data types
  * ---------------------------------------
  */
 
+/**
+ * Scale factors of RMID based events, retrieved once per poll
+ */
+struct mon_scale {
+        uint64_t llc;       /**< LLC occupancy scale factor */
+        uint64_t mbm_local; /**< local MBM scale factor */
+        uint64_t mbm_total; /**< total MBM scale factor */
+};
+
 /**
  * ---------------------------------------
  * Local data structures
@@ -97,6 +123,11 @@ static struct pqos_rmid_config rmid_cfg = {PQOS_RMID_TYPE_DEFAULT,
 #ifdef __linux__
 static int m_interface = PQOS_INTER_MSR;
 #endif
+static unsigned *m_reader = NULL;  /**< core to read RMID counters on,
+                                      indexed by logical core id */
+static unsigned m_reader_num = 0;  /**< number of entries in m_reader */
+static uint64_t m_reads_moved = 0; /**< RMID reads done on a housekeeping
+                                      core instead of the monitored one */
 /**
  * ---------------------------------------
  * Local Functions
@@ -112,15 +143,13 @@ static int mon_read(const unsigned lcore,
                     const enum pqos_mon_event event,
                     uint64_t *value);
 
-static int pqos_core_poll(struct pqos_mon_data *group);
+static int pqos_core_poll(struct pqos_mon_data *group,
+                          const struct mon_scale *scale);
 
 static unsigned get_event_id(const enum pqos_mon_event event);
 
 static uint64_t get_delta(const uint64_t old_value, const uint64_t new_value);
 
-static uint64_t scale_event(const enum pqos_mon_event event,
-                            const uint64_t val);
-
 /*
  * =======================================
  * =======================================
@@ -131,6 +160,213 @@ static uint64_t scale_event(const enum pqos_mon_event event,
  * =======================================
  */
 
+/**
+ * @brief Marks cores from a cpu list string (e.g. "0-3,8") in \a set
+ *
+ * @param [in] str cpu list string
+ * @param [out] set table of flags indexed by core id
+ * @param [in] size number of entries in \a set
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+mon_cpulist_parse(const char *str, char *set, const unsigned size)
+{
+        while (*str != '\0' && *str != '\n') {
+                unsigned long first, last;
+                char *end;
+
+                first = strtoul(str, &end, 10);
+                if (end == str)
+                        return PQOS_RETVAL_PARAM;
+                last = first;
+                if (*end == '-') {
+                        str = end + 1;
+                        last = strtoul(str, &end, 10);
+                        if (end == str || last < first)
+                                return PQOS_RETVAL_PARAM;
+                }
+                for (; first <= last && first < size; first++)
+                        set[first] = 1;
+
+                str = end;
+                if (*str == ',')
+                        str++;
+        }
+
+        return PQOS_RETVAL_OK;
+}
+
+#ifdef __linux__
+/**
+ * @brief Marks cores isolated from the scheduler or running tickless
+ *
+ * @param [out] set table of flags indexed by core id
+ * @param [in] size number of entries in \a set
+ */
+static void
+mon_isolated_get(char *set, const unsigned size)
+{
+        static const char *const files[] = {
+            "/sys/devices/system/cpu/isolated",
+            "/sys/devices/system/cpu/nohz_full"};
+        unsigned i;
+
+        for (i = 0; i < DIM(files); i++) {
+                char buf[4096];
+                FILE *fd = fopen_check_symlink(files[i], "r");
+
+                if (fd == NULL)
+                        continue;
+                if (fgets(buf, sizeof(buf), fd) != NULL &&
+                    mon_cpulist_parse(buf, set, size) != PQOS_RETVAL_OK)
+                        LOG_WARN("Failed to parse %s\n", files[i]);
+                fclose(fd);
+        }
+}
+#endif
+
+/**
+ * @brief Selects a housekeeping core per L3 cluster to read RMID counters on
+ *
+ * IA32_QM_CTR returns data of the whole L3 cluster, so RMID counters can be
+ * read from any core sharing the cache. Reading through the msr driver
+ * sends an IPI to the target core, selecting a core that is not isolated
+ * keeps these interrupts away from the monitored workload.
+ *
+ * Cores listed in RDT_MON_READ_CORES take precedence. "none" keeps reads
+ * on the monitored cores.
+ *
+ * @param [in] cpu cpu topology structure
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+mon_reader_init(const struct pqos_cpuinfo *cpu)
+{
+        const char *env = getenv(MON_READ_CORES_ENV);
+        char *isolated = NULL;
+        char *selected = NULL;
+        char *allowed = NULL;
+        unsigned i, j;
+        int ret = PQOS_RETVAL_OK;
+
+        m_reader_num = 0;
+        for (i = 0; i < cpu->num_cores; i++)
+                if (cpu->cores[i].lcore >= m_reader_num)
+                        m_reader_num = cpu->cores[i].lcore + 1;
+
+        m_reader = (unsigned *)malloc(sizeof(m_reader[0]) * m_reader_num);
+        isolated = (char *)calloc(m_reader_num, sizeof(isolated[0]));
+        selected = (char *)calloc(m_reader_num, sizeof(selected[0]));
+        allowed = (char *)calloc(m_reader_num, sizeof(allowed[0]));
+        if (m_reader == NULL || isolated == NULL || selected == NULL ||
+            allowed == NULL) {
+                ret = PQOS_RETVAL_RESOURCE;
+                goto mon_reader_init_exit;
+        }
+
+        for (i = 0; i < m_reader_num; i++)
+                m_reader[i] = i;
+
+        if (env != NULL && strcasecmp(env, "none") == 0) {
+                LOG_INFO("RMID counters read on monitored cores\n");
+                goto mon_reader_init_exit;
+        }
+
+        if (env != NULL &&
+            mon_cpulist_parse(env, selected, m_reader_num) != PQOS_RETVAL_OK) {
+                LOG_ERROR("Invalid %s value\n", MON_READ_CORES_ENV);
+                ret = PQOS_RETVAL_PARAM;
+                goto mon_reader_init_exit;
+        }
+
+#ifdef __linux__
+        {
+                cpu_set_t mask;
+
+                mon_isolated_get(isolated, m_reader_num);
+                CPU_ZERO(&mask);
+                if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+                        for (i = 0; i < m_reader_num; i++)
+                                allowed[i] = CPU_ISSET(i, &mask) ? 1 : 0;
+        }
+#endif
+
+        for (i = 0; i < cpu->num_cores; i++) {
+                const unsigned cluster = cpu->cores[i].l3_id;
+                unsigned reader = UINT_MAX;
+                int rank = 0;
+
+                /**
+                 * Find the best core in the cluster, in order of preference:
+                 * - selected by the user
+                 * - not isolated and in the affinity mask of this process,
+                 *   reading from the current core needs no IPI at all
+                 * - not isolated
+                 */
+                for (j = 0; j < cpu->num_cores; j++) {
+                        const unsigned lcore = cpu->cores[j].lcore;
+                        int r = 0;
+
+                        if (cpu->cores[j].l3_id != cluster)
+                                continue;
+                        if (selected[lcore])
+                                r = 3;
+                        else if (!isolated[lcore] && allowed[lcore])
+                                r = 2;
+                        else if (!isolated[lcore])
+                                r = 1;
+                        if (r > rank) {
+                                rank = r;
+                                reader = lcore;
+                        }
+                }
+
+                if (reader != UINT_MAX)
+                        m_reader[cpu->cores[i].lcore] = reader;
+        }
+
+        for (i = 0; i < cpu->num_cores; i++)
+                if (cpu->cores[i].lcore == m_reader[cpu->cores[i].lcore])
+                        LOG_INFO("Reading RMID counters of L3 cluster %u "
+                                 "on core %u\n",
+                                 cpu->cores[i].l3_id, cpu->cores[i].lcore);
+
+mon_reader_init_exit:
+        if (ret != PQOS_RETVAL_OK) {
+                free(m_reader);
+                m_reader = NULL;
+                m_reader_num = 0;
+        }
+        free(isolated);
+        free(selected);
+        free(allowed);
+
+        return ret;
+}
+
+/**
+ * @brief Releases housekeeping core table and reports avoided IPIs
+ */
+static void
+mon_reader_fini(void)
+{
+        if (m_reads_moved > 0)
+                LOG_INFO("%llu RMID counter reads done on housekeeping "
+                         "cores, avoided at least %llu IPIs on monitored "
+                         "cores\n",
+                         (unsigned long long)m_reads_moved,
+                         (unsigned long long)m_reads_moved * 2);
+
+        free(m_reader);
+        m_reader = NULL;
+        m_reader_num = 0;
+        m_reads_moved = 0;
+}
+
 int
 pqos_mon_init(const struct pqos_cpuinfo *cpu,
               const struct pqos_cap *cap,
@@ -197,6 +433,12 @@ pqos_mon_init_exit:
 #else
         UNUSED_PARAM(cfg);
 #endif
+        if (ret == PQOS_RETVAL_OK && cfg->interface == PQOS_INTER_MSR) {
+                ret = mon_reader_init(cpu);
+                if (ret != PQOS_RETVAL_OK)
+                        pqos_mon_fini();
+        }
+
         return ret;
 }
 
@@ -206,6 +448,7 @@ pqos_mon_fini(void)
         int ret = PQOS_RETVAL_OK;
 
         m_rmid_max = 0;
+        mon_reader_fini();
 #ifdef __linux__
         if (m_interface == PQOS_INTER_OS ||
             m_interface == PQOS_INTER_OS_RESCTRL_MON)
@@ -412,34 +655,6 @@ rmid_alloc_custom(struct pqos_mon_poll_ctx *ctx,
  * =======================================
  */
 
-/**
- * @brief Scale event values to bytes
- *
- * Retrieve event scale factor and scale value to bytes
- *
- * @param event event scale factor to retrieve
- * @param val value to be scaled
- *
- * @return scaled value
- * @retval value in bytes
- */
-static uint64_t
-scale_event(const enum pqos_mon_event event, const uint64_t val)
-{
-        const struct pqos_cap *cap;
-        const struct pqos_monitor *pmon;
-        int ret;
-
-        _pqos_cap_get(&cap, NULL);
-
-        ret = pqos_cap_get_event(cap, event, &pmon);
-        ASSERT(ret == PQOS_RETVAL_OK);
-        if (ret != PQOS_RETVAL_OK)
-                return val;
-        else
-                return val * pmon->scale_factor;
-}
-
 /**
  * @brief Associates core with RMID at register level
  *
@@ -627,79 +842,115 @@ mon_read(const unsigned lcore,
 }
 
 /**
- * @brief Reads monitoring event data from given core
+ * @brief Retrieves scale factors of RMID based events
  *
- * @param p pointer to monitoring structure
+ * @param [out] scale place to store scale factors
+ */
+static void
+mon_scale_get(struct mon_scale *scale)
+{
+        const struct pqos_cap *cap;
+        const struct pqos_monitor *pmon;
+
+        _pqos_cap_get(&cap, NULL);
+
+        scale->llc = 1;
+        scale->mbm_local = 1;
+        scale->mbm_total = 1;
+
+        if (pqos_cap_get_event(cap, PQOS_MON_EVENT_L3_OCCUP, &pmon) ==
+            PQOS_RETVAL_OK)
+                scale->llc = pmon->scale_factor;
+        if (pqos_cap_get_event(cap, PQOS_MON_EVENT_LMEM_BW, &pmon) ==
+            PQOS_RETVAL_OK)
+                scale->mbm_local = pmon->scale_factor;
+        if (pqos_cap_get_event(cap, PQOS_MON_EVENT_TMEM_BW, &pmon) ==
+            PQOS_RETVAL_OK)
+                scale->mbm_total = pmon->scale_factor;
+}
+
+/**
+ * @brief Reads RMID events of one poll context and adds them to \a acc
+ *
+ * Counters are read on the housekeeping core of the \a lcore L3 cluster.
+ *
+ * @param [in] lcore monitored logical core id
+ * @param [in] rmid RMID to be read
+ * @param [in,out] acc accumulators, acc->event selects events to read
  *
  * @return Operation status
  * @retval PQOS_RETVAL_OK on success
  */
 static int
-pqos_core_poll(struct pqos_mon_data *p)
+mon_read_ctx(unsigned lcore,
+             const pqos_rmid_t rmid,
+             struct pqos_mon_set_hot *acc)
 {
-        struct pqos_event_values *pv = &p->values;
-        int retval = PQOS_RETVAL_OK;
-        unsigned i;
+        uint64_t tmp = 0;
+        int ret;
 
-        if (p->event & PQOS_MON_EVENT_L3_OCCUP) {
-                uint64_t total = 0;
+        const int moved = lcore < m_reader_num && m_reader[lcore] != lcore;
 
-                for (i = 0; i < p->num_poll_ctx; i++) {
-                        uint64_t tmp = 0;
-                        int ret;
+        if (moved)
+                lcore = m_reader[lcore];
 
-                        ret = mon_read(
-                            p->poll_ctx[i].lcore, p->poll_ctx[i].rmid,
-                            get_event_id(PQOS_MON_EVENT_L3_OCCUP), &tmp);
-                        if (ret != PQOS_RETVAL_OK) {
-                                retval = PQOS_RETVAL_ERROR;
-                                goto pqos_core_poll__exit;
-                        }
-                        total += tmp;
-                }
-                pv->llc = scale_event(PQOS_MON_EVENT_L3_OCCUP, total);
+        if (acc->event & PQOS_MON_EVENT_L3_OCCUP) {
+                ret = mon_read(lcore, rmid,
+                               get_event_id(PQOS_MON_EVENT_L3_OCCUP), &tmp);
+                if (ret != PQOS_RETVAL_OK)
+                        return PQOS_RETVAL_ERROR;
+                acc->llc += tmp;
+                m_reads_moved += moved;
+        }
+        if (acc->event & (PQOS_MON_EVENT_LMEM_BW | PQOS_MON_EVENT_RMEM_BW)) {
+                ret = mon_read(lcore, rmid,
+                               get_event_id(PQOS_MON_EVENT_LMEM_BW), &tmp);
+                if (ret != PQOS_RETVAL_OK)
+                        return PQOS_RETVAL_ERROR;
+                acc->mbm_local += tmp;
+                m_reads_moved += moved;
+        }
+        if (acc->event & (PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW)) {
+                ret = mon_read(lcore, rmid,
+                               get_event_id(PQOS_MON_EVENT_TMEM_BW), &tmp);
+                if (ret != PQOS_RETVAL_OK)
+                        return PQOS_RETVAL_ERROR;
+                acc->mbm_total += tmp;
+                m_reads_moved += moved;
         }
-        if (p->event & (PQOS_MON_EVENT_LMEM_BW | PQOS_MON_EVENT_RMEM_BW)) {
-                uint64_t total = 0, old_value = pv->mbm_local;
 
-                for (i = 0; i < p->num_poll_ctx; i++) {
-                        uint64_t tmp = 0;
-                        int ret;
+        return PQOS_RETVAL_OK;
+}
 
-                        ret = mon_read(
-                            p->poll_ctx[i].lcore, p->poll_ctx[i].rmid,
-                            get_event_id(PQOS_MON_EVENT_LMEM_BW), &tmp);
-                        if (ret != PQOS_RETVAL_OK) {
-                                retval = PQOS_RETVAL_ERROR;
-                                goto pqos_core_poll__exit;
-                        }
-                        total += tmp;
-                }
-                pv->mbm_local = total;
-                pv->mbm_local_delta = get_delta(old_value, pv->mbm_local);
+/**
+ * @brief Updates group values with raw RMID event totals
+ *
+ * @param [in,out] p pointer to monitoring structure
+ * @param [in] scale event scale factors
+ * @param [in] acc raw event totals of the group
+ */
+static void
+mon_values_update(struct pqos_mon_data *p,
+                  const struct mon_scale *scale,
+                  const struct pqos_mon_set_hot *acc)
+{
+        struct pqos_event_values *pv = &p->values;
+
+        if (p->event & PQOS_MON_EVENT_L3_OCCUP)
+                pv->llc = acc->llc * scale->llc;
+        if (p->event & (PQOS_MON_EVENT_LMEM_BW | PQOS_MON_EVENT_RMEM_BW)) {
+                const uint64_t old_value = pv->mbm_local;
+
+                pv->mbm_local = acc->mbm_local;
                 pv->mbm_local_delta =
-                    scale_event(PQOS_MON_EVENT_LMEM_BW, pv->mbm_local_delta);
+                    get_delta(old_value, pv->mbm_local) * scale->mbm_local;
         }
         if (p->event & (PQOS_MON_EVENT_TMEM_BW | PQOS_MON_EVENT_RMEM_BW)) {
-                uint64_t total = 0, old_value = pv->mbm_total;
-
-                for (i = 0; i < p->num_poll_ctx; i++) {
-                        uint64_t tmp = 0;
-                        int ret;
+                const uint64_t old_value = pv->mbm_total;
 
-                        ret = mon_read(
-                            p->poll_ctx[i].lcore, p->poll_ctx[i].rmid,
-                            get_event_id(PQOS_MON_EVENT_TMEM_BW), &tmp);
-                        if (ret != PQOS_RETVAL_OK) {
-                                retval = PQOS_RETVAL_ERROR;
-                                goto pqos_core_poll__exit;
-                        }
-                        total += tmp;
-                }
-                pv->mbm_total = total;
-                pv->mbm_total_delta = get_delta(old_value, pv->mbm_total);
+                pv->mbm_total = acc->mbm_total;
                 pv->mbm_total_delta =
-                    scale_event(PQOS_MON_EVENT_TMEM_BW, pv->mbm_total_delta);
+                    get_delta(old_value, pv->mbm_total) * scale->mbm_total;
         }
         if (p->event & PQOS_MON_EVENT_RMEM_BW) {
                 pv->mbm_remote = 0;
@@ -710,74 +961,163 @@ pqos_core_poll(struct pqos_mon_data *p)
                         pv->mbm_remote_delta =
                             pv->mbm_total_delta - pv->mbm_local_delta;
         }
-        if (p->event & PQOS_PERF_EVENT_IPC) {
-                /**
-                 * If multiple cores monitored in one group
-                 * then we have to accumulate the values in the group.
-                 */
-                uint64_t unhalted = 0, retired = 0;
-                unsigned n;
+        if (!p->valid_mbm_read) {
+                /* Report zero memory bandwidth with first read */
+                pv->mbm_remote_delta = 0;
+                pv->mbm_local_delta = 0;
+                pv->mbm_total_delta = 0;
+                p->valid_mbm_read = 1;
+        }
+}
+
+/**
+ * Raw IA32 performance counter values of a group
+ */
+struct ia32_perf_raw {
+        uint64_t retired;  /**< instructions retired */
+        uint64_t unhalted; /**< unhalted cycles */
+        uint64_t missed;   /**< LLC misses */
+};
+
+/**
+ * @brief Reads IA32 performance counters for IPC and LLC miss events
+ *
+ * @param [in] num_cores number of cores in \a cores table
+ * @param [in] cores table with core id's
+ * @param [in] event mask of selected monitoring events
+ * @param [out] raw counter values accumulated over \a cores
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+ia32_perf_counter_read(const unsigned num_cores,
+                       const unsigned *cores,
+                       const enum pqos_mon_event event,
+                       struct ia32_perf_raw *raw)
+{
+        unsigned n;
+
+        memset(raw, 0, sizeof(*raw));
 
-                for (n = 0; n < p->num_cores; n++) {
+        /**
+         * If multiple cores monitored in one group
+         * then we have to accumulate the values in the group.
+         */
+        if (event & PQOS_PERF_EVENT_IPC)
+                for (n = 0; n < num_cores; n++) {
                         uint64_t tmp = 0;
-                        int ret = msr_read(p->cores[n],
-                                           IA32_MSR_INST_RETIRED_ANY, &tmp);
-                        if (ret != MACHINE_RETVAL_OK) {
-                                retval = PQOS_RETVAL_ERROR;
-                                goto pqos_core_poll__exit;
-                        }
-                        retired += tmp;
+                        int ret = msr_read(cores[n], IA32_MSR_INST_RETIRED_ANY,
+                                           &tmp);
+                        if (ret != MACHINE_RETVAL_OK)
+                                return PQOS_RETVAL_ERROR;
+                        raw->retired += tmp;
 
-                        ret = msr_read(p->cores[n],
-                                       IA32_MSR_CPU_UNHALTED_THREAD, &tmp);
-                        if (ret != MACHINE_RETVAL_OK) {
-                                retval = PQOS_RETVAL_ERROR;
-                                goto pqos_core_poll__exit;
-                        }
-                        unhalted += tmp;
+                        ret = msr_read(cores[n], IA32_MSR_CPU_UNHALTED_THREAD,
+                                       &tmp);
+                        if (ret != MACHINE_RETVAL_OK)
+                                return PQOS_RETVAL_ERROR;
+                        raw->unhalted += tmp;
+                }
+        if (event & PQOS_PERF_EVENT_LLC_MISS)
+                for (n = 0; n < num_cores; n++) {
+                        uint64_t tmp = 0;
+                        int ret = msr_read(cores[n], IA32_MSR_PMC0, &tmp);
+
+                        if (ret != MACHINE_RETVAL_OK)
+                                return PQOS_RETVAL_ERROR;
+                        raw->missed += tmp;
                 }
 
-                pv->ipc_unhalted_delta = unhalted - pv->ipc_unhalted;
-                pv->ipc_retired_delta = retired - pv->ipc_retired;
-                pv->ipc_unhalted = unhalted;
-                pv->ipc_retired = retired;
+        return PQOS_RETVAL_OK;
+}
+
+/**
+ * @brief Updates IPC and LLC miss values from raw counter values
+ *
+ * @param [in] event mask of selected monitoring events
+ * @param [in] raw counter values read by ia32_perf_counter_read()
+ * @param [in,out] pv event values to update
+ */
+static void
+ia32_perf_counter_update(const enum pqos_mon_event event,
+                         const struct ia32_perf_raw *raw,
+                         struct pqos_event_values *pv)
+{
+        if (event & PQOS_PERF_EVENT_IPC) {
+                pv->ipc_unhalted_delta = raw->unhalted - pv->ipc_unhalted;
+                pv->ipc_retired_delta = raw->retired - pv->ipc_retired;
+                pv->ipc_unhalted = raw->unhalted;
+                pv->ipc_retired = raw->retired;
                 if (pv->ipc_unhalted_delta == 0)
                         pv->ipc = 0.0;
                 else
                         pv->ipc = (double)pv->ipc_retired_delta /
                                   (double)pv->ipc_unhalted_delta;
         }
-        if (p->event & PQOS_PERF_EVENT_LLC_MISS) {
-                /**
-                 * If multiple cores monitored in one group
-                 * then we have to accumulate the values in the group.
-                 */
-                uint64_t missed = 0;
-                unsigned n;
+        if (event & PQOS_PERF_EVENT_LLC_MISS) {
+                pv->llc_misses_delta = raw->missed - pv->llc_misses;
+                pv->llc_misses = raw->missed;
+        }
+}
 
-                for (n = 0; n < p->num_cores; n++) {
-                        uint64_t tmp = 0;
-                        int ret = msr_read(p->cores[n], IA32_MSR_PMC0, &tmp);
+/**
+ * @brief Reads IA32 performance counters and updates IPC and LLC miss values
+ *
+ * @param [in] num_cores number of cores in \a cores table
+ * @param [in] cores table with core id's
+ * @param [in] event mask of selected monitoring events
+ * @param [in,out] pv event values to update
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+ia32_perf_counter_poll(const unsigned num_cores,
+                       const unsigned *cores,
+                       const enum pqos_mon_event event,
+                       struct pqos_event_values *pv)
+{
+        struct ia32_perf_raw raw;
+        int ret;
 
-                        if (ret != MACHINE_RETVAL_OK) {
-                                retval = PQOS_RETVAL_ERROR;
-                                goto pqos_core_poll__exit;
-                        }
-                        missed += tmp;
-                }
+        ret = ia32_perf_counter_read(num_cores, cores, event, &raw);
+        if (ret == PQOS_RETVAL_OK)
+                ia32_perf_counter_update(event, &raw, pv);
 
-                pv->llc_misses_delta = missed - pv->llc_misses;
-                pv->llc_misses = missed;
-        }
-        if (!p->valid_mbm_read) {
-                /* Report zero memory bandwidth with first read */
-                pv->mbm_remote_delta = 0;
-                pv->mbm_local_delta = 0;
-                pv->mbm_total_delta = 0;
-                p->valid_mbm_read = 1;
+        return ret;
+}
+
+/**
+ * @brief Reads monitoring event data from given core
+ *
+ * @param p pointer to monitoring structure
+ * @param scale event scale factors
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+pqos_core_poll(struct pqos_mon_data *p, const struct mon_scale *scale)
+{
+        struct pqos_mon_set_hot acc;
+        unsigned i;
+
+        memset(&acc, 0, sizeof(acc));
+        acc.event = p->event;
+
+        for (i = 0; i < p->num_poll_ctx; i++) {
+                int ret = mon_read_ctx(p->poll_ctx[i].lcore,
+                                       p->poll_ctx[i].rmid, &acc);
+
+                if (ret != PQOS_RETVAL_OK)
+                        return ret;
         }
-pqos_core_poll__exit:
-        return retval;
+
+        mon_values_update(p, scale, &acc);
+
+        return ia32_perf_counter_poll(p->num_cores, p->cores, p->event,
+                                      &p->values);
 }
 
 /**
@@ -914,38 +1254,28 @@ ia32_perf_counter_stop(const unsigned num_cores,
         return retval;
 }
 
-int
-hw_mon_start(const unsigned num_cores,
-             const unsigned *cores,
-             const enum pqos_mon_event event,
-             void *context,
-             struct pqos_mon_data *group)
-{
-        unsigned core2cluster[num_cores];
-        struct pqos_mon_poll_ctx ctxs[num_cores];
-        unsigned num_ctxs = 0;
-        unsigned i = 0;
-        int ret = PQOS_RETVAL_OK;
-        int retval = PQOS_RETVAL_OK;
+/**
+ * @brief Checks if all events of \a event are listed in capabilities
+ *
+ * @param [in] event combination of monitoring events
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK if all events are supported
+ * @retval PQOS_RETVAL_PARAM otherwise
+ */
+static int
+mon_event_check(const enum pqos_mon_event event)
+{
         const struct pqos_cap *cap;
-
-        ASSERT(group != NULL);
-        ASSERT(cores != NULL);
-        ASSERT(num_cores > 0);
-        ASSERT(event > 0);
-        ASSERT(m_cpu != NULL);
-
-        memset(ctxs, 0, sizeof(ctxs));
+        unsigned i;
 
         _pqos_cap_get(&cap, NULL);
 
-        /**
-         * Validate if event is listed in capabilities
-         */
         for (i = 0; i < (sizeof(event) * 8); i++) {
                 const enum pqos_mon_event evt_mask =
                     (enum pqos_mon_event)(1U << i);
                 const struct pqos_monitor *ptr = NULL;
+                int ret;
 
                 if (!(evt_mask & event))
                         continue;
@@ -955,6 +1285,56 @@ hw_mon_start(const unsigned num_cores,
                         return PQOS_RETVAL_PARAM;
         }
 
+        return PQOS_RETVAL_OK;
+}
+
+/**
+ * @brief Starts resource monitoring on selected group of cores
+ *
+ * Core list and poll context tables are provided by the caller.
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in] event combination of monitoring events
+ * @param [in] context a pointer for application's convenience
+ * @param [out] group monitoring structure to fill in
+ * @param [in] core2cluster scratch table of \a num_cores entries
+ * @param [in] core_buf core list table of \a num_cores entries
+ * @param [in] ctxs poll context table of \a num_cores entries
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+mon_start(const unsigned num_cores,
+          const unsigned *cores,
+          const enum pqos_mon_event event,
+          void *context,
+          struct pqos_mon_data *group,
+          unsigned *core2cluster,
+          unsigned *core_buf,
+          struct pqos_mon_poll_ctx *ctxs)
+{
+        unsigned num_ctxs = 0;
+        unsigned i = 0;
+        int ret = PQOS_RETVAL_OK;
+        int retval = PQOS_RETVAL_OK;
+
+        ASSERT(group != NULL);
+        ASSERT(cores != NULL);
+        ASSERT(num_cores > 0);
+        ASSERT(event > 0);
+        ASSERT(m_cpu != NULL);
+
+        memset(ctxs, 0, sizeof(ctxs[0]) * num_cores);
+
+        /**
+         * Validate if event is listed in capabilities
+         */
+        ret = mon_event_check(event);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
         /**
          * Check if all requested cores are valid
          * and not used by other monitoring processes.
@@ -1035,18 +1415,8 @@ hw_mon_start(const unsigned num_cores,
          * Fill in the monitoring group structure
          */
         memset(group, 0, sizeof(*group));
-        group->cores = (unsigned *)malloc(sizeof(group->cores[0]) * num_cores);
-        if (group->cores == NULL) {
-                retval = PQOS_RETVAL_RESOURCE;
-                goto pqos_mon_start_error1;
-        }
-
-        group->poll_ctx = (struct pqos_mon_poll_ctx *)malloc(
-            sizeof(group->poll_ctx[0]) * num_ctxs);
-        if (group->poll_ctx == NULL) {
-                retval = PQOS_RETVAL_RESOURCE;
-                goto pqos_mon_start_error2;
-        }
+        group->cores = core_buf;
+        group->poll_ctx = ctxs;
 
         ret = ia32_perf_counter_start(num_cores, cores, event);
         if (ret != PQOS_RETVAL_OK) {
@@ -1082,9 +1452,6 @@ hw_mon_start(const unsigned num_cores,
         }
 
         group->num_poll_ctx = num_ctxs;
-        for (i = 0; i < num_ctxs; i++)
-                group->poll_ctx[i] = ctxs[i];
-
         group->event = event;
         group->context = context;
 
@@ -1093,17 +1460,110 @@ pqos_mon_start_error2:
                 for (i = 0; i < num_cores; i++)
                         (void)mon_assoc_set(cores[i], RMID0);
 
-                if (group->poll_ctx != NULL)
-                        free(group->poll_ctx);
-
-                if (group->cores != NULL)
-                        free(group->cores);
+                memset(group, 0, sizeof(*group));
         }
 pqos_mon_start_error1:
 
         return retval;
 }
 
+int
+hw_mon_start(const unsigned num_cores,
+             const unsigned *cores,
+             const enum pqos_mon_event event,
+             void *context,
+             struct pqos_mon_data *group)
+{
+        unsigned *core2cluster = NULL;
+        unsigned *core_buf = NULL;
+        struct pqos_mon_poll_ctx *ctxs = NULL;
+        int ret;
+
+        ASSERT(group != NULL);
+        ASSERT(cores != NULL);
+        ASSERT(num_cores > 0);
+
+        core2cluster = (unsigned *)malloc(sizeof(core2cluster[0]) * num_cores);
+        core_buf = (unsigned *)malloc(sizeof(core_buf[0]) * num_cores);
+        ctxs = (struct pqos_mon_poll_ctx *)malloc(sizeof(ctxs[0]) * num_cores);
+        if (core2cluster == NULL || core_buf == NULL || ctxs == NULL) {
+                ret = PQOS_RETVAL_RESOURCE;
+                goto hw_mon_start_exit;
+        }
+
+        ret = mon_start(num_cores, cores, event, context, group, core2cluster,
+                        core_buf, ctxs);
+        if (ret == PQOS_RETVAL_OK) {
+                /* Shrink poll context table down to the number of clusters */
+                struct pqos_mon_poll_ctx *ptr =
+                    (struct pqos_mon_poll_ctx *)realloc(
+                        ctxs, sizeof(ctxs[0]) * group->num_poll_ctx);
+
+                if (ptr != NULL)
+                        group->poll_ctx = ptr;
+                core_buf = NULL;
+                ctxs = NULL;
+        }
+
+hw_mon_start_exit:
+        if (ctxs != NULL)
+                free(ctxs);
+        if (core_buf != NULL)
+                free(core_buf);
+        if (core2cluster != NULL)
+                free(core2cluster);
+
+        return ret;
+}
+
+int
+hw_mon_start_remainder(const unsigned cluster,
+                       const enum pqos_mon_event event,
+                       void *context,
+                       struct pqos_mon_data *group)
+{
+        unsigned *cores;
+        unsigned num_cores = 0;
+        int ret;
+
+        ASSERT(group != NULL);
+        ASSERT(m_cpu != NULL);
+
+        ret = mon_event_check(event);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        cores = pqos_cpu_get_cores_l3id(m_cpu, cluster, &num_cores);
+        if (cores == NULL || num_cores == 0) {
+                LOG_ERROR("Invalid cluster id %u\n", cluster);
+                if (cores != NULL)
+                        free(cores);
+                return PQOS_RETVAL_PARAM;
+        }
+
+        /**
+         * RMID0 of the cluster is read on any of the cluster cores
+         */
+        memset(group, 0, sizeof(*group));
+        group->poll_ctx = (struct pqos_mon_poll_ctx *)malloc(
+            sizeof(group->poll_ctx[0]));
+        if (group->poll_ctx == NULL) {
+                free(cores);
+                return PQOS_RETVAL_RESOURCE;
+        }
+        group->poll_ctx[0].lcore = cores[0];
+        group->poll_ctx[0].cluster = cluster;
+        group->poll_ctx[0].rmid = RMID0;
+        group->num_poll_ctx = 1;
+        group->event = event;
+        group->context = context;
+        group->remainder = 1;
+
+        free(cores);
+
+        return PQOS_RETVAL_OK;
+}
+
 int
 hw_mon_stop(struct pqos_mon_data *group)
 {
@@ -1113,6 +1573,13 @@ hw_mon_stop(struct pqos_mon_data *group)
 
         ASSERT(group != NULL);
 
+        if (group->remainder) {
+                /* Core associations with RMID0 are not owned by the group */
+                free(group->poll_ctx);
+                memset(group, 0, sizeof(*group));
+                return PQOS_RETVAL_OK;
+        }
+
         if (group->num_cores == 0 || group->cores == NULL ||
             group->num_poll_ctx == 0 || group->poll_ctx == NULL) {
                 return PQOS_RETVAL_PARAM;
@@ -1156,11 +1623,292 @@ hw_mon_stop(struct pqos_mon_data *group)
                 retval = PQOS_RETVAL_RESOURCE;
 
         /**
-         * Free poll contexts, core list and clear the group structure
+         * Free poll contexts, core list and clear the group structure.
+         * Tables of groups belonging to a group set are owned by the set.
          */
+        if (group->set == NULL) {
+                free(group->cores);
+                free(group->poll_ctx);
+        }
+        memset(group, 0, sizeof(*group));
+
+        return retval;
+}
+
+/**
+ * @brief Checks if \a lcore is on the \a cores list
+ *
+ * @param [in] lcore logical core id
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ *
+ * @retval 1 if found
+ * @retval 0 if not found
+ */
+static int
+mon_core_on_list(const unsigned lcore,
+                 const unsigned num_cores,
+                 const unsigned *cores)
+{
+        unsigned i;
+
+        for (i = 0; i < num_cores; i++)
+                if (cores[i] == lcore)
+                        return 1;
+
+        return 0;
+}
+
+int
+hw_mon_add_cores(const unsigned num_cores,
+                 const unsigned *cores,
+                 struct pqos_mon_data *group)
+{
+        const enum pqos_mon_event ctx_event = (enum pqos_mon_event)(
+            group->event & (~(PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS)));
+        struct pqos_mon_set_hot base;
+        struct pqos_mon_poll_ctx *ctxs = NULL;
+        unsigned *new_cores = NULL;
+        unsigned num_ctxs = group->num_poll_ctx;
+        unsigned i;
+        int ret = PQOS_RETVAL_OK;
+
+        ASSERT(group != NULL);
+        ASSERT(group->set == NULL);
+        ASSERT(cores != NULL);
+        ASSERT(num_cores > 0);
+        ASSERT(m_cpu != NULL);
+
+        /**
+         * Check if all requested cores are valid, not in the group yet
+         * and not used by other monitoring processes.
+         */
+        for (i = 0; i < num_cores; i++) {
+                const unsigned lcore = cores[i];
+                pqos_rmid_t rmid = RMID0;
+
+                ret = pqos_cpu_check_core(m_cpu, lcore);
+                if (ret != PQOS_RETVAL_OK)
+                        return PQOS_RETVAL_PARAM;
+
+                if (mon_core_on_list(lcore, group->num_cores, group->cores) ||
+                    mon_core_on_list(lcore, i, cores)) {
+                        LOG_ERROR("Core %u is already in the group\n", lcore);
+                        return PQOS_RETVAL_PARAM;
+                }
+
+                ret = mon_assoc_get(lcore, &rmid);
+                if (ret != PQOS_RETVAL_OK)
+                        return PQOS_RETVAL_PARAM;
+
+                if (rmid != RMID0) {
+                        LOG_INFO("Core %u is already monitored with "
+                                 "RMID%u.\n",
+                                 lcore, rmid);
+                        return PQOS_RETVAL_RESOURCE;
+                }
+        }
+
+        new_cores = (unsigned *)malloc(sizeof(new_cores[0]) *
+                                       (group->num_cores + num_cores));
+        ctxs = (struct pqos_mon_poll_ctx *)malloc(
+            sizeof(ctxs[0]) * (group->num_poll_ctx + num_cores));
+        if (new_cores == NULL || ctxs == NULL) {
+                ret = PQOS_RETVAL_RESOURCE;
+                goto hw_mon_add_cores_exit;
+        }
+        memcpy(new_cores, group->cores,
+               sizeof(new_cores[0]) * group->num_cores);
+        memcpy(ctxs, group->poll_ctx, sizeof(ctxs[0]) * group->num_poll_ctx);
+
+        /**
+         * Cores joining a cluster already present in the group share its
+         * RMID. New clusters get a new RMID, whose current counter values
+         * are recorded so that MBM deltas stay continuous.
+         */
+        memset(&base, 0, sizeof(base));
+        base.event = ctx_event;
+        for (i = 0; i < num_cores; i++) {
+                unsigned cluster, j;
+
+                ret = pqos_cpu_get_clusterid(m_cpu, cores[i], &cluster);
+                if (ret != PQOS_RETVAL_OK) {
+                        ret = PQOS_RETVAL_PARAM;
+                        goto hw_mon_add_cores_exit;
+                }
+
+                for (j = 0; j < num_ctxs; j++)
+                        if (ctxs[j].cluster == cluster)
+                                break;
+                if (j < num_ctxs)
+                        continue;
+
+                memset(&ctxs[num_ctxs], 0, sizeof(ctxs[0]));
+                ctxs[num_ctxs].lcore = cores[i];
+                ctxs[num_ctxs].cluster = cluster;
+#ifdef PQOS_RMID_CUSTOM
+                ret = rmid_alloc_custom(&ctxs[num_ctxs], ctx_event, &rmid_cfg);
+#else
+                ret = rmid_alloc(&ctxs[num_ctxs], ctx_event);
+#endif
+                if (ret != PQOS_RETVAL_OK)
+                        goto hw_mon_add_cores_exit;
+
+                if (mon_read_ctx(ctxs[num_ctxs].lcore, ctxs[num_ctxs].rmid,
+                                 &base) != PQOS_RETVAL_OK)
+                        /* Fall back to discarding next MBM read */
+                        group->valid_mbm_read = 0;
+
+                num_ctxs++;
+        }
+
+        ret = ia32_perf_counter_start(num_cores, cores, group->event);
+        if (ret != PQOS_RETVAL_OK)
+                goto hw_mon_add_cores_exit;
+
+        for (i = 0; i < num_cores; i++) {
+                unsigned cluster = 0, j;
+
+                (void)pqos_cpu_get_clusterid(m_cpu, cores[i], &cluster);
+                for (j = 0; j < num_ctxs; j++)
+                        if (ctxs[j].cluster == cluster)
+                                break;
+                ASSERT(j < num_ctxs);
+
+                ret = mon_assoc_set(cores[i], ctxs[j].rmid);
+                if (ret != PQOS_RETVAL_OK)
+                        break;
+                new_cores[group->num_cores + i] = cores[i];
+        }
+        if (ret != PQOS_RETVAL_OK) {
+                unsigned j;
+
+                for (j = 0; j <= i && j < num_cores; j++)
+                        (void)mon_assoc_set(cores[j], RMID0);
+                (void)ia32_perf_counter_stop(num_cores, cores, group->event);
+                goto hw_mon_add_cores_exit;
+        }
+
+        group->values.mbm_local += base.mbm_local;
+        group->values.mbm_total += base.mbm_total;
+
         free(group->cores);
         free(group->poll_ctx);
-        memset(group, 0, sizeof(*group));
+        group->cores = new_cores;
+        group->num_cores += num_cores;
+        group->poll_ctx = ctxs;
+        group->num_poll_ctx = num_ctxs;
+        new_cores = NULL;
+        ctxs = NULL;
+
+hw_mon_add_cores_exit:
+        if (new_cores != NULL)
+                free(new_cores);
+        if (ctxs != NULL)
+                free(ctxs);
+
+        return ret;
+}
+
+int
+hw_mon_remove_cores(const unsigned num_cores,
+                    const unsigned *cores,
+                    struct pqos_mon_data *group)
+{
+        struct pqos_mon_set_hot gone;
+        struct pqos_event_values removed;
+        unsigned i, n;
+        int ret;
+        int retval = PQOS_RETVAL_OK;
+
+        ASSERT(group != NULL);
+        ASSERT(group->set == NULL);
+        ASSERT(cores != NULL);
+        ASSERT(num_cores > 0);
+        ASSERT(m_cpu != NULL);
+
+        for (i = 0; i < num_cores; i++) {
+                if (!mon_core_on_list(cores[i], group->num_cores,
+                                      group->cores) ||
+                    mon_core_on_list(cores[i], i, cores)) {
+                        LOG_ERROR("Core %u is not in the group\n", cores[i]);
+                        return PQOS_RETVAL_PARAM;
+                }
+        }
+        if (num_cores >= group->num_cores) {
+                LOG_ERROR("Cannot remove all cores from the group\n");
+                return PQOS_RETVAL_PARAM;
+        }
+
+        /**
+         * Read final values of RMIDs and IA32 counters leaving the group.
+         * They are taken out of the group totals so that the next poll
+         * still accounts for activity since the previous poll.
+         */
+        memset(&gone, 0, sizeof(gone));
+        gone.event = (enum pqos_mon_event)(
+            group->event & (~(PQOS_PERF_EVENT_IPC | PQOS_PERF_EVENT_LLC_MISS)));
+        for (i = 0; i < group->num_poll_ctx; i++) {
+                struct pqos_mon_poll_ctx *ctx = &group->poll_ctx[i];
+                unsigned j;
+
+                for (j = 0; j < group->num_cores; j++) {
+                        unsigned cluster = 0;
+
+                        if (mon_core_on_list(group->cores[j], num_cores, cores))
+                                continue;
+                        ret = pqos_cpu_get_clusterid(m_cpu, group->cores[j],
+                                                     &cluster);
+                        if (ret == PQOS_RETVAL_OK && cluster == ctx->cluster)
+                                break;
+                }
+                if (j < group->num_cores) {
+                        /* cluster stays in the group */
+                        ctx->lcore = group->cores[j];
+                        continue;
+                }
+                if (mon_read_ctx(ctx->lcore, ctx->rmid, &gone) !=
+                    PQOS_RETVAL_OK)
+                        group->valid_mbm_read = 0;
+                /* mark poll context for removal */
+                ctx->cluster = UINT_MAX;
+        }
+
+        memset(&removed, 0, sizeof(removed));
+        ret = ia32_perf_counter_poll(num_cores, cores, group->event, &removed);
+        if (ret != PQOS_RETVAL_OK)
+                memset(&removed, 0, sizeof(removed));
+
+        /**
+         * Associate removed cores back with RMID0
+         */
+        for (i = 0; i < num_cores; i++) {
+                ret = mon_assoc_set(cores[i], RMID0);
+                if (ret != PQOS_RETVAL_OK)
+                        retval = PQOS_RETVAL_RESOURCE;
+        }
+        ret = ia32_perf_counter_stop(num_cores, cores, group->event);
+        if (ret != PQOS_RETVAL_OK)
+                retval = PQOS_RETVAL_RESOURCE;
+
+        /**
+         * Update the group
+         */
+        for (i = 0, n = 0; i < group->num_cores; i++)
+                if (!mon_core_on_list(group->cores[i], num_cores, cores))
+                        group->cores[n++] = group->cores[i];
+        group->num_cores = n;
+
+        for (i = 0, n = 0; i < group->num_poll_ctx; i++)
+                if (group->poll_ctx[i].cluster != UINT_MAX)
+                        group->poll_ctx[n++] = group->poll_ctx[i];
+        group->num_poll_ctx = n;
+
+        group->values.mbm_local -= gone.mbm_local;
+        group->values.mbm_total -= gone.mbm_total;
+        group->values.ipc_retired -= removed.ipc_retired;
+        group->values.ipc_unhalted -= removed.ipc_unhalted;
+        group->values.llc_misses -= removed.llc_misses;
 
         return retval;
 }
@@ -1168,21 +1916,331 @@ hw_mon_stop(struct pqos_mon_data *group)
 int
 hw_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups)
 {
+        struct mon_scale scale;
         unsigned i = 0;
 
         ASSERT(groups != NULL);
         ASSERT(num_groups > 0);
 
+        mon_scale_get(&scale);
+
         for (i = 0; i < num_groups; i++) {
-                int ret = pqos_core_poll(groups[i]);
+                int ret = pqos_core_poll(groups[i], &scale);
 
                 if (ret != PQOS_RETVAL_OK)
                         LOG_WARN("Failed to read event on "
                                  "core %u\n",
-                                 groups[i]->cores[0]);
+                                 groups[i]->poll_ctx[0].lcore);
         }
         return PQOS_RETVAL_OK;
 }
+
+/*
+ * =======================================
+ * =======================================
+ *
+ * Monitoring group set
+ *
+ * =======================================
+ * =======================================
+ */
+
+/**
+ * @brief Reserves \a size bytes at \a offset of the group set memory block
+ *
+ * @param [in,out] offset current end of the memory block
+ * @param [in] size table size
+ *
+ * @return Offset of the reserved table
+ */
+static size_t
+mon_set_carve(size_t *offset, const size_t size)
+{
+        const size_t ret = *offset;
+
+        *offset = (*offset + size + MON_SET_ALIGN - 1) &
+                  ~((size_t)MON_SET_ALIGN - 1);
+        return ret;
+}
+
+struct pqos_mon_set *
+mon_set_alloc(const unsigned max_groups, const unsigned max_cores)
+{
+        struct pqos_mon_set *set;
+        size_t size = 0;
+        size_t off_groups, off_ptrs, off_hot, off_cores, off_ctx, off_scratch;
+        size_t off_lcore, off_rmid, off_cluster, off_group;
+        char *mem = NULL;
+
+        (void)mon_set_carve(&size, sizeof(*set));
+        off_groups = mon_set_carve(&size, sizeof(set->groups[0]) * max_groups);
+        off_ptrs =
+            mon_set_carve(&size, sizeof(set->group_ptrs[0]) * max_groups);
+        off_hot = mon_set_carve(&size, sizeof(set->hot[0]) * max_groups);
+        off_cores = mon_set_carve(&size, sizeof(set->core_pool[0]) * max_cores);
+        off_ctx = mon_set_carve(&size, sizeof(set->ctx_pool[0]) * max_cores);
+        off_scratch = mon_set_carve(&size, sizeof(set->scratch[0]) * max_cores);
+        off_lcore =
+            mon_set_carve(&size, sizeof(set->poll_lcore[0]) * max_cores);
+        off_rmid = mon_set_carve(&size, sizeof(set->poll_rmid[0]) * max_cores);
+        off_cluster =
+            mon_set_carve(&size, sizeof(set->poll_cluster[0]) * max_cores);
+        off_group =
+            mon_set_carve(&size, sizeof(set->poll_group[0]) * max_cores);
+
+        if (posix_memalign((void **)&mem, MON_SET_ALIGN, size) != 0)
+                return NULL;
+        memset(mem, 0, size);
+
+        set = (struct pqos_mon_set *)(void *)mem;
+        set->max_groups = max_groups;
+        set->max_cores = max_cores;
+        set->groups = (struct pqos_mon_data *)(void *)(mem + off_groups);
+        set->group_ptrs = (struct pqos_mon_data **)(void *)(mem + off_ptrs);
+        set->hot = (struct pqos_mon_set_hot *)(void *)(mem + off_hot);
+        set->core_pool = (unsigned *)(void *)(mem + off_cores);
+        set->ctx_pool = (struct pqos_mon_poll_ctx *)(void *)(mem + off_ctx);
+        set->scratch = (unsigned *)(void *)(mem + off_scratch);
+        set->poll_lcore = (unsigned *)(void *)(mem + off_lcore);
+        set->poll_rmid = (pqos_rmid_t *)(void *)(mem + off_rmid);
+        set->poll_cluster = (unsigned *)(void *)(mem + off_cluster);
+        set->poll_group = (unsigned *)(void *)(mem + off_group);
+
+        return set;
+}
+
+void
+mon_set_free(struct pqos_mon_set *set)
+{
+        free(set);
+}
+
+int
+hw_mon_set_start(struct pqos_mon_set *set,
+                 const unsigned num_cores,
+                 const unsigned *cores,
+                 const enum pqos_mon_event event,
+                 void *context,
+                 struct pqos_mon_data **group)
+{
+        const unsigned idx = set->num_groups;
+        struct pqos_mon_data *grp;
+        unsigned i;
+        int ret;
+
+        ASSERT(set != NULL);
+        ASSERT(group != NULL);
+
+        if (idx >= set->max_groups ||
+            num_cores > set->max_cores - set->num_cores) {
+                LOG_ERROR("Monitoring group set is full\n");
+                return PQOS_RETVAL_RESOURCE;
+        }
+
+        /**
+         * Number of poll contexts never exceeds number of cores so there is
+         * always room for \a num_cores contexts in the context pool
+         */
+        grp = &set->groups[idx];
+        ret = mon_start(num_cores, cores, event, context, grp, set->scratch,
+                        &set->core_pool[set->num_cores],
+                        &set->ctx_pool[set->num_poll]);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        /**
+         * Insert poll contexts into poll tables
+         * keeping them sorted by cluster and core
+         */
+        for (i = 0; i < grp->num_poll_ctx; i++) {
+                const struct pqos_mon_poll_ctx *ctx = &grp->poll_ctx[i];
+                unsigned pos = set->num_poll;
+
+                while (pos > 0 &&
+                       (set->poll_cluster[pos - 1] > ctx->cluster ||
+                        (set->poll_cluster[pos - 1] == ctx->cluster &&
+                         set->poll_lcore[pos - 1] > ctx->lcore))) {
+                        set->poll_lcore[pos] = set->poll_lcore[pos - 1];
+                        set->poll_rmid[pos] = set->poll_rmid[pos - 1];
+                        set->poll_cluster[pos] = set->poll_cluster[pos - 1];
+                        set->poll_group[pos] = set->poll_group[pos - 1];
+                        pos--;
+                }
+                set->poll_lcore[pos] = ctx->lcore;
+                set->poll_rmid[pos] = ctx->rmid;
+                set->poll_cluster[pos] = ctx->cluster;
+                set->poll_group[pos] = idx;
+                set->num_poll++;
+        }
+
+        grp->set = set;
+        set->hot[idx].event = event;
+        set->group_ptrs[idx] = grp;
+        set->num_cores += num_cores;
+        set->num_groups++;
+        *group = grp;
+
+        return PQOS_RETVAL_OK;
+}
+
+uint64_t
+mon_timestamp(void)
+{
+        struct timespec ts;
+
+        if (clock_gettime(CLOCK_MONOTONIC, &ts) != 0)
+                return 0;
+
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void
+mon_snapshot_update(struct pqos_mon_data *group, const uint64_t timestamp)
+{
+        const struct pqos_event_values *pv = &group->values;
+        double interval;
+
+        group->read_interval = 0;
+        if (group->read_time != 0 && timestamp > group->read_time)
+                group->read_interval = timestamp - group->read_time;
+        group->read_time = timestamp;
+
+        group->mbm_local_rate = 0;
+        group->mbm_total_rate = 0;
+        group->mbm_remote_rate = 0;
+        if (group->read_interval == 0)
+                return;
+
+        interval = (double)group->read_interval / 1000000000.0;
+        group->mbm_local_rate = (double)pv->mbm_local_delta / interval;
+        group->mbm_total_rate = (double)pv->mbm_total_delta / interval;
+        group->mbm_remote_rate = (double)pv->mbm_remote_delta / interval;
+}
+
+int
+hw_mon_poll_snapshot(struct pqos_mon_data **groups,
+                     const unsigned num_groups,
+                     struct pqos_mon_snapshot *snapshot)
+{
+        struct mon_scale scale;
+        struct pqos_mon_set_hot *hot;
+        struct ia32_perf_raw *perf;
+        uint64_t *timestamp;
+        uint64_t first;
+        unsigned i;
+
+        ASSERT(groups != NULL);
+        ASSERT(num_groups > 0);
+        ASSERT(snapshot != NULL);
+
+        hot = calloc(num_groups, sizeof(hot[0]));
+        perf = calloc(num_groups, sizeof(perf[0]));
+        timestamp = calloc(num_groups, sizeof(timestamp[0]));
+        if (hot == NULL || perf == NULL || timestamp == NULL) {
+                free(hot);
+                free(perf);
+                free(timestamp);
+                return PQOS_RETVAL_RESOURCE;
+        }
+
+        mon_scale_get(&scale);
+
+        /**
+         * Read raw RMID and IA32 counters of all groups in one pass
+         */
+        first = mon_timestamp();
+        for (i = 0; i < num_groups; i++) {
+                const struct pqos_mon_data *p = groups[i];
+                unsigned j;
+
+                hot[i].event = p->event;
+                for (j = 0; j < p->num_poll_ctx && !hot[i].failed; j++)
+                        if (mon_read_ctx(p->poll_ctx[j].lcore,
+                                         p->poll_ctx[j].rmid,
+                                         &hot[i]) != PQOS_RETVAL_OK)
+                                hot[i].failed = 1;
+                if (!hot[i].failed &&
+                    ia32_perf_counter_read(p->num_cores, p->cores, p->event,
+                                           &perf[i]) != PQOS_RETVAL_OK)
+                        hot[i].failed = 1;
+                timestamp[i] = mon_timestamp();
+        }
+
+        snapshot->timestamp = first;
+        snapshot->max_skew = timestamp[num_groups - 1] - first;
+
+        /**
+         * Compute deltas and rates of each group
+         */
+        for (i = 0; i < num_groups; i++) {
+                struct pqos_mon_data *p = groups[i];
+
+                if (!hot[i].failed) {
+                        mon_values_update(p, &scale, &hot[i]);
+                        ia32_perf_counter_update(p->event, &perf[i],
+                                                 &p->values);
+                        mon_snapshot_update(p, timestamp[i]);
+                        continue;
+                }
+                LOG_WARN("Failed to read event on core %u\n",
+                         p->poll_ctx[0].lcore);
+        }
+
+        free(hot);
+        free(perf);
+        free(timestamp);
+
+        return PQOS_RETVAL_OK;
+}
+
+int
+hw_mon_set_poll(struct pqos_mon_set *set)
+{
+        struct mon_scale scale;
+        unsigned i;
+
+        ASSERT(set != NULL);
+
+        mon_scale_get(&scale);
+
+        for (i = 0; i < set->num_groups; i++) {
+                struct pqos_mon_set_hot *hot = &set->hot[i];
+
+                hot->failed = 0;
+                hot->llc = 0;
+                hot->mbm_local = 0;
+                hot->mbm_total = 0;
+        }
+
+        for (i = 0; i < set->num_poll; i++) {
+                struct pqos_mon_set_hot *hot = &set->hot[set->poll_group[i]];
+                int ret;
+
+                if (hot->failed)
+                        continue;
+
+                ret = mon_read_ctx(set->poll_lcore[i], set->poll_rmid[i], hot);
+                if (ret != PQOS_RETVAL_OK)
+                        hot->failed = 1;
+        }
+
+        for (i = 0; i < set->num_groups; i++) {
+                struct pqos_mon_data *grp = &set->groups[i];
+                const struct pqos_mon_set_hot *hot = &set->hot[i];
+
+                if (!hot->failed) {
+                        mon_values_update(grp, &scale, hot);
+                        if (ia32_perf_counter_poll(grp->num_cores, grp->cores,
+                                                   grp->event, &grp->values) ==
+                            PQOS_RETVAL_OK)
+                                continue;
+                }
+                LOG_WARN("Failed to read event on core %u\n", grp->cores[0]);
+        }
+
+        return PQOS_RETVAL_OK;
+}
+
 /*
  * =======================================
  * =======================================
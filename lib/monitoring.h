@@ -152,6 +152,167 @@ int hw_mon_stop(struct pqos_mon_data *group);
  */
 int hw_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups);
 
+/**
+ * @brief Hardware interface poll monitoring data as one snapshot
+ *
+ * @param [in] groups table of monitoring group pointers to be be updated
+ * @param [in] num_groups number of monitoring groups in the table
+ * @param [out] snapshot snapshot information
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_mon_poll_snapshot(struct pqos_mon_data **groups,
+                         const unsigned num_groups,
+                         struct pqos_mon_snapshot *snapshot);
+
+/**
+ * @brief Gets monotonic timestamp for snapshot reads
+ *
+ * @return Timestamp in nanoseconds
+ */
+uint64_t mon_timestamp(void);
+
+/**
+ * @brief Updates snapshot read time and memory bandwidth rates of the group
+ *
+ * Must be called after memory bandwidth deltas of the group are updated.
+ *
+ * @param [in,out] group monitoring group
+ * @param [in] timestamp time of the group read [ns]
+ */
+void mon_snapshot_update(struct pqos_mon_data *group, const uint64_t timestamp);
+
+/**
+ * @brief Hardware interface to start monitoring of RMID0 on the \a cluster
+ *
+ * @param [in] cluster L3 cluster id
+ * @param [in] event combination of monitoring events
+ * @param [in] context a pointer for application's convenience
+ * @param [in,out] group a pointer to monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_mon_start_remainder(const unsigned cluster,
+                           const enum pqos_mon_event event,
+                           void *context,
+                           struct pqos_mon_data *group);
+
+/**
+ * @brief Hardware interface to add cores to the monitoring group
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in,out] group monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_mon_add_cores(const unsigned num_cores,
+                     const unsigned *cores,
+                     struct pqos_mon_data *group);
+
+/**
+ * @brief Hardware interface to remove cores from the monitoring group
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in,out] group monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_mon_remove_cores(const unsigned num_cores,
+                        const unsigned *cores,
+                        struct pqos_mon_data *group);
+
+/**
+ * Per group data touched on every set poll
+ */
+struct pqos_mon_set_hot {
+        enum pqos_mon_event event; /**< monitored events */
+        int failed;                /**< read error in the current poll */
+        uint64_t llc;              /**< raw LLC occupancy accumulator */
+        uint64_t mbm_local;        /**< raw local MBM accumulator */
+        uint64_t mbm_total;        /**< raw total MBM accumulator */
+};
+
+/**
+ * Monitoring group set
+ *
+ * All tables below point into a single memory block allocated together
+ * with the structure. Poll tables (poll_*) are structure-of-arrays holding
+ * poll contexts of all groups sorted by cluster.
+ */
+struct pqos_mon_set {
+        unsigned max_groups;                /**< group table size */
+        unsigned max_cores;                 /**< core pool size */
+        unsigned num_groups;                /**< groups in use */
+        unsigned num_cores;                 /**< core pool entries in use */
+        unsigned num_poll;                  /**< poll table entries in use */
+        struct pqos_mon_data *groups;       /**< group table */
+        struct pqos_mon_data **group_ptrs;  /**< group pointer table */
+        struct pqos_mon_set_hot *hot;       /**< dense per group hot data */
+        unsigned *core_pool;                /**< group core lists */
+        struct pqos_mon_poll_ctx *ctx_pool; /**< group poll contexts */
+        unsigned *scratch;                  /**< core to cluster scratch */
+        unsigned *poll_lcore;               /**< core to read RMID on */
+        pqos_rmid_t *poll_rmid;             /**< RMID to read */
+        unsigned *poll_cluster;             /**< cluster of the context */
+        unsigned *poll_group;               /**< index of owning group */
+};
+
+/**
+ * @brief Allocates monitoring group set
+ *
+ * @param [in] max_groups maximum number of groups in the set
+ * @param [in] max_cores maximum number of cores across all groups
+ *
+ * @return Pointer to group set
+ * @retval NULL on allocation error
+ */
+struct pqos_mon_set *mon_set_alloc(const unsigned max_groups,
+                                   const unsigned max_cores);
+
+/**
+ * @brief Frees monitoring group set memory
+ *
+ * @param [in] set group set
+ */
+void mon_set_free(struct pqos_mon_set *set);
+
+/**
+ * @brief Hardware interface to start resource monitoring on selected
+ * group of cores within the group set
+ *
+ * @param [in] set group set
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in] event combination of monitoring events
+ * @param [in] context a pointer for application's convenience
+ * @param [out] group started monitoring group
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_mon_set_start(struct pqos_mon_set *set,
+                     const unsigned num_cores,
+                     const unsigned *cores,
+                     const enum pqos_mon_event event,
+                     void *context,
+                     struct pqos_mon_data **group);
+
+/**
+ * @brief Hardware interface to poll all groups in the group set
+ *
+ * @param [in] set group set
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int hw_mon_set_poll(struct pqos_mon_set *set);
+
 /*
  * =======================================
  * Allocation Technology
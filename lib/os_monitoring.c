@@ -42,6 +42,7 @@
 #include "log.h"
 #include "types.h"
 #include "os_monitoring.h"
+#include "monitoring.h"
 #include "perf_monitoring.h"
 #include "resctrl.h"
 #include "resctrl_monitoring.h"
@@ -60,7 +61,8 @@ const enum pqos_mon_event os_mon_event[] = {
     PQOS_MON_EVENT_TMEM_BW,
     PQOS_PERF_EVENT_LLC_MISS,
     (enum pqos_mon_event)PQOS_PERF_EVENT_CYCLES,
-    (enum pqos_mon_event)PQOS_PERF_EVENT_INSTRUCTIONS};
+    (enum pqos_mon_event)PQOS_PERF_EVENT_INSTRUCTIONS,
+    PQOS_PERF_EVENT_LLC_MISS_SAMPLE};
 
 /**
  * @brief Filter directory filenames
@@ -136,6 +138,10 @@ stop_event_error:
                 free(group->perf);
                 group->perf = NULL;
         }
+        if (group->samples != NULL) {
+                free(group->samples);
+                group->samples = NULL;
+        }
 
         if ((group->perf_event & stopped_evts) != group->perf_event) {
                 LOG_ERROR("Failed to stop all perf events\n");
@@ -192,6 +198,15 @@ start_events(struct pqos_mon_data *group)
         if (events & PQOS_PERF_EVENT_IPC)
                 events |= (enum pqos_mon_event)(PQOS_PERF_EVENT_CYCLES |
                                                 PQOS_PERF_EVENT_INSTRUCTIONS);
+        if (events & PQOS_PERF_EVENT_LLC_MISS_SAMPLE) {
+                group->samples = calloc(1, sizeof(*group->samples));
+                if (group->samples == NULL) {
+                        LOG_ERROR("Memory allocation failed\n");
+                        free(group->perf);
+                        group->perf = NULL;
+                        return PQOS_RETVAL_ERROR;
+                }
+        }
 
         /**
          * Determine selected events and Perf counters
@@ -380,12 +395,15 @@ os_mon_stop(struct pqos_mon_data *group)
 
         ASSERT(group != NULL);
 
-        if (group->num_cores == 0 && group->tid_nr == 0)
+        if (group->num_cores == 0 && group->tid_nr == 0 && !group->remainder)
                 return PQOS_RETVAL_PARAM;
 
         /* stop all started events */
         ret = stop_events(group);
 
+        if (group->remainder)
+                free(group->poll_ctx);
+
         /* free memory */
         if (group->num_cores > 0) {
                 free(group->cores);
@@ -395,17 +413,59 @@ os_mon_stop(struct pqos_mon_data *group)
                 free(group->tid_map);
                 group->tid_map = NULL;
         }
+        /* name of group without resctrl events */
+        free(group->resctrl_mon_group);
         memset(group, 0, sizeof(*group));
 
         return ret;
 }
 
-int
-os_mon_start(const unsigned num_cores,
-             const unsigned *cores,
-             const enum pqos_mon_event event,
-             void *context,
-             struct pqos_mon_data *group)
+/**
+ * @brief Sets resctrl mon group name of the group to be started
+ *
+ * @param [in] named named group configuration, NULL for unnamed group
+ * @param [in,out] group monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+mon_named_set(const struct pqos_mon_named *named, struct pqos_mon_data *group)
+{
+        if (named == NULL)
+                return PQOS_RETVAL_OK;
+
+        group->resctrl_mon_group = strdup(named->name);
+        if (group->resctrl_mon_group == NULL)
+                return PQOS_RETVAL_RESOURCE;
+
+        group->resctrl_mon_flags = RESCTRL_MON_NAMED;
+        if (named->keep)
+                group->resctrl_mon_flags |= RESCTRL_MON_KEEP;
+
+        return PQOS_RETVAL_OK;
+}
+
+/**
+ * @brief Starts monitoring of \a cores, optionally in named mon group
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in] event combination of monitoring events
+ * @param [in] context a pointer for application's convenience
+ * @param [in] named named group configuration, NULL for unnamed group
+ * @param [in,out] group a pointer to monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+mon_start_cores(const unsigned num_cores,
+                const unsigned *cores,
+                const enum pqos_mon_event event,
+                void *context,
+                const struct pqos_mon_named *named,
+                struct pqos_mon_data *group)
 {
         unsigned i = 0;
         int ret;
@@ -460,9 +520,352 @@ os_mon_start(const unsigned num_cores,
         for (i = 0; i < num_cores; i++)
                 group->cores[i] = cores[i];
 
-        ret = start_events(group);
-        if (ret != PQOS_RETVAL_OK && group->cores != NULL)
+        ret = mon_named_set(named, group);
+        if (ret == PQOS_RETVAL_OK)
+                ret = start_events(group);
+        if (ret != PQOS_RETVAL_OK) {
                 free(group->cores);
+                group->cores = NULL;
+                free(group->resctrl_mon_group);
+                group->resctrl_mon_group = NULL;
+        }
+
+        return ret;
+}
+
+int
+os_mon_start(const unsigned num_cores,
+             const unsigned *cores,
+             const enum pqos_mon_event event,
+             void *context,
+             struct pqos_mon_data *group)
+{
+        return mon_start_cores(num_cores, cores, event, context, NULL, group);
+}
+
+int
+os_mon_start_remainder(const unsigned cluster,
+                       const enum pqos_mon_event event,
+                       void *context,
+                       struct pqos_mon_data *group)
+{
+        enum pqos_mon_event events = event;
+        unsigned *cores;
+        unsigned num_cores = 0;
+        unsigned i;
+
+        ASSERT(group != NULL);
+        ASSERT(event > 0);
+
+        if (events & PQOS_MON_EVENT_RMEM_BW)
+                events |= (enum pqos_mon_event)(PQOS_MON_EVENT_LMEM_BW |
+                                                PQOS_MON_EVENT_TMEM_BW);
+
+        /**
+         * Remainder is computed from resctrl groups only
+         */
+        for (i = 0; i < DIM(os_mon_event); i++) {
+                enum pqos_mon_event evt = os_mon_event[i];
+
+                if ((events & evt) && !resctrl_mon_is_event_supported(evt)) {
+                        LOG_ERROR("Remainder monitoring requires resctrl "
+                                  "monitoring support\n");
+                        return PQOS_RETVAL_RESOURCE;
+                }
+        }
+
+        cores = pqos_cpu_get_cores_l3id(m_cpu, cluster, &num_cores);
+        if (cores == NULL || num_cores == 0) {
+                LOG_ERROR("Invalid cluster id %u\n", cluster);
+                if (cores != NULL)
+                        free(cores);
+                return PQOS_RETVAL_PARAM;
+        }
+
+        memset(group, 0, sizeof(*group));
+        group->poll_ctx = malloc(sizeof(group->poll_ctx[0]));
+        if (group->poll_ctx == NULL) {
+                free(cores);
+                return PQOS_RETVAL_RESOURCE;
+        }
+        group->poll_ctx[0].lcore = cores[0];
+        group->poll_ctx[0].cluster = cluster;
+        group->poll_ctx[0].rmid = 0;
+        group->num_poll_ctx = 1;
+        group->event = event;
+        group->context = context;
+        group->remainder = 1;
+        group->resctrl_event = (enum pqos_mon_event)(
+            events & (PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
+                      PQOS_MON_EVENT_TMEM_BW));
+
+        free(cores);
+
+        return PQOS_RETVAL_OK;
+}
+
+/**
+ * @brief Check if \a lcore is in \a cores
+ *
+ * @param[in] lcore core to search for
+ * @param[in] num_cores length of \a cores
+ * @param[in] cores list of cores
+ *
+ * @retval 1 if found
+ */
+static int
+core_exists(const unsigned lcore,
+            const unsigned num_cores,
+            const unsigned *cores)
+{
+        unsigned i;
+
+        for (i = 0; i < num_cores; i++)
+                if (cores[i] == lcore)
+                        return 1;
+
+        return 0;
+}
+
+int
+os_mon_add_cores(const unsigned num_cores,
+                 const unsigned *cores,
+                 struct pqos_mon_data *group)
+{
+        int ret = PQOS_RETVAL_OK;
+        unsigned i;
+        unsigned *ptr;
+        struct pqos_mon_perf_ctx *ctx;
+        struct pqos_mon_data added;
+        enum pqos_mon_event started_evts = (enum pqos_mon_event)0;
+        unsigned num_assoc = 0;
+
+        ASSERT(group != NULL);
+        ASSERT(num_cores > 0);
+        ASSERT(cores != NULL);
+
+        for (i = 0; i < num_cores; i++) {
+                if (pqos_cpu_check_core(m_cpu, cores[i]) != PQOS_RETVAL_OK)
+                        return PQOS_RETVAL_PARAM;
+
+                if (core_exists(cores[i], group->num_cores, group->cores) ||
+                    core_exists(cores[i], i, cores)) {
+                        LOG_ERROR("Core %u is already in the group\n",
+                                  cores[i]);
+                        return PQOS_RETVAL_PARAM;
+                }
+        }
+
+        memset(&added, 0, sizeof(added));
+        added.num_cores = num_cores;
+        added.cores = (unsigned *)malloc(sizeof(added.cores[0]) * num_cores);
+        if (added.cores == NULL) {
+                ret = PQOS_RETVAL_RESOURCE;
+                goto os_mon_add_cores_exit;
+        }
+        for (i = 0; i < num_cores; i++)
+                added.cores[i] = cores[i];
+
+        /**
+         * Start perf counters for the new cores
+         */
+        if (group->perf_event != 0) {
+                added.perf = calloc(num_cores, sizeof(added.perf[0]));
+                if (added.perf == NULL) {
+                        ret = PQOS_RETVAL_RESOURCE;
+                        goto os_mon_add_cores_exit;
+                }
+        }
+        for (i = 0; i < DIM(os_mon_event); i++) {
+                enum pqos_mon_event evt = os_mon_event[i];
+
+                if (!(group->perf_event & evt))
+                        continue;
+
+                ret = perf_mon_start(&added, evt);
+                if (ret != PQOS_RETVAL_OK)
+                        goto os_mon_add_cores_exit;
+                started_evts |= evt;
+        }
+
+        /**
+         * Add the new cores to the resctrl monitoring group.
+         * Group counters are kept by the kernel.
+         */
+        if (group->resctrl_event != 0) {
+                ret = resctrl_lock_exclusive();
+                if (ret != PQOS_RETVAL_OK)
+                        goto os_mon_add_cores_exit;
+
+                for (num_assoc = 0; num_assoc < num_cores; num_assoc++) {
+                        ret = resctrl_mon_assoc_set(cores[num_assoc],
+                                                    group->resctrl_mon_group);
+                        if (ret != PQOS_RETVAL_OK)
+                                break;
+                }
+                resctrl_lock_release();
+                if (ret != PQOS_RETVAL_OK)
+                        goto os_mon_add_cores_exit;
+        }
+
+        /**
+         * Update mon group
+         */
+        ptr = realloc(group->cores, sizeof(group->cores[0]) *
+                                        (group->num_cores + num_cores));
+        if (ptr == NULL) {
+                ret = PQOS_RETVAL_RESOURCE;
+                goto os_mon_add_cores_exit;
+        }
+        group->cores = ptr;
+
+        if (added.perf != NULL) {
+                ctx = realloc(group->perf, sizeof(group->perf[0]) *
+                                               (group->num_cores + num_cores));
+                if (ctx == NULL) {
+                        ret = PQOS_RETVAL_RESOURCE;
+                        goto os_mon_add_cores_exit;
+                }
+                group->perf = ctx;
+        }
+
+        for (i = 0; i < num_cores; i++) {
+                group->cores[group->num_cores + i] = cores[i];
+                if (added.perf != NULL)
+                        group->perf[group->num_cores + i] = added.perf[i];
+        }
+        group->num_cores += num_cores;
+
+os_mon_add_cores_exit:
+        if (ret != PQOS_RETVAL_OK) {
+                if (ret == PQOS_RETVAL_RESOURCE)
+                        LOG_ERROR("Memory allocation error!\n");
+
+                for (i = 0; i < DIM(os_mon_event); i++)
+                        if (started_evts & os_mon_event[i])
+                                perf_mon_stop(&added, os_mon_event[i]);
+
+                if (num_assoc > 0 &&
+                    resctrl_lock_exclusive() == PQOS_RETVAL_OK) {
+                        for (i = 0; i < num_assoc && i < num_cores; i++)
+                                resctrl_mon_assoc_unset(
+                                    cores[i], group->resctrl_mon_group);
+                        resctrl_lock_release();
+                }
+        }
+        if (added.perf != NULL)
+                free(added.perf);
+        if (added.cores != NULL)
+                free(added.cores);
+
+        return ret;
+}
+
+int
+os_mon_remove_cores(const unsigned num_cores,
+                    const unsigned *cores,
+                    struct pqos_mon_data *group)
+{
+        int ret = PQOS_RETVAL_OK;
+        unsigned i, n;
+        struct pqos_mon_data remove;
+
+        ASSERT(group != NULL);
+        ASSERT(num_cores > 0);
+        ASSERT(cores != NULL);
+
+        for (i = 0; i < num_cores; i++) {
+                if (!core_exists(cores[i], group->num_cores, group->cores) ||
+                    core_exists(cores[i], i, cores)) {
+                        LOG_ERROR("Core %u is not in the group\n", cores[i]);
+                        return PQOS_RETVAL_PARAM;
+                }
+        }
+        if (num_cores >= group->num_cores) {
+                LOG_ERROR("Cannot remove all cores from the group\n");
+                return PQOS_RETVAL_PARAM;
+        }
+
+        memset(&remove, 0, sizeof(remove));
+        remove.num_cores = num_cores;
+        remove.cores = (unsigned *)malloc(sizeof(remove.cores[0]) * num_cores);
+        if (remove.cores == NULL)
+                return PQOS_RETVAL_RESOURCE;
+        if (group->perf != NULL) {
+                remove.perf = malloc(sizeof(remove.perf[0]) * num_cores);
+                if (remove.perf == NULL) {
+                        free(remove.cores);
+                        return PQOS_RETVAL_RESOURCE;
+                }
+        }
+
+        /* Add cores for removal */
+        for (i = 0, n = 0; i < group->num_cores; i++) {
+                if (!core_exists(group->cores[i], num_cores, cores))
+                        continue;
+
+                remove.cores[n] = group->cores[i];
+                if (remove.perf != NULL)
+                        remove.perf[n] = group->perf[i];
+                n++;
+        }
+
+        /**
+         * Read final perf counter values of removed cores and take them out
+         * of the group totals, so that the next poll still accounts for
+         * activity since the previous poll.
+         */
+        for (i = 0; i < DIM(os_mon_event); i++) {
+                enum pqos_mon_event evt = os_mon_event[i];
+
+                if (!(group->perf_event & evt))
+                        continue;
+
+                if (perf_mon_poll(&remove, evt) != PQOS_RETVAL_OK)
+                        LOG_WARN("Failed to read final counter values of "
+                                 "removed cores\n");
+                perf_mon_stop(&remove, evt);
+        }
+        group->values.mbm_local -= remove.values.mbm_local;
+        group->values.mbm_total -= remove.values.mbm_total;
+        group->values.llc_misses -= remove.values.llc_misses;
+        group->values.ipc_unhalted -= remove.values.ipc_unhalted;
+        group->values.ipc_retired -= remove.values.ipc_retired;
+
+        /**
+         * Move removed cores out of the resctrl monitoring group
+         */
+        if (group->resctrl_event != 0) {
+                ret = resctrl_lock_exclusive();
+                if (ret == PQOS_RETVAL_OK) {
+                        for (i = 0; i < num_cores; i++) {
+                                int retval = resctrl_mon_assoc_unset(
+                                    cores[i], group->resctrl_mon_group);
+
+                                if (retval != PQOS_RETVAL_OK)
+                                        ret = retval;
+                        }
+                        resctrl_lock_release();
+                }
+        }
+
+        /**
+         * Update mon group
+         */
+        for (i = 0, n = 0; i < group->num_cores; i++) {
+                if (core_exists(group->cores[i], num_cores, cores))
+                        continue;
+
+                group->cores[n] = group->cores[i];
+                if (group->perf != NULL)
+                        group->perf[n] = group->perf[i];
+                n++;
+        }
+        group->num_cores = n;
+
+        if (remove.perf != NULL)
+                free(remove.perf);
+        free(remove.cores);
 
         return ret;
 }
@@ -596,12 +999,26 @@ tid_verify(const pid_t pid)
         return found;
 }
 
-int
-os_mon_start_pids(const unsigned num_pids,
-                  const pid_t *pids,
-                  const enum pqos_mon_event event,
-                  void *context,
-                  struct pqos_mon_data *group)
+/**
+ * @brief Starts monitoring of \a pids, optionally in named mon group
+ *
+ * @param [in] num_pids number of pids in \a pids array
+ * @param [in] pids array of process ID
+ * @param [in] event monitoring event id
+ * @param [in] context a pointer for application's convenience
+ * @param [in] named named group configuration, NULL for unnamed group
+ * @param [in,out] group a pointer to monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+mon_start_pids(const unsigned num_pids,
+               const pid_t *pids,
+               const enum pqos_mon_event event,
+               void *context,
+               const struct pqos_mon_named *named,
+               struct pqos_mon_data *group)
 {
         int ret;
         unsigned i;
@@ -650,7 +1067,15 @@ os_mon_start_pids(const unsigned num_pids,
         for (i = 0; i < num_pids; i++)
                 group->pids[i] = pids[i];
 
-        ret = start_events(group);
+        ret = mon_named_set(named, group);
+        if (ret == PQOS_RETVAL_OK)
+                ret = start_events(group);
+        if (ret != PQOS_RETVAL_OK) {
+                free(group->pids);
+                group->pids = NULL;
+                free(group->resctrl_mon_group);
+                group->resctrl_mon_group = NULL;
+        }
 
 os_mon_start_pids_exit:
         if (ret != PQOS_RETVAL_OK && tid_map != NULL)
@@ -659,6 +1084,61 @@ os_mon_start_pids_exit:
         return ret;
 }
 
+int
+os_mon_start_pids(const unsigned num_pids,
+                  const pid_t *pids,
+                  const enum pqos_mon_event event,
+                  void *context,
+                  struct pqos_mon_data *group)
+{
+        return mon_start_pids(num_pids, pids, event, context, NULL, group);
+}
+
+int
+os_mon_start_named(const unsigned num_groups,
+                   const struct pqos_mon_named *cfg,
+                   struct pqos_mon_data **groups)
+{
+        int ret = PQOS_RETVAL_OK;
+        unsigned i;
+
+        ASSERT(cfg != NULL);
+        ASSERT(groups != NULL);
+
+        for (i = 0; i < num_groups; i++) {
+                const struct pqos_mon_named *c = &cfg[i];
+
+                if (c->num_cores > 0)
+                        ret = mon_start_cores(c->num_cores, c->cores, c->event,
+                                              c->context, c, groups[i]);
+                else
+                        ret = mon_start_pids(c->num_pids, c->pids, c->event,
+                                             c->context, c, groups[i]);
+                if (ret != PQOS_RETVAL_OK) {
+                        LOG_ERROR("Failed to start monitoring group %s\n",
+                                  c->name);
+                        break;
+                }
+        }
+
+        /**
+         * Roll back groups started so far, adopted groups are left as
+         * they were found and groups created by this call are removed
+         */
+        if (ret != PQOS_RETVAL_OK)
+                while (i-- > 0) {
+                        if (groups[i]->resctrl_mon_flags & RESCTRL_MON_ADOPTED)
+                                groups[i]->resctrl_mon_flags |=
+                                    RESCTRL_MON_KEEP;
+                        else
+                                groups[i]->resctrl_mon_flags &=
+                                    ~RESCTRL_MON_KEEP;
+                        os_mon_stop(groups[i]);
+                }
+
+        return ret;
+}
+
 int
 os_mon_add_pids(const unsigned num_pids,
                 const pid_t *pids,
@@ -725,6 +1205,8 @@ os_mon_add_pids(const unsigned num_pids,
         added.tid_map = tid_map;
         added.event = group->event;
         added.num_pids = num_pids;
+        /* never remove the named group when rolling back */
+        added.resctrl_mon_flags = group->resctrl_mon_flags & RESCTRL_MON_KEEP;
         if (group->resctrl_mon_group != NULL) {
                 added.resctrl_mon_group = strdup(group->resctrl_mon_group);
                 if (added.resctrl_mon_group == NULL) {
@@ -893,6 +1375,54 @@ os_mon_remove_pids_exit:
         return ret;
 }
 
+int
+os_mon_poll_snapshot(struct pqos_mon_data **groups,
+                     const unsigned num_groups,
+                     struct pqos_mon_snapshot *snapshot)
+{
+        uint64_t *timestamp;
+        int *failed;
+        unsigned i;
+
+        ASSERT(groups != NULL);
+        ASSERT(num_groups > 0);
+        ASSERT(snapshot != NULL);
+
+        timestamp = calloc(num_groups, sizeof(timestamp[0]));
+        failed = calloc(num_groups, sizeof(failed[0]));
+        if (timestamp == NULL || failed == NULL) {
+                free(timestamp);
+                free(failed);
+                return PQOS_RETVAL_RESOURCE;
+        }
+
+        /**
+         * Perf and resctrl reads update deltas on the fly, so only the
+         * rate computation is deferred until all groups are read
+         */
+        snapshot->timestamp = mon_timestamp();
+        for (i = 0; i < num_groups; i++) {
+                failed[i] = poll_events(groups[i]) != PQOS_RETVAL_OK;
+                timestamp[i] = mon_timestamp();
+        }
+        snapshot->max_skew = timestamp[num_groups - 1] - snapshot->timestamp;
+
+        for (i = 0; i < num_groups; i++) {
+                if (failed[i]) {
+                        LOG_WARN("Failed to poll event on "
+                                 "group number %u\n",
+                                 i);
+                        continue;
+                }
+                mon_snapshot_update(groups[i], timestamp[i]);
+        }
+
+        free(timestamp);
+        free(failed);
+
+        return PQOS_RETVAL_OK;
+}
+
 int
 os_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups)
 {
@@ -108,6 +108,65 @@ int os_mon_start(const unsigned num_cores,
                  void *context,
                  struct pqos_mon_data *group);
 
+/**
+ * @brief OS interface to start named monitoring groups
+ *
+ * @param [in] num_groups number of groups to start
+ * @param [in] cfg table of group configurations
+ * @param [in,out] groups table of monitoring structures
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int os_mon_start_named(const unsigned num_groups,
+                       const struct pqos_mon_named *cfg,
+                       struct pqos_mon_data **groups);
+
+/**
+ * @brief OS interface to start monitoring of default resctrl groups
+ *        on the \a cluster
+ *
+ * @param [in] cluster L3 cluster id
+ * @param [in] event combination of monitoring events
+ * @param [in] context a pointer for application's convenience
+ * @param [in,out] group a pointer to monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int os_mon_start_remainder(const unsigned cluster,
+                           const enum pqos_mon_event event,
+                           void *context,
+                           struct pqos_mon_data *group);
+
+/**
+ * @brief OS interface to add cores to the monitoring group
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in,out] group a pointer to monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int os_mon_add_cores(const unsigned num_cores,
+                     const unsigned *cores,
+                     struct pqos_mon_data *group);
+
+/**
+ * @brief OS interface to remove cores from the monitoring group
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in,out] group a pointer to monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int os_mon_remove_cores(const unsigned num_cores,
+                        const unsigned *cores,
+                        struct pqos_mon_data *group);
+
 /**
  * @brief OS interface to poll monitoring data from requested groups
  *
@@ -119,6 +178,20 @@ int os_mon_start(const unsigned num_cores,
  */
 int os_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups);
 
+/**
+ * @brief OS interface to poll monitoring data as one snapshot
+ *
+ * @param [in] groups table of monitoring group pointers to be be updated
+ * @param [in] num_groups number of monitoring groups in the table
+ * @param [out] snapshot snapshot information
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int os_mon_poll_snapshot(struct pqos_mon_data **groups,
+                         const unsigned num_groups,
+                         struct pqos_mon_snapshot *snapshot);
+
 /**
  * @brief OS interface to start monitoring of selected group of \a pids
  *
@@ -86,6 +86,25 @@ perf_setup_counter(struct perf_event_attr *attr,
         return PQOS_RETVAL_OK;
 }
 
+int
+perf_probe_counter(const struct perf_event_attr *attr)
+{
+        struct perf_event_attr probe;
+        int fd;
+
+        if (attr == NULL)
+                return PQOS_RETVAL_PARAM;
+
+        probe = *attr;
+        probe.disabled = 1;
+        fd = perf_event_open(&probe, 0, -1, -1, 0);
+        if (fd < 0)
+                return PQOS_RETVAL_RESOURCE;
+        close(fd);
+
+        return PQOS_RETVAL_OK;
+}
+
 int
 perf_shutdown_counter(int counter_fd)
 {
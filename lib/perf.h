@@ -63,6 +63,20 @@ int perf_setup_counter(struct perf_event_attr *attr,
                        const unsigned long flags,
                        int *counter_fd);
 
+/**
+ * @brief Function to check if perf event counter can be opened
+ *
+ * Counter is opened disabled for the calling process and closed
+ * straight away.
+ *
+ * @param attr perf event attribute structure
+ *
+ * @return Operational status
+ * @retval PQOS_RETVAL_OK if counter can be opened
+ * @retval PQOS_RETVAL_RESOURCE if counter is not available
+ */
+int perf_probe_counter(const struct perf_event_attr *attr);
+
 /**
  * @brief Function to shutdown a perf event counter
  *
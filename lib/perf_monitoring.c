@@ -35,6 +35,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <dirent.h> /**< scandir() */
+#include <unistd.h>
+#include <sys/mman.h>
 #include <linux/perf_event.h>
 
 #include "pqos.h"
@@ -55,6 +57,17 @@
 #define OS_MON_EVT_IDX_CYC      5
 #define OS_MON_EVT_IDX_IPC      6
 #define OS_MON_EVT_IDX_LLC_MISS 7
+#define OS_MON_EVT_IDX_LLC_MISS_SAMPLE 8
+
+/**
+ * LLC miss load sampling
+ * - MEM_LOAD_RETIRED.L3_MISS precise event (Haswell and later)
+ * - number of data pages of per task sample ring buffer, power of 2
+ */
+#define PERF_LLC_MISS_SAMPLE_CONFIG 0x20d1
+#define PERF_LLC_MISS_SAMPLE_PERIOD 1000
+#define PERF_LLC_MISS_SAMPLE_PAGES 8
+#define PERF_LLC_MISS_SAMPLE_PAGE_MASK (~(uint64_t)0xfff)
 
 /**
  * ---------------------------------------
@@ -128,6 +141,10 @@ static struct perf_mon_supported_event {
      .desc = "LLC Misses",
      .event = PQOS_PERF_EVENT_LLC_MISS,
      .supported = 1}, /**< assumed support */
+    {.name = "",
+     .desc = "LLC Miss Samples",
+     .event = PQOS_PERF_EVENT_LLC_MISS_SAMPLE,
+     .supported = 0}, /**< probed on init */
 };
 
 /**
@@ -176,6 +193,8 @@ get_supported_event(const enum pqos_mon_event event)
                 return &events_tab[OS_MON_EVT_IDX_IPC];
         case PQOS_PERF_EVENT_LLC_MISS:
                 return &events_tab[OS_MON_EVT_IDX_LLC_MISS];
+        case PQOS_PERF_EVENT_LLC_MISS_SAMPLE:
+                return &events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE];
         default:
                 ASSERT(0);
                 return NULL;
@@ -258,9 +277,47 @@ set_arch_event_attrs(enum pqos_mon_event *events)
 
         *events |= (enum pqos_mon_event)PQOS_PERF_EVENT_IPC;
 
+        /* Set precise LLC miss load sampling attributes */
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].attrs = attr;
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].attrs.type = PERF_TYPE_RAW;
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].attrs.config =
+            PERF_LLC_MISS_SAMPLE_CONFIG;
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].attrs.sample_period =
+            PERF_LLC_MISS_SAMPLE_PERIOD;
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].attrs.sample_type =
+            PERF_SAMPLE_IP | PERF_SAMPLE_ADDR;
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].attrs.precise_ip = 2;
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].attrs.exclude_hv = 1;
+
         return PQOS_RETVAL_OK;
 }
 
+/**
+ * @brief Detects precise LLC miss load sampling support
+ *
+ * Sampling uses Intel specific raw event, the event is opened once
+ * to check that the CPU and kernel support it.
+ *
+ * @param [in] cpu cpu information structure
+ * @param [out] events event mask to be updated
+ */
+static void
+set_sample_event(const struct pqos_cpuinfo *cpu, enum pqos_mon_event *events)
+{
+        struct perf_mon_supported_event *se =
+            &events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE];
+
+        se->supported = 0;
+        if (cpu->vendor != PQOS_VENDOR_INTEL ||
+            perf_probe_counter(&se->attrs) != PQOS_RETVAL_OK) {
+                LOG_INFO("Precise LLC miss load sampling not supported\n");
+                return;
+        }
+
+        se->supported = 1;
+        *events |= PQOS_PERF_EVENT_LLC_MISS_SAMPLE;
+}
+
 /**
  * @brief Sets RDT perf event attributes
  *
@@ -423,6 +480,8 @@ perf_mon_init(const struct pqos_cpuinfo *cpu, const struct pqos_cap *cap)
         if (ret != PQOS_RETVAL_OK)
                 return ret;
 
+        set_sample_event(cpu, &all_evt_mask);
+
         /* Set RDT perf attribute type */
         ret = set_mon_type();
         if (ret != PQOS_RETVAL_OK)
@@ -471,11 +530,179 @@ perf_mon_get_fd(struct pqos_mon_perf_ctx *ctx, const enum pqos_mon_event event)
                 return &ctx->fd_cyc;
         case (enum pqos_mon_event)PQOS_PERF_EVENT_INSTRUCTIONS:
                 return &ctx->fd_inst;
+        case PQOS_PERF_EVENT_LLC_MISS_SAMPLE:
+                return &ctx->fd_llc_sample;
         default:
                 return NULL;
         }
 }
 
+/**
+ * @brief Gets size of the sample ring buffer mapping
+ *
+ * @return size of metadata page and data pages in bytes
+ */
+static size_t
+perf_mon_sample_buf_size(void)
+{
+        return (size_t)(PERF_LLC_MISS_SAMPLE_PAGES + 1) *
+               (size_t)sysconf(_SC_PAGESIZE);
+}
+
+/**
+ * @brief Copies data out of the sample ring buffer
+ *
+ * @param [in] data start of the ring data pages
+ * @param [in] size size of the ring data in bytes
+ * @param [in] offset ring offset to copy from, may exceed \a size
+ * @param [out] dst destination buffer
+ * @param [in] len number of bytes to copy
+ */
+static void
+perf_mon_sample_copy(const uint8_t *data,
+                     const uint64_t size,
+                     const uint64_t offset,
+                     void *dst,
+                     const size_t len)
+{
+        const uint64_t pos = offset & (size - 1);
+        const size_t first = (size_t)(size - pos) < len ? (size_t)(size - pos)
+                                                        : len;
+
+        memcpy(dst, data + pos, first);
+        if (first < len)
+                memcpy((uint8_t *)dst + first, data, len - first);
+}
+
+/**
+ * @brief Adds sample to the bounded table of most frequent addresses
+ *
+ * Space-saving algorithm: when the table is full, the least sampled
+ * entry is replaced and its count is inherited by the new address.
+ *
+ * @param [in,out] table table of addresses
+ * @param [in,out] num number of valid entries in \a table
+ * @param [in] addr sampled address
+ */
+static void
+perf_mon_sample_add(struct pqos_mon_sample *table,
+                    unsigned *num,
+                    const uint64_t addr)
+{
+        unsigned i, min = 0;
+
+        for (i = 0; i < *num; i++) {
+                if (table[i].addr == addr) {
+                        table[i].count++;
+                        return;
+                }
+                if (table[i].count < table[min].count)
+                        min = i;
+        }
+
+        if (*num < PQOS_MON_SAMPLE_MAX) {
+                table[*num].addr = addr;
+                table[*num].count = 1;
+                (*num)++;
+                return;
+        }
+        table[min].addr = addr;
+        table[min].count++;
+}
+
+/**
+ * @brief Compares samples by count, descending
+ *
+ * @param a sample
+ * @param b sample
+ *
+ * @return comparison result for qsort()
+ */
+static int
+perf_mon_sample_cmp(const void *a, const void *b)
+{
+        const struct pqos_mon_sample *sa = (const struct pqos_mon_sample *)a;
+        const struct pqos_mon_sample *sb = (const struct pqos_mon_sample *)b;
+
+        return (sa->count < sb->count) - (sa->count > sb->count);
+}
+
+/**
+ * @brief Drains sample ring buffer of one core/task
+ *
+ * @param [in] buf mmap'ed ring buffer
+ * @param [in,out] samples sample tables, samples are discarded if NULL
+ */
+static void
+perf_mon_sample_drain(void *buf, struct pqos_mon_samples *samples)
+{
+        struct perf_event_mmap_page *meta = (struct perf_event_mmap_page *)buf;
+        const uint64_t size =
+            (uint64_t)PERF_LLC_MISS_SAMPLE_PAGES * sysconf(_SC_PAGESIZE);
+        const uint8_t *data = (const uint8_t *)buf + sysconf(_SC_PAGESIZE);
+        uint64_t head, tail;
+
+        head = __atomic_load_n(&meta->data_head, __ATOMIC_ACQUIRE);
+        tail = meta->data_tail;
+
+        while (tail < head) {
+                struct perf_event_header hdr;
+                uint64_t rec[2]; /**< ip & addr or id & lost */
+
+                perf_mon_sample_copy(data, size, tail, &hdr, sizeof(hdr));
+                if (hdr.size < sizeof(hdr))
+                        break;
+
+                if (samples != NULL && hdr.size >= sizeof(hdr) + sizeof(rec) &&
+                    (hdr.type == PERF_RECORD_SAMPLE ||
+                     hdr.type == PERF_RECORD_LOST)) {
+                        perf_mon_sample_copy(data, size, tail + sizeof(hdr),
+                                             rec, sizeof(rec));
+                        if (hdr.type == PERF_RECORD_LOST)
+                                samples->lost += rec[1];
+                        else {
+                                samples->total++;
+                                perf_mon_sample_add(samples->ips,
+                                                    &samples->num_ips, rec[0]);
+                                if (rec[1] != 0)
+                                        perf_mon_sample_add(
+                                            samples->pages, &samples->num_pages,
+                                            rec[1] &
+                                                PERF_LLC_MISS_SAMPLE_PAGE_MASK);
+                        }
+                }
+                tail += hdr.size;
+        }
+
+        __atomic_store_n(&meta->data_tail, tail, __ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Maps sample ring buffer of started sampling event
+ *
+ * @param [in,out] ctx perf poll context
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+perf_mon_sample_map(struct pqos_mon_perf_ctx *ctx)
+{
+        void *buf = mmap(NULL, perf_mon_sample_buf_size(),
+                         PROT_READ | PROT_WRITE, MAP_SHARED,
+                         ctx->fd_llc_sample, 0);
+
+        if (buf == MAP_FAILED) {
+                LOG_ERROR("Failed to map perf sample buffer!\n");
+                perf_shutdown_counter(ctx->fd_llc_sample);
+                ctx->llc_sample_buf = NULL;
+                return PQOS_RETVAL_ERROR;
+        }
+        ctx->llc_sample_buf = buf;
+
+        return PQOS_RETVAL_OK;
+}
+
 int
 perf_mon_start(struct pqos_mon_data *group, enum pqos_mon_event event)
 {
@@ -522,6 +749,9 @@ perf_mon_start(struct pqos_mon_data *group, enum pqos_mon_event event)
                  * Otherwise, pass list of TID's
                  */
                 ret = perf_setup_counter(&se->attrs, tid, core, -1, 0, fd);
+                if (ret == PQOS_RETVAL_OK &&
+                    event == PQOS_PERF_EVENT_LLC_MISS_SAMPLE)
+                        ret = perf_mon_sample_map(ctx);
                 if (ret != PQOS_RETVAL_OK) {
                         LOG_ERROR("Failed to start perf "
                                   "counters for %s\n",
@@ -529,6 +759,9 @@ perf_mon_start(struct pqos_mon_data *group, enum pqos_mon_event event)
                         return PQOS_RETVAL_ERROR;
                 }
         }
+        if (event == PQOS_PERF_EVENT_LLC_MISS_SAMPLE &&
+            group->samples != NULL)
+                group->samples->period = se->attrs.sample_period;
 
         return PQOS_RETVAL_OK;
 }
@@ -561,6 +794,12 @@ perf_mon_stop(struct pqos_mon_data *group, enum pqos_mon_event event)
                 if (fd == NULL)
                         return PQOS_RETVAL_ERROR;
 
+                if (event == PQOS_PERF_EVENT_LLC_MISS_SAMPLE &&
+                    ctx->llc_sample_buf != NULL) {
+                        munmap(ctx->llc_sample_buf,
+                               perf_mon_sample_buf_size());
+                        ctx->llc_sample_buf = NULL;
+                }
                 perf_shutdown_counter(*fd);
         }
 
@@ -605,6 +844,26 @@ perf_mon_poll(struct pqos_mon_data *group, enum pqos_mon_event event)
         else
                 return PQOS_RETVAL_ERROR;
 
+        /**
+         * Aggregate samples of each task
+         */
+        if (event == PQOS_PERF_EVENT_LLC_MISS_SAMPLE) {
+                for (i = 0; i < num_ctrs; i++)
+                        if (group->perf[i].llc_sample_buf != NULL)
+                                perf_mon_sample_drain(
+                                    group->perf[i].llc_sample_buf,
+                                    group->samples);
+                if (group->samples != NULL) {
+                        qsort(group->samples->ips, group->samples->num_ips,
+                              sizeof(group->samples->ips[0]),
+                              perf_mon_sample_cmp);
+                        qsort(group->samples->pages, group->samples->num_pages,
+                              sizeof(group->samples->pages[0]),
+                              perf_mon_sample_cmp);
+                }
+                return PQOS_RETVAL_OK;
+        }
+
         /**
          * For each task read counter and sum of all counter values
          */
@@ -57,7 +57,7 @@ extern "C" {
  * =======================================
  */
 
-#define PQOS_VERSION      30200 /**< version 3.2.0 */
+#define PQOS_VERSION      40000 /**< version 4.0.0 */
 #define PQOS_MAX_COS      16    /** 16 x COS */
 #define PQOS_MAX_L3CA_COS PQOS_MAX_COS
 #define PQOS_MAX_L2CA_COS PQOS_MAX_COS
@@ -177,6 +177,14 @@ struct pqos_config {
  * @retval PQOS_RETVAL_OK on success
  * @note   If you require system wide interface enforcement you can do so by
  *         setting the "RDT_IFACE" environment variable.
+ * @note   With the MSR interface RMID counters are read on one
+ *         non-isolated core per L3 cluster. Cores to use can be set with
+ *         the "RDT_MON_READ_CORES" environment variable (e.g. "0,28"),
+ *         "none" reads counters on the monitored cores.
+ * @note   Capability discovery and allocation/monitoring initialization
+ *         are done on first use of a technology. Errors from these steps
+ *         are reported by the first API call that needs them, and failed
+ *         module initialization is reported by every later call too.
  */
 int pqos_init(const struct pqos_config *config);
 
@@ -277,6 +285,8 @@ enum pqos_mon_event {
         RESERVED2 = 0x2000,
         PQOS_PERF_EVENT_LLC_MISS = 0x4000, /**< LLC misses */
         PQOS_PERF_EVENT_IPC = 0x8000,      /**< instructions per clock */
+        PQOS_PERF_EVENT_LLC_MISS_SAMPLE = 0x10000, /**< precise LLC miss load
+                                                      sampling, tasks only */
 };
 
 /**
@@ -437,6 +447,36 @@ struct pqos_mon_perf_ctx {
         int fd_inst;
         int fd_cyc;
         int fd_llc_misses;
+        int fd_llc_sample;
+        void *llc_sample_buf; /**< mmap'ed perf sample ring buffer */
+};
+
+#define PQOS_MON_SAMPLE_MAX 32 /**< size of LLC miss sample tables */
+
+/**
+ * LLC miss sample aggregate
+ */
+struct pqos_mon_sample {
+        uint64_t addr;  /**< instruction address or data page address */
+        uint64_t count; /**< number of samples, may overestimate by at most
+                           the count of the least sampled table entry */
+};
+
+/**
+ * LLC miss samples of the monitoring group
+ *
+ * Samples are aggregated since the group was started into bounded
+ * tables of most frequent instruction addresses and data pages.
+ * Tables are sorted by count, most sampled first.
+ */
+struct pqos_mon_samples {
+        uint64_t period; /**< LLC miss loads per sample */
+        uint64_t total;  /**< number of samples taken */
+        uint64_t lost;   /**< samples lost on ring buffer overflow */
+        unsigned num_ips;
+        struct pqos_mon_sample ips[PQOS_MON_SAMPLE_MAX];
+        unsigned num_pages;
+        struct pqos_mon_sample pages[PQOS_MON_SAMPLE_MAX];
 };
 
 /**
@@ -486,6 +526,49 @@ struct pqos_mon_data {
         unsigned num_cores;                 /**< number of cores in the group */
         int valid_mbm_read;                 /**< flag to discard 1st invalid
                                                read */
+
+        /**
+         * Group set section
+         */
+        struct pqos_mon_set *set; /**< owning group set, NULL for groups
+                                     started with pqos_mon_start() */
+
+        /**
+         * Remainder specific section
+         */
+        int remainder; /**< group monitors activity of the cluster not
+                          assigned to any monitoring group */
+
+        /**
+         * Snapshot specific section
+         */
+        uint64_t read_time;     /**< time of the last snapshot read [ns] */
+        uint64_t read_interval; /**< time between the last two snapshot
+                                   reads of the group [ns] */
+        double mbm_local_rate;  /**< local memory bandwidth [B/s] */
+        double mbm_total_rate;  /**< total memory bandwidth [B/s] */
+        double mbm_remote_rate; /**< remote memory bandwidth [B/s] */
+
+        /**
+         * Sampling specific section
+         */
+        struct pqos_mon_samples *samples; /**< LLC miss samples, NULL unless
+                                             PQOS_PERF_EVENT_LLC_MISS_SAMPLE
+                                             is monitored */
+
+        /**
+         * Named group specific section
+         */
+        unsigned resctrl_mon_flags; /**< named mon group flags */
+};
+
+/**
+ * Monitoring snapshot information
+ */
+struct pqos_mon_snapshot {
+        uint64_t timestamp; /**< time of the first read in the snapshot [ns] */
+        uint64_t max_skew;  /**< time between the first and the last read
+                               in the snapshot [ns] */
 };
 
 /**
@@ -562,6 +645,10 @@ int pqos_mon_start_pid(const pid_t pid,
  *             (unused by the library)
  * @param [in,out] group a pointer to monitoring structure
  *
+ * PQOS_PERF_EVENT_LLC_MISS_SAMPLE can be added to \a event to sample
+ * LLC miss loads of the tasks with precise (PEBS) events. Samples are
+ * aggregated in \a group->samples on every poll.
+ *
  * @return Operations status
  * @retval PQOS_RETVAL_OK on success
  */
@@ -571,6 +658,50 @@ int pqos_mon_start_pids(const unsigned num_pids,
                         void *context,
                         struct pqos_mon_data *group);
 
+#define PQOS_MON_NAME_MAX 64 /**< size limit of named mon group name */
+
+/**
+ * Named monitoring group configuration
+ */
+struct pqos_mon_named {
+        const char *name;          /**< resctrl mon group name */
+        unsigned num_cores;        /**< number of cores, 0 for task group */
+        const unsigned *cores;     /**< cores to monitor */
+        unsigned num_pids;         /**< number of pids, 0 for core group */
+        const pid_t *pids;         /**< processes to monitor */
+        enum pqos_mon_event event; /**< monitoring events */
+        int keep;                  /**< leave mon group in place on stop */
+        void *context;             /**< application specific context */
+};
+
+/**
+ * @brief Starts monitoring groups in named resctrl monitoring groups
+ *
+ * Groups are started in order. A resctrl mon group that already exists
+ * with the same name is adopted only if it monitors exactly the cores or
+ * tasks of \a cfg, its counters then continue. An existing group with
+ * other members is not modified and the call fails with
+ * PQOS_RETVAL_RESOURCE. Missing groups are created.
+ * Groups with \a keep set are left in place by pqos_mon_stop(), so
+ * a restarted application adopts them instantly without churning RMIDs.
+ *
+ * Bandwidth deltas of an adopted group start from the time of this call.
+ *
+ * If any group fails to start, groups started by this call are stopped.
+ * Available for OS interface only.
+ *
+ * @param [in] num_groups number of groups to start
+ * @param [in] cfg table of \a num_groups group configurations
+ * @param [in,out] groups table of \a num_groups monitoring structures
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_RESOURCE if mon group exists with other members
+ */
+int pqos_mon_start_named(const unsigned num_groups,
+                         const struct pqos_mon_named *cfg,
+                         struct pqos_mon_data **groups);
+
 /**
  * @brief Adds pids to the resource monitoring grpup
  *
@@ -599,6 +730,67 @@ int pqos_mon_remove_pids(const unsigned num_pids,
                          const pid_t *pids,
                          struct pqos_mon_data *group);
 
+/**
+ * @brief Starts monitoring of the unmonitored remainder of the cluster
+ *
+ * Group reports LLC occupancy and memory bandwidth of all activity on
+ * the \a cluster that is not subject to any monitoring group, without
+ * allocating RMID. For MSR interface RMID0 is read. For OS interface
+ * values of default resctrl groups are computed from mon_data of the
+ * control groups.
+ *
+ * Only PQoS events (LLC occupancy and MBM) can be selected.
+ * The group is polled with pqos_mon_poll() and stopped with pqos_mon_stop().
+ *
+ * @param [in] cluster L3 cluster id
+ * @param [in] event combination of monitoring events
+ * @param [in] context a pointer for application's convenience
+ *            (unused by the library)
+ * @param [in,out] group a pointer to monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_start_remainder(const unsigned cluster,
+                             const enum pqos_mon_event event,
+                             void *context,
+                             struct pqos_mon_data *group);
+
+/**
+ * @brief Adds cores to the core monitoring group
+ *
+ * Only the added cores are associated with the group RMID (MSR interface)
+ * or resctrl monitoring group (OS interface). Accumulated counters of the
+ * group are preserved.
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in,out] group monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_add_cores(const unsigned num_cores,
+                       const unsigned *cores,
+                       struct pqos_mon_data *group);
+
+/**
+ * @brief Removes cores from the core monitoring group
+ *
+ * Group keeps at least one core. Accumulated counters of the group
+ * are preserved.
+ *
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in,out] group monitoring structure
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_remove_cores(const unsigned num_cores,
+                          const unsigned *cores,
+                          struct pqos_mon_data *group);
+
 /**
  * @brief Stops resource monitoring data for selected monitoring group
  *
@@ -620,6 +812,188 @@ int pqos_mon_stop(struct pqos_mon_data *group);
  */
 int pqos_mon_poll(struct pqos_mon_data **groups, const unsigned num_groups);
 
+/**
+ * @brief Polls monitoring data from requested groups as one snapshot
+ *
+ * Raw counters of all groups, including IPC and LLC miss counters, are
+ * read first in one pass and the read time of each group is recorded.
+ * Deltas are computed afterwards and memory bandwidth rates are normalized
+ * to the interval between the two last reads of each group. Rates are
+ * valid from the second snapshot on.
+ *
+ * @param [in] groups table of monitoring group pointers to be be updated
+ * @param [in] num_groups number of monitoring groups in the table
+ * @param [out] snapshot snapshot information, can be NULL
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_poll_snapshot(struct pqos_mon_data **groups,
+                           const unsigned num_groups,
+                           struct pqos_mon_snapshot *snapshot);
+
+/**
+ * Monitoring group set.
+ *
+ * Groups in the set are carved out of one memory arena together with
+ * their core lists and poll contexts. Poll contexts of all groups are
+ * kept contiguously, sorted by cluster, so that polling large numbers
+ * of groups does not chase pointers around the heap or allocate memory.
+ */
+struct pqos_mon_set;
+
+/**
+ * @brief Creates monitoring group set
+ *
+ * @param [in] max_groups maximum number of groups in the set
+ * @param [in] max_cores maximum number of cores across all groups
+ * @param [out] set place to store pointer to created group set
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_RESOURCE if memory allocation failed
+ */
+int pqos_mon_set_create(const unsigned max_groups,
+                        const unsigned max_cores,
+                        struct pqos_mon_set **set);
+
+/**
+ * @brief Starts resource monitoring on selected group of cores within
+ *        the group set
+ *
+ * Group structure is owned by the set. It must not be stopped with
+ * pqos_mon_stop(); use pqos_mon_set_destroy() instead.
+ *
+ * Only the MSR interface carves core lists and poll contexts out of the
+ * set arena. With the OS interface the group structure is taken from the
+ * set but its core list is allocated from the heap, groups are polled
+ * one by one and \a max_cores of the set is not enforced.
+ *
+ * @param [in] set group set
+ * @param [in] num_cores number of cores in \a cores array
+ * @param [in] cores array of logical core id's
+ * @param [in] event combination of monitoring events
+ * @param [in] context a pointer for application's convenience
+ *            (unused by the library)
+ * @param [out] group place to store pointer to started monitoring group
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_RESOURCE if the set has no space left
+ */
+int pqos_mon_set_start(struct pqos_mon_set *set,
+                       const unsigned num_cores,
+                       const unsigned *cores,
+                       const enum pqos_mon_event event,
+                       void *context,
+                       struct pqos_mon_data **group);
+
+/**
+ * @brief Polls monitoring data for all groups in the set
+ *
+ * @param [in] set group set
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_set_poll(struct pqos_mon_set *set);
+
+/**
+ * @brief Stops all monitoring groups in the set and frees the set
+ *
+ * @param [in] set group set
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_set_destroy(struct pqos_mon_set *set);
+
+/**
+ * Adaptive sampler configuration
+ */
+struct pqos_mon_sampler_config {
+        unsigned min_interval; /**< shortest sampling interval [us] */
+        unsigned max_interval; /**< longest sampling interval [us] */
+        unsigned read_budget;  /**< max number of group reads per second,
+                                  0 for no limit; not met if it needs
+                                  intervals above max_interval */
+        double llc_threshold;  /**< LLC occupancy [B] to sample at the
+                                  shortest interval when approached,
+                                  0 to disable */
+        double mbm_threshold;  /**< memory bandwidth [B/s] to sample at
+                                  the shortest interval when approached,
+                                  0 to disable */
+};
+
+/**
+ * Adaptive sampler.
+ *
+ * Sampling interval of each group shrinks when variance of its memory
+ * bandwidth or LLC occupancy rises or a threshold is approached, and
+ * stretches when the group is stable. Intervals are scaled together to
+ * keep number of group reads per second within the budget.
+ *
+ * The sampler does not own the groups and is not thread safe.
+ */
+struct pqos_mon_sampler;
+
+/**
+ * @brief Creates adaptive sampler for started monitoring groups
+ *
+ * @param [in] cfg sampler configuration
+ * @param [in] groups table of started monitoring groups
+ * @param [in] num_groups number of monitoring groups in the table
+ * @param [out] sampler place to store pointer to created sampler
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_sampler_create(const struct pqos_mon_sampler_config *cfg,
+                            struct pqos_mon_data **groups,
+                            const unsigned num_groups,
+                            struct pqos_mon_sampler **sampler);
+
+/**
+ * @brief Polls groups whose sampling interval has elapsed
+ *
+ * Groups are read with pqos_mon_poll_snapshot() so rates in the groups
+ * are normalized to the group's own interval.
+ *
+ * @param [in] sampler sampler
+ * @param [out] num_polled number of groups read, can be NULL
+ * @param [out] next_poll time to the next due group [us], can be NULL
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_sampler_poll(struct pqos_mon_sampler *sampler,
+                          unsigned *num_polled,
+                          unsigned *next_poll);
+
+/**
+ * @brief Reads current sampling interval of the group
+ *
+ * @param [in] sampler sampler
+ * @param [in] group monitoring group handled by the sampler
+ * @param [out] interval sampling interval before budget scaling [us]
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_sampler_get_interval(const struct pqos_mon_sampler *sampler,
+                                  const struct pqos_mon_data *group,
+                                  unsigned *interval);
+
+/**
+ * @brief Frees the sampler, monitoring groups are not stopped
+ *
+ * @param [in] sampler sampler
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int pqos_mon_sampler_destroy(struct pqos_mon_sampler *sampler);
+
 /*
  * =======================================
  * Allocation Technology
@@ -941,6 +1315,128 @@ int pqos_mba_get(const unsigned mba_id,
                  unsigned *num_cos,
                  struct pqos_mba *mba_tab);
 
+/*
+ * =======================================
+ * Hardware prefetcher control
+ * =======================================
+ */
+
+/**
+ * Hardware prefetchers, bit set means the prefetcher is enabled
+ */
+#define PQOS_PREFETCH_L2_HW  (1 << 0) /**< L2 hardware prefetcher */
+#define PQOS_PREFETCH_L2_ADJ (1 << 1) /**< L2 adjacent line prefetcher */
+#define PQOS_PREFETCH_DCU    (1 << 2) /**< L1 DCU next line prefetcher */
+#define PQOS_PREFETCH_DCU_IP (1 << 3) /**< L1 DCU IP prefetcher */
+#define PQOS_PREFETCH_ALL                                                      \
+        (PQOS_PREFETCH_L2_HW | PQOS_PREFETCH_L2_ADJ | PQOS_PREFETCH_DCU |      \
+         PQOS_PREFETCH_DCU_IP)
+
+/**
+ * @brief Enables selected hardware prefetchers on \a lcore
+ *
+ * Prefetchers not selected in \a enabled are disabled.
+ *
+ * @param [in] lcore CPU logical core id
+ * @param [in] enabled mask of PQOS_PREFETCH_* prefetchers to enable
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_RESOURCE if prefetcher control is not supported
+ */
+int pqos_prefetch_set(const unsigned lcore, const unsigned enabled);
+
+/**
+ * @brief Reads hardware prefetchers enabled on \a lcore
+ *
+ * @param [in] lcore CPU logical core id
+ * @param [out] enabled mask of enabled PQOS_PREFETCH_* prefetchers
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_RESOURCE if prefetcher control is not supported
+ */
+int pqos_prefetch_get(const unsigned lcore, unsigned *enabled);
+
+/**
+ * @brief Enables selected hardware prefetchers on all cores
+ *        associated with class of service \a class_id
+ *
+ * Prefetcher state is a per core setting. Cores associated with
+ * \a class_id later on keep their current prefetcher state.
+ *
+ * @param [in] class_id class of service
+ * @param [in] enabled mask of PQOS_PREFETCH_* prefetchers to enable
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_RESOURCE if prefetcher control is not supported
+ */
+int pqos_prefetch_cos_set(const unsigned class_id, const unsigned enabled);
+
+/*
+ * =======================================
+ * Configuration change trace
+ * =======================================
+ */
+
+#define PQOS_TRACE_ENTRIES 4096 /**< number of entries kept in the trace */
+
+/**
+ * Type of traced configuration change
+ */
+enum pqos_trace_type {
+        PQOS_TRACE_ASSOC = 0,  /**< core association, id is lcore */
+        PQOS_TRACE_ASSOC_PID,  /**< task association, id is task id */
+        PQOS_TRACE_L3CA,       /**< L3 CBM, id is L3 CAT id */
+        PQOS_TRACE_L3CA_DATA,  /**< L3 CDP data CBM, id is L3 CAT id */
+        PQOS_TRACE_L3CA_CODE,  /**< L3 CDP code CBM, id is L3 CAT id */
+        PQOS_TRACE_L2CA,       /**< L2 CBM, id is L2 id */
+        PQOS_TRACE_L2CA_DATA,  /**< L2 CDP data CBM, id is L2 id */
+        PQOS_TRACE_L2CA_CODE,  /**< L2 CDP code CBM, id is L2 id */
+        PQOS_TRACE_MBA,        /**< MBA rate or MBps, id is MBA id */
+        PQOS_TRACE_PREFETCH,   /**< enabled prefetchers, id is lcore */
+        PQOS_TRACE_RESET       /**< allocation reset */
+};
+
+/**
+ * Configuration change trace entry
+ */
+struct pqos_trace_entry {
+        uint64_t seq;              /**< sequence number of the change */
+        uint64_t tsc;              /**< TSC value at the time of change */
+        uint64_t time;             /**< wall clock time [us] */
+        pid_t pid;                 /**< process making the change */
+        enum pqos_trace_type type; /**< type of change */
+        unsigned id;               /**< resource id, core or task */
+        unsigned class_id;         /**< class of service */
+        uint64_t old_value;        /**< value before the change */
+        uint64_t new_value;        /**< value after the change */
+};
+
+/**
+ * @brief Reads recent configuration changes
+ *
+ * Successful COS definition, association, MBA, prefetcher and reset
+ * operations are recorded, values that did not change are skipped.
+ * Old value of a class definition is read from the resource before the
+ * change. When possible the trace is shared by all processes
+ * using the library, otherwise changes made by this process only are
+ * available. The trace file is used only when owned by the effective user
+ * and not writable by group or others.
+ *
+ * @param [in] max_num maximum number of entries to read
+ * @param [out] num number of entries read
+ * @param [out] entries table of entries, oldest first
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_INIT if library is not initialized
+ */
+int pqos_trace_get(const unsigned max_num,
+                   unsigned *num,
+                   struct pqos_trace_entry *entries);
+
 /*
  * =======================================
  * Utility API
@@ -99,6 +99,7 @@ class CPqosMonitor(ctypes.Structure):
     RESERVED2 = 0x2000
     PQOS_PERF_EVENT_LLC_MISS = 0x4000
     PQOS_PERF_EVENT_IPC = 0x8000
+    PQOS_PERF_EVENT_LLC_MISS_SAMPLE = 0x10000
 
     _fields_ = [
         (u"type", ctypes.c_int),
@@ -90,7 +90,37 @@ class CPqosMonPerfCtx(ctypes.Structure):
         (u'fd_mbt', ctypes.c_int),
         (u'fd_inst', ctypes.c_int),
         (u'fd_cyc', ctypes.c_int),
-        (u'fd_llc_misses', ctypes.c_int)
+        (u'fd_llc_misses', ctypes.c_int),
+        (u'fd_llc_sample', ctypes.c_int),
+        (u'llc_sample_buf', ctypes.c_void_p)
+    ]
+
+
+PQOS_MON_SAMPLE_MAX = 32
+
+
+class CPqosMonSample(ctypes.Structure):
+    "pqos_mon_sample structure"
+    # pylint: disable=too-few-public-methods
+
+    _fields_ = [
+        (u'addr', ctypes.c_uint64),
+        (u'count', ctypes.c_uint64)
+    ]
+
+
+class CPqosMonSamples(ctypes.Structure):
+    "pqos_mon_samples structure"
+    # pylint: disable=too-few-public-methods
+
+    _fields_ = [
+        (u'period', ctypes.c_uint64),
+        (u'total', ctypes.c_uint64),
+        (u'lost', ctypes.c_uint64),
+        (u'num_ips', ctypes.c_uint),
+        (u'ips', CPqosMonSample * PQOS_MON_SAMPLE_MAX),
+        (u'num_pages', ctypes.c_uint),
+        (u'pages', CPqosMonSample * PQOS_MON_SAMPLE_MAX)
     ]
 
 
@@ -115,7 +145,16 @@ class CPqosMonData(ctypes.Structure):
         (u'num_poll_ctx', ctypes.c_uint),
         (u'cores', ctypes.POINTER(ctypes.c_uint)),
         (u'num_cores', ctypes.c_uint),
-        (u'valid_mbm_read', ctypes.c_int)
+        (u'valid_mbm_read', ctypes.c_int),
+        (u'set', ctypes.c_void_p),
+        (u'remainder', ctypes.c_int),
+        (u'read_time', ctypes.c_uint64),
+        (u'read_interval', ctypes.c_uint64),
+        (u'mbm_local_rate', ctypes.c_double),
+        (u'mbm_total_rate', ctypes.c_double),
+        (u'mbm_remote_rate', ctypes.c_double),
+        (u'samples', ctypes.POINTER(CPqosMonSamples)),
+        (u'resctrl_mon_flags', ctypes.c_uint)
     ]
 
     def __init__(self, *args, **kwargs):
@@ -151,6 +190,33 @@ class CPqosMonData(ctypes.Structure):
         ret = self.pqos.lib.pqos_mon_remove_pids(num_pids, pids_arr, ref)
         pqos_handle_error(u'pqos_mon_remove_pids', ret)
 
+    def get_samples(self):
+        """
+        Gets LLC miss samples of the monitoring group.
+
+        Returns:
+            a dictionary with sampling period, number of taken and lost
+            samples and lists of (address, count) tuples of the most
+            sampled instruction addresses and data pages, or None if
+            'perf_llc_miss_sample' event is not monitored
+        """
+
+        if not self.samples:
+            return None
+
+        samples = self.samples.contents
+        ips = [(samples.ips[i].addr, samples.ips[i].count)
+               for i in range(samples.num_ips)]
+        pages = [(samples.pages[i].addr, samples.pages[i].count)
+                 for i in range(samples.num_pages)]
+        return {
+            u'period': samples.period,
+            u'total': samples.total,
+            u'lost': samples.lost,
+            u'ips': ips,
+            u'pages': pages
+        }
+
     def get_ref(self):
         """
         Gets a pointer to a monitoring data.
@@ -171,7 +237,8 @@ def _get_event_mask(events):
         'tmem_bw': CPqosMonitor.PQOS_MON_EVENT_TMEM_BW,
         'rmem_bw': CPqosMonitor.PQOS_MON_EVENT_RMEM_BW,
         'perf_llc_miss': CPqosMonitor.PQOS_PERF_EVENT_LLC_MISS,
-        'perf_ipc': CPqosMonitor.PQOS_PERF_EVENT_IPC
+        'perf_ipc': CPqosMonitor.PQOS_PERF_EVENT_IPC,
+        'perf_llc_miss_sample': CPqosMonitor.PQOS_PERF_EVENT_LLC_MISS_SAMPLE
     }
 
     mask = 0
@@ -243,7 +310,8 @@ class PqosMon:
         Parameters:
             pids: a list of process IDs
             events: a list of events, available options: 'l3_occup', 'lmem_bw',
-                    'tmem_bw', 'rmem_bw', 'perf_llc_miss', 'perf_ipc'
+                    'tmem_bw', 'rmem_bw', 'perf_llc_miss', 'perf_ipc',
+                    'perf_llc_miss_sample'
             context: a pointer to additional information, by defualt None
 
         Returns:
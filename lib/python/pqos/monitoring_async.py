@@ -0,0 +1,332 @@
+################################################################################
+# BSD LICENSE
+#
+# Copyright(c) 2020 Intel Corporation. All rights reserved.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#   * Neither the name of Intel Corporation nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+
+"""
+The module defines PqosMonAsync which polls monitoring groups on a dedicated
+thread and delivers the samples to an asyncio event loop.
+"""
+
+from __future__ import absolute_import, division, print_function
+import asyncio
+import collections
+import ctypes
+import os
+import threading
+import time
+
+from pqos.common import pqos_handle_error
+from pqos.monitoring import PqosMon, CPqosMonData, CPqosEventValues
+
+
+class CPqosMonSamplerConfig(ctypes.Structure):
+    "pqos_mon_sampler_config structure"
+    # pylint: disable=too-few-public-methods
+
+    _fields_ = [
+        (u'min_interval', ctypes.c_uint),
+        (u'max_interval', ctypes.c_uint),
+        (u'read_budget', ctypes.c_uint),
+        (u'llc_threshold', ctypes.c_double),
+        (u'mbm_threshold', ctypes.c_double)
+    ]
+
+
+PqosMonSample = collections.namedtuple(u'PqosMonSample',
+                                       [u'timestamp', u'values'])
+PqosMonSample.__doc__ = u"""
+Monitoring sample.
+
+Attributes:
+    timestamp: time of the sample (time.time())
+    values: a list of CPqosEventValues copies, in order of monitored groups
+"""
+
+
+_STREAM_END = object()
+
+
+class _Notifier(object):
+    "Wakes up the event loop, eventfd based with a self-pipe fallback."
+
+    def __init__(self):
+        if hasattr(os, u'eventfd'):
+            self.rfd = os.eventfd(0, os.EFD_NONBLOCK | os.EFD_CLOEXEC)
+            self.wfd = self.rfd
+        else:
+            self.rfd, self.wfd = os.pipe()
+            os.set_blocking(self.rfd, False)
+            os.set_blocking(self.wfd, False)
+
+    def notify(self):
+        "Signals the event loop, can be called from any thread."
+
+        try:
+            os.write(self.wfd, (1).to_bytes(8, 'little'))
+        except BlockingIOError:
+            # Event loop has not drained previous notifications yet
+            pass
+
+    def drain(self):
+        "Clears pending notifications."
+
+        try:
+            while os.read(self.rfd, 4096):
+                pass
+        except BlockingIOError:
+            pass
+
+    def close(self):
+        "Closes file descriptors."
+
+        os.close(self.rfd)
+        if self.wfd != self.rfd:
+            os.close(self.wfd)
+
+
+class PqosMonStream(object):
+    "Awaitable iterator over monitoring samples."
+
+    def __init__(self, owner, maxsize):
+        self._owner = owner
+        self._queue = asyncio.Queue(maxsize=maxsize)
+
+    def _put(self, item):
+        "Queues an item, the oldest sample is dropped when queue is full."
+
+        if self._queue.full():
+            self._queue.get_nowait()
+        self._queue.put_nowait(item)
+
+    def __aiter__(self):
+        return self
+
+    async def __anext__(self):
+        item = await self._queue.get()
+
+        if item is _STREAM_END:
+            self._put(_STREAM_END)
+            raise StopAsyncIteration
+
+        if isinstance(item, Exception):
+            raise item
+
+        return item
+
+    def close(self):
+        """
+        Unsubscribes the stream from the monitor, iteration ends after
+        queued samples are consumed.
+        """
+
+        self._owner.unsubscribe(self)
+        self._put(_STREAM_END)
+
+
+class PqosMonAsync(object):
+    """
+    Asynchronous PQoS monitoring.
+
+    Groups are polled on a dedicated thread, either every interval or
+    by the library adaptive sampler when sampler_config is given. Samples
+    are passed to the event loop through an eventfd and fanned out to
+    all streams, so coroutines can consume them without blocking the loop.
+
+    The groups are updated from the polling thread, samples from the
+    streams should be used instead of reading the groups directly.
+    """
+
+    def __init__(self, groups, interval=1.0, sampler_config=None,
+                 queue_size=16):
+        """
+        Parameters:
+            groups: a list of started CPqosMonData monitoring groups
+            interval: polling interval in seconds, by default 1.0
+            sampler_config: a dictionary with CPqosMonSamplerConfig fields
+                            to poll with the library adaptive sampler,
+                            by default None
+            queue_size: maximum number of samples waiting in a stream,
+                        the oldest ones are dropped, by default 16
+        """
+
+        self.groups = list(groups)
+        self.interval = interval
+        self.sampler_config = sampler_config
+        self.queue_size = queue_size
+        self.mon = PqosMon()
+        self._samples = collections.deque(maxlen=queue_size)
+        self._streams = set()
+        self._stop = threading.Event()
+        self._thread = None
+        self._loop = None
+        self._notifier = None
+
+    def start(self, loop=None):
+        """
+        Starts the polling thread.
+
+        Parameters:
+            loop: event loop to deliver samples to, by default the running
+                  event loop
+        """
+
+        if self._thread is not None:
+            raise RuntimeError(u'Monitoring is already started')
+
+        self._loop = loop if loop is not None else asyncio.get_running_loop()
+        self._notifier = _Notifier()
+        self._loop.add_reader(self._notifier.rfd, self._dispatch)
+        self._stop.clear()
+        self._thread = threading.Thread(target=self._run,
+                                        name=u'pqos-mon-async', daemon=True)
+        self._thread.start()
+
+    def stop(self):
+        """
+        Stops the polling thread and ends all streams. Monitoring groups
+        are not stopped.
+        """
+
+        if self._thread is None:
+            return
+
+        self._stop.set()
+        self._thread.join()
+        self._thread = None
+
+        self._dispatch()
+        self._loop.remove_reader(self._notifier.rfd)
+        self._notifier.close()
+        self._notifier = None
+
+        for stream in list(self._streams):
+            stream.close()
+
+    def stream(self):
+        """
+        Subscribes a new stream of samples.
+
+        Returns:
+            PqosMonStream awaitable iterator
+        """
+
+        stream = PqosMonStream(self, self.queue_size)
+        self._streams.add(stream)
+        return stream
+
+    def unsubscribe(self, stream):
+        """
+        Removes a stream from the monitor.
+
+        Parameters:
+            stream: PqosMonStream returned by stream()
+        """
+
+        self._streams.discard(stream)
+
+    async def __aenter__(self):
+        self.start()
+        return self
+
+    async def __aexit__(self, exc_type, exc, traceback):
+        self.stop()
+
+    def _publish(self, item):
+        "Passes a sample or an error to the event loop (polling thread)."
+
+        self._samples.append(item)
+        self._notifier.notify()
+
+    def _snapshot(self):
+        "Copies current values of the groups (polling thread)."
+
+        values = [CPqosEventValues.from_buffer_copy(group.values)
+                  for group in self.groups]
+        return PqosMonSample(time.time(), values)
+
+    def _dispatch(self):
+        "Fans queued samples out to the streams (event loop thread)."
+
+        self._notifier.drain()
+        while self._samples:
+            item = self._samples.popleft()
+            for stream in list(self._streams):
+                stream._put(item)  # pylint: disable=protected-access
+
+    def _run(self):
+        "Polling thread main function."
+
+        try:
+            if self.sampler_config is None:
+                self._run_periodic()
+            else:
+                self._run_sampler()
+        except Exception as ex:  # pylint: disable=broad-except
+            self._publish(ex)
+
+    def _run_periodic(self):
+        "Polls all groups every interval."
+
+        next_poll = time.monotonic()
+        while not self._stop.is_set():
+            self.mon.poll(self.groups)
+            self._publish(self._snapshot())
+            next_poll += self.interval
+            self._stop.wait(max(0.0, next_poll - time.monotonic()))
+
+    def _run_sampler(self):
+        "Polls groups when due according to the library adaptive sampler."
+
+        lib = self.mon.pqos.lib
+        cfg = CPqosMonSamplerConfig(**self.sampler_config)
+        refs = [group.get_ref() for group in self.groups]
+        num_groups = len(self.groups)
+        groups_arr = (ctypes.POINTER(CPqosMonData) * num_groups)(*refs)
+        sampler = ctypes.c_void_p()
+
+        ret = lib.pqos_mon_sampler_create(ctypes.byref(cfg), groups_arr,
+                                          num_groups, ctypes.byref(sampler))
+        pqos_handle_error(u'pqos_mon_sampler_create', ret)
+
+        try:
+            while not self._stop.is_set():
+                num_polled = ctypes.c_uint(0)
+                next_poll = ctypes.c_uint(0)
+                ret = lib.pqos_mon_sampler_poll(sampler,
+                                                ctypes.byref(num_polled),
+                                                ctypes.byref(next_poll))
+                pqos_handle_error(u'pqos_mon_sampler_poll', ret)
+                if num_polled.value > 0:
+                    self._publish(self._snapshot())
+                self._stop.wait(next_poll.value / 1000000.0)
+        finally:
+            lib.pqos_mon_sampler_destroy(sampler)
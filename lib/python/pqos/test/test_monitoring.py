@@ -45,7 +45,8 @@ from pqos.test.helper import ctypes_ref_set_uint
 from pqos.test.mock_pqos import mock_pqos_lib
 
 from pqos.capability import CPqosMonitor
-from pqos.monitoring import PqosMon, CPqosEventValues, CPqosMonData
+from pqos.monitoring import PqosMon, CPqosEventValues, CPqosMonData, \
+    CPqosMonSamples
 
 
 class TestPqosMon(unittest.TestCase):
@@ -284,3 +285,27 @@ class TestCPqosMonData(unittest.TestCase):
         group_mock.remove_pids([555, 444, 321, 121])
 
         lib.pqos_mon_remove_pids.assert_called_once()
+
+    def test_get_samples(self):
+        "Tests get_samples() method."
+
+        group = CPqosMonData()
+        self.assertIsNone(group.get_samples())
+
+        samples = CPqosMonSamples(period=1000, total=30, lost=2, num_ips=2,
+                                  num_pages=1)
+        samples.ips[0].addr = 0x401000
+        samples.ips[0].count = 20
+        samples.ips[1].addr = 0x401234
+        samples.ips[1].count = 10
+        samples.pages[0].addr = 0x7f0000001000
+        samples.pages[0].count = 28
+        group.samples = ctypes.pointer(samples)
+
+        result = group.get_samples()
+
+        self.assertEqual(result['period'], 1000)
+        self.assertEqual(result['total'], 30)
+        self.assertEqual(result['lost'], 2)
+        self.assertEqual(result['ips'], [(0x401000, 20), (0x401234, 10)])
+        self.assertEqual(result['pages'], [(0x7f0000001000, 28)])
@@ -0,0 +1,178 @@
+################################################################################
+# BSD LICENSE
+#
+# Copyright(c) 2020 Intel Corporation. All rights reserved.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#   * Neither the name of Intel Corporation nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+
+"""
+Unit tests for monitoring_async module.
+"""
+
+from __future__ import absolute_import, division, print_function
+import asyncio
+import ctypes
+import unittest
+
+from unittest.mock import MagicMock
+
+from pqos.test.helper import ctypes_ref_set_uint
+from pqos.test.mock_pqos import mock_pqos_lib
+
+from pqos.error import PqosErrorResource
+from pqos.monitoring import CPqosEventValues, CPqosMonData
+from pqos.monitoring_async import PqosMonAsync
+
+
+def _collect(stream, count):
+    "Collects a given number of samples from a stream."
+
+    async def collect():
+        samples = []
+        async for sample in stream:
+            samples.append(sample)
+            if len(samples) == count:
+                break
+        return samples
+
+    return collect()
+
+
+class TestPqosMonAsync(unittest.TestCase):
+    "Tests for PqosMonAsync class."
+
+    @mock_pqos_lib
+    def test_poll(self, lib):
+        "Tests delivery of periodically polled samples to streams."
+
+        groups = [CPqosMonData(values=CPqosEventValues(llc=0)),
+                  CPqosMonData(values=CPqosEventValues(llc=100))]
+
+        def pqos_mon_poll_mock(groups_arr, num_groups):
+            "Mock pqos_mon_poll()."
+
+            self.assertEqual(num_groups, 2)
+            for i in range(num_groups):
+                groups_arr[i].contents.values.llc += 1
+            return 0
+
+        lib.pqos_mon_poll = MagicMock(side_effect=pqos_mon_poll_mock)
+
+        async def run():
+            async with PqosMonAsync(groups, interval=0.01) as mon:
+                streams = [mon.stream(), mon.stream()]
+                results = await asyncio.gather(
+                    *[_collect(stream, 3) for stream in streams])
+            return results
+
+        results = asyncio.run(run())
+
+        for samples in results:
+            self.assertEqual(len(samples), 3)
+            llc = [sample.values[0].llc for sample in samples]
+            self.assertEqual(llc, sorted(llc))
+            for sample in samples:
+                self.assertEqual(sample.values[1].llc,
+                                 sample.values[0].llc + 100)
+
+    @mock_pqos_lib
+    def test_stop(self, lib):
+        "Tests that streams end when monitoring is stopped."
+
+        groups = [CPqosMonData()]
+        lib.pqos_mon_poll = MagicMock(return_value=0)
+
+        async def run():
+            mon = PqosMonAsync(groups, interval=0.01)
+            mon.start()
+            stream = mon.stream()
+            await stream.__anext__()
+            mon.stop()
+            return [sample async for sample in stream]
+
+        samples = asyncio.run(run())
+
+        self.assertLessEqual(len(samples), 16)
+        self.assertTrue(all(len(sample.values) == 1 for sample in samples))
+
+    @mock_pqos_lib
+    def test_poll_error(self, lib):
+        "Tests that polling errors are raised from streams."
+
+        groups = [CPqosMonData()]
+        lib.pqos_mon_poll = MagicMock(return_value=3)
+
+        async def run():
+            async with PqosMonAsync(groups, interval=0.01) as mon:
+                await _collect(mon.stream(), 1)
+
+        with self.assertRaises(PqosErrorResource):
+            asyncio.run(run())
+
+    @mock_pqos_lib
+    def test_sampler(self, lib):
+        "Tests polling with the library adaptive sampler."
+
+        groups = [CPqosMonData(values=CPqosEventValues(llc=7))]
+
+        def pqos_mon_sampler_create_mock(cfg_ref, _groups_arr, num_groups,
+                                         _sampler_ref):
+            "Mock pqos_mon_sampler_create()."
+
+            cfg = cfg_ref._obj  # pylint: disable=protected-access
+            self.assertEqual(cfg.min_interval, 1000)
+            self.assertEqual(cfg.max_interval, 100000)
+            self.assertEqual(num_groups, 1)
+            return 0
+
+        def pqos_mon_sampler_poll_mock(_sampler, num_polled_ref,
+                                       next_poll_ref):
+            "Mock pqos_mon_sampler_poll()."
+
+            ctypes_ref_set_uint(num_polled_ref, 1)
+            ctypes_ref_set_uint(next_poll_ref, 1000)
+            return 0
+
+        lib.pqos_mon_sampler_create = \
+            MagicMock(side_effect=pqos_mon_sampler_create_mock)
+        lib.pqos_mon_sampler_poll = \
+            MagicMock(side_effect=pqos_mon_sampler_poll_mock)
+        lib.pqos_mon_sampler_destroy = MagicMock(return_value=0)
+
+        async def run():
+            config = {u'min_interval': 1000, u'max_interval': 100000}
+            async with PqosMonAsync(groups, sampler_config=config) as mon:
+                return await _collect(mon.stream(), 2)
+
+        samples = asyncio.run(run())
+
+        self.assertEqual(len(samples), 2)
+        self.assertEqual(samples[0].values[0].llc, 7)
+        lib.pqos_mon_sampler_create.assert_called_once()
+        lib.pqos_mon_sampler_destroy.assert_called_once()
@@ -329,10 +329,11 @@ resctrl_mon_cpumask_read(const unsigned class_id,
 }
 
 /**
- * @brief Read counter value
+ * @brief Read counter value of single L3 domain
  *
  * @param [in] class_id COS id
- * @param [in] resctrl_group mon group name
+ * @param [in] resctrl_group mon group name, NULL for control group
+ * @param [in] l3cat_id L3 domain id
  * @param [in] event resctrl mon event
  * @param [out] value counter value
  *
@@ -340,19 +341,18 @@ resctrl_mon_cpumask_read(const unsigned class_id,
  * @retval PQOS_RETVAL_OK on success
  */
 static int
-resctrl_mon_read_counters(const unsigned class_id,
-                          const char *resctrl_group,
-                          const enum pqos_mon_event event,
-                          uint64_t *value)
+resctrl_mon_read_counter(const unsigned class_id,
+                         const char *resctrl_group,
+                         const unsigned l3cat_id,
+                         const enum pqos_mon_event event,
+                         uint64_t *value)
 {
-        int ret = PQOS_RETVAL_OK;
-        unsigned *l3cat_ids = NULL;
-        unsigned l3cat_id_num;
-        unsigned l3cat_id;
         char buf[128];
+        char path[PATH_MAX];
         const char *name;
+        FILE *fd;
+        unsigned long long counter;
 
-        ASSERT(resctrl_group != NULL);
         ASSERT(value != NULL);
 
         switch (event) {
@@ -375,6 +375,45 @@ resctrl_mon_read_counters(const unsigned class_id,
 
         resctrl_mon_group_path(class_id, resctrl_group, NULL, buf, sizeof(buf));
 
+        snprintf(path, sizeof(path), "%s/mon_data/mon_L3_%02u/%s", buf,
+                 l3cat_id, name);
+        fd = fopen_check_symlink(path, "r");
+        if (fd == NULL)
+                return PQOS_RETVAL_ERROR;
+        if (fscanf(fd, "%llu", &counter) == 1)
+                *value = counter;
+        fclose(fd);
+
+        return PQOS_RETVAL_OK;
+}
+
+/**
+ * @brief Read counter value
+ *
+ * @param [in] class_id COS id
+ * @param [in] resctrl_group mon group name
+ * @param [in] event resctrl mon event
+ * @param [out] value counter value
+ *
+ * @return Operational status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+resctrl_mon_read_counters(const unsigned class_id,
+                          const char *resctrl_group,
+                          const enum pqos_mon_event event,
+                          uint64_t *value)
+{
+        int ret = PQOS_RETVAL_OK;
+        unsigned *l3cat_ids = NULL;
+        unsigned l3cat_id_num;
+        unsigned l3cat_id;
+
+        ASSERT(resctrl_group != NULL);
+        ASSERT(value != NULL);
+
+        *value = 0;
+
         l3cat_ids = pqos_cpu_get_l3cat_ids(m_cpu, &l3cat_id_num);
         if (l3cat_ids == NULL) {
                 ret = PQOS_RETVAL_ERROR;
@@ -382,20 +421,14 @@ resctrl_mon_read_counters(const unsigned class_id,
         }
 
         for (l3cat_id = 0; l3cat_id < l3cat_id_num; l3cat_id++) {
-                char path[PATH_MAX];
-                FILE *fd;
-                unsigned long long counter;
+                uint64_t counter;
 
-                snprintf(path, sizeof(path), "%s/mon_data/mon_L3_%02u/%s", buf,
-                         l3cat_ids[l3cat_id], name);
-                fd = fopen_check_symlink(path, "r");
-                if (fd == NULL) {
-                        ret = PQOS_RETVAL_ERROR;
+                ret = resctrl_mon_read_counter(class_id, resctrl_group,
+                                               l3cat_ids[l3cat_id], event,
+                                               &counter);
+                if (ret != PQOS_RETVAL_OK)
                         goto resctrl_mon_read_exit;
-                }
-                if (fscanf(fd, "%llu", &counter) == 1)
-                        *value += counter;
-                fclose(fd);
+                *value += counter;
         }
 
 resctrl_mon_read_exit:
@@ -405,6 +438,88 @@ resctrl_mon_read_exit:
         return ret;
 }
 
+/**
+ * @brief Read counter value of default monitoring groups on L3 domain
+ *
+ * Control group mon_data accounts for the default group of the control
+ * group and all its monitoring groups. Default group values are obtained
+ * by subtracting values of monitoring groups.
+ *
+ * @param [in] l3cat_id L3 domain id
+ * @param [in] event resctrl mon event
+ * @param [out] value counter value
+ *
+ * @return Operational status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+resctrl_mon_read_remainder(const unsigned l3cat_id,
+                           const enum pqos_mon_event event,
+                           uint64_t *value)
+{
+        const struct pqos_cap *cap;
+        unsigned max_cos;
+        unsigned cos;
+        int ret;
+
+        ASSERT(value != NULL);
+
+        _pqos_cap_get(&cap, NULL);
+
+        ret = resctrl_alloc_get_grps_num(cap, &max_cos);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        *value = 0;
+
+        cos = 0;
+        do {
+                struct dirent **namelist = NULL;
+                struct stat st;
+                char dir[256];
+                uint64_t ctrl;
+                int num_groups;
+                int i;
+
+                resctrl_mon_group_path(cos, NULL, NULL, dir, sizeof(dir));
+                if (stat(dir, &st) != 0)
+                        continue;
+
+                ret = resctrl_mon_read_counter(cos, NULL, l3cat_id, event,
+                                               &ctrl);
+                if (ret != PQOS_RETVAL_OK)
+                        return ret;
+
+                resctrl_mon_group_path(cos, "", NULL, dir, sizeof(dir));
+                num_groups = scandir(dir, &namelist, filter, NULL);
+                if (num_groups < 0) {
+                        LOG_ERROR("Failed to read monitoring groups for "
+                                  "COS %u\n",
+                                  cos);
+                        return PQOS_RETVAL_ERROR;
+                }
+
+                for (i = 0; i < num_groups; i++) {
+                        uint64_t mon = 0;
+
+                        if (ret == PQOS_RETVAL_OK)
+                                ret = resctrl_mon_read_counter(
+                                    cos, namelist[i]->d_name, l3cat_id, event,
+                                    &mon);
+                        /* counters are not read atomically */
+                        ctrl = (ctrl > mon) ? ctrl - mon : 0;
+                        free(namelist[i]);
+                }
+                free(namelist);
+                if (ret != PQOS_RETVAL_OK)
+                        return ret;
+
+                *value += ctrl;
+        } while (++cos < max_cos);
+
+        return PQOS_RETVAL_OK;
+}
+
 /**
  * @brief Check if mon group is empty (no cores/tasks assigned)
  *
@@ -602,6 +717,10 @@ resctrl_mon_assoc_set(const unsigned lcore, const char *name)
         if (ret != PQOS_RETVAL_OK)
                 return ret;
 
+        /* already assigned, e.g. adopted named group */
+        if (resctrl_cpumask_get(lcore, &cpumask))
+                return PQOS_RETVAL_OK;
+
         resctrl_cpumask_set(lcore, &cpumask);
 
         ret = resctrl_mon_cpumask_write(class_id, name, &cpumask);
@@ -613,6 +732,44 @@ resctrl_mon_assoc_set(const unsigned lcore, const char *name)
         return ret;
 }
 
+int
+resctrl_mon_assoc_unset(const unsigned lcore, const char *name)
+{
+        unsigned class_id = 0;
+        int ret;
+        char path[128];
+        struct resctrl_cpumask cpumask;
+        struct stat st;
+
+        ASSERT(name != NULL);
+
+        ret = alloc_assoc_get(lcore, &class_id);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        /* Group not present in the core's COS - nothing to do */
+        resctrl_mon_group_path(class_id, name, NULL, path, sizeof(path));
+        if (stat(path, &st) != 0)
+                return PQOS_RETVAL_OK;
+
+        ret = resctrl_mon_cpumask_read(class_id, name, &cpumask);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        if (!resctrl_cpumask_get(lcore, &cpumask))
+                return PQOS_RETVAL_OK;
+
+        resctrl_cpumask_unset(lcore, &cpumask);
+
+        ret = resctrl_mon_cpumask_write(class_id, name, &cpumask);
+        if (ret != PQOS_RETVAL_OK)
+                LOG_ERROR("Could not remove core %u from resctrl monitoring "
+                          "group\n",
+                          lcore);
+
+        return ret;
+}
+
 /* @brief Restore association of \a lcore to monitoring group
  *
  * @param [in] lcore CPU logical core id
@@ -763,12 +920,143 @@ resctrl_mon_assoc_set_pid(const pid_t task, const char *name)
         return PQOS_RETVAL_OK;
 }
 
+/**
+ * @brief Compares tasks of mon group \a name in COS \a class_id
+ *        with tasks of \a group
+ *
+ * @param [in] class_id COS id
+ * @param [in] name mon group name
+ * @param [in] group monitoring structure
+ * @param [in,out] found number of tasks of \a group in the mon group
+ * @param [out] foreign set to 1 if the mon group has tasks not in \a group
+ *
+ * @return Operational status
+ * @retval PQOS_RETVAL_OK on success
+ */
+static int
+resctrl_mon_tasks_cmp(const unsigned class_id,
+                      const char *name,
+                      const struct pqos_mon_data *group,
+                      unsigned *found,
+                      int *foreign)
+{
+        char path[256];
+        char buf[128];
+        FILE *fd;
+        int ret = PQOS_RETVAL_OK;
+
+        resctrl_mon_group_path(class_id, name, "/tasks", path, sizeof(path));
+        fd = fopen_check_symlink(path, "r");
+        if (fd == NULL)
+                return PQOS_RETVAL_ERROR;
+
+        while (fgets(buf, sizeof(buf), fd) != NULL) {
+                char *endptr = NULL;
+                pid_t value = strtol(buf, &endptr, 10);
+                unsigned i;
+
+                if (!(*buf != '\0' && (*endptr == '\0' || *endptr == '\n'))) {
+                        ret = PQOS_RETVAL_ERROR;
+                        break;
+                }
+
+                for (i = 0; i < group->tid_nr; i++)
+                        if (group->tid_map[i] == value)
+                                break;
+                if (i < group->tid_nr)
+                        (*found)++;
+                else
+                        *foreign = 1;
+        }
+
+        fclose(fd);
+
+        return ret;
+}
+
+/**
+ * @brief Checks if named group can be started in mon group \a name
+ *
+ * Existing mon group is adopted only if it monitors exactly the cores
+ * and tasks of \a group, mon groups of other owners are not modified.
+ *
+ * @param [in] group monitoring structure
+ * @param [in] name mon group name
+ * @param [out] exists set to 1 if the mon group exists in any COS
+ *
+ * @return Operational status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_RESOURCE if mon group exists with other members
+ */
+static int
+resctrl_mon_named_check(const struct pqos_mon_data *group,
+                        const char *name,
+                        int *exists)
+{
+        unsigned max_cos;
+        unsigned cos = 0;
+        const struct pqos_cap *cap;
+        struct resctrl_cpumask cpus;
+        struct resctrl_cpumask wanted;
+        unsigned found = 0;
+        int foreign = 0;
+        unsigned i;
+        int ret;
+
+        _pqos_cap_get(&cap, NULL);
+
+        ret = resctrl_alloc_get_grps_num(cap, &max_cos);
+        if (ret != PQOS_RETVAL_OK)
+                return ret;
+
+        memset(&cpus, 0, sizeof(cpus));
+        memset(&wanted, 0, sizeof(wanted));
+        for (i = 0; i < group->num_cores; i++)
+                resctrl_cpumask_set(group->cores[i], &wanted);
+
+        *exists = 0;
+        do {
+                struct resctrl_cpumask mask;
+                struct stat st;
+                char buf[128];
+
+                resctrl_mon_group_path(cos, name, NULL, buf, sizeof(buf));
+                if (stat(buf, &st) != 0)
+                        continue;
+                *exists = 1;
+
+                ret = resctrl_mon_cpumask_read(cos, name, &mask);
+                if (ret != PQOS_RETVAL_OK)
+                        return ret;
+                for (i = 0; i < sizeof(mask.tab); i++)
+                        cpus.tab[i] |= mask.tab[i];
+
+                ret = resctrl_mon_tasks_cmp(cos, name, group, &found,
+                                            &foreign);
+                if (ret != PQOS_RETVAL_OK)
+                        return ret;
+        } while (++cos < max_cos);
+
+        if (!*exists)
+                return PQOS_RETVAL_OK;
+
+        if (memcmp(&cpus, &wanted, sizeof(cpus)) != 0 || foreign ||
+            found != group->tid_nr) {
+                LOG_ERROR("Mon group %s exists with other cores or tasks\n",
+                          name);
+                return PQOS_RETVAL_RESOURCE;
+        }
+
+        return PQOS_RETVAL_OK;
+}
+
 int
 resctrl_mon_start(struct pqos_mon_data *group)
 {
         char *resctrl_group = NULL;
         char buf[128];
         int ret = PQOS_RETVAL_OK;
+        int adopted = 0;
         unsigned i;
 
         ASSERT(group != NULL);
@@ -792,6 +1080,18 @@ resctrl_mon_start(struct pqos_mon_data *group)
         } else
                 resctrl_group = group->resctrl_mon_group;
 
+        if (group->resctrl_mon_flags & RESCTRL_MON_NAMED) {
+                ret = resctrl_mon_named_check(group, resctrl_group,
+                                              &adopted);
+                if (ret != PQOS_RETVAL_OK)
+                        goto resctrl_mon_start_exit;
+                if (adopted) {
+                        LOG_INFO("Adopting existing mon group %s\n",
+                                 resctrl_group);
+                        group->resctrl_mon_flags |= RESCTRL_MON_ADOPTED;
+                }
+        }
+
         /**
          * Add pids to the resctrl group
          */
@@ -813,6 +1113,25 @@ resctrl_mon_start(struct pqos_mon_data *group)
 
         group->resctrl_mon_group = resctrl_group;
 
+        /**
+         * Counters of adopted group continue, take baseline so that the
+         * first deltas do not include traffic from before the start
+         */
+        if (adopted) {
+                const enum pqos_mon_event mbm[] = {PQOS_MON_EVENT_LMEM_BW,
+                                                   PQOS_MON_EVENT_TMEM_BW};
+
+                for (i = 0; i < DIM(mbm); i++) {
+                        if (!(group->resctrl_event & mbm[i]))
+                                continue;
+                        ret = resctrl_mon_poll(group, mbm[i]);
+                        if (ret != PQOS_RETVAL_OK)
+                                goto resctrl_mon_start_exit;
+                }
+                group->values.mbm_local_delta = 0;
+                group->values.mbm_total_delta = 0;
+        }
+
 resctrl_mon_start_exit:
         if (ret != PQOS_RETVAL_OK && group->resctrl_mon_group != resctrl_group)
                 free(resctrl_group);
@@ -839,13 +1158,23 @@ resctrl_mon_stop(struct pqos_mon_data *group)
 
         ASSERT(group != NULL);
 
+        /* Default groups are not owned by the remainder group */
+        if (group->remainder)
+                return PQOS_RETVAL_OK;
+
         _pqos_cap_get(&cap, NULL);
 
         ret = resctrl_alloc_get_grps_num(cap, &max_cos);
         if (ret != PQOS_RETVAL_OK)
                 return ret;
 
-        if (group->resctrl_mon_group != NULL) {
+        if (group->resctrl_mon_group != NULL &&
+            (group->resctrl_mon_flags & RESCTRL_MON_KEEP)) {
+                LOG_DEBUG("Keeping mon group %s\n", group->resctrl_mon_group);
+                free(group->resctrl_mon_group);
+                group->resctrl_mon_group = NULL;
+
+        } else if (group->resctrl_mon_group != NULL) {
                 cos = 0;
                 do {
                         char buf[128];
@@ -927,6 +1256,10 @@ resctrl_mon_purge(struct pqos_mon_data *group)
 
         ASSERT(group != NULL);
 
+        /* persistent groups stay in place even when empty */
+        if (group->resctrl_mon_flags & RESCTRL_MON_KEEP)
+                return PQOS_RETVAL_OK;
+
         _pqos_cap_get(&cap, NULL);
 
         ret = resctrl_alloc_get_grps_num(cap, &max_cos);
@@ -1015,6 +1348,21 @@ resctrl_mon_poll(struct pqos_mon_data *group, const enum pqos_mon_event event)
         if (ret != PQOS_RETVAL_OK)
                 return ret;
 
+        if (group->remainder) {
+                const struct pqos_coreinfo *coreinfo =
+                    pqos_cpu_get_core_info(m_cpu, group->poll_ctx[0].lcore);
+
+                if (coreinfo == NULL)
+                        return PQOS_RETVAL_ERROR;
+
+                ret = resctrl_mon_read_remainder(coreinfo->l3cat_id, event,
+                                                 &value);
+                if (ret != PQOS_RETVAL_OK)
+                        goto resctrl_mon_poll_exit;
+
+                goto resctrl_mon_poll_value;
+        }
+
         /*
          * When core COS assoc changes then kernel resets monitoring group
          * assoc. We need to restore monitoring assoc for cores
@@ -1047,6 +1395,7 @@ resctrl_mon_poll(struct pqos_mon_data *group, const enum pqos_mon_event event)
 
         } while (++cos < max_cos);
 
+resctrl_mon_poll_value:
         /**
          * Set value
          */
@@ -1072,6 +1421,20 @@ resctrl_mon_poll(struct pqos_mon_data *group, const enum pqos_mon_event event)
                 return PQOS_RETVAL_ERROR;
         }
 
+        /*
+         * Remainder counters go backwards when monitoring groups are
+         * created or removed, that is not an overflow
+         */
+        if (group->remainder) {
+                if (event == PQOS_MON_EVENT_LMEM_BW &&
+                    value < old_value)
+                        group->values.mbm_local_delta = 0;
+                else if (event == PQOS_MON_EVENT_TMEM_BW &&
+                         value < old_value)
+                        group->values.mbm_total_delta = 0;
+                goto resctrl_mon_poll_exit;
+        }
+
         /*
          * If this group is empty, save the values for
          * next poll and clear the group.
@@ -43,6 +43,13 @@
 extern "C" {
 #endif
 
+/** mon group name selected by the user */
+#define RESCTRL_MON_NAMED   (1 << 0)
+/** do not remove mon group on stop */
+#define RESCTRL_MON_KEEP    (1 << 1)
+/** mon group existed before start */
+#define RESCTRL_MON_ADOPTED (1 << 2)
+
 /**
  * @brief Initializes resctrl structures used for OS monitoring interface
  *
@@ -142,6 +149,19 @@ int resctrl_mon_assoc_get(const unsigned lcore,
  */
 int resctrl_mon_assoc_set(const unsigned lcore, const char *name);
 
+/**
+ * @brief Remove association of \a lcore with monitoring group
+ *
+ * Kernel moves the core back to the default monitoring group of its COS.
+ *
+ * @param [in] lcore CPU logical core id
+ * @param [in] name name of monitoring group
+ *
+ * @return Operations status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int resctrl_mon_assoc_unset(const unsigned lcore, const char *name);
+
 /**
  * @brief Read association of \a task with monitoring group
  *
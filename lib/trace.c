@@ -0,0 +1,270 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "trace.h"
+#include "log.h"
+#include "types.h"
+
+#ifndef TRACEFILE
+#ifdef __linux__
+#define TRACEFILE "/dev/shm/libpqos_trace"
+#endif
+#ifdef __FreeBSD__
+#define TRACEFILE "/var/tmp/libpqos_trace"
+#endif
+#endif /*!TRACEFILE*/
+
+#define TRACE_MAGIC 0x45435254 /**< "TRCE" */
+
+/**
+ * Trace slot
+ *
+ * Slot is being written while \a lock is odd. Complete entry with
+ * sequence number N has \a lock equal 2 * N + 2.
+ */
+struct trace_slot {
+        uint64_t lock;
+        struct pqos_trace_entry entry;
+};
+
+/**
+ * Trace ring, layout of the shared file
+ */
+struct trace_ring {
+        uint32_t magic;   /**< TRACE_MAGIC */
+        uint32_t size;    /**< number of slots */
+        uint64_t head;    /**< sequence number of next entry */
+        struct trace_slot slots[PQOS_TRACE_ENTRIES];
+};
+
+static struct trace_ring *m_ring = NULL;
+static int m_shared = 0;
+
+/**
+ * @brief Maps trace ring from the shared file
+ *
+ * @return mapped ring or NULL on error
+ */
+static struct trace_ring *
+trace_map(void)
+{
+        struct trace_ring *ring;
+        struct stat st;
+        int fd;
+
+        fd = open(TRACEFILE, O_RDWR | O_CREAT | O_NOFOLLOW | O_CLOEXEC,
+                  S_IRUSR | S_IWUSR);
+        if (fd < 0)
+                return NULL;
+
+        if (fstat(fd, &st) != 0) {
+                close(fd);
+                return NULL;
+        }
+
+        /* file writable by others could be used to forge the trace */
+        if (!S_ISREG(st.st_mode) || st.st_uid != geteuid() ||
+            (st.st_mode & (S_IWGRP | S_IWOTH)) != 0) {
+                LOG_WARN("Ignoring %s, not owned by effective user or "
+                         "writable by others\n",
+                         TRACEFILE);
+                close(fd);
+                return NULL;
+        }
+
+        /* file of different layout is not touched */
+        if ((st.st_size != 0 && st.st_size != sizeof(*ring)) ||
+            (st.st_size == 0 && ftruncate(fd, sizeof(*ring)) != 0)) {
+                close(fd);
+                return NULL;
+        }
+
+        ring = mmap(NULL, sizeof(*ring), PROT_READ | PROT_WRITE, MAP_SHARED,
+                    fd, 0);
+        close(fd);
+        if (ring == MAP_FAILED)
+                return NULL;
+
+        /* pqos_init() holds the API lock, new file is set up once */
+        if (ring->magic == 0 && ring->size == 0) {
+                ring->size = PQOS_TRACE_ENTRIES;
+                __atomic_store_n(&ring->magic, TRACE_MAGIC, __ATOMIC_RELEASE);
+        }
+        if (ring->magic != TRACE_MAGIC || ring->size != PQOS_TRACE_ENTRIES) {
+                munmap(ring, sizeof(*ring));
+                return NULL;
+        }
+
+        return ring;
+}
+
+int
+trace_init(void)
+{
+        if (m_ring != NULL)
+                return PQOS_RETVAL_OK;
+
+        m_ring = trace_map();
+        if (m_ring != NULL) {
+                m_shared = 1;
+                return PQOS_RETVAL_OK;
+        }
+
+        LOG_INFO("Configuration change trace is not shared\n");
+        m_ring = calloc(1, sizeof(*m_ring));
+        if (m_ring == NULL)
+                return PQOS_RETVAL_RESOURCE;
+        m_ring->magic = TRACE_MAGIC;
+        m_ring->size = PQOS_TRACE_ENTRIES;
+        m_shared = 0;
+
+        return PQOS_RETVAL_OK;
+}
+
+int
+trace_fini(void)
+{
+        if (m_ring == NULL)
+                return PQOS_RETVAL_OK;
+
+        if (m_shared)
+                munmap(m_ring, sizeof(*m_ring));
+        else
+                free(m_ring);
+        m_ring = NULL;
+        m_shared = 0;
+
+        return PQOS_RETVAL_OK;
+}
+
+/**
+ * @brief Reads time stamp counter
+ *
+ * @return TSC value
+ */
+static inline uint64_t
+trace_tsc(void)
+{
+        uint32_t lo, hi;
+
+        asm volatile("rdtsc" : "=a"(lo), "=d"(hi));
+
+        return ((uint64_t)hi << 32) | lo;
+}
+
+void
+trace_add(const enum pqos_trace_type type,
+          const unsigned id,
+          const unsigned class_id,
+          const uint64_t old_value,
+          const uint64_t new_value)
+{
+        struct trace_ring *ring = m_ring;
+        struct trace_slot *slot;
+        struct timespec ts;
+        uint64_t seq;
+
+        if (ring == NULL)
+                return;
+
+        seq = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED);
+        slot = &ring->slots[seq % PQOS_TRACE_ENTRIES];
+
+        __atomic_store_n(&slot->lock, 2 * seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        slot->entry.seq = seq;
+        slot->entry.tsc = trace_tsc();
+        if (clock_gettime(CLOCK_REALTIME, &ts) == 0)
+                slot->entry.time =
+                    (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+        else
+                slot->entry.time = 0;
+        slot->entry.pid = getpid();
+        slot->entry.type = type;
+        slot->entry.id = id;
+        slot->entry.class_id = class_id;
+        slot->entry.old_value = old_value;
+        slot->entry.new_value = new_value;
+
+        __atomic_store_n(&slot->lock, 2 * seq + 2, __ATOMIC_RELEASE);
+}
+
+int
+trace_get(const unsigned max_num,
+          unsigned *num,
+          struct pqos_trace_entry *entries)
+{
+        struct trace_ring *ring = m_ring;
+        uint64_t head, seq;
+        unsigned n = 0;
+
+        if (num == NULL || (entries == NULL && max_num != 0))
+                return PQOS_RETVAL_PARAM;
+        if (ring == NULL)
+                return PQOS_RETVAL_INIT;
+
+        head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+        seq = head > max_num ? head - max_num : 0;
+        if (head - seq > PQOS_TRACE_ENTRIES)
+                seq = head - PQOS_TRACE_ENTRIES;
+
+        for (; seq < head; seq++) {
+                const struct trace_slot *slot =
+                    &ring->slots[seq % PQOS_TRACE_ENTRIES];
+                uint64_t lock;
+
+                lock = __atomic_load_n(&slot->lock, __ATOMIC_ACQUIRE);
+                if (lock != 2 * seq + 2)
+                        continue;
+                entries[n] = slot->entry;
+                __atomic_thread_fence(__ATOMIC_ACQUIRE);
+
+                /* skip entries overwritten while being copied */
+                if (__atomic_load_n(&slot->lock, __ATOMIC_RELAXED) != lock)
+                        continue;
+                n++;
+        }
+        *num = n;
+
+        return PQOS_RETVAL_OK;
+}
@@ -0,0 +1,103 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+/**
+ * @brief Configuration change trace
+ */
+
+#ifndef __PQOS_TRACE_H__
+#define __PQOS_TRACE_H__
+
+#include "pqos.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Initializes configuration change trace
+ *
+ * Trace ring is mapped from a file shared by all library users.
+ * Process local ring is used if the file cannot be mapped.
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int trace_init(void);
+
+/**
+ * @brief Shuts down configuration change trace
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ */
+int trace_fini(void);
+
+/**
+ * @brief Records configuration change
+ *
+ * Safe to be called concurrently from multiple threads and processes.
+ *
+ * @param [in] type type of change
+ * @param [in] id resource id, core or task
+ * @param [in] class_id class of service
+ * @param [in] old_value value before the change
+ * @param [in] new_value value after the change
+ */
+void trace_add(const enum pqos_trace_type type,
+               const unsigned id,
+               const unsigned class_id,
+               const uint64_t old_value,
+               const uint64_t new_value);
+
+/**
+ * @brief Reads recent configuration changes
+ *
+ * @param [in] max_num maximum number of entries to read
+ * @param [out] num number of entries read
+ * @param [out] entries table of entries, oldest first
+ *
+ * @return Operation status
+ * @retval PQOS_RETVAL_OK on success
+ * @retval PQOS_RETVAL_INIT if trace is not initialized
+ */
+int trace_get(const unsigned max_num,
+              unsigned *num,
+              struct pqos_trace_entry *entries);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __PQOS_TRACE_H__ */
@@ -44,6 +44,7 @@
 #include "pqos.h"
 #include "types.h"
 #include "utils.h"
+#include "common.h"
 #include "cpuinfo.h"
 
 #define TOPO_OBJ_SOCKET     0
@@ -63,6 +64,14 @@ _pqos_utils_init(int interface)
         return PQOS_RETVAL_OK;
 }
 
+int
+_pqos_utils_fini(void)
+{
+        fopen_check_symlink_fini();
+
+        return PQOS_RETVAL_OK;
+}
+
 unsigned *
 pqos_cpu_get_mba_ids(const struct pqos_cpuinfo *cpu, unsigned *count)
 {
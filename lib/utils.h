@@ -53,6 +53,14 @@ extern "C" {
  */
 int _pqos_utils_init(int interface);
 
+/**
+ * @brief Shuts down utils module
+ *
+ * @return Operational status
+ * @retval PQOS_RETVAL_OK success
+ */
+int _pqos_utils_fini(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -66,7 +66,8 @@ enum sel_alloc_type {
         L3CA,
         L2CA,
         MBA,
-        MBA_CTRL
+        MBA_CTRL,
+        PREFETCH
 };
 
 /**
@@ -110,6 +111,18 @@ static struct {
         unsigned class_id;
 } sel_assoc_pid_tab[128];
 
+/**
+ * Number of COS prefetcher settings to be applied
+ */
+static unsigned sel_prefetch_num = 0;
+
+/**
+ * COS prefetcher settings, applied after core associations
+ */
+static struct {
+        unsigned class_id;
+        unsigned enabled;
+} sel_prefetch_tab[PQOS_MAX_COS];
 
 /**
  * Maintains alloc option - allocate cores or task id's
@@ -439,6 +452,23 @@ set_allocation_cos(char *str, unsigned *res_ids,
         parse_cos_mask_type(str, &update_scope, &class_id);
         mask = strtouint64(p+1);
 
+        /* prefetcher settings need core associations to be in place */
+        if (type == PREFETCH) {
+                if (mask & ~((uint64_t)PQOS_PREFETCH_ALL)) {
+                        printf("Invalid prefetcher mask 0x%llx!\n",
+                               (unsigned long long)mask);
+                        return -1;
+                }
+                if (sel_prefetch_num >= DIM(sel_prefetch_tab)) {
+                        printf("Too many prefetcher settings!\n");
+                        return -1;
+                }
+                sel_prefetch_tab[sel_prefetch_num].class_id = class_id;
+                sel_prefetch_tab[sel_prefetch_num].enabled = (unsigned)mask;
+                sel_prefetch_num++;
+                return 1;
+        }
+
         /* if MBA selected, set MBA classes */
         if (type == MBA || type == MBA_CTRL) {
                 int ctrl = (type == MBA_CTRL) ? 1 : 0;
@@ -551,6 +581,8 @@ set_allocation_class(char *str, const struct pqos_cpuinfo *cpu)
                 type = MBA;
         else if (strcasecmp(str, "mba_max") == 0)
                 type = MBA_CTRL;
+        else if (strcasecmp(str, "prefetch") == 0 && sp == NULL)
+                type = PREFETCH;
         else {
                 printf("Unrecognized allocation type: %s\n", s);
                 free(s);
@@ -681,6 +713,38 @@ set_allocation_assoc(void)
         return sel_assoc_core_num | sel_assoc_pid_num;
 }
 
+/**
+ * @brief Applies selected prefetcher settings to cores associated
+ *        with classes of service
+ *
+ * @return Number of classes set
+ * @retval 0 no prefetcher setting requested
+ * @retval negative error
+ * @retval positive success
+ */
+static int
+set_prefetch(void)
+{
+        unsigned i;
+
+        for (i = 0; i < sel_prefetch_num; i++) {
+                const unsigned class_id = sel_prefetch_tab[i].class_id;
+                const unsigned enabled = sel_prefetch_tab[i].enabled;
+                int ret = pqos_prefetch_cos_set(class_id, enabled);
+
+                if (ret == PQOS_RETVAL_RESOURCE) {
+                        printf("Prefetcher control not supported!\n");
+                        return -1;
+                } else if (ret != PQOS_RETVAL_OK) {
+                        printf("COS%u PREFETCH - FAILED!\n", class_id);
+                        return -1;
+                }
+                printf("COS%u PREFETCH => 0x%x\n", class_id, enabled);
+        }
+
+        return (int)sel_prefetch_num;
+}
+
 /**
  * @brief Verifies and translates allocation association config string into
  *        internal core table.
@@ -1023,13 +1087,14 @@ print_per_socket_config(const struct pqos_capability *cap_l3ca,
  * @param [in] is_alloc indicates if any allocation technology is present
  * @param [in] is_l3 indicates if L3 cache is present
  * @param [in] is_mon indicates if monitoring technology is present
+ * @param [in] verbose prints prefetcher state when set
  * @param [in] ci core info structure with all topology details
  */
 static void
 print_core_assoc(const int is_alloc, const int is_l3, const int is_mon,
-                 const struct pqos_coreinfo *ci)
+                 const int verbose, const struct pqos_coreinfo *ci)
 {
-        unsigned class_id = 0;
+        unsigned class_id = 0, prefetch = 0;
         pqos_rmid_t rmid = 0;
         int ret = PQOS_RETVAL_OK;
 
@@ -1054,9 +1119,13 @@ print_core_assoc(const int is_alloc, const int is_l3, const int is_mon,
                 printf("COS%u", class_id);
 
         if (is_mon && sel_interface == PQOS_INTER_MSR)
-                printf("%sRMID%u\n", is_alloc ? ", " : "", (unsigned) rmid);
-        else
-                printf("\n");
+                printf("%sRMID%u", is_alloc ? ", " : "", (unsigned) rmid);
+
+        if (verbose && pqos_prefetch_get(ci->lcore, &prefetch) ==
+            PQOS_RETVAL_OK)
+                printf(", PREFETCH 0x%x", prefetch);
+
+        printf("\n");
 }
 
 
@@ -1136,7 +1205,7 @@ void alloc_print_config(const struct pqos_capability *cap_mon,
                                          (cap_mba != NULL) /* is_alloc */,
                                          cpu_info->l3.detected /* is_l3 */,
                                          (cap_mon != NULL) /* is_mon */,
-                                         core_info);
+                                         verbose, core_info);
                 }
                 free(lcores);
         }
@@ -1198,7 +1267,7 @@ int alloc_apply(const struct pqos_capability *cap_l3ca,
                  * For monitoring, start the program again unless
                  * config file was provided
                  */
-                int ret_assoc = 0, ret_cos = 0;
+                int ret_assoc = 0, ret_cos = 0, ret_prefetch = 0;
 
                 ret_cos = set_alloc(cpu);
                 if (ret_cos < 0) {
@@ -1210,10 +1279,15 @@ int alloc_apply(const struct pqos_capability *cap_l3ca,
                         printf("Allocation association error!\n");
                         return -1;
                 }
+                ret_prefetch = set_prefetch();
+                if (ret_prefetch < 0) {
+                        printf("Prefetcher configuration error!\n");
+                        return -1;
+                }
                 /**
                  * Check if any allocation configuration has changed
                  */
-                if (ret_assoc > 0 || ret_cos > 0) {
+                if (ret_assoc > 0 || ret_cos > 0 || ret_prefetch > 0) {
                         printf("Allocation configuration altered.\n");
                         return 1;
                 }
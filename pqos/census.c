@@ -0,0 +1,473 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Platform QoS utility - cache footprint census module
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <dirent.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "pqos.h"
+
+#include "main.h"
+#include "census.h"
+
+#define CENSUS_TOP_MAX 10 /**< number of processes in each ranking */
+
+/**
+ * Census record of single process
+ */
+struct census_proc {
+        pid_t pid;
+        char comm[32];       /**< process name */
+        unsigned sweep;      /**< sweep of last measurement, 0 if none */
+        uint64_t llc;        /**< LLC occupancy in bytes */
+        double mbl;          /**< local memory bandwidth in MB/s */
+        double mbt;          /**< total memory bandwidth in MB/s */
+};
+
+static int sel_census = 0;
+
+/**
+ * Stop census indicator
+ */
+static volatile sig_atomic_t stop_census = 0;
+
+/**
+ * Processes found by last scan of /proc, sorted by pid
+ */
+static struct census_proc *census_procs = NULL;
+static unsigned census_num_procs = 0;
+
+void selfn_monitor_census(const char *arg)
+{
+        UNUSED_ARG(arg);
+        sel_census = 1;
+}
+
+int census_selected(void)
+{
+        return sel_census;
+}
+
+/**
+ * @brief CTRL-C handler for census loop
+ *
+ * @param [in] signo signal number
+ */
+static void census_ctrlc(int signo)
+{
+        UNUSED_ARG(signo);
+        stop_census = 1;
+}
+
+/**
+ * @brief Compares census records by pid
+ *
+ * @param [in] a record
+ * @param [in] b record
+ *
+ * @return comparison result for qsort() and bsearch()
+ */
+static int
+census_pid_cmp(const void *a, const void *b)
+{
+        const struct census_proc *pa = (const struct census_proc *)a;
+        const struct census_proc *pb = (const struct census_proc *)b;
+
+        return (pa->pid > pb->pid) - (pa->pid < pb->pid);
+}
+
+/**
+ * @brief Reads process name
+ *
+ * @param [in] pid process id
+ * @param [out] comm buffer for the name
+ * @param [in] size size of \a comm
+ */
+static void
+census_comm_get(const pid_t pid, char *comm, const size_t size)
+{
+        char path[64];
+        FILE *fp;
+
+        snprintf(comm, size, "?");
+        snprintf(path, sizeof(path), "/proc/%d/comm", (int)pid);
+        fp = fopen(path, "r");
+        if (fp == NULL)
+                return;
+        if (fgets(comm, (int)size, fp) != NULL)
+                comm[strcspn(comm, "\n")] = '\0';
+        fclose(fp);
+}
+
+/**
+ * @brief Rebuilds process table from /proc
+ *
+ * Measurements of processes still running are carried over,
+ * records of processes that exited are dropped.
+ *
+ * @return Operation status
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+static int
+census_scan(void)
+{
+        struct census_proc *procs = NULL;
+        unsigned num = 0, max = 0;
+        struct dirent *de;
+        DIR *dir;
+
+        dir = opendir("/proc");
+        if (dir == NULL) {
+                printf("Error opening /proc!\n");
+                return -1;
+        }
+
+        while ((de = readdir(dir)) != NULL) {
+                struct census_proc key, *old;
+                char *endptr = NULL;
+                long pid;
+
+                pid = strtol(de->d_name, &endptr, 10);
+                if (endptr == de->d_name || *endptr != '\0' || pid <= 0)
+                        continue;
+
+                if (num == max) {
+                        struct census_proc *p;
+
+                        max = max == 0 ? 256 : max * 2;
+                        p = realloc(procs, max * sizeof(procs[0]));
+                        if (p == NULL) {
+                                printf("Error allocating memory!\n");
+                                free(procs);
+                                closedir(dir);
+                                return -1;
+                        }
+                        procs = p;
+                }
+
+                memset(&key, 0, sizeof(key));
+                key.pid = (pid_t)pid;
+                old = bsearch(&key, census_procs, census_num_procs,
+                              sizeof(census_procs[0]), census_pid_cmp);
+                if (old != NULL)
+                        procs[num] = *old;
+                else {
+                        procs[num] = key;
+                        census_comm_get(key.pid, procs[num].comm,
+                                        sizeof(procs[num].comm));
+                }
+                num++;
+        }
+        closedir(dir);
+
+        qsort(procs, num, sizeof(procs[0]), census_pid_cmp);
+        free(census_procs);
+        census_procs = procs;
+        census_num_procs = num;
+
+        return 0;
+}
+
+/**
+ * @brief Compares measured processes by LLC occupancy, descending
+ *
+ * @param [in] a pointer to record
+ * @param [in] b pointer to record
+ *
+ * @return comparison result for qsort()
+ */
+static int
+census_llc_cmp(const void *a, const void *b)
+{
+        const struct census_proc *pa = *(const struct census_proc * const *)a;
+        const struct census_proc *pb = *(const struct census_proc * const *)b;
+
+        if (pa->llc != pb->llc)
+                return pa->llc < pb->llc ? 1 : -1;
+        return (pa->mbt < pb->mbt) - (pa->mbt > pb->mbt);
+}
+
+/**
+ * @brief Compares measured processes by memory bandwidth, descending
+ *
+ * @param [in] a pointer to record
+ * @param [in] b pointer to record
+ *
+ * @return comparison result for qsort()
+ */
+static int
+census_mb_cmp(const void *a, const void *b)
+{
+        const struct census_proc *pa = *(const struct census_proc * const *)a;
+        const struct census_proc *pb = *(const struct census_proc * const *)b;
+
+        if (pa->mbt != pb->mbt)
+                return pa->mbt < pb->mbt ? 1 : -1;
+        return (pa->llc < pb->llc) - (pa->llc > pb->llc);
+}
+
+/**
+ * @brief Prints single ranking
+ *
+ * @param [in] title ranking title
+ * @param [in] rank measured processes
+ * @param [in] num number of processes in \a rank
+ * @param [in] sweep current sweep number
+ */
+static void
+census_rank_print(const char *title,
+                  struct census_proc **rank,
+                  const unsigned num,
+                  const unsigned sweep)
+{
+        unsigned i;
+
+        printf("%s\n%7s %-16s %10s %10s %10s %5s\n", title, "PID", "COMMAND",
+               "LLC[KB]", "MBL[MB/s]", "MBT[MB/s]", "AGE");
+        for (i = 0; i < num && i < CENSUS_TOP_MAX; i++)
+                printf("%7d %-16.16s %10.1f %10.1f %10.1f %5u\n",
+                       (int)rank[i]->pid, rank[i]->comm,
+                       (double)rank[i]->llc / 1024.0, rank[i]->mbl,
+                       rank[i]->mbt, sweep - rank[i]->sweep);
+}
+
+/**
+ * @brief Prints census rankings by LLC occupancy and memory bandwidth
+ *
+ * @param [in] sweep current sweep number
+ * @param [in] batch number of processes measured at a time
+ */
+static void
+census_print(const unsigned sweep, const unsigned batch)
+{
+        struct census_proc **rank;
+        unsigned num = 0, i;
+        char cb_time[64] = "error";
+        time_t now = time(NULL);
+        struct tm tm;
+
+        rank = calloc(census_num_procs + 1, sizeof(rank[0]));
+        if (rank == NULL)
+                return;
+
+        for (i = 0; i < census_num_procs; i++)
+                if (census_procs[i].sweep != 0)
+                        rank[num++] = &census_procs[i];
+
+        if (localtime_r(&now, &tm) != NULL)
+                strftime(cb_time, sizeof(cb_time), "%Y-%m-%d %H:%M:%S", &tm);
+
+        if (isatty(fileno(stdout)))
+                printf("\033[2J"      /* Clear screen */
+                       "\033[0;0H");  /* move to position 0:0 */
+        printf("TIME %s CENSUS sweep %u, %u processes, %u measured, "
+               "%u per batch\n", cb_time, sweep, census_num_procs, num,
+               batch);
+
+        qsort(rank, num, sizeof(rank[0]), census_llc_cmp);
+        census_rank_print("Top LLC occupancy:", rank, num, sweep);
+        qsort(rank, num, sizeof(rank[0]), census_mb_cmp);
+        census_rank_print("Top memory bandwidth:", rank, num, sweep);
+        fflush(stdout);
+
+        free(rank);
+}
+
+/**
+ * @brief Measures one batch of processes
+ *
+ * Monitoring groups are started for processes from \a cursor on until
+ * \a batch groups are started or monitoring resources run out.
+ *
+ * @param [in] events events to monitor
+ * @param [in] interval measurement window in 100ms units
+ * @param [in] sweep current sweep number
+ * @param [in,out] cursor index of next process to measure
+ * @param [in,out] batch maximum number of groups, reduced when
+ *                 fewer monitoring resources are available
+ * @param [in] data table of \a batch monitoring groups
+ * @param [in] groups table of \a batch group pointers
+ * @param [in] procs table of \a batch processes being measured
+ *
+ * @return Operation status
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+static int
+census_batch(const enum pqos_mon_event events,
+             const unsigned interval,
+             const unsigned sweep,
+             unsigned *cursor,
+             unsigned *batch,
+             struct pqos_mon_data *data,
+             struct pqos_mon_data **groups,
+             struct census_proc **procs)
+{
+        const double window = (double)interval / 10.0;
+        unsigned num = 0, i;
+        int ret;
+
+        while (num < *batch && *cursor < census_num_procs) {
+                struct census_proc *proc = &census_procs[*cursor];
+
+                memset(&data[num], 0, sizeof(data[num]));
+                ret = pqos_mon_start_pid(proc->pid, events, NULL, &data[num]);
+                if (ret == PQOS_RETVAL_RESOURCE) {
+                        if (num == 0) {
+                                printf("No monitoring resources available "
+                                       "for census!\n");
+                                return -1;
+                        }
+                        /* RMIDs held by other users, shrink the batch */
+                        *batch = num;
+                        break;
+                }
+                (*cursor)++;
+                /* process exited or cannot be monitored */
+                if (ret != PQOS_RETVAL_OK)
+                        continue;
+                groups[num] = &data[num];
+                procs[num] = proc;
+                num++;
+        }
+        if (num == 0)
+                return 0;
+
+        /* first poll sets the bandwidth counter baseline */
+        ret = pqos_mon_poll(groups, num);
+        if (ret == PQOS_RETVAL_OK) {
+                usleep(interval * 100000);
+                ret = pqos_mon_poll(groups, num);
+        }
+
+        for (i = 0; i < num; i++) {
+                const struct pqos_event_values *pv = &groups[i]->values;
+
+                if (ret == PQOS_RETVAL_OK) {
+                        procs[i]->llc = pv->llc;
+                        procs[i]->mbl = (double)pv->mbm_local_delta /
+                                        (1024.0 * 1024.0) / window;
+                        procs[i]->mbt = (double)pv->mbm_total_delta /
+                                        (1024.0 * 1024.0) / window;
+                        procs[i]->sweep = sweep;
+                }
+                (void)pqos_mon_stop(groups[i]);
+        }
+        if (ret != PQOS_RETVAL_OK)
+                printf("Failed to poll monitoring data!\n");
+
+        return 0;
+}
+
+int census_run(const struct pqos_capability *cap_mon,
+               const int interval,
+               const int timeout)
+{
+        enum pqos_mon_event events = (enum pqos_mon_event)0;
+        const enum pqos_mon_event census_events = (enum pqos_mon_event)
+                (PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
+                 PQOS_MON_EVENT_TMEM_BW);
+        struct pqos_mon_data *data = NULL;
+        struct pqos_mon_data **groups = NULL;
+        struct census_proc **procs = NULL;
+        unsigned batch, cursor = 0, sweep = 1, i;
+        struct timeval tv_start, tv_now;
+        int ret = -1;
+
+        for (i = 0; i < cap_mon->u.mon->num_events; i++)
+                events |= cap_mon->u.mon->events[i].type & census_events;
+        if (!(events & PQOS_MON_EVENT_L3_OCCUP)) {
+                printf("LLC occupancy monitoring not supported!\n");
+                return -1;
+        }
+
+        /* RMID 0 is used by the default group */
+        batch = cap_mon->u.mon->max_rmid > 1 ? cap_mon->u.mon->max_rmid - 1
+                                              : 1;
+        data = calloc(batch, sizeof(data[0]));
+        groups = calloc(batch, sizeof(groups[0]));
+        procs = calloc(batch, sizeof(procs[0]));
+        if (data == NULL || groups == NULL || procs == NULL) {
+                printf("Error allocating memory!\n");
+                goto exit;
+        }
+
+        if (signal(SIGINT, census_ctrlc) == SIG_ERR)
+                printf("Failed to catch SIGINT!\n");
+        if (signal(SIGHUP, census_ctrlc) == SIG_ERR)
+                printf("Failed to catch SIGHUP!\n");
+
+        if (census_scan() != 0)
+                goto exit;
+
+        gettimeofday(&tv_start, NULL);
+        while (!stop_census) {
+                if (cursor >= census_num_procs) {
+                        if (census_scan() != 0)
+                                goto exit;
+                        cursor = 0;
+                        sweep++;
+                }
+
+                if (census_batch(events, interval, sweep, &cursor, &batch,
+                                 data, groups, procs) != 0)
+                        goto exit;
+                census_print(sweep, batch);
+
+                if (timeout >= 0) {
+                        gettimeofday(&tv_now, NULL);
+                        if (tv_now.tv_sec - tv_start.tv_sec > timeout)
+                                break;
+                }
+        }
+        ret = 0;
+
+ exit:
+        free(census_procs);
+        census_procs = NULL;
+        census_num_procs = 0;
+        free(procs);
+        free(groups);
+        free(data);
+        return ret;
+}
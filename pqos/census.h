@@ -0,0 +1,85 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Cache footprint census module
+ */
+
+#include "pqos.h"
+
+#ifndef __CENSUS_H__
+#define __CENSUS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Selects cache footprint census
+ *
+ * @param arg not used
+ */
+void selfn_monitor_census(const char *arg);
+
+/**
+ * @brief Checks if cache footprint census was selected
+ *
+ * @return 1 if census was selected
+ */
+int census_selected(void);
+
+/**
+ * @brief Runs cache footprint census of all processes
+ *
+ * Processes are measured in batches sized to available monitoring
+ * resources. Each batch is monitored over \a interval, then the next
+ * batch is measured. Rankings of processes by LLC occupancy and memory
+ * bandwidth are refreshed after every batch.
+ *
+ * @param [in] cap_mon monitoring capability structure
+ * @param [in] interval measurement window in 100ms units
+ * @param [in] timeout census time in seconds, negative for infinite
+ *
+ * @return Operation status
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+int census_run(const struct pqos_capability *cap_mon,
+               const int interval,
+               const int timeout);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CENSUS_H__ */
@@ -52,6 +52,8 @@
 #include "monitor.h"
 #include "alloc.h"
 #include "cap.h"
+#include "report.h"
+#include "census.h"
 #include "common.h"
 
 #define FILE_READ_WRITE (0600)
@@ -564,7 +566,11 @@ parse_config_file(const char *fname)
                 {"monitor-file:",       selfn_monitor_file },      /**< -o */
                 {"monitor-file-type:",  selfn_monitor_file_type }, /**< -u */
                 {"monitor-top-like:",   selfn_monitor_top_like },  /**< -T */
+                {"monitor-other:",      selfn_monitor_other },
                 {"reset-cat:",          selfn_reset_alloc },       /**< -R */
+                {"alloc-report:",       selfn_alloc_report },
+                {"trace:",              selfn_trace },
+                {"monitor-census:",     selfn_monitor_census },
                 {"iface-os:",           selfn_iface_os },          /**< -I */
         };
         FILE *fp = NULL;
@@ -648,10 +654,14 @@ static const char help_printf_short[] =
         "          [-o FILE] [--mon-file=FILE]\n"
         "          [-u TYPE] [--mon-file-type=TYPE]\n"
         "          [-r] [--mon-reset]\n"
+        "          [--mon-other]\n"
+        "          [--mon-census]\n"
         "          [-P] [--percent-llc]\n"
         "       %s [-e CLASSDEF] [--alloc-class=CLASSDEF]\n"
         "          [-a CLASS2ID] [--alloc-assoc=CLASS2ID]\n"
         "       %s [-R] [--alloc-reset]\n"
+        "       %s [--alloc-report] [-i N] [--mon-interval=N]\n"
+        "       %s [--trace]\n"
         "       %s [-H] [--profile-list] | [-c PROFILE] "
         "[--profile-set=PROFILE]\n"
         "       %s [-f FILE] [--config-file=FILE]\n";
@@ -676,7 +686,10 @@ static const char help_printf_long[] =
         "                    'l2:2=0x3f;l2@2:1=0xf',\n"
         "                    'l2:2d=0xf;l2:2c=0xc',\n"
         "                    'mba:1=30;mba@1:3=80',\n"
-        "                    'mba_max:1=4000;mba_max@1:3=6000'.\n"
+        "                    'mba_max:1=4000;mba_max@1:3=6000',\n"
+        "                    'prefetch:1=0x0;prefetch:2=0xc'.\n"
+        "          prefetch DEFINITION is a mask of enabled prefetchers:\n"
+        "          0x1 L2 HW, 0x2 L2 adjacent line, 0x4 DCU, 0x8 DCU IP.\n"
         "  -a CLASS2ID, --alloc-assoc=CLASS2ID\n"
         "          associate cores/tasks with an allocation class.\n"
         "          CLASS2ID format is 'TYPE:ID=CORE_LIST/TASK_LIST'.\n"
@@ -689,6 +702,15 @@ static const char help_printf_long[] =
         "                         l2cdp-on, l2cdp-off, l2cdp-any,\n"
         "                         mbaCtrl-on, mbaCtrl-off, mbaCtrl-any\n"
         "          (default l3cdp-any,l2cdp-any,mbaCtrl-any).\n"
+        "  --alloc-report\n"
+        "          measure LLC occupancy of each class of service over\n"
+        "          the monitoring interval and compare it with the size\n"
+        "          of the class L3 CBM. Classes using less than half of\n"
+        "          their ways are reported for reclaim, classes filling\n"
+        "          their ways with high LLC miss rate for expansion.\n"
+        "  --trace\n"
+        "          print recent allocation configuration changes made\n"
+        "          through the library by any process, oldest first.\n"
         "  -m EVTCORES, --mon-core=EVTCORES\n"
         "          select cores and events for monitoring.\n"
         "          EVTCORES format is 'EVENT:CORE_LIST'.\n"
@@ -730,6 +752,14 @@ static const char help_printf_long[] =
         "          set monitoring time in seconds. Use 'inf' or 'infinite'\n"
         "          for infinite monitoring. CTRL+C stops monitoring.\n"
         "  -r, --mon-reset             monitoring reset, claim all RMID's\n"
+        "  --mon-other                 monitor activity not tracked by\n"
+        "                              selected core groups, one row per\n"
+        "                              L3 cluster.\n"
+        "  --mon-census                rank all processes by LLC occupancy\n"
+        "                              and memory bandwidth. Processes are\n"
+        "                              measured in batches sized to the\n"
+        "                              available RMIDs, one batch per\n"
+        "                              interval. Requires -I.\n"
         "  -H, --profile-list          list supported allocation profiles\n"
         "  -c PROFILE, --profile-set=PROFILE\n"
         "          select a PROFILE of predefined allocation classes.\n"
@@ -752,7 +782,8 @@ static void print_help(const int is_long)
 #ifdef PQOS_RMID_CUSTOM
                m_cmd_name,
 #endif
-               m_cmd_name, m_cmd_name, m_cmd_name, m_cmd_name, m_cmd_name);
+               m_cmd_name, m_cmd_name, m_cmd_name, m_cmd_name, m_cmd_name,
+               m_cmd_name, m_cmd_name);
         if (is_long)
                 printf("%s", help_printf_long);
 }
@@ -776,6 +807,10 @@ static void print_lib_version(const struct pqos_cap *p_cap)
 #endif
 #define OPTION_DISABLE_MON_IPC 1001
 #define OPTION_DISABLE_MON_LLC_MISS 1002
+#define OPTION_MON_OTHER 1003
+#define OPTION_ALLOC_REPORT 1004
+#define OPTION_TRACE 1005
+#define OPTION_MON_CENSUS 1006
 
 static struct option long_cmd_opts[] = {
         {"help",                 no_argument,       0, 'h'},
@@ -797,9 +832,13 @@ static struct option long_cmd_opts[] = {
         {"disable-mon-ipc",      no_argument,       0, OPTION_DISABLE_MON_IPC},
         {"disable-mon-llc_miss", no_argument,       0,
          OPTION_DISABLE_MON_LLC_MISS},
+        {"mon-other",            no_argument,       0, OPTION_MON_OTHER},
+        {"mon-census",           no_argument,       0, OPTION_MON_CENSUS},
         {"alloc-class",          required_argument, 0, 'e'},
         {"alloc-reset",          required_argument, 0, 'R'},
         {"alloc-assoc",          required_argument, 0, 'a'},
+        {"alloc-report",         no_argument,       0, OPTION_ALLOC_REPORT},
+        {"trace",                no_argument,       0, OPTION_TRACE},
         {"verbose",              no_argument,       0, 'v'},
         {"super-verbose",        no_argument,       0, 'V'},
         {"iface-os",             no_argument,       0, 'I'},
@@ -966,6 +1005,18 @@ int main(int argc, char **argv)
                 case OPTION_DISABLE_MON_LLC_MISS:
                         selfn_monitor_disable_llc_miss(NULL);
                         break;
+                case OPTION_MON_OTHER:
+                        selfn_monitor_other(NULL);
+                        break;
+                case OPTION_MON_CENSUS:
+                        selfn_monitor_census(NULL);
+                        break;
+                case OPTION_ALLOC_REPORT:
+                        selfn_alloc_report(NULL);
+                        break;
+                case OPTION_TRACE:
+                        selfn_trace(NULL);
+                        break;
 #ifdef PQOS_RMID_CUSTOM
                 case OPTION_RMID:
                         selfn_monitor_rmids(optarg);
@@ -983,6 +1034,7 @@ int main(int argc, char **argv)
                 }
         }
 
+        pid_flag |= census_selected();
         if (pid_flag == 1 && sel_interface == PQOS_INTER_MSR) {
                 printf("Error! OS interface option [-I] needed for PID"
                        " operations. Please re-run with the -I option.\n");
@@ -1104,6 +1156,25 @@ int main(int argc, char **argv)
                 goto allocation_exit;
         }
 
+        if (report_selected()) {
+                /**
+                 * Measure class occupancy against allotted ways and exit
+                 */
+                if (report_print(cap_mon, cap_l3ca, p_cpu,
+                                 monitor_get_interval()) != 0)
+                        exit_val = EXIT_FAILURE;
+                goto allocation_exit;
+        }
+
+        if (report_trace_selected()) {
+                /**
+                 * Show recent configuration changes and exit
+                 */
+                if (report_trace_print() != 0)
+                        exit_val = EXIT_FAILURE;
+                goto allocation_exit;
+        }
+
         if (sel_display || sel_display_verbose) {
                 /**
                  * Display info about supported capabilities
@@ -1147,6 +1218,16 @@ int main(int argc, char **argv)
                 goto error_exit_2;
         }
 
+        if (census_selected()) {
+                /**
+                 * Rank all processes by cache footprint and exit
+                 */
+                if (census_run(cap_mon, monitor_get_interval(),
+                               monitor_get_timeout()) != 0)
+                        exit_val = EXIT_FAILURE;
+                goto error_exit_2;
+        }
+
         if (monitor_setup(p_cpu, cap_mon) != 0) {
                 exit_val = EXIT_FAILURE;
                 goto error_exit_2;
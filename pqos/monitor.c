@@ -124,6 +124,20 @@ static struct pid_group {
         enum pqos_mon_event events;
 } sel_monitor_pid_tab[PQOS_MAX_PID_MON_GROUPS];
 
+/**
+ * Maintains table of remainder groups, one per L3 cluster, accounting for
+ * activity of cores and tasks not tracked by any other monitoring group
+ */
+static struct core_group sel_monitor_other_tab[PQOS_MAX_CORES];
+
+/**
+ * Number of remainder groups in use
+ */
+static int sel_monitor_other_num = 0;
+
+/** Trigger for remainder monitoring */
+static int sel_monitor_other = 0;
+
 /**
  * Maintains the number of process id's you want to track
  */
@@ -684,6 +698,12 @@ void selfn_monitor_disable_llc_miss(const char *arg)
         sel_disable_llc_miss = 1;
 }
 
+void selfn_monitor_other(const char *arg)
+{
+        UNUSED_ARG(arg);
+        sel_monitor_other = 1;
+}
+
 void selfn_monitor_cores(const char *arg)
 {
         char *cp = NULL, *str = NULL;
@@ -753,6 +773,97 @@ static void monitor_setup_events(enum pqos_mon_event *events,
         sel_events_max |= *events;
 }
 
+/**
+ * @brief Starts remainder monitoring group for each L3 cluster
+ *
+ * @param [in] cpu_info cpu information structure
+ * @param [in] cap_mon monitoring capability
+ *
+ * @return Operation status
+ * @retval 0 on success
+ */
+static int monitor_setup_other(const struct pqos_cpuinfo *cpu_info,
+                               const struct pqos_capability * const cap_mon)
+{
+        unsigned i;
+        int ret;
+
+        for (i = 0; i < cpu_info->num_cores; i++) {
+                const unsigned cluster = cpu_info->cores[i].l3_id;
+                enum pqos_mon_event events =
+                        (enum pqos_mon_event)PQOS_MON_EVENT_ALL;
+                struct core_group *cg;
+                char desc[16];
+                int j;
+
+                for (j = 0; j < sel_monitor_other_num; j++)
+                        if (sel_monitor_other_tab[j].cores[0] == cluster)
+                                break;
+                if (j < sel_monitor_other_num)
+                        continue;
+
+                if ((unsigned)sel_monitor_other_num >=
+                    DIM(sel_monitor_other_tab))
+                        break;
+
+                /**
+                 * Remainder groups report RDT events only
+                 */
+                monitor_setup_events(&events, cap_mon);
+                events &= (enum pqos_mon_event)(PQOS_MON_EVENT_L3_OCCUP |
+                                                PQOS_MON_EVENT_LMEM_BW |
+                                                PQOS_MON_EVENT_TMEM_BW |
+                                                PQOS_MON_EVENT_RMEM_BW);
+                if (events == 0) {
+                        printf("No RDT monitoring events available for "
+                               "remainder monitoring\n");
+                        goto monitor_setup_other_error;
+                }
+
+                cg = &sel_monitor_other_tab[sel_monitor_other_num];
+                snprintf(desc, sizeof(desc), "other/%u", cluster);
+                cg->desc = strdup(desc);
+                cg->cores = malloc(sizeof(cg->cores[0]));
+                cg->pgrp = malloc(sizeof(*cg->pgrp));
+                if (cg->desc == NULL || cg->cores == NULL ||
+                    cg->pgrp == NULL) {
+                        printf("Error with memory allocation!\n");
+                        exit(EXIT_FAILURE);
+                }
+                /* cluster id is kept in place of the core list */
+                cg->cores[0] = cluster;
+                cg->num_cores = 0;
+                cg->events = events;
+
+                ret = pqos_mon_start_remainder(cluster, events,
+                                               (void *)cg->desc, cg->pgrp);
+                if (ret != PQOS_RETVAL_OK) {
+                        printf("Remainder monitoring start error on "
+                               "cluster %u, status %d\n",
+                               cluster, ret);
+                        free(cg->desc);
+                        free(cg->cores);
+                        free(cg->pgrp);
+                        goto monitor_setup_other_error;
+                }
+                sel_monitor_other_num++;
+        }
+
+        return 0;
+
+monitor_setup_other_error:
+        for (i = 0; i < (unsigned)sel_monitor_other_num; i++) {
+                struct core_group *cg = &sel_monitor_other_tab[i];
+
+                pqos_mon_stop(cg->pgrp);
+                free(cg->desc);
+                free(cg->cores);
+                free(cg->pgrp);
+        }
+        sel_monitor_other_num = 0;
+        return -1;
+}
+
 int monitor_setup(const struct pqos_cpuinfo *cpu_info,
                   const struct pqos_capability * const cap_mon)
 {
@@ -837,6 +948,11 @@ int monitor_setup(const struct pqos_cpuinfo *cpu_info,
                        " tracking can not be done simultaneously\n");
                 return -1;
         }
+        if (sel_process_num > 0 && sel_monitor_other) {
+                printf("Monitoring start error, remainder monitoring"
+                       " is available for core tracking only\n");
+                return -1;
+        }
         if (!process_mode()) {
                 /**
                  * Make calls to pqos_mon_start - track cores
@@ -874,6 +990,12 @@ int monitor_setup(const struct pqos_cpuinfo *cpu_info,
                                 return -1;
                         }
                 }
+                if (sel_monitor_other &&
+                    monitor_setup_other(cpu_info, cap_mon) != 0) {
+                        for (i = 0; i < (unsigned)sel_monitor_num; i++)
+                                pqos_mon_stop(sel_monitor_core_tab[i].pgrp);
+                        return -1;
+                }
         } else {
                 /**
                  * Make calls to pqos_mon_start_pid - track PIDs
@@ -935,6 +1057,17 @@ void monitor_stop(void)
                         free(sel_monitor_pid_tab[i].pids);
                         free(sel_monitor_pid_tab[i].pgrp);
                 }
+
+        for (i = 0; i < sel_monitor_other_num; i++) {
+                int ret = pqos_mon_stop(sel_monitor_other_tab[i].pgrp);
+
+                if (ret != PQOS_RETVAL_OK)
+                        printf("Monitoring stop error!\n");
+                free(sel_monitor_other_tab[i].desc);
+                free(sel_monitor_other_tab[i].cores);
+                free(sel_monitor_other_tab[i].pgrp);
+        }
+        sel_monitor_other_num = 0;
 }
 
 void selfn_monitor_time(const char *arg)
@@ -951,6 +1084,19 @@ void selfn_monitor_time(const char *arg)
 void selfn_monitor_interval(const char *arg)
 {
         sel_mon_interval = (int) strtouint64(arg);
+        if (sel_mon_interval <= 0)
+                parse_error(arg, "Monitoring interval has to be greater "
+                            "than 0!");
+}
+
+int monitor_get_interval(void)
+{
+        return sel_mon_interval;
+}
+
+int monitor_get_timeout(void)
+{
+        return sel_timeout;
 }
 
 void selfn_monitor_top_like(const char *arg)
@@ -2464,6 +2610,7 @@ build_header_row(char *hdr, const size_t sz_hdr,
  * - initializes allocated arrays with data from core or pid table
  * - saves array pointers in \a parray1 and \a parray2
  * - both arrays have identical content
+ * - remainder groups, if any, are placed at the end of the arrays
  *
  * @param parray1 pointer to an array of pointers to PQoS monitoring structures
  * @param parray2 pointer to an array of pointers to PQoS monitoring structures
@@ -2482,8 +2629,8 @@ get_mon_arrays(struct pqos_mon_data ***parray1,
                 mon_number = (unsigned) sel_monitor_num;
         else
                 mon_number = (unsigned) sel_process_num;
-        p1 = malloc(sizeof(p1[0]) * mon_number);
-        p2 = malloc(sizeof(p2[0]) * mon_number);
+        p1 = malloc(sizeof(p1[0]) * (mon_number + sel_monitor_other_num));
+        p2 = malloc(sizeof(p2[0]) * (mon_number + sel_monitor_other_num));
         if (p1 == NULL || p2 == NULL) {
                 if (p1)
                         free(p1);
@@ -2500,6 +2647,11 @@ get_mon_arrays(struct pqos_mon_data ***parray1,
                         p1[i] = sel_monitor_pid_tab[i].pgrp;
                 p2[i] = p1[i];
         }
+        for (i = 0; i < (unsigned)sel_monitor_other_num; i++) {
+                p1[mon_number] = sel_monitor_other_tab[i].pgrp;
+                p2[mon_number] = p1[mon_number];
+                mon_number++;
+        }
 
         *parray1 = p1;
         *parray2 = p2;
@@ -2615,7 +2767,7 @@ void monitor_loop(void)
         const size_t sz_header = 128;
         unsigned cache_size;
         char header[sz_header];
-        unsigned mon_number = 0, display_num = 0;
+        unsigned mon_number = 0, display_num = 0, sort_num = 0;
         struct pqos_mon_data **mon_data = NULL, **mon_grps = NULL;
 
         if ((!istext)  && (!isxml) && (!iscsv)) {
@@ -2631,6 +2783,8 @@ void monitor_loop(void)
 
         mon_number = get_mon_arrays(&mon_grps, &mon_data);
         display_num = mon_number;
+        /* remainder groups are always displayed last */
+        sort_num = mon_number - (unsigned)sel_monitor_other_num;
 
         /**
          * Capture ctrl-c to gracefully stop the loop
@@ -2689,10 +2843,10 @@ void monitor_loop(void)
                 memcpy(mon_data, mon_grps, mon_number * sizeof(mon_grps[0]));
 
                 if (sel_mon_top_like)
-                        qsort(mon_data, mon_number, sizeof(mon_data[0]),
+                        qsort(mon_data, sort_num, sizeof(mon_data[0]),
                               mon_qsort_llc_cmp_desc);
                 else if (!process_mode())
-                        qsort(mon_data, mon_number, sizeof(mon_data[0]),
+                        qsort(mon_data, sort_num, sizeof(mon_data[0]),
                               mon_qsort_coreid_cmp_asc);
 
                 /**
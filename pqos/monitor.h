@@ -75,6 +75,20 @@ void selfn_monitor_top_like(const char *arg);
  */
 void selfn_monitor_interval(const char *arg);
 
+/**
+ * @brief Gets selected monitoring interval
+ *
+ * @return monitoring interval in 100ms units
+ */
+int monitor_get_interval(void);
+
+/**
+ * @brief Gets selected monitoring time
+ *
+ * @return monitoring time in seconds, negative for infinite
+ */
+int monitor_get_timeout(void);
+
 /**
  * @brief Selects monitoring time
  *
@@ -121,6 +135,14 @@ void selfn_monitor_disable_ipc(const char *arg);
  */
 void selfn_monitor_disable_llc_miss(const char *arg);
 
+/**
+ * @brief Enables monitoring of activity not tracked by selected
+ *        core groups, one row per L3 cluster
+ *
+ * @param arg not used
+ */
+void selfn_monitor_other(const char *arg);
+
 /**
  * @brief Stops monitoring on selected core(s)/pid(s)
  *
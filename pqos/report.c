@@ -0,0 +1,477 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Platform QoS utility - allocation efficiency report module
+ *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "pqos.h"
+
+#include "main.h"
+#include "report.h"
+
+#define REPORT_RECLAIM_UTIL 50   /**< occupancy below this % reclaims ways */
+#define REPORT_EXPAND_UTIL  90   /**< occupancy above this % may expand */
+#define REPORT_EXPAND_MPKI  1.0  /**< LLC misses per 1000 instr. to expand */
+#define REPORT_HEADROOM     25   /**< % of occupancy kept on reclaim */
+
+/**
+ * Class of service on single L3 CAT id
+ */
+struct report_class {
+        unsigned l3cat_id;           /**< L3 CAT resource id */
+        struct pqos_l3ca ca;         /**< class definition */
+        unsigned *cores;             /**< cores associated with class */
+        unsigned num_cores;
+        struct pqos_mon_data *group; /**< NULL if class is not monitored */
+        int mon_ret;                 /**< monitoring start status */
+};
+
+static int sel_alloc_report = 0;
+static int sel_trace = 0;
+
+void selfn_alloc_report(const char *arg)
+{
+        UNUSED_ARG(arg);
+        sel_alloc_report = 1;
+}
+
+int report_selected(void)
+{
+        return sel_alloc_report;
+}
+
+void selfn_trace(const char *arg)
+{
+        UNUSED_ARG(arg);
+        sel_trace = 1;
+}
+
+int report_trace_selected(void)
+{
+        return sel_trace;
+}
+
+/**
+ * @brief Counts cache ways used by the class
+ *
+ * @param [in] ca class definition
+ *
+ * @return number of ways, code and data ways are merged with CDP
+ */
+static unsigned
+report_ways(const struct pqos_l3ca *ca)
+{
+        uint64_t mask = ca->cdp ? ca->u.s.data_mask | ca->u.s.code_mask
+                                : ca->u.ways_mask;
+        unsigned ways = 0;
+
+        for (; mask != 0; mask &= mask - 1)
+                ways++;
+
+        return ways;
+}
+
+/**
+ * @brief Builds table of classes with cores associated on each L3 CAT id
+ *
+ * @param [in] cap_l3ca L3 CAT capability structure
+ * @param [in] cpu_info cpu information structure
+ * @param [out] classes table of classes
+ * @param [out] num_classes number of classes in the table
+ *
+ * @return Operation status
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+static int
+report_classes_get(const struct pqos_capability *cap_l3ca,
+                   const struct pqos_cpuinfo *cpu_info,
+                   struct report_class **classes,
+                   unsigned *num_classes)
+{
+        const unsigned max_cos = cap_l3ca->u.l3ca->num_classes;
+        struct report_class *table = NULL;
+        unsigned *ids = NULL, *assoc = NULL;
+        unsigned num_ids, num = 0, i, j, k;
+        int ret = -1;
+
+        ids = pqos_cpu_get_l3cat_ids(cpu_info, &num_ids);
+        if (ids == NULL) {
+                printf("Error retrieving CPU socket information!\n");
+                goto exit;
+        }
+
+        assoc = calloc(cpu_info->num_cores, sizeof(assoc[0]));
+        table = calloc(num_ids * max_cos, sizeof(table[0]));
+        if (assoc == NULL || table == NULL) {
+                printf("Error allocating memory!\n");
+                goto exit;
+        }
+
+        for (i = 0; i < cpu_info->num_cores; i++)
+                if (pqos_alloc_assoc_get(cpu_info->cores[i].lcore,
+                                         &assoc[i]) != PQOS_RETVAL_OK) {
+                        printf("Error reading class of core %u!\n",
+                               cpu_info->cores[i].lcore);
+                        goto exit;
+                }
+
+        for (i = 0; i < num_ids; i++) {
+                struct pqos_l3ca ca[PQOS_MAX_L3CA_COS];
+                unsigned num_ca;
+
+                if (pqos_l3ca_get(ids[i], PQOS_MAX_L3CA_COS, &num_ca, ca) !=
+                    PQOS_RETVAL_OK) {
+                        printf("Error reading L3 CAT classes on "
+                               "L3 CAT ID %u!\n", ids[i]);
+                        goto exit;
+                }
+
+                for (j = 0; j < num_ca; j++) {
+                        struct report_class *rc = &table[num];
+
+                        rc->cores = malloc(cpu_info->num_cores *
+                                           sizeof(rc->cores[0]));
+                        if (rc->cores == NULL) {
+                                printf("Error allocating memory!\n");
+                                goto exit;
+                        }
+
+                        for (k = 0; k < cpu_info->num_cores; k++)
+                                if (cpu_info->cores[k].l3cat_id == ids[i] &&
+                                    assoc[k] == ca[j].class_id)
+                                        rc->cores[rc->num_cores++] =
+                                                cpu_info->cores[k].lcore;
+
+                        /* classes without cores are not occupying cache */
+                        if (rc->num_cores == 0) {
+                                free(rc->cores);
+                                rc->cores = NULL;
+                                continue;
+                        }
+                        rc->l3cat_id = ids[i];
+                        rc->ca = ca[j];
+                        num++;
+                }
+        }
+        ret = 0;
+
+ exit:
+        if (ret != 0 && table != NULL) {
+                for (i = 0; i < num_ids * max_cos; i++)
+                        free(table[i].cores);
+                free(table);
+                table = NULL;
+                num = 0;
+        }
+        free(assoc);
+        free(ids);
+        *classes = table;
+        *num_classes = num;
+        return ret;
+}
+
+/**
+ * @brief Prints single class row with suggestion
+ *
+ * @param [in] rc class
+ * @param [in] way_size cache way size in bytes
+ * @param [in] interval measurement interval in 100ms units
+ * @param [in,out] reclaim number of ways suggested for reclaim
+ * @param [in,out] expand number of ways suggested for expansion
+ */
+static void
+report_class_print(const struct report_class *rc,
+                   const unsigned way_size,
+                   const unsigned interval,
+                   unsigned *reclaim,
+                   unsigned *expand)
+{
+        const unsigned ways = report_ways(&rc->ca);
+        const uint64_t allotted = (uint64_t)ways * way_size;
+        const struct pqos_event_values *pv;
+        double util, misses, mpki = -1.0;
+
+        printf("  COS%-3u %5u %4u %12.1f ", rc->ca.class_id, rc->num_cores,
+               ways, (double)allotted / 1024.0);
+
+        if (rc->group == NULL) {
+                printf("%13s %7s %11s %6s  ", "N/A", "N/A", "N/A", "N/A");
+                if (rc->mon_ret == PQOS_RETVAL_RESOURCE)
+                        printf("monitoring failed, no free RMID\n");
+                else
+                        printf("monitoring failed, error %d\n", rc->mon_ret);
+                return;
+        }
+
+        pv = &rc->group->values;
+        util = allotted != 0 ? (double)pv->llc * 100.0 / (double)allotted
+                             : 0.0;
+        misses = (double)pv->llc_misses_delta * 10.0 / (double)interval;
+        if (pv->ipc_retired_delta != 0)
+                mpki = (double)pv->llc_misses_delta * 1000.0 /
+                       (double)pv->ipc_retired_delta;
+
+        printf("%13.1f %7.1f ", (double)pv->llc / 1024.0, util);
+        if (rc->group->event & PQOS_PERF_EVENT_LLC_MISS)
+                printf("%11.1f ", misses / 1000.0);
+        else
+                printf("%11s ", "N/A");
+        if (mpki >= 0.0)
+                printf("%6.2f  ", mpki);
+        else
+                printf("%6s  ", "N/A");
+
+        if (util < REPORT_RECLAIM_UTIL && ways > 1) {
+                /* keep occupied ways plus headroom */
+                uint64_t need = (pv->llc * (100 + REPORT_HEADROOM) +
+                                 (uint64_t)way_size * 100 - 1) /
+                                ((uint64_t)way_size * 100);
+
+                if (need == 0)
+                        need = 1;
+                if (need < ways) {
+                        printf("reclaim %u ways\n", ways - (unsigned)need);
+                        *reclaim += ways - (unsigned)need;
+                        return;
+                }
+        } else if (util >= REPORT_EXPAND_UTIL &&
+                   (mpki >= 0.0 ? mpki >= REPORT_EXPAND_MPKI : misses > 0)) {
+                printf("expand 1 way\n");
+                (*expand)++;
+                return;
+        }
+        printf("ok\n");
+}
+
+int report_print(const struct pqos_capability *cap_mon,
+                 const struct pqos_capability *cap_l3ca,
+                 const struct pqos_cpuinfo *cpu_info,
+                 const unsigned interval)
+{
+        enum pqos_mon_event events = (enum pqos_mon_event)0;
+        struct pqos_mon_data **groups = NULL;
+        struct report_class *classes = NULL;
+        unsigned num_classes = 0, num_groups = 0, i;
+        unsigned reclaim = 0, expand = 0;
+        int ret = -1;
+
+        if (cap_l3ca == NULL) {
+                printf("L3 CAT capability not detected!\n");
+                return -1;
+        }
+        if (cap_mon == NULL) {
+                printf("Monitoring capability not detected!\n");
+                return -1;
+        }
+
+        for (i = 0; i < cap_mon->u.mon->num_events; i++)
+                events |= cap_mon->u.mon->events[i].type;
+        if (!(events & PQOS_MON_EVENT_L3_OCCUP)) {
+                printf("LLC occupancy monitoring not supported!\n");
+                return -1;
+        }
+        events &= (PQOS_MON_EVENT_L3_OCCUP | PQOS_PERF_EVENT_LLC_MISS |
+                   PQOS_PERF_EVENT_IPC);
+
+        if (report_classes_get(cap_l3ca, cpu_info, &classes, &num_classes) !=
+            0)
+                return -1;
+
+        groups = calloc(num_classes, sizeof(groups[0]));
+        if (groups == NULL && num_classes != 0) {
+                printf("Error allocating memory!\n");
+                goto exit;
+        }
+
+        for (i = 0; i < num_classes; i++) {
+                struct report_class *rc = &classes[i];
+
+                rc->group = calloc(1, sizeof(*rc->group));
+                if (rc->group == NULL) {
+                        printf("Error allocating memory!\n");
+                        goto exit;
+                }
+                /* RMIDs may run out, report remaining classes anyway */
+                rc->mon_ret = pqos_mon_start(rc->num_cores, rc->cores, events,
+                                             NULL, rc->group);
+                if (rc->mon_ret != PQOS_RETVAL_OK) {
+                        free(rc->group);
+                        rc->group = NULL;
+                        continue;
+                }
+                groups[num_groups++] = rc->group;
+        }
+
+        if (num_groups != 0) {
+                if (pqos_mon_poll(groups, num_groups) != PQOS_RETVAL_OK) {
+                        printf("Error polling monitoring data!\n");
+                        goto exit;
+                }
+                usleep(interval * 100000);
+                if (pqos_mon_poll(groups, num_groups) != PQOS_RETVAL_OK) {
+                        printf("Error polling monitoring data!\n");
+                        goto exit;
+                }
+        }
+
+        for (i = 0; i < num_classes; i++) {
+                const unsigned way_size = cap_l3ca->u.l3ca->way_size;
+
+                if (i == 0 || classes[i].l3cat_id != classes[i - 1].l3cat_id) {
+                        reclaim = 0;
+                        expand = 0;
+                        printf("L3CA COS efficiency on L3 CAT ID %u "
+                               "(way size %u KB):\n",
+                               classes[i].l3cat_id, way_size / 1024);
+                        printf("  %-6s %5s %4s %12s %13s %7s %11s %6s  %s\n",
+                               "COS", "CORES", "WAYS", "ALLOTTED[KB]",
+                               "OCCUPANCY[KB]", "UTIL[%]", "MISSES[k/s]",
+                               "MPKI", "SUGGESTION");
+                }
+
+                report_class_print(&classes[i], way_size, interval, &reclaim,
+                                   &expand);
+
+                if (i + 1 == num_classes ||
+                    classes[i].l3cat_id != classes[i + 1].l3cat_id)
+                        printf("  Reclaimable ways: %u, requested ways: %u\n",
+                               reclaim, expand);
+        }
+        ret = num_groups == num_classes ? 0 : -1;
+
+ exit:
+        for (i = 0; i < num_classes; i++) {
+                if (classes[i].group != NULL) {
+                        (void)pqos_mon_stop(classes[i].group);
+                        free(classes[i].group);
+                }
+                free(classes[i].cores);
+        }
+        free(classes);
+        free(groups);
+        return ret;
+}
+
+/**
+ * @brief Converts trace entry type to string
+ *
+ * @param [in] type trace entry type
+ *
+ * @return type name
+ */
+static const char *
+report_trace_type(const enum pqos_trace_type type)
+{
+        switch (type) {
+        case PQOS_TRACE_ASSOC:
+                return "core";
+        case PQOS_TRACE_ASSOC_PID:
+                return "pid";
+        case PQOS_TRACE_L3CA:
+                return "llc";
+        case PQOS_TRACE_L3CA_DATA:
+                return "llc_data";
+        case PQOS_TRACE_L3CA_CODE:
+                return "llc_code";
+        case PQOS_TRACE_L2CA:
+                return "l2";
+        case PQOS_TRACE_L2CA_DATA:
+                return "l2_data";
+        case PQOS_TRACE_L2CA_CODE:
+                return "l2_code";
+        case PQOS_TRACE_MBA:
+                return "mba";
+        case PQOS_TRACE_PREFETCH:
+                return "prefetch";
+        case PQOS_TRACE_RESET:
+                return "reset";
+        }
+        return "unknown";
+}
+
+int report_trace_print(void)
+{
+        struct pqos_trace_entry *entries;
+        unsigned num = 0, i;
+        int ret;
+
+        entries = calloc(PQOS_TRACE_ENTRIES, sizeof(entries[0]));
+        if (entries == NULL) {
+                printf("Error allocating memory!\n");
+                return -1;
+        }
+
+        ret = pqos_trace_get(PQOS_TRACE_ENTRIES, &num, entries);
+        if (ret != PQOS_RETVAL_OK) {
+                printf("Error retrieving configuration change trace!\n");
+                free(entries);
+                return -1;
+        }
+
+        printf("%8s %20s %-26s %7s %-9s %6s %4s %s\n", "SEQ", "TSC",
+               "TIME", "PID", "TYPE", "ID", "COS", "OLD -> NEW");
+        for (i = 0; i < num; i++) {
+                const struct pqos_trace_entry *e = &entries[i];
+                const time_t sec = (time_t)(e->time / 1000000);
+                struct tm tm;
+                char tstr[32] = "-";
+
+                if (localtime_r(&sec, &tm) != NULL) {
+                        size_t len = strftime(tstr, sizeof(tstr),
+                                              "%Y-%m-%d %H:%M:%S", &tm);
+
+                        snprintf(tstr + len, sizeof(tstr) - len, ".%06u",
+                                 (unsigned)(e->time % 1000000));
+                }
+
+                printf("%8llu %20llu %-26s %7d %-9s %6u %4u 0x%llx -> "
+                       "0x%llx\n", (unsigned long long)e->seq,
+                       (unsigned long long)e->tsc, tstr, (int)e->pid,
+                       report_trace_type(e->type), e->id, e->class_id,
+                       (unsigned long long)e->old_value,
+                       (unsigned long long)e->new_value);
+        }
+        if (num == 0)
+                printf("No configuration changes recorded\n");
+
+        free(entries);
+        return 0;
+}
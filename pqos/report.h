@@ -0,0 +1,116 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Allocation efficiency report module
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include "pqos.h"
+
+#ifndef __REPORT_H__
+#define __REPORT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Selects allocation efficiency report
+ *
+ * @param arg not used
+ */
+void selfn_alloc_report(const char *arg);
+
+/**
+ * @brief Checks if allocation efficiency report was selected
+ *
+ * @return 1 if report was selected
+ */
+int report_selected(void);
+
+/**
+ * @brief Prints allocation efficiency report
+ *
+ * LLC occupancy of each class of service is measured on every L3 CAT id
+ * and compared with the size of the class CBM. Classes occupying much less
+ * than their ways are reported for reclaim, classes filling their ways
+ * under high LLC miss pressure are reported for expansion. Classes whose
+ * monitoring could not be started are listed with the error.
+ *
+ * @param [in] cap_mon monitoring capability structure
+ * @param [in] cap_l3ca L3 CAT capability structure
+ * @param [in] cpu_info cpu information structure
+ * @param [in] interval measurement interval in 100ms units
+ *
+ * @return Operation status
+ * @retval 0 on success
+ * @retval -1 on error or if monitoring of any class failed to start
+ */
+int report_print(const struct pqos_capability *cap_mon,
+                 const struct pqos_capability *cap_l3ca,
+                 const struct pqos_cpuinfo *cpu_info,
+                 const unsigned interval);
+
+/**
+ * @brief Selects printing of configuration change trace
+ *
+ * @param arg not used
+ */
+void selfn_trace(const char *arg);
+
+/**
+ * @brief Checks if configuration change trace was selected
+ *
+ * @return 1 if trace was selected
+ */
+int report_trace_selected(void);
+
+/**
+ * @brief Prints configuration change trace
+ *
+ * Changes of class definitions and associations recorded by the library,
+ * including changes made by other processes, are printed oldest first.
+ *
+ * @return Operation status
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+int report_trace_print(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __REPORT_H__ */
@@ -37,6 +37,8 @@
 #include <string.h>
 #include <errno.h>
 #include <sys/time.h> /**< gettimeofday() */
+#include <sys/wait.h>
+#include <signal.h>
 
 #include "common.h"
 #include "rdt.h"
@@ -280,3 +282,31 @@ get_time_usec(void)
 
         return ((uint64_t)tv.tv_usec) + ((uint64_t)tv.tv_sec * 1000000L);
 }
+
+int
+task_running(const pid_t pid)
+{
+        int status;
+        int ret;
+
+        if (pid != -1) {
+                ret = waitpid(pid, &status, WNOHANG);
+                if (ret == 0)
+                        return 1;
+                if (ret == pid &&
+                    (!WIFEXITED(status) && WEXITSTATUS(status) != EXIT_SUCCESS))
+                        exit(EXIT_FAILURE);
+
+        } else if (!g_cfg.command) {
+                unsigned i;
+
+                /* Send sig-null to check if pid is still running */
+                for (i = 0; i < g_cfg.pid_count; i++) {
+                        ret = kill(g_cfg.pids[i], 0);
+                        if (ret == 0)
+                                return 1;
+                }
+        }
+
+        return 0;
+}
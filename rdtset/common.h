@@ -158,6 +158,15 @@ struct rdt_config {
         struct pqos_l3ca l3; /**< L3 configuration */
         struct pqos_l2ca l2; /**< L2 configuration */
         struct pqos_mba mba; /**< MBA configuretion */
+        unsigned mba_weight; /**< MBA fair share weight, 0 if not set */
+        unsigned slo;        /**< p99 latency SLO [us], 0 if not set */
+        unsigned prefetch;   /**< mask of enabled HW prefetchers */
+        int prefetch_cfg;    /**< prefetch mask selected */
+        uint64_t l2_smt;     /**< L2 CBM of SMT siblings, 0 if not set */
+        cpu_set_t l2_smt_siblings; /**< siblings in restricted L2 class */
+        int irq_cfg;         /**< CPUs serving IRQs selected */
+        const char *irq_match; /**< IRQ name filter, NULL for all IRQs */
+        int irq_threads;     /**< associate IRQ kernel threads by PID */
         int pid_cfg;         /**< associate PIDs to this cfg */
 };
 
@@ -172,8 +181,12 @@ struct rdtset {
         unsigned sudo_keep : 1,        /**< don't drop elevated privileges */
             verbose : 1,               /**< be verbose */
             command : 1,               /**< command to be executed detected */
-            show_version : 1;          /**< print library version */
+            show_version : 1,          /**< print library version */
+            stat : 1;                  /**< run-and-report mode */
         enum pqos_interface interface; /**< pqos interface to use */
+        const char *slo_socket;        /**< latency samples socket path */
+        unsigned stat_interval;        /**< stat sampling interval [ms] */
+        const char *stat_json;         /**< stat JSON report path */
 };
 
 extern struct rdtset g_cfg;
@@ -245,6 +258,16 @@ unsigned strlisttotab(char *s, uint64_t *tab, const unsigned max);
  */
 uint64_t get_time_usec(void);
 
+/**
+ * @brief Check if child process or selected PIDs are still running
+ *
+ * @param[in] pid Child pid, -1 if no command was executed
+ *
+ * @return status
+ * @retval 1 if still running
+ */
+int task_running(const pid_t pid);
+
 /**
  * @brief Scale MB value to bytes
  *
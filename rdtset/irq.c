@@ -0,0 +1,545 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "irq.h"
+#include "common.h"
+#include "rdt.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <errno.h>
+#include <string.h>
+#include <ctype.h>
+#include <dirent.h>
+
+#define IRQ_PROC_INTERRUPTS "/proc/interrupts"
+
+static const struct pqos_cpuinfo *m_cpu;
+
+/**
+ * IRQ class state
+ */
+struct irq_class {
+        unsigned idx;      /**< rdtset configuration index */
+        unsigned *irqs;    /**< selected IRQ numbers */
+        unsigned num_irqs;
+        cpu_set_t cpuset;  /**< cores IRQs are affine to */
+        pid_t *pids;       /**< associated kernel threads */
+        unsigned num_pids;
+        unsigned class_id; /**< class kernel threads are associated with */
+};
+
+static struct irq_class *m_irq;
+static unsigned m_num_irq;
+
+int
+irq_mode(const struct rdtset *cfg)
+{
+        unsigned i;
+
+        for (i = 0; i < cfg->config_count; i++)
+                if (cfg->config[i].irq_cfg)
+                        return 1;
+
+        return 0;
+}
+
+/**
+ * @brief Selects IRQs of the class from /proc/interrupts
+ *
+ * IRQs that were never raised are skipped, so are architecture specific
+ * interrupts (NMI, LOC...) that are served by all cores.
+ *
+ * @param[in,out] cls IRQ class
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+irq_scan(struct irq_class *cls)
+{
+        const char *match = g_cfg.config[cls->idx].irq_match;
+        unsigned *irqs = NULL;
+        unsigned num_irqs = 0;
+        unsigned max_irqs = 0;
+        unsigned num_cols = 0;
+        char *saveptr = NULL;
+        char *line = NULL;
+        size_t len = 0;
+        char *tok;
+        FILE *fp;
+        int ret = 0;
+
+        fp = fopen(IRQ_PROC_INTERRUPTS, "r");
+        if (fp == NULL) {
+                fprintf(stderr, "IRQ: failed to open %s\n",
+                        IRQ_PROC_INTERRUPTS);
+                return -errno;
+        }
+
+        /* header has one column per online CPU */
+        if (getline(&line, &len, fp) < 0) {
+                ret = -EIO;
+                goto exit;
+        }
+        for (tok = strtok_r(line, " \t\n", &saveptr); tok != NULL;
+             tok = strtok_r(NULL, " \t\n", &saveptr))
+                num_cols++;
+
+        while (getline(&line, &len, fp) > 0) {
+                unsigned long long total = 0;
+                unsigned long irq;
+                char *p = line;
+                char *end = NULL;
+                unsigned i;
+
+                irq = strtoul(p, &end, 10);
+                if (end == p || *end != ':')
+                        continue;
+
+                for (p = end + 1, i = 0; i < num_cols; i++, p = end) {
+                        unsigned long long count = strtoull(p, &end, 10);
+
+                        if (end == p)
+                                break;
+                        total += count;
+                }
+                if (total == 0)
+                        continue;
+                if (match != NULL && strstr(p, match) == NULL)
+                        continue;
+
+                if (num_irqs == max_irqs) {
+                        unsigned *tmp;
+
+                        max_irqs = max_irqs ? 2 * max_irqs : 64;
+                        tmp = realloc(irqs, max_irqs * sizeof(irqs[0]));
+                        if (tmp == NULL) {
+                                ret = -ENOMEM;
+                                goto exit;
+                        }
+                        irqs = tmp;
+                }
+                irqs[num_irqs++] = (unsigned)irq;
+        }
+
+exit:
+        free(line);
+        fclose(fp);
+
+        if (ret == 0) {
+                free(cls->irqs);
+                cls->irqs = irqs;
+                cls->num_irqs = num_irqs;
+        } else
+                free(irqs);
+
+        return ret;
+}
+
+/**
+ * @brief Reads cores IRQ is affine to
+ *
+ * Effective affinity is used when the kernel provides it.
+ *
+ * @param[in] irq IRQ number
+ * @param[out] cpuset affinity
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+irq_affinity(const unsigned irq, cpu_set_t *cpuset)
+{
+        static const char *const files[] = {"effective_affinity_list",
+                                            "smp_affinity_list"};
+        unsigned i;
+
+        for (i = 0; i < DIM(files); i++) {
+                char path[64];
+                char buf[CPU_SETSIZE * 4];
+                char *nl;
+                FILE *fp;
+
+                snprintf(path, sizeof(path), "/proc/irq/%u/%s", irq, files[i]);
+                fp = fopen(path, "r");
+                if (fp == NULL)
+                        continue;
+                nl = fgets(buf, sizeof(buf), fp);
+                fclose(fp);
+                if (nl == NULL)
+                        continue;
+
+                nl = strchr(buf, '\n');
+                if (nl != NULL)
+                        *nl = '\0';
+                if (str_to_cpuset(buf, strlen(buf), cpuset) > 0)
+                        return 0;
+        }
+
+        return -ENOENT;
+}
+
+/**
+ * @brief Gets cores serving IRQs of the class
+ *
+ * IRQs affine to all cores are not pinned and are skipped.
+ *
+ * @param[in] cls IRQ class
+ * @param[out] cpuset cores serving IRQs
+ */
+static void
+irq_cpuset(const struct irq_class *cls, cpu_set_t *cpuset)
+{
+        unsigned i;
+
+        CPU_ZERO(cpuset);
+
+        for (i = 0; i < cls->num_irqs; i++) {
+                cpu_set_t affinity;
+                unsigned j, num_cores = 0;
+
+                if (irq_affinity(cls->irqs[i], &affinity) != 0)
+                        continue;
+
+                for (j = 0; j < m_cpu->num_cores; j++)
+                        if (CPU_ISSET(m_cpu->cores[j].lcore, &affinity))
+                                num_cores++;
+                if (num_cores == m_cpu->num_cores)
+                        continue;
+
+                for (j = 0; j < m_cpu->num_cores; j++)
+                        if (CPU_ISSET(m_cpu->cores[j].lcore, &affinity))
+                                CPU_SET(m_cpu->cores[j].lcore, cpuset);
+        }
+}
+
+/**
+ * @brief Gets cores of the class not used by other classes
+ *
+ * @param[in] cls IRQ class
+ * @param[out] cores cores to be associated with IRQ class
+ */
+static void
+irq_get_cores(const struct irq_class *cls, cpu_set_t *cores)
+{
+        unsigned i, j;
+
+        *cores = cls->cpuset;
+
+        for (i = 0; i < g_cfg.config_count; i++) {
+                const struct rdt_config *config = &g_cfg.config[i];
+
+                if (i == cls->idx)
+                        continue;
+
+                for (j = 0; j < CPU_SETSIZE; j++)
+                        if (CPU_ISSET(j, &config->cpumask) ||
+                            CPU_ISSET(j, &config->l2_smt_siblings))
+                                CPU_CLR(j, cores);
+        }
+}
+
+/**
+ * @brief Checks if kernel thread handles IRQs of the class
+ *
+ * @param[in] cls IRQ class
+ * @param[in] comm kernel thread name
+ *
+ * @return 1 for softirq thread of IRQ core or threaded IRQ handler
+ */
+static int
+irq_thread_match(const struct irq_class *cls, const char *comm)
+{
+        unsigned val, i;
+        char c;
+
+        if (sscanf(comm, "ksoftirqd/%u%c", &val, &c) == 1)
+                return val < CPU_SETSIZE && CPU_ISSET(val, &cls->cpuset);
+
+        if (sscanf(comm, "irq/%u-%c", &val, &c) == 2)
+                for (i = 0; i < cls->num_irqs; i++)
+                        if (cls->irqs[i] == val)
+                                return 1;
+
+        return 0;
+}
+
+/**
+ * @brief Associates kernel threads handling IRQs with the class
+ *
+ * Threads are associated by PID, so they stay in the IRQ class when
+ * they run on cores of other classes.
+ *
+ * @param[in,out] cls IRQ class
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+irq_threads_assoc(struct irq_class *cls)
+{
+        const struct rdt_config *config = &g_cfg.config[cls->idx];
+        unsigned class_id, i;
+        struct dirent *ent;
+        DIR *dir;
+
+        for (i = 0; i < CPU_SETSIZE; i++)
+                if (CPU_ISSET(i, &config->cpumask))
+                        break;
+        if (i == CPU_SETSIZE ||
+            pqos_alloc_assoc_get(i, &class_id) != PQOS_RETVAL_OK)
+                return -EFAULT;
+
+        /* class changed, move threads already associated */
+        if (class_id != cls->class_id) {
+                unsigned num_pids = 0;
+
+                for (i = 0; i < cls->num_pids; i++)
+                        if (pqos_alloc_assoc_set_pid(cls->pids[i], class_id) ==
+                            PQOS_RETVAL_OK)
+                                cls->pids[num_pids++] = cls->pids[i];
+                cls->num_pids = num_pids;
+                cls->class_id = class_id;
+        }
+
+        dir = opendir("/proc");
+        if (dir == NULL)
+                return -errno;
+
+        while ((ent = readdir(dir)) != NULL) {
+                char path[64];
+                char comm[32];
+                char *nl;
+                pid_t pid;
+                FILE *fp;
+                pid_t *tmp;
+
+                if (!isdigit(ent->d_name[0]))
+                        continue;
+                pid = (pid_t)atoi(ent->d_name);
+
+                for (i = 0; i < cls->num_pids; i++)
+                        if (cls->pids[i] == pid)
+                                break;
+                if (i < cls->num_pids)
+                        continue;
+
+                snprintf(path, sizeof(path), "/proc/%d/comm", (int)pid);
+                fp = fopen(path, "r");
+                if (fp == NULL)
+                        continue;
+                nl = fgets(comm, sizeof(comm), fp);
+                fclose(fp);
+                if (nl == NULL)
+                        continue;
+                nl = strchr(comm, '\n');
+                if (nl != NULL)
+                        *nl = '\0';
+
+                if (!irq_thread_match(cls, comm))
+                        continue;
+
+                tmp = realloc(cls->pids, (cls->num_pids + 1) * sizeof(*tmp));
+                if (tmp == NULL)
+                        break;
+                cls->pids = tmp;
+
+                if (pqos_alloc_assoc_set_pid(pid, class_id) !=
+                    PQOS_RETVAL_OK) {
+                        DBG("IRQ: failed to associate %s (%d)\n", comm,
+                            (int)pid);
+                        continue;
+                }
+                DBG("IRQ: %s (%d) associated with COS%u\n", comm, (int)pid,
+                    class_id);
+                cls->pids[cls->num_pids++] = pid;
+        }
+        closedir(dir);
+
+        return 0;
+}
+
+/**
+ * @brief Updates cores and threads of IRQ class
+ *
+ * @param[in,out] cls IRQ class
+ * @param[in] rescan read IRQs from /proc/interrupts again
+ */
+static void
+irq_update(struct irq_class *cls, const int rescan)
+{
+        const struct rdt_config *config = &g_cfg.config[cls->idx];
+        cpu_set_t cores;
+
+        if (rescan && irq_scan(cls) != 0)
+                return;
+
+        irq_cpuset(cls, &cls->cpuset);
+        irq_get_cores(cls, &cores);
+        if (CPU_COUNT(&cores) == 0) {
+                DBG("IRQ: no cores serving IRQs, keeping current cores\n");
+                return;
+        }
+
+        if (alloc_update(cls->idx, &cores) != 0)
+                fprintf(stderr, "IRQ: failed to update IRQ class cores\n");
+
+        if (rescan && config->irq_threads)
+                (void)irq_threads_assoc(cls);
+}
+
+int
+irq_init(void)
+{
+        const struct pqos_cap *cap;
+        unsigned i;
+        int ret;
+
+        if (m_cpu != NULL) {
+                DBG("IRQ: module already initialized!\n");
+                return -EEXIST;
+        }
+
+        ret = pqos_cap_get(&cap, &m_cpu);
+        if (ret != PQOS_RETVAL_OK) {
+                DBG("IRQ: Error retrieving PQoS capabilities!\n");
+                return -EFAULT;
+        }
+
+        m_irq = calloc(g_cfg.config_count, sizeof(*m_irq));
+        if (m_irq == NULL) {
+                ret = -ENOMEM;
+                goto err;
+        }
+
+        for (i = 0; i < g_cfg.config_count; i++) {
+                struct rdt_config *config = &g_cfg.config[i];
+                struct irq_class *cls = &m_irq[m_num_irq];
+                char cpustr[CPU_SETSIZE * 3];
+
+                if (!config->irq_cfg)
+                        continue;
+
+                if (config->irq_threads && g_cfg.interface != PQOS_INTER_OS) {
+                        fprintf(stderr, "IRQ: irq_threads requires OS "
+                                        "interface (-I)\n");
+                        ret = -EINVAL;
+                        goto err;
+                }
+
+                cls->idx = i;
+                cls->class_id = 0;
+                m_num_irq++;
+
+                ret = irq_scan(cls);
+                if (ret != 0)
+                        goto err;
+
+                irq_cpuset(cls, &cls->cpuset);
+                irq_get_cores(cls, &config->cpumask);
+                if (CPU_COUNT(&config->cpumask) == 0) {
+                        fprintf(stderr, "IRQ: no cores serving %s IRQs\n",
+                                config->irq_match != NULL ? config->irq_match
+                                                          : "pinned");
+                        ret = -ENODEV;
+                        goto err;
+                }
+
+                cpuset_to_str(cpustr, sizeof(cpustr), &config->cpumask);
+                DBG("IRQ: %u IRQs served by CPUs %s\n", cls->num_irqs, cpustr);
+        }
+
+        return 0;
+err:
+        irq_fini();
+        return ret;
+}
+
+void
+irq_fini(void)
+{
+        unsigned i;
+
+        for (i = 0; i < m_num_irq; i++) {
+                free(m_irq[i].irqs);
+                free(m_irq[i].pids);
+        }
+        free(m_irq);
+        m_irq = NULL;
+        m_num_irq = 0;
+        m_cpu = NULL;
+}
+
+void
+irq_exit(void)
+{
+        unsigned i, j;
+
+        for (i = 0; i < m_num_irq; i++) {
+                struct irq_class *cls = &m_irq[i];
+
+                /* threads may have exited, release one by one */
+                for (j = 0; j < cls->num_pids; j++)
+                        (void)pqos_alloc_release_pid(&cls->pids[j], 1);
+                cls->num_pids = 0;
+        }
+}
+
+int
+irq_main(pid_t pid)
+{
+        unsigned tick = 0;
+        unsigned i;
+
+        if (m_cpu == NULL)
+                return -EFAULT;
+
+        for (i = 0; i < m_num_irq; i++)
+                if (g_cfg.config[m_irq[i].idx].irq_threads)
+                        (void)irq_threads_assoc(&m_irq[i]);
+
+        while (task_running(pid)) {
+                usleep(IRQ_CHECK_INTERVAL * 1000);
+                tick++;
+
+                for (i = 0; i < m_num_irq; i++)
+                        irq_update(&m_irq[i], tick % IRQ_RESCAN_TICKS == 0);
+        }
+
+        return 0;
+}
@@ -0,0 +1,89 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _IRQ_H
+#define _IRQ_H
+
+#include <unistd.h>
+#include "common.h"
+
+#define IRQ_CHECK_INTERVAL 1000 /**< IRQ affinity check interval in ms */
+#define IRQ_RESCAN_TICKS   10   /**< checks between /proc/interrupts scans */
+
+/**
+ * @brief Checks if IRQ class is configured
+ *
+ * @param[in] cfg rdtset configuration
+ *
+ * @return 1 if at least one class selects IRQ serving cores
+ */
+int irq_mode(const struct rdtset *cfg);
+
+/**
+ * @brief Initializes IRQ module
+ *
+ * Selects IRQs from /proc/interrupts and sets CPUs of IRQ classes
+ * to the cores serving them. Cores of other classes are excluded.
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+int irq_init(void);
+
+/**
+ * @brief Shuts down IRQ module
+ */
+void irq_fini(void);
+
+/**
+ * @brief Releases kernel threads associated with IRQ classes
+ */
+void irq_exit(void);
+
+/**
+ * @brief Main loop of IRQ module
+ *
+ * IRQ affinity is checked every IRQ_CHECK_INTERVAL and cores of IRQ
+ * classes are updated when it changes. New IRQs are picked up from
+ * /proc/interrupts every IRQ_RESCAN_TICKS checks.
+ *
+ * @param[in] pid Child pid to monitor for exit status
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+int irq_main(pid_t pid);
+
+#endif /* #define _IRQ_H */
@@ -39,8 +39,6 @@
 #include <sched.h>
 #include <errno.h>
 #include <string.h>
-#include <sys/wait.h>
-#include <signal.h>
 
 static const struct pqos_cap *m_cap;
 static const struct pqos_cpuinfo *m_cpu;
@@ -63,6 +61,36 @@ static struct mba_sc_state *state = NULL;
 static unsigned state_num;
 static int supported = 0;
 
+/**
+ * Weighted fair share class on single MBA cluster
+ */
+struct mba_fs_class {
+        struct pqos_mon_data group;
+        unsigned cluster;  /**< MBA cluster id */
+        unsigned lcore;    /**< core to read class id from */
+        unsigned weight;   /**< fair share weight */
+        unsigned rate;     /**< current MBA rate */
+        uint64_t bw;       /**< last measured bandwidth [B/s] */
+        uint64_t share;    /**< weighted fair share [B/s] */
+};
+
+/**
+ * Weighted fair share state of single MBA cluster
+ */
+struct mba_fs_cluster {
+        unsigned id;             /**< MBA cluster id */
+        uint64_t capacity;       /**< estimated bandwidth capacity [B/s] */
+        uint64_t total_bw;       /**< last measured total bandwidth [B/s] */
+        int saturated;           /**< cluster bandwidth saturated */
+        uint64_t reg_start_time; /**< start of regulation, 0 if stable */
+};
+
+static struct mba_fs_class *fs_class = NULL;
+static struct pqos_mon_data **fs_groups = NULL;
+static unsigned fs_class_num;
+static struct mba_fs_cluster *fs_cluster = NULL;
+static unsigned fs_cluster_num;
+
 /**
  * @brief Start LMBM monitoring
  *
@@ -223,8 +251,31 @@ mba_sc_stop(void)
         unsigned i;
         int ret = 0;
 
+        if (fs_class != NULL) {
+                for (i = 0; i < fs_class_num; i++) {
+                        int retval = mba_sc_mon_stop(&fs_class[i].group);
+
+                        if (retval < 0)
+                                ret = retval;
+                }
+                free(fs_class);
+                fs_class = NULL;
+                fs_class_num = 0;
+        }
+
+        if (fs_groups != NULL) {
+                free(fs_groups);
+                fs_groups = NULL;
+        }
+
+        if (fs_cluster != NULL) {
+                free(fs_cluster);
+                fs_cluster = NULL;
+                fs_cluster_num = 0;
+        }
+
         if (state == NULL)
-                return 0;
+                return ret;
 
         for (i = 0; i < state_num; i++) {
                 int retval = mba_sc_mon_stop(&state[i].group);
@@ -245,41 +296,6 @@ mba_sc_exit(void)
         mba_sc_stop();
 }
 
-/**
- * @brief Check if child process is still running
- *
- * @param[in] pid Child pid
- *
- * @return status
- */
-static int
-mba_sc_running(const pid_t pid)
-{
-        int status;
-        int ret;
-
-        if (pid != -1) {
-                ret = waitpid(pid, &status, WNOHANG);
-                if (ret == 0)
-                        return 1;
-                if (ret == pid &&
-                    (!WIFEXITED(status) && WEXITSTATUS(status) != EXIT_SUCCESS))
-                        exit(EXIT_FAILURE);
-
-        } else if (!g_cfg.command) {
-                unsigned i;
-
-                /* Send sig-null to check if pid is still running */
-                for (i = 0; i < g_cfg.pid_count; i++) {
-                        ret = kill(g_cfg.pids[i], 0);
-                        if (ret == 0)
-                                return 1;
-                }
-        }
-
-        return 0;
-}
-
 int
 mba_sc_mode(const struct rdtset *cfg)
 {
@@ -289,7 +305,8 @@ mba_sc_mode(const struct rdtset *cfg)
                 return 0;
 
         for (i = 0; i < cfg->config_count; i++)
-                if (cfg->config[i].mba.ctrl == 1)
+                if (cfg->config[i].mba.ctrl == 1 ||
+                    cfg->config[i].mba_weight > 0)
                         return 1;
 
         return 0;
@@ -440,6 +457,343 @@ mba_sc_update(struct mba_sc_state *state)
         return 0;
 }
 
+/**
+ * @brief Sets MBA rate of fair share class
+ *
+ * @param [in] fs fair share class
+ * @param [in] rate MBA rate to be set
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+mba_fs_rate_set(struct mba_fs_class *fs, const unsigned rate)
+{
+        struct pqos_mba mba_cfg;
+        int ret;
+
+        mba_cfg.ctrl = 0;
+        mba_cfg.mb_max = rate;
+
+        ret = pqos_alloc_assoc_get(fs->lcore, &mba_cfg.class_id);
+        if (ret != PQOS_RETVAL_OK) {
+                DBG("MBA FS: error while reading assoc for lcore %u\n",
+                    fs->lcore);
+                return -EFAULT;
+        }
+
+        ret = pqos_mba_set(fs->cluster, 1, &mba_cfg, NULL);
+        if (ret != PQOS_RETVAL_OK) {
+                DBG("MBA FS: error while setting mba for cluster %u\n",
+                    fs->cluster);
+                return -EFAULT;
+        }
+
+        fs->rate = rate;
+
+        return 0;
+}
+
+/**
+ * @brief Starts weighted fair share controller
+ *
+ * One class is created for each weighted configuration on each MBA
+ * cluster its cores belong to.
+ *
+ * @param[in] cfg rdtset configuration
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+mba_fs_start(const struct rdtset *cfg)
+{
+        unsigned i;
+        int ret;
+
+        fs_class = calloc(cfg->config_count * m_cpu->num_cores,
+                          sizeof(*fs_class));
+        fs_groups = calloc(cfg->config_count * m_cpu->num_cores,
+                           sizeof(*fs_groups));
+        fs_cluster = calloc(m_cpu->num_cores, sizeof(*fs_cluster));
+        if (fs_class == NULL || fs_groups == NULL || fs_cluster == NULL) {
+                DBG("MBA FS: memory allocation failed\n");
+                return -EFAULT;
+        }
+
+        /* register MBA clusters of weighted configurations */
+        for (i = 0; i < cfg->config_count; i++) {
+                const struct rdt_config *config = &cfg->config[i];
+                unsigned j;
+
+                if (config->mba_weight == 0)
+                        continue;
+
+                if (config->pid_cfg) {
+                        DBG("MBA FS: weight requires cpu list\n");
+                        return -EINVAL;
+                }
+
+                for (j = 0; j < m_cpu->num_cores; j++) {
+                        const unsigned lcore = m_cpu->cores[j].lcore;
+                        unsigned cluster;
+                        unsigned k;
+
+                        if (!CPU_ISSET(lcore, &config->cpumask))
+                                continue;
+                        if (pqos_cpu_get_clusterid(m_cpu, lcore, &cluster) !=
+                            PQOS_RETVAL_OK)
+                                return -EFAULT;
+                        for (k = 0; k < fs_cluster_num; k++)
+                                if (fs_cluster[k].id == cluster)
+                                        break;
+                        if (k == fs_cluster_num)
+                                fs_cluster[fs_cluster_num++].id = cluster;
+                }
+        }
+
+        /* start monitoring of each configuration on each cluster */
+        for (i = 0; i < cfg->config_count; i++) {
+                const struct rdt_config *config = &cfg->config[i];
+                unsigned j;
+
+                if (config->mba_weight == 0)
+                        continue;
+
+                for (j = 0; j < fs_cluster_num; j++) {
+                        struct mba_fs_class *fs = &fs_class[fs_class_num];
+                        cpu_set_t cpumask;
+                        unsigned k;
+
+                        CPU_ZERO(&cpumask);
+                        for (k = 0; k < m_cpu->num_cores; k++) {
+                                const unsigned lcore = m_cpu->cores[k].lcore;
+
+                                if (!CPU_ISSET(lcore, &config->cpumask) ||
+                                    m_cpu->cores[k].l3_id != fs_cluster[j].id)
+                                        continue;
+                                if (CPU_COUNT(&cpumask) == 0)
+                                        fs->lcore = lcore;
+                                CPU_SET(lcore, &cpumask);
+                        }
+                        if (CPU_COUNT(&cpumask) == 0)
+                                continue;
+
+                        ret = mba_sc_mon_start(cpumask, &fs->group);
+                        if (ret != 0) {
+                                DBG("MBA FS: failed to start monitoring\n");
+                                return ret;
+                        }
+                        fs->cluster = fs_cluster[j].id;
+                        fs->weight = config->mba_weight;
+                        fs->rate = MBA_SC_DEF_INIT_MBA;
+                        fs_groups[fs_class_num++] = &fs->group;
+                }
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Computes weighted max-min fair shares on the cluster
+ *
+ * Classes using less than their share give the rest to other classes.
+ * Throttled classes are assumed to demand more than they use.
+ *
+ * @param[in] cluster MBA cluster
+ */
+static void
+mba_fs_share(const struct mba_fs_cluster *cluster)
+{
+        uint64_t remaining = cluster->capacity;
+        unsigned i;
+        int changed;
+
+        for (i = 0; i < fs_class_num; i++)
+                fs_class[i].share = 0;
+
+        do {
+                uint64_t weights = 0;
+
+                changed = 0;
+                for (i = 0; i < fs_class_num; i++)
+                        if (fs_class[i].cluster == cluster->id &&
+                            fs_class[i].share == 0)
+                                weights += fs_class[i].weight;
+                if (weights == 0)
+                        break;
+
+                for (i = 0; i < fs_class_num; i++) {
+                        struct mba_fs_class *fs = &fs_class[i];
+                        const uint64_t share =
+                            remaining * fs->weight / weights;
+
+                        if (fs->cluster != cluster->id || fs->share != 0)
+                                continue;
+                        if (fs->rate >= MBA_SC_DEF_INIT_MBA &&
+                            fs->bw < share) {
+                                /* demand satisfied, give the rest away */
+                                fs->share = fs->bw > 0 ? fs->bw : 1;
+                                remaining -= fs->share;
+                                changed = 1;
+                        }
+                }
+                if (changed)
+                        continue;
+
+                for (i = 0; i < fs_class_num; i++) {
+                        struct mba_fs_class *fs = &fs_class[i];
+
+                        if (fs->cluster == cluster->id && fs->share == 0)
+                                fs->share = remaining * fs->weight / weights;
+                }
+        } while (changed);
+}
+
+/**
+ * @brief Computes Jain's fairness index of weighted bandwidth on cluster
+ *
+ * @param[in] cluster MBA cluster
+ *
+ * @return fairness index, 1 for perfectly weighted allocation
+ */
+static double
+mba_fs_fairness(const struct mba_fs_cluster *cluster)
+{
+        double sum = 0;
+        double sum_sq = 0;
+        unsigned num = 0;
+        unsigned i;
+
+        for (i = 0; i < fs_class_num; i++) {
+                const struct mba_fs_class *fs = &fs_class[i];
+                double x;
+
+                if (fs->cluster != cluster->id || fs->share == 0)
+                        continue;
+
+                x = (double)fs->bw / (double)fs->share;
+                sum += x;
+                sum_sq += x * x;
+                num++;
+        }
+
+        if (num == 0 || sum_sq == 0)
+                return 1;
+
+        return (sum * sum) / (num * sum_sq);
+}
+
+/**
+ * @brief Single step of weighted fair share controller on the cluster
+ *
+ * When the cluster is saturated classes above their weighted share are
+ * throttled and classes below are released. When bandwidth is idle all
+ * classes are released.
+ *
+ * @param[in] cluster MBA cluster
+ */
+static void
+mba_fs_cluster_update(struct mba_fs_cluster *cluster)
+{
+        const unsigned min_rate = m_cap_mba->u.mba->throttle_step;
+        const unsigned step_rate = m_cap_mba->u.mba->throttle_step;
+        const unsigned max_rate = MBA_SC_DEF_INIT_MBA;
+        uint64_t cur_time = get_time_usec();
+        int changed = 0;
+        unsigned i;
+
+        cluster->total_bw = 0;
+        for (i = 0; i < fs_class_num; i++)
+                if (fs_class[i].cluster == cluster->id)
+                        cluster->total_bw += fs_class[i].bw;
+
+        /* capacity is the peak bandwidth seen, decaying slowly */
+        cluster->capacity -= cluster->capacity / 1000;
+        if (cluster->total_bw > cluster->capacity)
+                cluster->capacity = cluster->total_bw;
+
+        cluster->saturated = cluster->capacity > 0 &&
+                             cluster->total_bw >= cluster->capacity * 9 / 10;
+
+        mba_fs_share(cluster);
+
+        for (i = 0; i < fs_class_num; i++) {
+                struct mba_fs_class *fs = &fs_class[i];
+                unsigned rate = fs->rate;
+
+                if (fs->cluster != cluster->id)
+                        continue;
+
+                if (cluster->saturated && fs->bw > fs->share &&
+                    fs->rate > min_rate)
+                        rate = fs->rate - step_rate;
+                else if (fs->rate < max_rate &&
+                         (!cluster->saturated || fs->bw < fs->share * 9 / 10))
+                        rate = fs->rate + step_rate;
+
+                if (rate > max_rate)
+                        rate = max_rate;
+                if (rate == fs->rate)
+                        continue;
+
+                DBG("MBA FS: cluster %u class weight %u %lluMBps share "
+                    "%lluMBps, setting MBA to %u%%\n",
+                    cluster->id, fs->weight,
+                    (unsigned long long)bytes_to_mb(fs->bw),
+                    (unsigned long long)bytes_to_mb(fs->share), rate);
+                if (mba_fs_rate_set(fs, rate) == 0)
+                        changed = 1;
+        }
+
+        if (changed) {
+                if (!cluster->reg_start_time)
+                        cluster->reg_start_time = cur_time;
+        } else if (cluster->reg_start_time) {
+                DBG("MBA FS: cluster %u %lluMBps of %lluMBps%s, fairness "
+                    "%.3f, regulation took %.1fs\n",
+                    cluster->id,
+                    (unsigned long long)bytes_to_mb(cluster->total_bw),
+                    (unsigned long long)bytes_to_mb(cluster->capacity),
+                    cluster->saturated ? " saturated" : "",
+                    mba_fs_fairness(cluster),
+                    (cur_time - cluster->reg_start_time) / 1000000.0);
+                cluster->reg_start_time = 0;
+        }
+}
+
+/**
+ * @brief Single step of weighted fair share controller
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+mba_fs_update(void)
+{
+        unsigned i;
+        int ret;
+
+        if (fs_class_num == 0)
+                return 0;
+
+        /* all classes are read together, rates use own read interval */
+        ret = pqos_mon_poll_snapshot(fs_groups, fs_class_num, NULL);
+        if (ret != PQOS_RETVAL_OK)
+                return -EFAULT;
+
+        for (i = 0; i < fs_class_num; i++)
+                fs_class[i].bw = (uint64_t)fs_class[i].group.mbm_local_rate;
+
+        for (i = 0; i < fs_cluster_num; i++)
+                mba_fs_cluster_update(&fs_cluster[i]);
+
+        return 0;
+}
+
 int
 mba_sc_main(pid_t pid)
 {
@@ -453,7 +807,7 @@ mba_sc_main(pid_t pid)
         /* allocate memory for state struct */
         state_num = mba_sc_count(&g_cfg);
         state = calloc(state_num, sizeof(*state));
-        if (state == NULL) {
+        if (state == NULL && state_num > 0) {
                 DBG("MBA SC: memory allocation failed\n");
                 return -EFAULT;
         }
@@ -477,14 +831,20 @@ mba_sc_main(pid_t pid)
                 }
         }
 
+        ret = mba_fs_start(&g_cfg);
+        if (ret != 0)
+                goto err;
+
         for (i = 0; i < state_num; i++)
                 state[i].prev_time = get_time_usec();
 
-        while (mba_sc_running(pid)) {
+        while (task_running(pid)) {
                 usleep(MBA_SC_SAMPLING_INTERVAL * 1000);
 
                 for (i = 0; i < state_num; i++)
                         mba_sc_update(&state[i]);
+
+                mba_fs_update();
         }
 
 err:
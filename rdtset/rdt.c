@@ -53,6 +53,14 @@ static const struct pqos_capability *m_cap_l2ca = NULL;
 static const struct pqos_capability *m_cap_l3ca = NULL;
 static const struct pqos_capability *m_cap_mba = NULL;
 
+/**
+ * Prefetcher state of cores before rdtset changed it
+ */
+static struct {
+        unsigned enabled; /**< mask of enabled prefetchers */
+        int saved;        /**< state saved for the core */
+} m_prefetch[CPU_SETSIZE];
+
 /**
  * @brief Prints L2, L3 or MBA configuration in \a cfg
  *
@@ -495,6 +503,40 @@ rdt_mba_str_to_mbps(const char *param, struct rdt_cfg mba)
         return 0;
 }
 
+/**
+ * @brief Parses fair share weight string \a param and stores in \a mba
+ *
+ * Class starts unthrottled, MBA rate is adjusted by the SW controller.
+ *
+ * @param [in] param weight string
+ * @param [out] mba to store result
+ * @param [out] weight to store weight
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+rdt_mba_str_to_weight(const char *param, struct rdt_cfg mba, unsigned *weight)
+{
+        uint64_t val;
+        int ret;
+
+        if (PQOS_CAP_TYPE_MBA != mba.type || NULL == mba.u.generic_ptr ||
+            NULL == param)
+                return -EINVAL;
+
+        ret = str_to_uint64(param, 10, &val);
+        if (ret < 0 || val == 0 || val > UINT_MAX)
+                return -EINVAL;
+
+        mba.u.mba->ctrl = 0;
+        mba.u.mba->mb_max = MBA_SC_DEF_INIT_MBA;
+        *weight = (unsigned)val;
+
+        return 0;
+}
+
 /*
  * @brief Simplifies feature string
  *
@@ -517,6 +559,11 @@ simplify_feature_str(const char *feature)
             {"l3", '3'},
             {"mba", 'm'},
             {"mba_max", 'b'},
+            {"mba_weight", 'w'},
+            {"slo", 's'},
+            {"prefetch", 'f'},
+            {"l2_smt", 'l'},
+            {"irq_threads", 'i'},
             {NULL, 0}
             /* clang-format on */
         };
@@ -593,9 +640,20 @@ parse_rdt(char *rdtstr)
                         break;
 
                 case 'c':
-                        if (CPU_COUNT(&g_cfg.config[idx].cpumask) != 0)
+                        if (CPU_COUNT(&g_cfg.config[idx].cpumask) != 0 ||
+                            g_cfg.config[idx].irq_cfg)
                                 return -EINVAL;
 
+                        /* CPUs serving IRQs are selected by irq module */
+                        if (strcmp(param, "irq") == 0 ||
+                            strncmp(param, "irq:", 4) == 0) {
+                                g_cfg.config[idx].irq_cfg = 1;
+                                if (param[3] == ':' && param[4] != '\0')
+                                        g_cfg.config[idx].irq_match =
+                                            param + 4;
+                                break;
+                        }
+
                         ret = str_to_cpuset(param, strlen(param),
                                             &g_cfg.config[idx].cpumask);
                         if (ret <= 0)
@@ -623,6 +681,67 @@ parse_rdt(char *rdtstr)
                                 return ret;
                         break;
 
+                case 'w':
+                        if (rdt_cfg_is_valid(mba))
+                                return -EINVAL;
+
+                        ret = rdt_mba_str_to_weight(
+                            param, mba, &g_cfg.config[idx].mba_weight);
+                        if (ret < 0)
+                                return ret;
+                        break;
+
+                case 's': {
+                        uint64_t slo;
+
+                        if (g_cfg.config[idx].slo != 0)
+                                return -EINVAL;
+
+                        ret = str_to_uint64(param, 10, &slo);
+                        if (ret < 0 || slo == 0 || slo > UINT_MAX)
+                                return -EINVAL;
+                        g_cfg.config[idx].slo = (unsigned)slo;
+                        break;
+                }
+
+                case 'f': {
+                        uint64_t prefetch;
+
+                        if (g_cfg.config[idx].prefetch_cfg)
+                                return -EINVAL;
+
+                        ret = str_to_uint64(param, 16, &prefetch);
+                        if (ret < 0 || prefetch > PQOS_PREFETCH_ALL)
+                                return -EINVAL;
+                        g_cfg.config[idx].prefetch = (unsigned)prefetch;
+                        g_cfg.config[idx].prefetch_cfg = 1;
+                        break;
+                }
+
+                case 'l': {
+                        uint64_t mask;
+
+                        if (g_cfg.config[idx].l2_smt != 0)
+                                return -EINVAL;
+
+                        ret = str_to_uint64(param, 16, &mask);
+                        if (ret < 0 || mask == 0 ||
+                            is_contiguous("L2", mask) == 0)
+                                return -EINVAL;
+                        g_cfg.config[idx].l2_smt = mask;
+                        break;
+                }
+
+                case 'i': {
+                        uint64_t threads;
+
+                        ret = str_to_uint64(param, 10, &threads);
+                        if (ret < 0 || threads > 1)
+                                return -EINVAL;
+                        g_cfg.config[idx].irq_threads = (int)threads;
+                        break;
+                }
+
                 default:
                         fprintf(stderr, "Invalid option: \"%s\"\n", feature);
                         return -EINVAL;
@@ -632,11 +751,32 @@ parse_rdt(char *rdtstr)
         }
 
         /* if no cpus specified then set pid flag */
-        if (CPU_COUNT(&g_cfg.config[idx].cpumask) == 0)
+        if (CPU_COUNT(&g_cfg.config[idx].cpumask) == 0 &&
+            !g_cfg.config[idx].irq_cfg)
                 g_cfg.config[idx].pid_cfg = 1;
 
-        if (!(rdt_cfg_is_valid(l2ca) || rdt_cfg_is_valid(l3ca) ||
-              rdt_cfg_is_valid(mba)))
+        if (g_cfg.config[idx].irq_threads && !g_cfg.config[idx].irq_cfg) {
+                fprintf(stderr, "irq_threads requires cpu=irq\n");
+                return -EINVAL;
+        }
+
+        /* prefetchers are controlled per core */
+        if (g_cfg.config[idx].pid_cfg && g_cfg.config[idx].prefetch_cfg) {
+                fprintf(stderr, "Prefetch requires CPUs to be specified\n");
+                return -EINVAL;
+        }
+
+        /* L2 SMT partitioning selects its own classes per L2 cluster */
+        if (g_cfg.config[idx].l2_smt != 0) {
+                if (g_cfg.config[idx].pid_cfg || g_cfg.config[idx].irq_cfg ||
+                    rdt_cfg_is_valid(l2ca) || rdt_cfg_is_valid(l3ca) ||
+                    rdt_cfg_is_valid(mba)) {
+                        fprintf(stderr, "l2_smt can only be combined with "
+                                        "cpu and prefetch\n");
+                        return -EINVAL;
+                }
+        } else if (!(rdt_cfg_is_valid(l2ca) || rdt_cfg_is_valid(l3ca) ||
+                     rdt_cfg_is_valid(mba)))
                 return -EINVAL;
 
         g_cfg.config_count++;
@@ -886,7 +1026,8 @@ check_supported(void)
                         return -ENOTSUP;
                 }
 
-                if (rdt_cfg_is_valid(wrap_l2ca(&g_cfg.config[i].l2)) &&
+                if ((rdt_cfg_is_valid(wrap_l2ca(&g_cfg.config[i].l2)) ||
+                     g_cfg.config[i].l2_smt != 0) &&
                     NULL == m_cap_l2ca) {
                         fprintf(stderr, "Allocation: L2CA requested but not "
                                         "supported by system!\n");
@@ -1067,6 +1208,86 @@ check_cbm_len_and_contention_all(void)
         return 0;
 }
 
+/**
+ * @brief Validates L2 SMT partitioning and finds SMT siblings
+ *        of the latency critical cores
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+check_l2_smt(void)
+{
+        unsigned i;
+
+        for (i = 0; i < g_cfg.config_count; i++) {
+                struct rdt_config *cfg = &g_cfg.config[i];
+                uint64_t ways_mask;
+                unsigned j;
+
+                if (cfg->l2_smt == 0)
+                        continue;
+
+                ways_mask = (1ULL << m_cap_l2ca->u.l2ca->num_ways) - 1ULL;
+                if ((cfg->l2_smt & ~ways_mask) != 0 ||
+                    cfg->l2_smt == ways_mask ||
+                    !is_contiguous("L2", ways_mask & ~cfg->l2_smt)) {
+                        fprintf(stderr, "Allocation: L2 SMT sibling mask "
+                                        "0x%llx leaves no contiguous ways "
+                                        "for critical cores.\n",
+                                (unsigned long long)cfg->l2_smt);
+                        return -EINVAL;
+                }
+
+                CPU_ZERO(&cfg->l2_smt_siblings);
+                for (j = 0; j < m_cpu->num_cores; j++) {
+                        const struct pqos_coreinfo *ci = &m_cpu->cores[j];
+                        unsigned k, cos_id = 0;
+                        int critical = 0;
+
+                        if (CPU_ISSET(ci->lcore, &cfg->cpumask))
+                                continue;
+
+                        for (k = 0; k < m_cpu->num_cores && !critical; k++)
+                                critical = m_cpu->cores[k].l2_id ==
+                                               ci->l2_id &&
+                                           CPU_ISSET(m_cpu->cores[k].lcore,
+                                                     &cfg->cpumask);
+                        if (!critical)
+                                continue;
+
+                        for (k = 0; k < g_cfg.config_count; k++)
+                                if (CPU_ISSET(ci->lcore,
+                                              &g_cfg.config[k].cpumask)) {
+                                        fprintf(stderr,
+                                                "Allocation: cpu %u shares L2 "
+                                                "with l2_smt cores and can't "
+                                                "be configured.\n",
+                                                ci->lcore);
+                                        return -EINVAL;
+                                }
+
+                        if (pqos_alloc_assoc_get(ci->lcore, &cos_id) !=
+                            PQOS_RETVAL_OK)
+                                return -EFAULT;
+
+                        if (cos_id != 0) {
+                                fprintf(stderr,
+                                        "Allocation: cpu %u has already "
+                                        "associated COS#%u. Please reset "
+                                        "allocation.\n",
+                                        ci->lcore, cos_id);
+                                return -EBUSY;
+                        }
+
+                        CPU_SET(ci->lcore, &cfg->l2_smt_siblings);
+                }
+        }
+
+        return 0;
+}
+
 /**
  * @brief Validates requested CAT/MBA configuration
  *
@@ -1107,6 +1328,10 @@ alloc_validate(void)
         if (ret != 0)
                 return ret;
 
+        ret = check_l2_smt();
+        if (ret != 0)
+                return ret;
+
         return 0;
 }
 
@@ -1773,6 +1998,237 @@ set_pids_exit:
         return ret;
 }
 
+/**
+ * @brief Partitions L2 cache between latency critical \a cores
+ *        and their SMT siblings
+ *
+ * In each L2 cluster critical cores and siblings are assigned to separate
+ * classes and both class definitions are written with a single
+ * pqos_l2ca_set() call per cluster.
+ *
+ * @param [in] cores latency critical cores
+ * @param [in] siblings SMT siblings of \a cores
+ * @param [in] mask L2 CBM of siblings, critical cores get remaining ways
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+cfg_set_l2_smt(const cpu_set_t *cores,
+               const cpu_set_t *siblings,
+               const uint64_t mask)
+{
+        const unsigned technology = 1 << PQOS_CAP_TYPE_L2CA;
+        const uint64_t ways_mask =
+            (1ULL << m_cap_l2ca->u.l2ca->num_ways) - 1ULL;
+        const int cdp = m_cap_l2ca->u.l2ca->cdp_on;
+        unsigned *l2ids, l2id_num = 0, i;
+        int ret = 0;
+
+        l2ids = pqos_cpu_get_l2ids(m_cpu, &l2id_num);
+        if (l2ids == NULL)
+                return -EFAULT;
+
+        for (i = 0; i < l2id_num; i++) {
+                unsigned crit[CPU_SETSIZE], sib[CPU_SETSIZE];
+                unsigned crit_num = 0, sib_num = 0, j;
+                struct pqos_l2ca ca[2];
+
+                ret = get_l2id_cores(cores, l2ids[i], &crit_num, crit);
+                if (ret == 0)
+                        ret = get_l2id_cores(siblings, l2ids[i], &sib_num, sib);
+                if (ret != 0)
+                        break;
+
+                if (crit_num == 0)
+                        continue;
+
+                if (sib_num == 0) {
+                        DBG("L2 SMT: no siblings in L2 cluster %u\n",
+                            l2ids[i]);
+                        continue;
+                }
+
+                memset(ca, 0, sizeof(ca));
+                ret = pqos_alloc_assign(technology, crit, crit_num,
+                                        &ca[0].class_id);
+                if (ret == PQOS_RETVAL_OK)
+                        ret = pqos_alloc_assign(technology, sib, sib_num,
+                                                &ca[1].class_id);
+                if (ret != PQOS_RETVAL_OK) {
+                        fprintf(stderr, "L2 SMT: Failed to assign COS in L2 "
+                                        "cluster %u!\n", l2ids[i]);
+                        ret = -EFAULT;
+                        break;
+                }
+
+                for (j = 0; j < DIM(ca); j++) {
+                        const uint64_t cbm = j == 0 ? ways_mask & ~mask : mask;
+
+                        ca[j].cdp = cdp;
+                        if (cdp) {
+                                ca[j].u.s.data_mask = cbm;
+                                ca[j].u.s.code_mask = cbm;
+                        } else
+                                ca[j].u.ways_mask = cbm;
+                }
+
+                /* both classes of the cluster written in one batch */
+                ret = pqos_l2ca_set(l2ids[i], DIM(ca), ca);
+                if (ret != PQOS_RETVAL_OK) {
+                        fprintf(stderr, "L2 SMT: Failed to set L2 classes in "
+                                        "L2 cluster %u!\n", l2ids[i]);
+                        ret = -EFAULT;
+                        break;
+                }
+
+                DBG("L2 SMT: L2 cluster %u, critical COS%u 0x%llx, "
+                    "siblings COS%u 0x%llx\n",
+                    l2ids[i], ca[0].class_id,
+                    (unsigned long long)(ways_mask & ~mask), ca[1].class_id,
+                    (unsigned long long)mask);
+        }
+
+        free(l2ids);
+        return ret;
+}
+
+/**
+ * @brief Enables selected HW prefetchers on \a cores
+ *
+ * Original prefetcher state is saved to be restored on exit.
+ *
+ * @param [in] cores cores to configure
+ * @param [in] enabled mask of prefetchers to enable
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+prefetch_set(const cpu_set_t *cores, const unsigned enabled)
+{
+        unsigned i;
+
+        for (i = 0; i < CPU_SETSIZE; i++) {
+                int ret;
+
+                if (0 == CPU_ISSET(i, cores))
+                        continue;
+
+                if (!m_prefetch[i].saved) {
+                        ret = pqos_prefetch_get(i, &m_prefetch[i].enabled);
+                        if (ret != PQOS_RETVAL_OK) {
+                                fprintf(stderr, "Prefetch: Failed to read "
+                                                "state of core %u!\n", i);
+                                return -EFAULT;
+                        }
+                        m_prefetch[i].saved = 1;
+                }
+
+                ret = pqos_prefetch_set(i, enabled);
+                if (ret != PQOS_RETVAL_OK) {
+                        fprintf(stderr, "Prefetch: Failed to configure "
+                                        "core %u!\n", i);
+                        return -EFAULT;
+                }
+                DBG("Prefetch: core %u, enabled 0x%x\n", i, enabled);
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Restores HW prefetcher state saved by prefetch_set()
+ *
+ * @param [in] cores cores to restore, NULL for all cores
+ */
+static void
+prefetch_restore(const cpu_set_t *cores)
+{
+        unsigned i;
+
+        for (i = 0; i < CPU_SETSIZE; i++) {
+                if (!m_prefetch[i].saved)
+                        continue;
+                if (cores != NULL && 0 == CPU_ISSET(i, cores))
+                        continue;
+
+                if (pqos_prefetch_set(i, m_prefetch[i].enabled) !=
+                    PQOS_RETVAL_OK)
+                        fprintf(stderr, "Prefetch: Failed to restore "
+                                        "core %u!\n", i);
+                m_prefetch[i].saved = 0;
+        }
+}
+
+/**
+ * @brief Gets RDT allocation technologies used by configuration
+ *
+ * @param [in] config rdtset configuration
+ *
+ * @return technology bitmask
+ */
+static unsigned
+cfg_get_technology(struct rdt_config *config)
+{
+        unsigned technology = 0;
+
+        if (rdt_cfg_is_valid(wrap_l2ca(&config->l2)))
+                technology |= (1 << PQOS_CAP_TYPE_L2CA);
+
+        if (rdt_cfg_is_valid(wrap_l3ca(&config->l3)))
+                technology |= (1 << PQOS_CAP_TYPE_L3CA);
+
+        if (rdt_cfg_is_valid(wrap_mba(&config->mba)))
+                technology |= (1 << PQOS_CAP_TYPE_MBA);
+
+        return technology;
+}
+
+/**
+ * @brief Gets class of \a cores sharing allocation resources with \a core
+ *
+ * @param [in] technology configured RDT allocation technologies
+ * @param [in] cores cores of the configuration
+ * @param [in] core core to find class for
+ * @param [out] cos_id class id
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative when no core shares resources with \a core
+ */
+static int
+cfg_get_domain_cos(const unsigned technology,
+                   const cpu_set_t *cores,
+                   const struct pqos_coreinfo *core,
+                   unsigned *cos_id)
+{
+        unsigned i;
+
+        for (i = 0; i < m_cpu->num_cores; i++) {
+                const struct pqos_coreinfo *ci = &m_cpu->cores[i];
+
+                if (0 == CPU_ISSET(ci->lcore, cores))
+                        continue;
+                if ((technology & (1 << PQOS_CAP_TYPE_L2CA)) &&
+                    ci->l2_id != core->l2_id)
+                        continue;
+                if ((technology & (1 << PQOS_CAP_TYPE_L3CA)) &&
+                    ci->l3cat_id != core->l3cat_id)
+                        continue;
+                if ((technology & (1 << PQOS_CAP_TYPE_MBA)) &&
+                    ci->mba_id != core->mba_id)
+                        continue;
+
+                if (pqos_alloc_assoc_get(ci->lcore, cos_id) == PQOS_RETVAL_OK)
+                        return 0;
+        }
+
+        return -ENOENT;
+}
+
 int
 alloc_configure(void)
 {
@@ -1802,19 +2258,15 @@ alloc_configure(void)
         }
 
         for (i = 0; i < g_cfg.config_count; i++) {
-                unsigned technology = 0;
-
-                if (rdt_cfg_is_valid(wrap_l2ca(&l2ca[i])))
-                        technology |= (1 << PQOS_CAP_TYPE_L2CA);
-
-                if (rdt_cfg_is_valid(wrap_l3ca(&l3ca[i])))
-                        technology |= (1 << PQOS_CAP_TYPE_L3CA);
-
-                if (rdt_cfg_is_valid(wrap_mba(&mba[i])))
-                        technology |= (1 << PQOS_CAP_TYPE_MBA);
+                const unsigned technology =
+                    cfg_get_technology(&g_cfg.config[i]);
 
                 /* If pid config selected then assign tasks otherwise cores */
-                if (pid_cfg[i])
+                if (g_cfg.config[i].l2_smt != 0)
+                        ret = cfg_set_l2_smt(&cpu[i],
+                                             &g_cfg.config[i].l2_smt_siblings,
+                                             g_cfg.config[i].l2_smt);
+                else if (pid_cfg[i])
                         ret = cfg_set_pids(technology, &l3ca[i], &l2ca[i],
                                            &mba[i]);
                 else if (g_cfg.interface == PQOS_INTER_MSR)
@@ -1824,6 +2276,9 @@ alloc_configure(void)
                         ret = cfg_set_cores_os(technology, &cpu[i], &l2ca[i],
                                                &l3ca[i], &mba[i]);
 
+                if (ret == 0 && g_cfg.config[i].prefetch_cfg)
+                        ret = prefetch_set(&cpu[i], g_cfg.config[i].prefetch);
+
                 /* If assign fails then free already assigned cpus */
                 if (ret != 0) {
                         fprintf(stderr, "Allocation failed!\n");
@@ -1832,7 +2287,10 @@ alloc_configure(void)
                                 if (pid_cfg[i])
                                         continue;
                                 (void)alloc_release(&cpu[i]);
+                                (void)alloc_release(
+                                    &g_cfg.config[i].l2_smt_siblings);
                         }
+                        prefetch_restore(NULL);
                         return ret;
                 }
         }
@@ -1840,6 +2298,110 @@ alloc_configure(void)
         return 0;
 }
 
+int
+alloc_update(const unsigned idx, const cpu_set_t *cores)
+{
+        struct rdt_config *config = &g_cfg.config[idx];
+        char cpustr[CPU_SETSIZE * 3];
+        cpu_set_t removed, added, orphans;
+        unsigned technology;
+        unsigned i;
+        int ret;
+
+        if (m_cpu == NULL || idx >= g_cfg.config_count || cores == NULL)
+                return -EFAULT;
+
+        technology = cfg_get_technology(config);
+        CPU_ZERO(&removed);
+        CPU_ZERO(&added);
+        CPU_ZERO(&orphans);
+
+        for (i = 0; i < m_cpu->num_cores; i++) {
+                const unsigned lcore = m_cpu->cores[i].lcore;
+                const int used = CPU_ISSET(lcore, &config->cpumask) != 0;
+                const int selected = CPU_ISSET(lcore, cores) != 0;
+
+                if (used && !selected)
+                        CPU_SET(lcore, &removed);
+                else if (!used && selected)
+                        CPU_SET(lcore, &added);
+        }
+        if (CPU_COUNT(&removed) == 0 && CPU_COUNT(&added) == 0)
+                return 0;
+
+        /* cores no longer selected go back to default class */
+        ret = alloc_release(&removed);
+        if (ret != 0)
+                return ret;
+        prefetch_restore(&removed);
+        for (i = 0; i < CPU_SETSIZE; i++)
+                if (CPU_ISSET(i, &removed))
+                        CPU_CLR(i, &config->cpumask);
+
+        /* new cores join class of the cores sharing resources with them */
+        for (i = 0; i < m_cpu->num_cores; i++) {
+                const struct pqos_coreinfo *ci = &m_cpu->cores[i];
+                unsigned cos_id;
+
+                if (0 == CPU_ISSET(ci->lcore, &added))
+                        continue;
+
+                ret = pqos_alloc_assoc_get(ci->lcore, &cos_id);
+                if (ret != PQOS_RETVAL_OK || cos_id != 0) {
+                        DBG("Allocation: cpu %u has already associated "
+                            "COS, skipping\n",
+                            ci->lcore);
+                        CPU_CLR(ci->lcore, &added);
+                        continue;
+                }
+
+                if (cfg_get_domain_cos(technology, &config->cpumask, ci,
+                                       &cos_id) != 0) {
+                        CPU_SET(ci->lcore, &orphans);
+                        continue;
+                }
+
+                ret = pqos_alloc_assoc_set(ci->lcore, cos_id);
+                if (ret != PQOS_RETVAL_OK) {
+                        fprintf(stderr,
+                                "Error associating COS, core: %u, COS: %u!\n",
+                                ci->lcore, cos_id);
+                        return -EFAULT;
+                }
+                CPU_SET(ci->lcore, &config->cpumask);
+        }
+
+        /* no class on resource ids of these cores yet */
+        if (CPU_COUNT(&orphans) != 0) {
+                if (g_cfg.interface == PQOS_INTER_MSR)
+                        ret = cfg_set_cores_msr(technology, &orphans,
+                                                &config->l2, &config->l3,
+                                                &config->mba);
+                else
+                        ret = cfg_set_cores_os(technology, &orphans,
+                                               &config->l2, &config->l3,
+                                               &config->mba);
+                if (ret != 0) {
+                        (void)alloc_release(&orphans);
+                        return ret;
+                }
+                for (i = 0; i < CPU_SETSIZE; i++)
+                        if (CPU_ISSET(i, &orphans))
+                                CPU_SET(i, &config->cpumask);
+        }
+
+        if (config->prefetch_cfg) {
+                ret = prefetch_set(&added, config->prefetch);
+                if (ret != 0)
+                        return ret;
+        }
+
+        cpuset_to_str(cpustr, sizeof(cpustr), &config->cpumask);
+        DBG("Allocation: CPUs of class %u changed to %s\n", idx, cpustr);
+
+        return 0;
+}
+
 int
 alloc_reset(void)
 {
@@ -1907,7 +2469,11 @@ alloc_exit(void)
                 /* release cores */
                 if (alloc_release(&g_cfg.config[i].cpumask) != 0)
                         fprintf(stderr, "Failed to release cores COS!\n");
+                if (alloc_release(&g_cfg.config[i].l2_smt_siblings) != 0)
+                        fprintf(stderr, "Failed to release siblings COS!\n");
         }
+
+        prefetch_restore(NULL);
 }
 
 int
@@ -1987,10 +2553,18 @@ print_cmd_line_rdt_config(void)
                 struct rdt_cfg cfg_array[3];
                 unsigned j;
 
-                if (CPU_COUNT(&g_cfg.config[i].cpumask) == 0)
+                /* CPUs serving IRQs are not known before initialization */
+                if (g_cfg.config[i].irq_cfg)
+                        snprintf(cpustr, sizeof(cpustr), "irq%s%s",
+                                 g_cfg.config[i].irq_match != NULL ? ":" : "",
+                                 g_cfg.config[i].irq_match != NULL
+                                     ? g_cfg.config[i].irq_match
+                                     : "");
+                else if (CPU_COUNT(&g_cfg.config[i].cpumask) == 0)
                         continue;
-
-                cpuset_to_str(cpustr, sizeof(cpustr), &g_cfg.config[i].cpumask);
+                else
+                        cpuset_to_str(cpustr, sizeof(cpustr),
+                                      &g_cfg.config[i].cpumask);
 
                 cfg_array[0] = wrap_l2ca(&g_cfg.config[i].l2);
                 cfg_array[1] = wrap_l3ca(&g_cfg.config[i].l3);
@@ -2004,6 +2578,16 @@ print_cmd_line_rdt_config(void)
                         rdt_cfg_print(stdout, cfg_array[j]);
                         printf("\n");
                 }
+
+                if (g_cfg.config[i].prefetch_cfg)
+                        printf("Prefetch: CPUs: %s ENABLED: 0x%x\n", cpustr,
+                               g_cfg.config[i].prefetch);
+
+                if (g_cfg.config[i].l2_smt != 0)
+                        printf("L2 SMT Allocation: CPUs: %s SIBLINGS MASK: "
+                               "0x%llx\n",
+                               cpustr,
+                               (unsigned long long)g_cfg.config[i].l2_smt);
         }
 }
 
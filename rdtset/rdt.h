@@ -108,6 +108,21 @@ int parse_rdt(char *rdtstr);
  */
 int alloc_configure(void);
 
+/**
+ * @brief Changes CPUs of configured class
+ *
+ * Removed CPUs are associated with default class, new CPUs join class
+ * of the CPUs sharing allocation resources with them.
+ *
+ * @param [in] idx index of rdtset configuration
+ * @param [in] cores new CPUs of the class
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+int alloc_update(const unsigned idx, const cpu_set_t *cores);
+
 /*
  * @brief Resets COS association (assign COS#0) on listed CPUs
  *
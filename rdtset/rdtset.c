@@ -32,6 +32,7 @@
  */
 
 #include <errno.h>
+#include <fcntl.h>
 #include <getopt.h>
 #include <grp.h>
 #include <signal.h>
@@ -48,6 +49,9 @@
 #include "common.h"
 #include "cpu.h"
 #include "mba_sc.h"
+#include "slo.h"
+#include "irq.h"
+#include "stat.h"
 
 static pid_t child = -1;
 
@@ -135,9 +139,18 @@ err:
 static int
 execute_cmd(int argc, char **argv)
 {
+        int sync[2] = {-1, -1};
+
         if (0 >= argc || NULL == argv)
                 return -1;
 
+        /* in stat mode the child waits until its monitoring is started */
+        if (stat_mode(&g_cfg) && 0 != pipe2(sync, O_CLOEXEC)) {
+                fprintf(stderr, "%s,%s:%d Failed to create pipe!\n", __FILE__,
+                        __func__, __LINE__);
+                return -1;
+        }
+
         if (g_cfg.verbose) {
                 int i;
 
@@ -158,8 +171,22 @@ execute_cmd(int argc, char **argv)
                 return -1;
         } else if (0 < child) {
                 int status = EXIT_FAILURE;
+                int ret;
+
+                if (stat_mode(&g_cfg)) {
+                        close(sync[0]);
+                        if (0 != stat_start(child)) {
+                                kill(child, SIGKILL);
+                                waitpid(child, NULL, 0);
+                                close(sync[1]);
+                                return -1;
+                        }
+                        /* release the child */
+                        close(sync[1]);
+                }
+
                 /* Wait for child */
-                int ret = waitpid(child, &status, WNOHANG);
+                ret = waitpid(child, &status, WNOHANG);
 
                 if (ret < -1)
                         return -1;
@@ -167,6 +194,16 @@ execute_cmd(int argc, char **argv)
                     (!WIFEXITED(status) && WEXITSTATUS(status) != EXIT_SUCCESS))
                         return -1;
         } else {
+                if (stat_mode(&g_cfg)) {
+                        char c;
+
+                        close(sync[1]);
+                        /* EOF once the parent started monitoring */
+                        while (read(sync[0], &c, 1) < 0 && errno == EINTR)
+                                ;
+                        close(sync[0]);
+                }
+
                 if (0 != CPU_COUNT(&g_cfg.cpu_aff_cpuset))
                         /* set cpu affinity */
                         if (0 != set_affinity(0)) {
@@ -213,8 +250,11 @@ print_usage(char *prgname, unsigned short_usage)
                "       %s -r <cpulist> -t <feature=value;...cpu=cpulist>... "
                "[-I] -p <pidlist>\n"
                "       %s -t <feature=value> -I [-c <cpulist>] "
-               "(-p <pidlist> | [-k] cmd [<args>...])\n\n",
-               prgname, prgname, prgname, prgname, prgname);
+               "(-p <pidlist> | [-k] cmd [<args>...])\n"
+               "       %s -s [--stat-interval <ms>] [--stat-json <path>] "
+               "[-t <feature=value>...] [-c <cpulist>] [-k] cmd "
+               "[<args>...]\n\n",
+               prgname, prgname, prgname, prgname, prgname, prgname);
 
         printf("Options:\n"
                " -t/--rdt feature=value;...cpu=cpulist "
@@ -224,6 +264,11 @@ print_usage(char *prgname, unsigned short_usage)
                "   3, l3\n"
                "   m, mba\n"
                "   b, mba_max\n"
+               "   w, mba_weight\n"
+               "   s, slo\n"
+               "   f, prefetch\n"
+               "   l, l2_smt\n"
+               "   i, irq_threads\n"
                " -c <cpulist>, --cpu <cpulist>         "
                "specify CPUs (affinity)\n"
                " -p <pidlist>, --pid <pidlist>                 "
@@ -242,7 +287,18 @@ print_usage(char *prgname, unsigned short_usage)
                " -h, --help                            "
                "display help\n"
                " -w, --version                         "
-               "display PQoS library version\n\n");
+               "display PQoS library version\n"
+               " -S <path>, --slo-socket <path>        "
+               "socket to receive latency samples on\n"
+               " -s, --stat                            "
+               "monitor the command and its children and threads,\n"
+               "                                       "
+               "print statistics when it exits (uses OS interface)\n"
+               " --stat-interval <ms>                  "
+               "stat sampling interval, default %u ms\n"
+               " --stat-json <path>                    "
+               "write stat report as JSON, \"-\" for stdout\n\n",
+               STAT_DEF_INTERVAL);
 
         if (short_usage) {
                 printf("For more help run with -h/--help\n");
@@ -293,7 +349,39 @@ print_usage(char *prgname, unsigned short_usage)
 
             "    -t 'mba_max=1200;cpu=1'\n"
             "        Use SW controller to limit local memory B/W to 1200MBps "
-            "on core 1\n\n");
+            "on core 1\n\n"
+
+            "    -t 'mba_weight=4;cpu=0-3' -t 'mba_weight=1;cpu=4-7'\n"
+            "        Use SW controller to share local memory B/W 4:1 "
+            "between cores 0-3\n"
+            "        and 4-7 when saturated, idle B/W can be used by "
+            "anyone\n\n"
+
+            "    -t 'l3=0xf;slo=500;cpu=0-3' -t 'l3=0xf0;mba=100;cpu=4-7'\n"
+            "        Grow L3 CBM of cores 0-3 and throttle MBA of cores 4-7 "
+            "when p99\n"
+            "        latency reported on the SLO socket exceeds 500us\n\n"
+
+            "    -t 'l3=0x3;prefetch=0x0;cpu=4-7'\n"
+            "        CPUs 4-7 use two L3 cache-ways with all HW prefetchers "
+            "disabled\n\n"
+
+            "    -t 'l2_smt=0x3;cpu=2,3'\n"
+            "        L2 cluster siblings of CPUs 2 and 3 are limited to two "
+            "L2 cache-ways,\n"
+            "        CPUs 2 and 3 get the remaining L2 cache-ways\n\n"
+
+            "    -t 'l3=0x1;mba=20;cpu=irq:eth0' -t 'l3=0xfe;cpu=0-7'\n"
+            "        CPUs serving eth0 IRQs use one L3 cache-way and 20%% "
+            "of memory B/W,\n"
+            "        changes of IRQ affinity are tracked while running\n\n");
+
+        printf("Example run-and-report usage:\n"
+               "    -s --stat-interval 50 --stat-json out.json -- make -j8\n"
+               "        Print LLC occupancy, memory B/W, IPC and LLC miss "
+               "statistics of make\n"
+               "        and all its children sampled every 50 ms, save "
+               "them to out.json\n\n");
 
         printf("Example PID configuration strings:\n"
                "    -I -t 'l3=0xf' -p 23187,567-570\n"
@@ -332,6 +420,7 @@ print_usage(char *prgname, unsigned short_usage)
  * @param [in] f_i flag for -I argument
  * @param [in] cmd flag for command to be executed
  * @param [in] f_w flag for -w argument
+ * @param [in] f_s flag for -s argument
  *
  * @return Operation status
  * @retval 1 on success
@@ -344,7 +433,8 @@ validate_args(const int f_r,
               const int f_p,
               const int f_i,
               const int cmd,
-              const int f_w)
+              const int f_w,
+              const int f_s)
 {
         unsigned i;
         int f_n = 0; /**< non cpu (pid) config flag */
@@ -359,6 +449,10 @@ validate_args(const int f_r,
                 }
         }
 
+        /* stat mode monitors the executed command only */
+        if (f_s)
+                return cmd && !f_p;
+
         return (f_c && !f_p && cmd && !f_n) || (f_c && f_p && !cmd && !f_n) ||
                (f_r && f_p && !cmd) || (f_i && f_n && !f_p && cmd) ||
                (f_i && f_n && f_p && !cmd) || f_w;
@@ -429,11 +523,15 @@ parse_args(int argc, char **argv)
                 { "iface-os",   no_argument,            0, 'I' },
                 { "help",       no_argument,            0, 'h' },
                 { "version",    no_argument,            0, 'w' },
+                { "slo-socket", required_argument,      0, 'S' },
+                { "stat",       no_argument,            0, 's' },
+                { "stat-interval", required_argument,   0, 'i' },
+                { "stat-json",  required_argument,      0, 'j' },
                 { NULL, 0, 0, 0 }
             /* clang-format on */
         };
 
-        while ((opt = getopt_long(argc, argvopt, "+c:p:r:t:kvIhw", lgopts,
+        while ((opt = getopt_long(argc, argvopt, "+c:p:r:t:kvIhwS:s", lgopts,
                                   NULL)) != -1) {
                 switch (opt) {
                 case 'c':
@@ -482,6 +580,30 @@ parse_args(int argc, char **argv)
                 case 'w':
                         g_cfg.show_version = 1;
                         break;
+                case 'S':
+                        g_cfg.slo_socket = optarg;
+                        break;
+                case 's':
+                        g_cfg.stat = 1;
+                        /* task monitoring requires the OS interface */
+                        g_cfg.interface = PQOS_INTER_OS;
+                        break;
+                case 'i': {
+                        char *end = NULL;
+                        unsigned long val = strtoul(optarg, &end, 10);
+
+                        if (end == optarg || *end != '\0' || val == 0 ||
+                            val > 60000) {
+                                fprintf(stderr, "Invalid stat interval!\n");
+                                retval = -EINVAL;
+                                goto exit;
+                        }
+                        g_cfg.stat_interval = (unsigned)val;
+                        break;
+                }
+                case 'j':
+                        g_cfg.stat_json = optarg;
+                        break;
                 }
         }
 
@@ -495,6 +617,9 @@ exit:
 static void
 rdtset_fini(void)
 {
+        stat_fini();
+        irq_fini();
+        slo_fini();
         mba_sc_fini();
         alloc_fini();
 }
@@ -505,6 +630,9 @@ rdtset_fini(void)
 static void
 rdtset_exit(void)
 {
+        stat_exit();
+        irq_exit();
+        slo_exit();
         mba_sc_exit();
         alloc_exit();
 
@@ -563,6 +691,54 @@ rdtset_init(void)
                 }
         }
 
+        /* Initialize latency SLO controller */
+        if (slo_mode(&g_cfg)) {
+                if (mba_sc_mode(&g_cfg)) {
+                        fprintf(stderr, "%s,%s:%d SLO controller can not be "
+                                        "used with MBA SC!\n",
+                                __FILE__, __func__, __LINE__);
+                        ret = -EINVAL;
+                        goto err;
+                }
+                ret = slo_init();
+                if (ret < 0) {
+                        fprintf(stderr, "%s,%s:%d SLO init failed!\n",
+                                __FILE__, __func__, __LINE__);
+                        ret = -EFAULT;
+                        goto err;
+                }
+        }
+
+        /* Select cores serving IRQs */
+        if (irq_mode(&g_cfg)) {
+                ret = irq_init();
+                if (ret < 0) {
+                        fprintf(stderr, "%s,%s:%d IRQ init failed!\n",
+                                __FILE__, __func__, __LINE__);
+                        ret = -EFAULT;
+                        goto err;
+                }
+        }
+
+        /* Initialize run-and-report monitoring */
+        if (stat_mode(&g_cfg)) {
+                if (mba_sc_mode(&g_cfg) || slo_mode(&g_cfg) ||
+                    irq_mode(&g_cfg)) {
+                        fprintf(stderr, "%s,%s:%d Stat mode can not be used "
+                                        "with MBA SC, SLO or IRQ classes!\n",
+                                __FILE__, __func__, __LINE__);
+                        ret = -EINVAL;
+                        goto err;
+                }
+                ret = stat_init();
+                if (ret < 0) {
+                        fprintf(stderr, "%s,%s:%d STAT init failed!\n",
+                                __FILE__, __func__, __LINE__);
+                        ret = -EFAULT;
+                        goto err;
+                }
+        }
+
         signal(SIGINT, signal_handler);
         signal(SIGTERM, signal_handler);
 
@@ -601,6 +777,7 @@ main(int argc, char **argv)
         int ret = 0;
 
         memset(&g_cfg, 0, sizeof(g_cfg));
+        g_cfg.stat_interval = STAT_DEF_INTERVAL;
 
         /* Parse cmd line args */
         ret = parse_args(argc, argv);
@@ -619,7 +796,8 @@ main(int argc, char **argv)
                            0 != g_cfg.config_count,
                            0 != CPU_COUNT(&g_cfg.cpu_aff_cpuset),
                            0 != g_cfg.pid_count, 0 != g_cfg.interface,
-                           0 != g_cfg.command, 0 != g_cfg.show_version)) {
+                           0 != g_cfg.command, 0 != g_cfg.show_version,
+                           0 != g_cfg.stat)) {
                 fprintf(stderr, "Incorrect invocation!\n");
                 print_usage(argv[0], 1);
                 exit(EXIT_FAILURE);
@@ -700,6 +878,16 @@ main(int argc, char **argv)
         if (mba_sc_mode(&g_cfg)) {
                 mba_sc_main(child);
 
+        } else if (slo_mode(&g_cfg)) {
+                slo_main(child);
+
+        } else if (irq_mode(&g_cfg)) {
+                irq_main(child);
+
+        } else if (stat_mode(&g_cfg)) {
+                if (0 != stat_main(child, argc - optind, argv + optind))
+                        exit(EXIT_FAILURE);
+
         } else if (0 != g_cfg.command) {
                 int status = EXIT_FAILURE;
                 /* Wait for child */
@@ -708,7 +896,8 @@ main(int argc, char **argv)
                         exit(EXIT_FAILURE);
         }
 
-        if (0 != g_cfg.command || mba_sc_mode(&g_cfg))
+        if (0 != g_cfg.command || mba_sc_mode(&g_cfg) || slo_mode(&g_cfg) ||
+            irq_mode(&g_cfg))
                 /*
                  * If we were running some command or doing MBA SW control,
                  * do clean-up. Clean-up function is executed on process exit.
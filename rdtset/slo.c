@@ -0,0 +1,603 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "slo.h"
+#include "common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <errno.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define SLO_MAX_SAMPLES 8192 /**< latency samples kept per control step */
+#define SLO_MIN_SAMPLES 10   /**< samples needed for control step */
+#define SLO_HEADROOM    80   /**< p99 below this % of SLO releases */
+
+static const struct pqos_cap *m_cap;
+static const struct pqos_cpuinfo *m_cpu;
+static const struct pqos_capability *m_cap_l3ca;
+static const struct pqos_capability *m_cap_mba;
+
+/**
+ * Controlled class resources on single L3 CAT or MBA id
+ */
+struct slo_res {
+        unsigned id;     /**< L3 CAT or MBA id */
+        unsigned lcore;  /**< core to read class id from */
+        uint64_t mask;   /**< current CBM */
+        uint64_t init;   /**< initial CBM or MBA rate */
+        unsigned rate;   /**< current MBA rate */
+};
+
+static struct {
+        int fd;                      /**< samples socket */
+        unsigned slo;                /**< p99 latency SLO [us] */
+        uint64_t *samples;           /**< samples of current step */
+        unsigned num_samples;
+        unsigned next_sample;        /**< ring position of next sample */
+        struct slo_res *prot;        /**< protected class CBMs */
+        unsigned num_prot;
+        struct slo_res *be;          /**< best-effort class MBA */
+        unsigned num_be;
+        struct slo_res *be_l3;       /**< best-effort class CBMs */
+        unsigned num_be_l3;
+} slo = {.fd = -1};
+
+int
+slo_mode(const struct rdtset *cfg)
+{
+        unsigned i;
+
+        for (i = 0; i < cfg->config_count; i++)
+                if (cfg->config[i].slo > 0)
+                        return 1;
+
+        return 0;
+}
+
+int
+slo_init(void)
+{
+        int ret;
+
+        if (m_cap != NULL || m_cpu != NULL) {
+                DBG("SLO: module already initialized!\n");
+                return -EEXIST;
+        }
+
+        ret = pqos_cap_get(&m_cap, &m_cpu);
+        if (ret != PQOS_RETVAL_OK) {
+                DBG("SLO: Error retrieving PQoS capabilities!\n");
+                ret = -EFAULT;
+                goto err;
+        }
+
+        ret = pqos_cap_get_type(m_cap, PQOS_CAP_TYPE_L3CA, &m_cap_l3ca);
+        if (ret != PQOS_RETVAL_OK) {
+                DBG("SLO: L3 CAT not supported.\n");
+                ret = -EFAULT;
+                goto err;
+        }
+        if (m_cap_l3ca->u.l3ca->cdp_on) {
+                DBG("SLO: L3 CDP is not supported.\n");
+                ret = -EFAULT;
+                goto err;
+        }
+
+        /* best-effort classes are not throttled without MBA */
+        if (pqos_cap_get_type(m_cap, PQOS_CAP_TYPE_MBA, &m_cap_mba) !=
+            PQOS_RETVAL_OK)
+                m_cap_mba = NULL;
+
+        return 0;
+err:
+        slo_fini();
+        return ret;
+}
+
+void
+slo_fini(void)
+{
+        m_cap = NULL;
+        m_cpu = NULL;
+        m_cap_l3ca = NULL;
+        m_cap_mba = NULL;
+}
+
+void
+slo_exit(void)
+{
+        if (slo.fd >= 0) {
+                struct sockaddr_un addr;
+                socklen_t len = sizeof(addr);
+
+                if (getsockname(slo.fd, (struct sockaddr *)&addr, &len) == 0)
+                        unlink(addr.sun_path);
+                close(slo.fd);
+                slo.fd = -1;
+        }
+
+        free(slo.samples);
+        slo.samples = NULL;
+        free(slo.prot);
+        slo.prot = NULL;
+        slo.num_prot = 0;
+        free(slo.be);
+        slo.be = NULL;
+        slo.num_be = 0;
+        free(slo.be_l3);
+        slo.be_l3 = NULL;
+        slo.num_be_l3 = 0;
+}
+
+/**
+ * @brief Opens Unix datagram socket for latency samples
+ *
+ * @param[in] path socket path
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+slo_socket_open(const char *path)
+{
+        struct sockaddr_un addr;
+
+        if (strlen(path) >= sizeof(addr.sun_path)) {
+                fprintf(stderr, "SLO: socket path too long\n");
+                return -EINVAL;
+        }
+
+        slo.fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (slo.fd < 0)
+                return -errno;
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, path, sizeof(addr.sun_path) - 1);
+
+        unlink(path);
+        if (bind(slo.fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+            fcntl(slo.fd, F_SETFL, O_NONBLOCK) != 0) {
+                int ret = -errno;
+
+                fprintf(stderr, "SLO: failed to open socket %s\n", path);
+                close(slo.fd);
+                slo.fd = -1;
+                return ret;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Receives all pending latency samples
+ */
+static void
+slo_socket_drain(void)
+{
+        char buf[4096];
+        ssize_t len;
+
+        while ((len = recv(slo.fd, buf, sizeof(buf) - 1, 0)) > 0) {
+                char *saveptr = NULL;
+                char *tok;
+
+                buf[len] = '\0';
+                for (tok = strtok_r(buf, " \t\r\n", &saveptr); tok != NULL;
+                     tok = strtok_r(NULL, " \t\r\n", &saveptr)) {
+                        char *end = NULL;
+                        unsigned long long val = strtoull(tok, &end, 10);
+
+                        if (end == tok || *end != '\0')
+                                continue;
+                        /* keep the latest samples */
+                        slo.samples[slo.next_sample] = val;
+                        slo.next_sample =
+                            (slo.next_sample + 1) % SLO_MAX_SAMPLES;
+                        if (slo.num_samples < SLO_MAX_SAMPLES)
+                                slo.num_samples++;
+                }
+        }
+}
+
+/**
+ * @brief Compare function for qsort
+ */
+static int
+slo_cmp(const void *a, const void *b)
+{
+        const uint64_t va = *(const uint64_t *)a;
+        const uint64_t vb = *(const uint64_t *)b;
+
+        return (va > vb) - (va < vb);
+}
+
+/**
+ * @brief Adds resources of configuration cores to the table
+ *
+ * One entry is created for each L3 CAT id (\a l3) or MBA id of the cores.
+ * Entries of other configurations sharing the table are kept separate.
+ *
+ * @param[in] config rdtset configuration
+ * @param[in] l3 non-zero for L3 CAT ids, MBA ids otherwise
+ * @param[in,out] res resource table
+ * @param[in,out] num number of entries in the table
+ */
+static void
+slo_res_add(const struct rdt_config *config,
+            const int l3,
+            struct slo_res *res,
+            unsigned *num)
+{
+        const unsigned first = *num;
+        unsigned i;
+
+        for (i = 0; i < m_cpu->num_cores; i++) {
+                const struct pqos_coreinfo *ci = &m_cpu->cores[i];
+                const unsigned id = l3 ? ci->l3cat_id : ci->mba_id;
+                unsigned j;
+
+                if (!CPU_ISSET(ci->lcore, &config->cpumask))
+                        continue;
+
+                for (j = first; j < *num; j++)
+                        if (res[j].id == id)
+                                break;
+                if (j < *num)
+                        continue;
+
+                res[j].id = id;
+                res[j].lcore = ci->lcore;
+                if (l3) {
+                        res[j].mask = config->l3.u.ways_mask;
+                        res[j].init = config->l3.u.ways_mask;
+                } else {
+                        res[j].rate = config->mba.mb_max;
+                        res[j].init = config->mba.mb_max;
+                }
+                (*num)++;
+        }
+}
+
+/**
+ * @brief Sets CBM of the class
+ *
+ * @param[in] res class resource
+ * @param[in] mask CBM to be set
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+slo_l3ca_set(struct slo_res *res, const uint64_t mask)
+{
+        struct pqos_l3ca ca;
+
+        memset(&ca, 0, sizeof(ca));
+        if (pqos_alloc_assoc_get(res->lcore, &ca.class_id) != PQOS_RETVAL_OK)
+                return -EFAULT;
+        ca.u.ways_mask = mask;
+
+        if (pqos_l3ca_set(res->id, 1, &ca) != PQOS_RETVAL_OK) {
+                DBG("SLO: error while setting L3 CAT on l3cat id %u\n",
+                    res->id);
+                return -EFAULT;
+        }
+        res->mask = mask;
+
+        return 0;
+}
+
+/**
+ * @brief Sets MBA rate of the best-effort class
+ *
+ * @param[in] res best-effort class resource
+ * @param[in] rate MBA rate to be set
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+slo_mba_set(struct slo_res *res, const unsigned rate)
+{
+        struct pqos_mba mba;
+
+        memset(&mba, 0, sizeof(mba));
+        if (pqos_alloc_assoc_get(res->lcore, &mba.class_id) != PQOS_RETVAL_OK)
+                return -EFAULT;
+        mba.mb_max = rate;
+
+        if (pqos_mba_set(res->id, 1, &mba, NULL) != PQOS_RETVAL_OK) {
+                DBG("SLO: error while setting MBA on mba id %u\n", res->id);
+                return -EFAULT;
+        }
+        res->rate = rate;
+
+        return 0;
+}
+
+/**
+ * @brief Checks if CBM is contiguous and not empty
+ *
+ * @param[in] mask CBM
+ *
+ * @return 1 if \a mask is valid
+ */
+static int
+slo_mask_valid(const uint64_t mask)
+{
+        return mask != 0 && ((mask + (mask & -mask)) & mask) == 0;
+}
+
+/**
+ * @brief Moves ways between best-effort classes and the protected class
+ *
+ * Best-effort classes keep their initial CBM without the ways of protected
+ * CBM \a mask, ways are not shared while the protected class is grown.
+ *
+ * @param[in] prot protected class resource
+ * @param[in] mask new CBM of the protected class
+ * @param[in] apply zero to only check that best-effort CBMs stay valid
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+slo_be_l3ca_update(const struct slo_res *prot,
+                   const uint64_t mask,
+                   const int apply)
+{
+        unsigned i;
+        int ret = 0;
+
+        for (i = 0; i < slo.num_be_l3; i++) {
+                struct slo_res *res = &slo.be_l3[i];
+                const uint64_t be =
+                    mask == prot->init ? res->init : res->init & ~mask;
+
+                if (res->id != prot->id)
+                        continue;
+                if (!slo_mask_valid(be))
+                        return -EINVAL;
+                if (apply && be != res->mask && slo_l3ca_set(res, be) != 0)
+                        ret = -EFAULT;
+        }
+
+        return ret;
+}
+
+/**
+ * @brief Grows protected class resources when SLO is violated
+ */
+static void
+slo_tighten(void)
+{
+        const uint64_t full = (1ULL << m_cap_l3ca->u.l3ca->num_ways) - 1ULL;
+        unsigned i;
+
+        for (i = 0; i < slo.num_prot; i++) {
+                struct slo_res *res = &slo.prot[i];
+                const uint64_t up = res->mask | res->mask << 1;
+                const uint64_t down = res->mask | res->mask >> 1;
+                uint64_t mask = res->mask;
+
+                /**
+                 * Extend contiguous CBM by one way, up first. The way is
+                 * taken from best-effort classes, they release it first.
+                 */
+                if ((up & ~full) == 0 && slo_be_l3ca_update(res, up, 0) == 0)
+                        mask = up;
+                else if ((res->mask & 1) == 0 &&
+                         slo_be_l3ca_update(res, down, 0) == 0)
+                        mask = down;
+
+                if (mask != res->mask &&
+                    slo_be_l3ca_update(res, mask, 1) == 0 &&
+                    slo_l3ca_set(res, mask) == 0)
+                        DBG("SLO: l3cat id %u protected CBM 0x%llx\n",
+                            res->id, (unsigned long long)mask);
+        }
+
+        for (i = 0; i < slo.num_be && m_cap_mba != NULL; i++) {
+                struct slo_res *res = &slo.be[i];
+                const unsigned step = m_cap_mba->u.mba->throttle_step;
+
+                if (res->rate <= step)
+                        continue;
+                if (slo_mba_set(res, res->rate - step) == 0)
+                        DBG("SLO: mba id %u best-effort MBA %u%%\n", res->id,
+                            res->rate);
+        }
+}
+
+/**
+ * @brief Releases resources one step when there is headroom
+ *
+ * MBA of best-effort classes is released before protected CBM shrinks.
+ */
+static void
+slo_release(void)
+{
+        int released = 0;
+        unsigned i;
+
+        for (i = 0; i < slo.num_be && m_cap_mba != NULL; i++) {
+                struct slo_res *res = &slo.be[i];
+                unsigned rate = res->rate + m_cap_mba->u.mba->throttle_step;
+
+                if (res->rate >= res->init)
+                        continue;
+                if (rate > res->init)
+                        rate = (unsigned)res->init;
+                if (slo_mba_set(res, rate) == 0)
+                        DBG("SLO: mba id %u best-effort MBA %u%%\n", res->id,
+                            res->rate);
+                released = 1;
+        }
+        if (released)
+                return;
+
+        for (i = 0; i < slo.num_prot; i++) {
+                struct slo_res *res = &slo.prot[i];
+                uint64_t mask = res->mask;
+                uint64_t top = mask & ~(mask >> 1);
+                uint64_t bottom = mask & ~(mask << 1);
+
+                /* remove one way added by slo_tighten() */
+                if ((top & res->init) == 0)
+                        mask &= ~top;
+                else if ((bottom & res->init) == 0)
+                        mask &= ~bottom;
+
+                if (mask == res->mask || slo_l3ca_set(res, mask) != 0)
+                        continue;
+                DBG("SLO: l3cat id %u protected CBM 0x%llx\n", res->id,
+                    (unsigned long long)mask);
+                /* return the way to best-effort classes */
+                (void)slo_be_l3ca_update(res, mask, 1);
+        }
+}
+
+/**
+ * @brief Single control step of the SLO controller
+ */
+static void
+slo_update(void)
+{
+        uint64_t p99;
+
+        if (slo.num_samples < SLO_MIN_SAMPLES) {
+                DBG("SLO: %u samples, no action\n", slo.num_samples);
+                return;
+        }
+
+        qsort(slo.samples, slo.num_samples, sizeof(slo.samples[0]), slo_cmp);
+        p99 = slo.samples[(slo.num_samples * 99 - 1) / 100];
+        DBG("SLO: p99 %lluus of %u samples, SLO %uus\n",
+            (unsigned long long)p99, slo.num_samples, slo.slo);
+        slo.num_samples = 0;
+        slo.next_sample = 0;
+
+        if (p99 > slo.slo)
+                slo_tighten();
+        else if (p99 * 100 < (uint64_t)slo.slo * SLO_HEADROOM)
+                slo_release();
+}
+
+int
+slo_main(pid_t pid)
+{
+        const uint64_t interval = SLO_CONTROL_INTERVAL * 1000;
+        uint64_t last;
+        unsigned i;
+        int ret;
+
+        if (m_cap == NULL)
+                return -EFAULT;
+
+        slo.samples = calloc(SLO_MAX_SAMPLES, sizeof(slo.samples[0]));
+        slo.prot = calloc(m_cpu->num_cores, sizeof(*slo.prot));
+        slo.be = calloc(m_cpu->num_cores * g_cfg.config_count,
+                        sizeof(*slo.be));
+        slo.be_l3 = calloc(m_cpu->num_cores * g_cfg.config_count,
+                           sizeof(*slo.be_l3));
+        if (slo.samples == NULL || slo.prot == NULL || slo.be == NULL ||
+            slo.be_l3 == NULL) {
+                DBG("SLO: memory allocation failed\n");
+                ret = -EFAULT;
+                goto exit;
+        }
+
+        for (i = 0; i < g_cfg.config_count; i++) {
+                const struct rdt_config *config = &g_cfg.config[i];
+
+                if (config->slo == 0 && config->mba.mb_max == 0 &&
+                    config->l3.u.ways_mask == 0)
+                        continue;
+
+                if (config->pid_cfg) {
+                        fprintf(stderr, "SLO: cpu list required\n");
+                        ret = -EINVAL;
+                        goto exit;
+                }
+
+                if (config->slo > 0) {
+                        if (slo.slo != 0 || config->l3.u.ways_mask == 0) {
+                                fprintf(stderr, "SLO: single protected class "
+                                                "with l3 CBM required\n");
+                                ret = -EINVAL;
+                                goto exit;
+                        }
+                        slo.slo = config->slo;
+                        slo_res_add(config, 1, slo.prot, &slo.num_prot);
+                        continue;
+                }
+
+                if (config->l3.u.ways_mask != 0)
+                        slo_res_add(config, 1, slo.be_l3, &slo.num_be_l3);
+                if (config->mba.mb_max != 0 && config->mba.ctrl == 0 &&
+                    config->mba_weight == 0)
+                        slo_res_add(config, 0, slo.be, &slo.num_be);
+        }
+
+        ret = slo_socket_open(g_cfg.slo_socket != NULL ? g_cfg.slo_socket
+                                                       : SLO_DEF_SOCKET);
+        if (ret != 0)
+                goto exit;
+
+        last = get_time_usec();
+        while (task_running(pid)) {
+                usleep(SLO_SAMPLING_INTERVAL * 1000);
+
+                slo_socket_drain();
+                if (get_time_usec() - last < interval)
+                        continue;
+                last += interval;
+
+                slo_update();
+        }
+
+exit:
+        slo_exit();
+
+        return ret;
+}
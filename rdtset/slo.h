@@ -0,0 +1,90 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _SLO_H
+#define _SLO_H
+
+#include <unistd.h>
+#include "common.h"
+
+#define SLO_SAMPLING_INTERVAL 100  /**< Socket drain interval in ms */
+#define SLO_CONTROL_INTERVAL  1000 /**< Control step interval in ms */
+#define SLO_DEF_SOCKET        "/var/run/rdtset_slo.sock"
+
+/**
+ * @brief Checks if latency SLO controller is configured
+ *
+ * @param[in] cfg rdtset configuration
+ *
+ * @return 1 if at least one class has latency SLO
+ */
+int slo_mode(const struct rdtset *cfg);
+
+/**
+ * @brief Initializes latency SLO controller
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+int slo_init(void);
+
+/**
+ * @brief Shuts down latency SLO controller module
+ */
+void slo_fini(void);
+
+/**
+ * @brief Closes samples socket and releases controller state
+ */
+void slo_exit(void);
+
+/**
+ * @brief Main loop of latency SLO controller
+ *
+ * Latency samples of protected application are received over Unix
+ * datagram socket as ASCII decimal values in microseconds separated by
+ * white spaces. When p99 latency exceeds the SLO, L3 CBM of the protected
+ * class grows by one way taken from CBMs of best-effort classes and MBA
+ * rate of best-effort classes is reduced by one step. With headroom
+ * resources are released one step at a time, MBA first.
+ *
+ * @param[in] pid Child pid to monitor for exit status
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+int slo_main(pid_t pid);
+
+#endif /* #define _SLO_H */
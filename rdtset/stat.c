@@ -0,0 +1,571 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "stat.h"
+#include "common.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+
+#define STAT_PERCENTILES 3 /**< number of reported percentiles */
+
+static const unsigned stat_pct[STAT_PERCENTILES] = {50, 95, 99};
+
+static const struct pqos_cap *m_cap;
+static const struct pqos_cpuinfo *m_cpu;
+
+/**
+ * Sampled metric
+ */
+struct stat_metric {
+        const char *name; /**< name in the text report */
+        const char *json; /**< key in the JSON report */
+        double *val;      /**< samples */
+        unsigned num;     /**< number of samples */
+        unsigned max;     /**< size of samples table */
+};
+
+enum stat_metric_id {
+        STAT_LLC = 0,
+        STAT_MBL,
+        STAT_MBT,
+        STAT_MBR,
+        STAT_IPC,
+        STAT_MISSES,
+        STAT_NUMOF
+};
+
+static struct {
+        enum pqos_mon_event event;  /**< monitored events */
+        struct pqos_mon_data group; /**< child monitoring group */
+        int started;                /**< monitoring group started */
+        struct stat_metric metric[STAT_NUMOF];
+        uint64_t mbm_local;         /**< total local memory traffic [B] */
+        uint64_t mbm_total;         /**< total memory traffic [B] */
+        uint64_t mbm_remote;        /**< total remote memory traffic [B] */
+        uint64_t llc_misses;        /**< total LLC misses */
+        uint64_t retired;           /**< total retired instructions */
+        uint64_t unhalted;          /**< total unhalted cycles */
+        unsigned samples;           /**< number of polls */
+} st = {
+    .metric = {
+        [STAT_LLC] = {"LLC[KB]", "llc_occupancy_kb", NULL, 0, 0},
+        [STAT_MBL] = {"MBL[MB/s]", "mbm_local_mbps", NULL, 0, 0},
+        [STAT_MBT] = {"MBT[MB/s]", "mbm_total_mbps", NULL, 0, 0},
+        [STAT_MBR] = {"MBR[MB/s]", "mbm_remote_mbps", NULL, 0, 0},
+        [STAT_IPC] = {"IPC", "ipc", NULL, 0, 0},
+        [STAT_MISSES] = {"MISSES[k/s]", "llc_misses_kps", NULL, 0, 0},
+    }};
+
+int
+stat_mode(const struct rdtset *cfg)
+{
+        return cfg->stat;
+}
+
+int
+stat_init(void)
+{
+        static const enum pqos_mon_event events[] = {
+            PQOS_MON_EVENT_L3_OCCUP, PQOS_MON_EVENT_LMEM_BW,
+            PQOS_MON_EVENT_TMEM_BW,  PQOS_MON_EVENT_RMEM_BW,
+            PQOS_PERF_EVENT_IPC,     PQOS_PERF_EVENT_LLC_MISS};
+        const struct pqos_monitor *mon;
+        unsigned i;
+        int ret;
+
+        if (m_cap != NULL || m_cpu != NULL) {
+                DBG("STAT: module already initialized!\n");
+                return -EEXIST;
+        }
+
+        ret = pqos_cap_get(&m_cap, &m_cpu);
+        if (ret != PQOS_RETVAL_OK) {
+                DBG("STAT: Error retrieving PQoS capabilities!\n");
+                ret = -EFAULT;
+                goto err;
+        }
+
+        st.event = (enum pqos_mon_event)0;
+        for (i = 0; i < DIM(events); i++)
+                if (pqos_cap_get_event(m_cap, events[i], &mon) ==
+                    PQOS_RETVAL_OK)
+                        st.event |= events[i];
+
+        if ((st.event & (PQOS_MON_EVENT_L3_OCCUP | PQOS_MON_EVENT_LMEM_BW |
+                         PQOS_MON_EVENT_TMEM_BW)) == 0) {
+                fprintf(stderr, "STAT: RDT monitoring not supported!\n");
+                ret = -EFAULT;
+                goto err;
+        }
+
+        return 0;
+err:
+        stat_fini();
+        return ret;
+}
+
+void
+stat_fini(void)
+{
+        m_cap = NULL;
+        m_cpu = NULL;
+}
+
+void
+stat_exit(void)
+{
+        unsigned i;
+
+        if (st.started) {
+                pqos_mon_stop(&st.group);
+                st.started = 0;
+        }
+
+        for (i = 0; i < STAT_NUMOF; i++) {
+                free(st.metric[i].val);
+                st.metric[i].val = NULL;
+                st.metric[i].num = 0;
+                st.metric[i].max = 0;
+        }
+}
+
+int
+stat_start(pid_t pid)
+{
+        struct pqos_mon_data *group = &st.group;
+
+        if (m_cap == NULL)
+                return -EFAULT;
+
+        memset(group, 0, sizeof(*group));
+        if (pqos_mon_start_pid(pid, st.event, NULL, group) != PQOS_RETVAL_OK) {
+                fprintf(stderr, "STAT: Failed to start monitoring of pid %d\n",
+                        (int)pid);
+                return -EFAULT;
+        }
+        st.started = 1;
+
+        /* baseline for the first sample, the command has not started yet */
+        if (pqos_mon_poll_snapshot(&group, 1, NULL) != PQOS_RETVAL_OK) {
+                fprintf(stderr, "STAT: Failed to read counters of pid %d\n",
+                        (int)pid);
+                return -EFAULT;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Appends sample to the metric
+ *
+ * @param[in,out] m metric
+ * @param[in] val sample value
+ */
+static void
+stat_add(struct stat_metric *m, const double val)
+{
+        if (m->num == m->max) {
+                unsigned max = m->max == 0 ? 1024 : m->max * 2;
+                double *ptr = realloc(m->val, max * sizeof(m->val[0]));
+
+                if (ptr == NULL)
+                        return;
+                m->val = ptr;
+                m->max = max;
+        }
+
+        m->val[m->num++] = val;
+}
+
+/**
+ * @brief Records one poll of the monitoring group
+ */
+static void
+stat_record(void)
+{
+        const struct pqos_mon_data *g = &st.group;
+        const struct pqos_event_values *pv = &g->values;
+        const double mb = 1024.0 * 1024.0;
+        double interval;
+
+        st.samples++;
+        if (g->read_interval == 0)
+                return;
+        interval = (double)g->read_interval / 1000000000.0;
+
+        if (st.event & PQOS_MON_EVENT_L3_OCCUP)
+                stat_add(&st.metric[STAT_LLC], (double)pv->llc / 1024.0);
+        if (st.event & PQOS_MON_EVENT_LMEM_BW) {
+                stat_add(&st.metric[STAT_MBL], g->mbm_local_rate / mb);
+                st.mbm_local += pv->mbm_local_delta;
+        }
+        if (st.event & PQOS_MON_EVENT_TMEM_BW) {
+                stat_add(&st.metric[STAT_MBT], g->mbm_total_rate / mb);
+                st.mbm_total += pv->mbm_total_delta;
+        }
+        if (st.event & PQOS_MON_EVENT_RMEM_BW) {
+                stat_add(&st.metric[STAT_MBR], g->mbm_remote_rate / mb);
+                st.mbm_remote += pv->mbm_remote_delta;
+        }
+        if (st.event & PQOS_PERF_EVENT_IPC) {
+                /* idle intervals carry no IPC information */
+                if (pv->ipc_unhalted_delta > 0)
+                        stat_add(&st.metric[STAT_IPC], pv->ipc);
+                st.retired += pv->ipc_retired_delta;
+                st.unhalted += pv->ipc_unhalted_delta;
+        }
+        if (st.event & PQOS_PERF_EVENT_LLC_MISS) {
+                stat_add(&st.metric[STAT_MISSES],
+                         (double)pv->llc_misses_delta / interval / 1000.0);
+                st.llc_misses += pv->llc_misses_delta;
+        }
+}
+
+/**
+ * @brief Compare function for qsort
+ */
+static int
+stat_cmp(const void *a, const void *b)
+{
+        const double va = *(const double *)a;
+        const double vb = *(const double *)b;
+
+        return (va > vb) - (va < vb);
+}
+
+/**
+ * Summary of a metric
+ */
+struct stat_summary {
+        double mean;
+        double pct[STAT_PERCENTILES];
+        double peak;
+};
+
+/**
+ * @brief Sorts metric samples and computes the summary
+ *
+ * @param[in,out] m metric
+ * @param[out] s summary
+ */
+static void
+stat_summarize(struct stat_metric *m, struct stat_summary *s)
+{
+        double sum = 0.0;
+        unsigned i;
+
+        memset(s, 0, sizeof(*s));
+        if (m->num == 0)
+                return;
+
+        qsort(m->val, m->num, sizeof(m->val[0]), stat_cmp);
+        for (i = 0; i < m->num; i++)
+                sum += m->val[i];
+
+        s->mean = sum / m->num;
+        /* nearest-rank percentiles */
+        for (i = 0; i < STAT_PERCENTILES; i++)
+                s->pct[i] = m->val[(m->num * stat_pct[i] + 99) / 100 - 1];
+        s->peak = m->val[m->num - 1];
+}
+
+/**
+ * @brief Writes string as JSON string literal
+ *
+ * @param[in] fp output stream
+ * @param[in] str string to write
+ */
+static void
+stat_json_str(FILE *fp, const char *str)
+{
+        fputc('"', fp);
+        for (; *str != '\0'; str++) {
+                const unsigned char c = (unsigned char)*str;
+
+                if (c == '"' || c == '\\')
+                        fprintf(fp, "\\%c", c);
+                else if (c < 0x20)
+                        fprintf(fp, "\\u%04x", c);
+                else
+                        fputc(c, fp);
+        }
+        fputc('"', fp);
+}
+
+/**
+ * @brief Prints human readable report
+ *
+ * @param[in] fp output stream
+ * @param[in] argc number of command args
+ * @param[in] argv command args
+ * @param[in] elapsed run time in us
+ * @param[in] summary metric summaries
+ */
+static void
+stat_print_text(FILE *fp,
+                int argc,
+                char **argv,
+                const uint64_t elapsed,
+                const struct stat_summary *summary)
+{
+        const double mb = 1024.0 * 1024.0;
+        unsigned i, j;
+        int n;
+
+        fprintf(fp, "\n RDT stats for '");
+        for (n = 0; n < argc; n++)
+                fprintf(fp, "%s%s", n > 0 ? " " : "", argv[n]);
+        fprintf(fp, "':\n\n");
+
+        fprintf(fp, " %-12s %8s %12s", "METRIC", "SAMPLES", "MEAN");
+        for (j = 0; j < STAT_PERCENTILES; j++)
+                fprintf(fp, "          p%02u", stat_pct[j]);
+        fprintf(fp, " %12s\n", "PEAK");
+
+        for (i = 0; i < STAT_NUMOF; i++) {
+                const struct stat_metric *m = &st.metric[i];
+                const struct stat_summary *s = &summary[i];
+
+                if (m->num == 0)
+                        continue;
+                fprintf(fp, " %-12s %8u %12.2f", m->name, m->num, s->mean);
+                for (j = 0; j < STAT_PERCENTILES; j++)
+                        fprintf(fp, " %12.2f", s->pct[j]);
+                fprintf(fp, " %12.2f\n", s->peak);
+        }
+
+        fprintf(fp, "\n");
+        if (st.event & PQOS_MON_EVENT_LMEM_BW)
+                fprintf(fp, " %16.1f MB local memory traffic\n",
+                        st.mbm_local / mb);
+        if (st.event & PQOS_MON_EVENT_TMEM_BW)
+                fprintf(fp, " %16.1f MB total memory traffic\n",
+                        st.mbm_total / mb);
+        if (st.event & PQOS_MON_EVENT_RMEM_BW)
+                fprintf(fp, " %16.1f MB remote memory traffic\n",
+                        st.mbm_remote / mb);
+        if (st.event & PQOS_PERF_EVENT_IPC) {
+                fprintf(fp, " %16llu instructions\n",
+                        (unsigned long long)st.retired);
+                fprintf(fp, " %16llu cycles\n",
+                        (unsigned long long)st.unhalted);
+                if (st.unhalted > 0)
+                        fprintf(fp, " %16.2f IPC\n",
+                                (double)st.retired / st.unhalted);
+        }
+        if (st.event & PQOS_PERF_EVENT_LLC_MISS)
+                fprintf(fp, " %16llu LLC misses\n",
+                        (unsigned long long)st.llc_misses);
+
+        fprintf(fp, "\n %16.3f seconds elapsed, %u samples every %u ms\n\n",
+                elapsed / 1000000.0, st.samples, g_cfg.stat_interval);
+}
+
+/**
+ * @brief Writes JSON report
+ *
+ * @param[in] fp output stream
+ * @param[in] argc number of command args
+ * @param[in] argv command args
+ * @param[in] elapsed run time in us
+ * @param[in] status child exit status, -1 if unknown
+ * @param[in] summary metric summaries
+ */
+static void
+stat_print_json(FILE *fp,
+                int argc,
+                char **argv,
+                const uint64_t elapsed,
+                const int status,
+                const struct stat_summary *summary)
+{
+        unsigned i, j;
+        int n;
+
+        fprintf(fp, "{\n  \"command\": [");
+        for (n = 0; n < argc; n++) {
+                fprintf(fp, "%s", n > 0 ? ", " : "");
+                stat_json_str(fp, argv[n]);
+        }
+        fprintf(fp, "],\n");
+        fprintf(fp, "  \"exit_status\": %d,\n", status);
+        fprintf(fp, "  \"elapsed_s\": %.6f,\n", elapsed / 1000000.0);
+        fprintf(fp, "  \"interval_ms\": %u,\n", g_cfg.stat_interval);
+        fprintf(fp, "  \"samples\": %u,\n", st.samples);
+
+        fprintf(fp, "  \"totals\": {");
+        n = 0;
+        if (st.event & PQOS_MON_EVENT_LMEM_BW)
+                fprintf(fp, "%s\n    \"mbm_local_bytes\": %llu",
+                        n++ ? "," : "", (unsigned long long)st.mbm_local);
+        if (st.event & PQOS_MON_EVENT_TMEM_BW)
+                fprintf(fp, "%s\n    \"mbm_total_bytes\": %llu",
+                        n++ ? "," : "", (unsigned long long)st.mbm_total);
+        if (st.event & PQOS_MON_EVENT_RMEM_BW)
+                fprintf(fp, "%s\n    \"mbm_remote_bytes\": %llu",
+                        n++ ? "," : "", (unsigned long long)st.mbm_remote);
+        if (st.event & PQOS_PERF_EVENT_IPC) {
+                fprintf(fp, "%s\n    \"instructions\": %llu",
+                        n++ ? "," : "", (unsigned long long)st.retired);
+                fprintf(fp, ",\n    \"cycles\": %llu",
+                        (unsigned long long)st.unhalted);
+                fprintf(fp, ",\n    \"ipc\": %.4f",
+                        st.unhalted > 0 ? (double)st.retired / st.unhalted
+                                        : 0.0);
+        }
+        if (st.event & PQOS_PERF_EVENT_LLC_MISS)
+                fprintf(fp, "%s\n    \"llc_misses\": %llu", n++ ? "," : "",
+                        (unsigned long long)st.llc_misses);
+        fprintf(fp, "\n  },\n");
+
+        fprintf(fp, "  \"metrics\": {");
+        n = 0;
+        for (i = 0; i < STAT_NUMOF; i++) {
+                const struct stat_metric *m = &st.metric[i];
+                const struct stat_summary *s = &summary[i];
+
+                if (m->num == 0)
+                        continue;
+                fprintf(fp, "%s\n    \"%s\": {\"samples\": %u, \"mean\": %.4f",
+                        n++ ? "," : "", m->json, m->num, s->mean);
+                for (j = 0; j < STAT_PERCENTILES; j++)
+                        fprintf(fp, ", \"p%u\": %.4f", stat_pct[j], s->pct[j]);
+                fprintf(fp, ", \"peak\": %.4f}", s->peak);
+        }
+        fprintf(fp, "\n  }\n}\n");
+}
+
+/**
+ * @brief Prints text report and writes JSON report if selected
+ *
+ * @param[in] argc number of command args
+ * @param[in] argv command args
+ * @param[in] elapsed run time in us
+ * @param[in] status child exit status, -1 if unknown
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+stat_report(int argc, char **argv, const uint64_t elapsed, const int status)
+{
+        struct stat_summary summary[STAT_NUMOF];
+        unsigned i;
+        FILE *fp;
+
+        for (i = 0; i < STAT_NUMOF; i++)
+                stat_summarize(&st.metric[i], &summary[i]);
+
+        stat_print_text(stderr, argc, argv, elapsed, summary);
+
+        if (g_cfg.stat_json == NULL)
+                return 0;
+
+        if (strcmp(g_cfg.stat_json, "-") == 0) {
+                stat_print_json(stdout, argc, argv, elapsed, status, summary);
+                return 0;
+        }
+
+        fp = fopen(g_cfg.stat_json, "w");
+        if (fp == NULL) {
+                fprintf(stderr, "STAT: Failed to open %s\n", g_cfg.stat_json);
+                return -errno;
+        }
+        stat_print_json(fp, argc, argv, elapsed, status, summary);
+        if (fclose(fp) != 0)
+                return -EIO;
+
+        return 0;
+}
+
+int
+stat_main(pid_t pid, int argc, char **argv)
+{
+        const uint64_t interval = (uint64_t)g_cfg.stat_interval * 1000000ULL;
+        struct pqos_mon_data *group = &st.group;
+        struct timespec next;
+        uint64_t start;
+        int status = -1;
+        int ret;
+
+        if (m_cap == NULL || !st.started)
+                return -EFAULT;
+
+        start = get_time_usec();
+        clock_gettime(CLOCK_MONOTONIC, &next);
+
+        for (;;) {
+                int exited;
+
+                /* absolute deadlines, sampling does not drift */
+                next.tv_nsec += interval % 1000000000ULL;
+                next.tv_sec += interval / 1000000000ULL;
+                if (next.tv_nsec >= 1000000000L) {
+                        next.tv_nsec -= 1000000000L;
+                        next.tv_sec++;
+                }
+                while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+                                       NULL) == EINTR)
+                        ;
+
+                exited = waitpid(pid, &status, WNOHANG) == pid;
+
+                /* counters of an exited command may be gone already */
+                if (pqos_mon_poll_snapshot(&group, 1, NULL) == PQOS_RETVAL_OK)
+                        stat_record();
+                else if (!exited)
+                        DBG("STAT: Failed to read counters\n");
+
+                if (exited)
+                        break;
+        }
+
+        if (WIFEXITED(status))
+                status = WEXITSTATUS(status);
+        else if (WIFSIGNALED(status))
+                status = 128 + WTERMSIG(status);
+
+        ret = stat_report(argc, argv, get_time_usec() - start, status);
+        stat_exit();
+        if (ret == 0 && status != EXIT_SUCCESS)
+                ret = -ECHILD;
+
+        return ret;
+}
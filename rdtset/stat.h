@@ -0,0 +1,104 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef _STAT_H
+#define _STAT_H
+
+#include <unistd.h>
+#include "common.h"
+
+#define STAT_DEF_INTERVAL 100 /**< Default sampling interval in ms */
+
+/**
+ * @brief Checks if run-and-report mode is selected
+ *
+ * @param[in] cfg rdtset configuration
+ *
+ * @return 1 if --stat was given
+ */
+int stat_mode(const struct rdtset *cfg);
+
+/**
+ * @brief Initializes run-and-report module
+ *
+ * Selects all monitoring events supported by the platform.
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+int stat_init(void);
+
+/**
+ * @brief Shuts down run-and-report module
+ */
+void stat_fini(void);
+
+/**
+ * @brief Stops monitoring and releases collected samples
+ */
+void stat_exit(void);
+
+/**
+ * @brief Starts monitoring of the child process
+ *
+ * Called after fork and before the child executes the command, so that
+ * all threads and children of the command are tracked from the start.
+ *
+ * @param[in] pid Child pid
+ *
+ * @return status
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+int stat_start(pid_t pid);
+
+/**
+ * @brief Main loop of run-and-report module
+ *
+ * Samples monitoring events every g_cfg.stat_interval ms until the child
+ * exits, then prints mean, percentiles and peak of LLC occupancy, memory
+ * bandwidth, IPC and LLC misses together with totals. Report is printed
+ * on stderr and optionally written as JSON to g_cfg.stat_json.
+ *
+ * @param[in] pid Child pid to monitor for exit status
+ * @param[in] argc number of command args
+ * @param[in] argv command args
+ *
+ * @return status
+ * @retval 0 on success, child exited with success
+ * @retval negative on error (-errno)
+ */
+int stat_main(pid_t pid, int argc, char **argv);
+
+#endif /* #define _STAT_H */
@@ -0,0 +1,100 @@
+################################################################################
+# BSD LICENSE
+#
+# Copyright(c) 2020 Intel Corporation. All rights reserved.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#   * Neither the name of Intel Corporation nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+
+import test
+import re
+import pytest
+from priority import PRIORITY_MEDIUM
+
+class TestPqosPrefetch(test.Test):
+
+    ## @cond
+    @pytest.fixture(autouse=True)
+    def init(self, request):
+        super(TestPqosPrefetch, self).init(request)
+        yield
+        super(TestPqosPrefetch, self).fini()
+    ## @endcond
+
+
+    ## PQOS - Prefetch Set COS prefetchers
+    #
+    #  \b Priority: Medium
+    #
+    #  \b Objective:
+    #  Verify disabling HW prefetchers on cores associated with COS
+    #
+    #  \b Instruction:
+    #  Run "pqos -a llc:7=1,3 -e prefetch:7=0x0" to disable prefetchers on cores
+    #  associated with COS7. Verify prefetcher state with "pqos -s -v".
+    #
+    #  \b Result:
+    #  Observe "COS7 PREFETCH => 0x0" in output. Cores 1 and 3 report PREFETCH 0x0.
+    @PRIORITY_MEDIUM
+    @pytest.mark.iface_msr
+    @pytest.mark.rdt_supported("cat_l3")
+    def test_pqos_prefetch_set(self, iface):
+        (stdout, _, exitstatus) = self.run_pqos(iface, "-a llc:7=1,3 -e prefetch:7=0x0")
+        assert exitstatus == 0
+        assert "COS7 PREFETCH => 0x0" in stdout
+
+        try:
+            (stdout, _, exitstatus) = self.run_pqos(iface, "-s -v")
+            assert exitstatus == 0
+            assert re.search("Core 1, L2ID [0-9]+, L3ID [0-9]+ => COS7.*PREFETCH 0x0",
+                             stdout) is not None
+            assert re.search("Core 3, L2ID [0-9]+, L3ID [0-9]+ => COS7.*PREFETCH 0x0",
+                             stdout) is not None
+        finally:
+            self.run_pqos(iface, "-e prefetch:7=0xf")
+
+
+    ## PQOS - Prefetch Set COS prefetchers - Negative
+    #
+    #  \b Priority: Medium
+    #
+    #  \b Objective:
+    #  Unable to set invalid prefetcher mask
+    #
+    #  \b Instruction:
+    #  Run "pqos -e prefetch:7=0x10" to set prefetchers.
+    #
+    #  \b Result:
+    #  Observe "Invalid prefetcher mask 0x10!" in output
+    @PRIORITY_MEDIUM
+    @pytest.mark.iface_msr
+    @pytest.mark.rdt_supported("cat_l3")
+    def test_pqos_prefetch_set_negative(self, iface):
+        (stdout, _, exitstatus) = self.run_pqos(iface, "-e prefetch:7=0x10")
+        assert exitstatus == 1
+        assert "Invalid prefetcher mask 0x10!" in stdout
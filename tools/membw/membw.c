@@ -42,6 +42,7 @@
 #include <unistd.h>
 #include <signal.h>
 #include <sys/time.h>
+#include <sys/mman.h>
 #include <pthread.h>
 #include <getopt.h>
 
@@ -83,6 +84,19 @@
 #define CPU_FEATURE_CLWB    (1ULL << 1)
 #define CPU_FEATURE_AVX512F (1ULL << 2)
 
+#define MAX_PHASES  16
+#define DIM(x)      (sizeof(x) / sizeof(x[0]))
+#define MIX_PERIOD  100 /* accesses in one read/write mix period */
+#define RATIO_UNSET UINT_MAX
+
+#define HUGEPAGE_2M      (2UL * 1024 * 1024)
+#define HUGEPAGE_1G      (1024UL * 1024 * 1024)
+#define MAX_INIT_THREADS 64
+
+#if defined(MAP_HUGETLB) && !defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif
+
 /**
  * DATA STRUCTURES
  */
@@ -130,13 +144,46 @@ struct cpuid_out {
 static struct cpuid_out cpuid_1_0; /* leaf 1, sub-leaf 0 */
 static struct cpuid_out cpuid_7_0; /* leaf 7, sub-leaf 0 */
 
+struct mem_phase;
+
+/**
+ * Access kernel - performs \a n accesses of one operation type
+ * following the phase access pattern
+ */
+typedef void (*mem_kernel_fn)(struct mem_phase *ph, unsigned n,
+                              const uint64_t val);
+
+/**
+ * Single phase of the access schedule
+ */
+struct mem_phase {
+        /* configuration */
+        enum cl_type rd_type;  /* operation used for reads */
+        enum cl_type wr_type;  /* operation used for writes */
+        unsigned bw;           /* bandwidth in MB/s */
+        unsigned write_ratio;  /* percentage of write accesses */
+        unsigned stride;       /* stride in cache lines */
+        int random;            /* random access order */
+        size_t wss;            /* working set size in bytes */
+        unsigned duration;     /* phase duration in seconds, 0 - endless */
+        /* runtime state, set up by phase_prepare() */
+        mem_kernel_fn rd_fn;   /* specialized read kernel */
+        mem_kernel_fn wr_fn;   /* specialized write kernel */
+        size_t lines;          /* working set size in cache lines */
+        size_t slots;          /* number of accessed lines per pass */
+        uint32_t *perm;        /* line indexes in random access order */
+        size_t cursor;         /* current line/permutation index */
+        unsigned mix_pos;      /* position in the read/write mix period */
+        unsigned chunk_lines;  /* cache lines accessed per interval */
+};
+
 /**
  * COMMON DATA
  */
 
 static int stop_loop = 0;
 static void *memchunk = NULL;
-static unsigned memchunk_offset = 0;
+static size_t memchunk_mapped = 0;
 
 /**
  * UTILS
@@ -329,41 +376,6 @@ mem_flush(void *p, size_t s)
         sb();
 }
 
-/**
- * @brief Function to initialize and allocate memory to thread
- *
- * @param s size of memory to allocate to thread
- *
- * @retval p allocated memory
- */
-static void *
-malloc_and_init_memory(size_t s)
-{
-        void *p = NULL;
-        int ret;
-
-        ret = posix_memalign(&p, PAGE_SIZE, s - s % PAGE_SIZE);
-
-        if (ret != 0 || p == NULL) {
-                printf("ERROR: Failed to allocate %lu bytes\n",
-                       (unsigned long)s - s % PAGE_SIZE);
-                stop_loop = 1;
-                return NULL;
-        }
-
-        uint64_t *p64 = (uint64_t *)p;
-        size_t s64 = s / sizeof(uint64_t);
-
-        while (s64 > 0) {
-                *p64 = (uint64_t)rand();
-                p64 += (CL_SIZE / sizeof(uint64_t));
-                s64 -= (CL_SIZE / sizeof(uint64_t));
-        }
-
-        mem_flush(p, MEMCHUNK_SIZE);
-        return p;
-}
-
 /**
  * MEMORY OPERATIONS
  */
@@ -701,8 +713,8 @@ cl_read(void *p)
                      "movq 40(%1), %0\n\t"
                      "movq 48(%1), %0\n\t"
                      "movq 56(%1), %0\n\t"
-                     :
-                     : "r"(v), "r"(p)
+                     : "=&r"(v)
+                     : "r"(p)
                      : "memory");
 #else
         asm volatile("movl (%1), %0\n\t"
@@ -721,8 +733,8 @@ cl_read(void *p)
                      "movl 52(%1), %0\n\t"
                      "movl 56(%1), %0\n\t"
                      "movl 64(%1), %0\n\t"
-                     :
-                     : "r"(v), "r"(p)
+                     : "=&r"(v)
+                     : "r"(p)
                      : "memory");
 #endif
 }
@@ -746,94 +758,266 @@ cl_read_dqa(void *p)
 }
 
 /**
- * @brief Function to find selected operation and execute it
+ * @brief Function to execute selected operation on a cache line
  *
- * @param bw amount of bandwidth
- * @param type operation type to perform on core
+ * @param ptr pointer to cache line
+ * @param val value to write
+ * @param type operation type to perform
  */
 ALWAYS_INLINE void
-mem_execute(const unsigned bw, const enum cl_type type)
+cl_access(void *ptr, const uint64_t val, const enum cl_type type)
+{
+        switch (type) {
+        case CL_TYPE_PREFETCH_T0:
+                cl_prefetch_t0(ptr);
+                break;
+        case CL_TYPE_PREFETCH_T1:
+                cl_prefetch_t1(ptr);
+                break;
+        case CL_TYPE_PREFETCH_T2:
+                cl_prefetch_t2(ptr);
+                break;
+        case CL_TYPE_PREFETCH_NTA:
+                cl_prefetch_nta(ptr);
+                break;
+        case CL_TYPE_PREFETCH_W:
+                cl_prefetch_w(ptr);
+                break;
+        case CL_TYPE_READ_NTQ:
+                cl_read_ntq(ptr);
+                break;
+        case CL_TYPE_READ_WB:
+                cl_read(ptr);
+                break;
+        case CL_TYPE_READ_WB_DQA:
+                cl_read_dqa(ptr);
+                break;
+        case CL_TYPE_READ_MOD_WRITE:
+                cl_read_mod_write(ptr, val);
+                break;
+#ifdef __x86_64__
+        case CL_TYPE_WRITE_DQA:
+                cl_write_dqa(ptr, val);
+                break;
+        case CL_TYPE_WRITE_DQA_FLUSH:
+                cl_write_dqa_flush(ptr, val);
+                break;
+#endif
+        case CL_TYPE_WRITE_WB:
+                cl_write(ptr, val);
+                break;
+#ifdef __x86_64__
+        case CL_TYPE_WRITE_WB_AVX512:
+                cl_write_avx512(ptr, val);
+                break;
+#endif
+        case CL_TYPE_WRITE_WB_CLWB:
+                cl_write_clwb(ptr, val);
+                break;
+        case CL_TYPE_WRITE_WB_FLUSH:
+                cl_write_flush(ptr, val);
+                break;
+        case CL_TYPE_WRITE_NTI:
+                cl_write_nti(ptr, val);
+                break;
+        case CL_TYPE_WRITE_NTI_CLWB:
+                cl_write_nti_clwb(ptr, val);
+                break;
+#ifdef __x86_64__
+        case CL_TYPE_WRITE_NT512:
+                cl_write_nt512(ptr, val);
+                break;
+        case CL_TYPE_WRITE_NTDQ:
+                cl_write_ntdq(ptr, val);
+                break;
+#endif
+        default:
+                assert(0);
+                break;
+        }
+}
+
+/**
+ * @brief Access working set linearly with a fixed stride
+ *
+ * @param ph phase to execute
+ * @param n number of cache lines to access
+ * @param val value to write
+ * @param type operation type to perform
+ */
+ALWAYS_INLINE void
+mem_linear(struct mem_phase *ph,
+           unsigned n,
+           const uint64_t val,
+           const enum cl_type type)
 {
-        const uint64_t val = (uint64_t)rand();
         char *cp = (char *)memchunk;
-        unsigned i = 0;
-        const size_t s = MEMCHUNK_SIZE / CL_SIZE; /* mem size in cache lines */
+        const size_t lines = ph->lines;
+        const size_t stride = ph->stride;
+        size_t off = ph->cursor;
 
         assert(memchunk != NULL);
 
-        for (i = 0; i < bw; i++) {
-                char *ptr = cp + (memchunk_offset * CL_SIZE);
+        while (n-- > 0) {
+                cl_access(cp + (off * CL_SIZE), val, type);
+                off += stride;
+                if (off >= lines)
+                        off -= lines;
+        }
+        ph->cursor = off;
+}
 
-                switch (type) {
-                case CL_TYPE_PREFETCH_T0:
-                        cl_prefetch_t0(ptr);
-                        break;
-                case CL_TYPE_PREFETCH_T1:
-                        cl_prefetch_t1(ptr);
-                        break;
-                case CL_TYPE_PREFETCH_T2:
-                        cl_prefetch_t2(ptr);
-                        break;
-                case CL_TYPE_PREFETCH_NTA:
-                        cl_prefetch_nta(ptr);
-                        break;
-                case CL_TYPE_PREFETCH_W:
-                        cl_prefetch_w(ptr);
-                        break;
-                case CL_TYPE_READ_NTQ:
-                        cl_read_ntq(ptr);
-                        break;
-                case CL_TYPE_READ_WB:
-                        cl_read(ptr);
-                        break;
-                case CL_TYPE_READ_WB_DQA:
-                        cl_read_dqa(ptr);
-                        break;
-                case CL_TYPE_READ_MOD_WRITE:
-                        cl_read_mod_write(ptr, val);
-                        break;
+/**
+ * @brief Access working set in precomputed random order
+ *
+ * @param ph phase to execute
+ * @param n number of cache lines to access
+ * @param val value to write
+ * @param type operation type to perform
+ */
+ALWAYS_INLINE void
+mem_random(struct mem_phase *ph,
+           unsigned n,
+           const uint64_t val,
+           const enum cl_type type)
+{
+        char *cp = (char *)memchunk;
+        const uint32_t *perm = ph->perm;
+        const size_t slots = ph->slots;
+        size_t idx = ph->cursor;
+
+        assert(memchunk != NULL);
+        assert(perm != NULL);
+
+        while (n-- > 0) {
+                cl_access(cp + ((size_t)perm[idx] * CL_SIZE), val, type);
+                if (++idx >= slots)
+                        idx = 0;
+        }
+        ph->cursor = idx;
+}
+
+/**
+ * Generates linear and random access kernels specialized
+ * for a single operation type
+ */
+#define MEM_KERNEL(name, type)                                                 \
+        static void mem_linear_##name(struct mem_phase *ph, unsigned n,        \
+                                      const uint64_t val)                      \
+        {                                                                      \
+                mem_linear(ph, n, val, type);                                  \
+        }                                                                      \
+        static void mem_random_##name(struct mem_phase *ph, unsigned n,        \
+                                      const uint64_t val)                      \
+        {                                                                      \
+                mem_random(ph, n, val, type);                                  \
+        }
+
+#define MEM_KERNEL_ENTRY(name)                                                 \
+        {                                                                      \
+                mem_linear_##name, mem_random_##name                           \
+        }
+
+MEM_KERNEL(prefetch_t0, CL_TYPE_PREFETCH_T0)
+MEM_KERNEL(prefetch_t1, CL_TYPE_PREFETCH_T1)
+MEM_KERNEL(prefetch_t2, CL_TYPE_PREFETCH_T2)
+MEM_KERNEL(prefetch_nta, CL_TYPE_PREFETCH_NTA)
+MEM_KERNEL(prefetch_w, CL_TYPE_PREFETCH_W)
+MEM_KERNEL(read_ntq, CL_TYPE_READ_NTQ)
+MEM_KERNEL(read_wb, CL_TYPE_READ_WB)
+MEM_KERNEL(read_wb_dqa, CL_TYPE_READ_WB_DQA)
+MEM_KERNEL(read_mod_write, CL_TYPE_READ_MOD_WRITE)
 #ifdef __x86_64__
-                case CL_TYPE_WRITE_DQA:
-                        cl_write_dqa(ptr, val);
-                        break;
-                case CL_TYPE_WRITE_DQA_FLUSH:
-                        cl_write_dqa_flush(ptr, val);
-                        break;
+MEM_KERNEL(write_dqa, CL_TYPE_WRITE_DQA)
+MEM_KERNEL(write_dqa_flush, CL_TYPE_WRITE_DQA_FLUSH)
 #endif
-                case CL_TYPE_WRITE_WB:
-                        cl_write(ptr, val);
-                        break;
+MEM_KERNEL(write_wb, CL_TYPE_WRITE_WB)
 #ifdef __x86_64__
-                case CL_TYPE_WRITE_WB_AVX512:
-                        cl_write_avx512(ptr, val);
-                        break;
+MEM_KERNEL(write_wb_avx512, CL_TYPE_WRITE_WB_AVX512)
 #endif
-                case CL_TYPE_WRITE_WB_CLWB:
-                        cl_write_clwb(ptr, val);
-                        break;
-                case CL_TYPE_WRITE_WB_FLUSH:
-                        cl_write_flush(ptr, val);
-                        break;
-                case CL_TYPE_WRITE_NTI:
-                        cl_write_nti(ptr, val);
-                        break;
-                case CL_TYPE_WRITE_NTI_CLWB:
-                        cl_write_nti_clwb(ptr, val);
-                        break;
+MEM_KERNEL(write_wb_clwb, CL_TYPE_WRITE_WB_CLWB)
+MEM_KERNEL(write_wb_flush, CL_TYPE_WRITE_WB_FLUSH)
+MEM_KERNEL(write_nti, CL_TYPE_WRITE_NTI)
+MEM_KERNEL(write_nti_clwb, CL_TYPE_WRITE_NTI_CLWB)
 #ifdef __x86_64__
-                case CL_TYPE_WRITE_NT512:
-                        cl_write_nt512(ptr, val);
-                        break;
-                case CL_TYPE_WRITE_NTDQ:
-                        cl_write_ntdq(ptr, val);
-                        break;
+MEM_KERNEL(write_nt512, CL_TYPE_WRITE_NT512)
+MEM_KERNEL(write_ntdq, CL_TYPE_WRITE_NTDQ)
 #endif
-                default:
-                        assert(0);
-                        break;
+
+/**
+ * Access kernels indexed by operation type
+ */
+static const struct {
+        mem_kernel_fn linear;
+        mem_kernel_fn random;
+} kernel_tab[] = {
+    [CL_TYPE_PREFETCH_T0] = MEM_KERNEL_ENTRY(prefetch_t0),
+    [CL_TYPE_PREFETCH_T1] = MEM_KERNEL_ENTRY(prefetch_t1),
+    [CL_TYPE_PREFETCH_T2] = MEM_KERNEL_ENTRY(prefetch_t2),
+    [CL_TYPE_PREFETCH_NTA] = MEM_KERNEL_ENTRY(prefetch_nta),
+    [CL_TYPE_PREFETCH_W] = MEM_KERNEL_ENTRY(prefetch_w),
+    [CL_TYPE_READ_NTQ] = MEM_KERNEL_ENTRY(read_ntq),
+    [CL_TYPE_READ_WB] = MEM_KERNEL_ENTRY(read_wb),
+    [CL_TYPE_READ_WB_DQA] = MEM_KERNEL_ENTRY(read_wb_dqa),
+    [CL_TYPE_READ_MOD_WRITE] = MEM_KERNEL_ENTRY(read_mod_write),
+#ifdef __x86_64__
+    [CL_TYPE_WRITE_DQA] = MEM_KERNEL_ENTRY(write_dqa),
+    [CL_TYPE_WRITE_DQA_FLUSH] = MEM_KERNEL_ENTRY(write_dqa_flush),
+#endif
+    [CL_TYPE_WRITE_WB] = MEM_KERNEL_ENTRY(write_wb),
+#ifdef __x86_64__
+    [CL_TYPE_WRITE_WB_AVX512] = MEM_KERNEL_ENTRY(write_wb_avx512),
+#endif
+    [CL_TYPE_WRITE_WB_CLWB] = MEM_KERNEL_ENTRY(write_wb_clwb),
+    [CL_TYPE_WRITE_WB_FLUSH] = MEM_KERNEL_ENTRY(write_wb_flush),
+    [CL_TYPE_WRITE_NTI] = MEM_KERNEL_ENTRY(write_nti),
+    [CL_TYPE_WRITE_NTI_CLWB] = MEM_KERNEL_ENTRY(write_nti_clwb),
+#ifdef __x86_64__
+    [CL_TYPE_WRITE_NT512] = MEM_KERNEL_ENTRY(write_nt512),
+    [CL_TYPE_WRITE_NTDQ] = MEM_KERNEL_ENTRY(write_ntdq),
+#endif
+};
+
+/**
+ * @brief Function to execute one interval of the phase
+ *
+ * Reads and writes are issued in runs within a MIX_PERIOD accesses long
+ * period, so the selected mix does not cost a branch per access.
+ *
+ * @param ph phase to execute
+ */
+static void
+mem_execute(struct mem_phase *ph)
+{
+        const uint64_t val = (uint64_t)rand();
+        unsigned n = ph->chunk_lines;
+
+        if (ph->write_ratio == 0) {
+                ph->rd_fn(ph, n, val);
+                n = 0;
+        } else if (ph->write_ratio == MIX_PERIOD) {
+                ph->wr_fn(ph, n, val);
+                n = 0;
+        }
+
+        while (n > 0) {
+                unsigned cnt;
+
+                if (ph->mix_pos < ph->write_ratio) {
+                        cnt = ph->write_ratio - ph->mix_pos;
+                        if (cnt > n)
+                                cnt = n;
+                        ph->wr_fn(ph, cnt, val);
+                } else {
+                        cnt = MIX_PERIOD - ph->mix_pos;
+                        if (cnt > n)
+                                cnt = n;
+                        ph->rd_fn(ph, cnt, val);
                 }
-                if (++memchunk_offset >= s)
-                        memchunk_offset = 0;
+                ph->mix_pos += cnt;
+                if (ph->mix_pos >= MIX_PERIOD)
+                        ph->mix_pos = 0;
+                n -= cnt;
         }
         sb();
 }
@@ -850,10 +1034,28 @@ mem_execute(const unsigned bw, const enum cl_type type)
 static void
 usage(char **argv)
 {
-        printf("Usage: %s -c <cpu> -b <BW [MB/s]> <operation type>\n"
+        printf("Usage: %s -c <cpu> -b <BW [MB/s]> [<pattern options>] "
+               "<operation type>\n"
                "Description:\n"
                "  -c, --cpu          cpu to generate B/W\n"
                "  -b, --bandwidth    memory B/W specified in MBps\n"
+               "Pattern options:\n"
+               "  --stride <n>       access every n-th cache line "
+               "(default 1)\n"
+               "  --random           access cache lines in random order\n"
+               "  --wss <size>       working set size, e.g. 256K, 16M, "
+               "or l2, llc, dram\n"
+               "  --write-ratio <n>  percentage of accesses made with the "
+               "write operation\n"
+               "                     when a read and a write operation are "
+               "selected\n"
+               "  --phase <spec>     add phase to the schedule, "
+               "comma separated list of\n"
+               "                     time=<s>, bw=<MB/s>, op=<operation>, "
+               "stride=<n>, wss=<size>,\n"
+               "                     write-ratio=<n>, random and linear\n"
+               "  --hugepage <size>  back memory with 2M (default) or 1G "
+               "hugepages, or none\n"
                "Operation types:\n"
                "  --prefetch-t0      prefetcht0\n"
                "  --prefetch-t1      prefetcht1\n"
@@ -966,21 +1168,604 @@ str_to_uint(const char *str, const unsigned base, unsigned *value)
         return 0;
 }
 
+/**
+ * @brief Converts string str to working set size
+ *
+ * Accepts number of bytes with optional K, M or G suffix, or one of
+ * l2, llc and dram keywords. Keywords l2 and llc select 3/4 of the
+ * cache size, so the working set fits into the cache level, limited
+ * to the memory chunk size.
+ *
+ * @param [in] str string
+ * @param [out] value size in bytes
+ *
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+str_to_size(const char *str, size_t *value)
+{
+        unsigned long long tmp;
+        char *str_end = NULL;
+        long cache_size = -1;
+
+        if (NULL == str || NULL == value)
+                return -EINVAL;
+
+        if (strcasecmp(str, "dram") == 0) {
+                *value = MEMCHUNK_SIZE;
+                return 0;
+        }
+
+        if (strcasecmp(str, "l2") == 0 || strcasecmp(str, "llc") == 0) {
+#ifdef _SC_LEVEL2_CACHE_SIZE
+                if (strcasecmp(str, "l2") == 0)
+                        cache_size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+                else
+                        cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+                if (cache_size <= 0)
+                        return -ENOTSUP;
+                *value = (size_t)cache_size / 4 * 3;
+                if (*value > MEMCHUNK_SIZE)
+                        *value = MEMCHUNK_SIZE;
+                return 0;
+        }
+
+        if (!isdigit(*str))
+                return -EINVAL;
+
+        errno = 0;
+        tmp = strtoull(str, &str_end, 10);
+        if (errno != 0)
+                return -EINVAL;
+
+        switch (toupper(*str_end)) {
+        case 'G':
+                tmp *= 1024;
+                /* fall through */
+        case 'M':
+                tmp *= 1024;
+                /* fall through */
+        case 'K':
+                tmp *= 1024;
+                str_end++;
+                break;
+        default:
+                break;
+        }
+        if (*str_end != '\0')
+                return -EINVAL;
+
+        *value = (size_t)tmp;
+        return 0;
+}
+
+/**
+ * @brief Checks if operation type belongs to read operations
+ *
+ * @param type operation type
+ *
+ * @return 1 for loads and prefetches, 0 otherwise
+ */
+static int
+op_is_read(const enum cl_type type)
+{
+        switch (type) {
+        case CL_TYPE_PREFETCH_T0:
+        case CL_TYPE_PREFETCH_T1:
+        case CL_TYPE_PREFETCH_T2:
+        case CL_TYPE_PREFETCH_NTA:
+        case CL_TYPE_PREFETCH_W:
+        case CL_TYPE_READ_NTQ:
+        case CL_TYPE_READ_WB:
+        case CL_TYPE_READ_WB_DQA:
+                return 1;
+        default:
+                return 0;
+        }
+}
+
+/**
+ * @brief Selects read or write operation of the phase
+ *
+ * @param ph phase
+ * @param type operation type
+ */
+static void
+phase_set_op(struct mem_phase *ph, const enum cl_type type)
+{
+        if (op_is_read(type))
+                ph->rd_type = type;
+        else
+                ph->wr_type = type;
+}
+
+/**
+ * @brief Checks CPU support for operation type
+ *
+ * @param type operation type
+ * @param features bitmap of supported CPU features
+ *
+ * @retval 0 on success
+ * @retval -1 operation not supported
+ */
+static int
+check_features(const enum cl_type type, const uint64_t features)
+{
+        switch (type) {
+        case CL_TYPE_READ_WB_DQA:
+#ifdef __x86_64__
+        case CL_TYPE_WRITE_DQA:
+        case CL_TYPE_WRITE_DQA_FLUSH:
+        case CL_TYPE_WRITE_NTDQ:
+#endif
+                if (!(features & CPU_FEATURE_SSE4_2)) {
+                        printf("No CPU support for SSE4.2 instructions!\n");
+                        return -1;
+                }
+                break;
+        case CL_TYPE_WRITE_NTI_CLWB:
+        case CL_TYPE_WRITE_WB_CLWB:
+                if (!(features & CPU_FEATURE_CLWB)) {
+                        printf("No CPU support for CLWB instruction!\n");
+                        return -1;
+                }
+                break;
+#ifdef __x86_64__
+        case CL_TYPE_WRITE_NT512:
+        case CL_TYPE_WRITE_WB_AVX512:
+                if (!(features & CPU_FEATURE_AVX512F)) {
+                        printf("No CPU support for AVX512 instructions!\n");
+                        return -1;
+                }
+                break;
+#endif
+        default:
+                break;
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Parses phase specification
+ *
+ * Parameters not present in the specification are left unchanged.
+ *
+ * @param [in] opts command line options, used to look up operations
+ * @param [in] spec comma separated list of phase parameters
+ * @param [out] ph phase
+ *
+ * @retval 0 on success
+ * @retval negative on error (-errno)
+ */
+static int
+phase_parse(const struct option *opts, char *spec, struct mem_phase *ph)
+{
+        char *saveptr = NULL;
+        char *tok;
+
+        for (tok = strtok_r(spec, ",", &saveptr); tok != NULL;
+             tok = strtok_r(NULL, ",", &saveptr)) {
+                char *val = strchr(tok, '=');
+                int ret = 0;
+
+                if (val != NULL)
+                        *val++ = '\0';
+
+                if (val == NULL && strcmp(tok, "random") == 0)
+                        ph->random = 1;
+                else if (val == NULL && strcmp(tok, "linear") == 0)
+                        ph->random = 0;
+                else if (val == NULL)
+                        ret = -EINVAL;
+                else if (strcmp(tok, "time") == 0)
+                        ret = str_to_uint(val, 10, &ph->duration);
+                else if (strcmp(tok, "bw") == 0) {
+                        ret = str_to_uint(val, 10, &ph->bw);
+                        if (ret == 0 && (ph->bw == 0 || ph->bw > MAX_MEM_BW))
+                                ret = -EINVAL;
+                } else if (strcmp(tok, "stride") == 0)
+                        ret = str_to_uint(val, 10, &ph->stride);
+                else if (strcmp(tok, "wss") == 0)
+                        ret = str_to_size(val, &ph->wss);
+                else if (strcmp(tok, "write-ratio") == 0) {
+                        ret = str_to_uint(val, 10, &ph->write_ratio);
+                        if (ret == 0 && ph->write_ratio > MIX_PERIOD)
+                                ret = -EINVAL;
+                } else if (strcmp(tok, "op") == 0) {
+                        const struct option *o;
+
+                        /* operation types only, not other flag options */
+                        for (o = opts; o->name != NULL; o++)
+                                if (o->has_arg == no_argument &&
+                                    o->val > CL_TYPE_INVALID &&
+                                    (size_t)o->val < DIM(kernel_tab) &&
+                                    strcmp(o->name, val) == 0)
+                                        break;
+                        if (o->name == NULL)
+                                ret = -EINVAL;
+                        else
+                                phase_set_op(ph, (enum cl_type)o->val);
+                } else
+                        ret = -EINVAL;
+
+                if (ret != 0) {
+                        printf("Invalid phase parameter %s%s%s!\n", tok,
+                               val != NULL ? "=" : "",
+                               val != NULL ? val : "");
+                        return ret;
+                }
+        }
+
+        return 0;
+}
+
+/**
+ * @brief Validates phase and sets up its runtime state
+ *
+ * Selects access kernels specialized for the phase operations and access
+ * pattern, and precomputes the random access order.
+ *
+ * @param ph phase
+ * @param features bitmap of supported CPU features
+ *
+ * @retval 0 on success
+ * @retval -1 on error
+ */
+static int
+phase_prepare(struct mem_phase *ph, const uint64_t features)
+{
+        size_t i;
+
+        if (ph->write_ratio == RATIO_UNSET) {
+                if (ph->wr_type == CL_TYPE_INVALID)
+                        ph->write_ratio = 0;
+                else if (ph->rd_type == CL_TYPE_INVALID)
+                        ph->write_ratio = MIX_PERIOD;
+                else
+                        ph->write_ratio = MIX_PERIOD / 2;
+        }
+        if (ph->rd_type == CL_TYPE_INVALID)
+                ph->rd_type = CL_TYPE_READ_WB;
+        if (ph->wr_type == CL_TYPE_INVALID)
+                ph->wr_type = CL_TYPE_WRITE_WB;
+        if ((size_t)ph->rd_type >= DIM(kernel_tab) ||
+            (size_t)ph->wr_type >= DIM(kernel_tab)) {
+                printf("Invalid operation type!\n");
+                return -1;
+        }
+
+        if (ph->write_ratio < MIX_PERIOD &&
+            check_features(ph->rd_type, features) != 0)
+                return -1;
+        if (ph->write_ratio > 0 && check_features(ph->wr_type, features) != 0)
+                return -1;
+
+        if (ph->wss > MEMCHUNK_SIZE || ph->wss < CL_SIZE) {
+                printf("Working set size must be between %u and %u bytes!\n",
+                       CL_SIZE, MEMCHUNK_SIZE);
+                return -1;
+        }
+        ph->lines = ph->wss / CL_SIZE;
+
+        if (ph->stride == 0 || ph->stride > ph->lines) {
+                printf("Stride must be between 1 and %zu cache lines!\n",
+                       ph->lines);
+                return -1;
+        }
+        ph->slots = (ph->lines + ph->stride - 1) / ph->stride;
+
+        if (ph->random) {
+                ph->perm = malloc(ph->slots * sizeof(ph->perm[0]));
+                if (ph->perm == NULL) {
+                        printf("Failed to allocate memory!\n");
+                        return -1;
+                }
+                for (i = 0; i < ph->slots; i++)
+                        ph->perm[i] = (uint32_t)(i * ph->stride);
+                /* Fisher-Yates shuffle */
+                for (i = ph->slots - 1; i > 0; i--) {
+                        const size_t j = (size_t)rand() % (i + 1);
+                        const uint32_t tmp = ph->perm[i];
+
+                        ph->perm[i] = ph->perm[j];
+                        ph->perm[j] = tmp;
+                }
+                ph->rd_fn = kernel_tab[ph->rd_type].random;
+                ph->wr_fn = kernel_tab[ph->wr_type].random;
+        } else {
+                ph->rd_fn = kernel_tab[ph->rd_type].linear;
+                ph->wr_fn = kernel_tab[ph->wr_type].linear;
+        }
+
+        ph->cursor = 0;
+        ph->mix_pos = 0;
+        ph->chunk_lines = ph->bw * (((1024 * 1024) / CL_SIZE) / CHUNKS);
+
+        return 0;
+}
+
+/**
+ * @brief Maps anonymous memory, backed by hugepages if possible
+ *
+ * Falls back from 1GB to 2MB hugepages and then to regular pages
+ * with transparent hugepages advised. With hugepages disabled, regular
+ * pages are mapped and transparent hugepages are turned off for them.
+ *
+ * @param [in] s size of memory to map
+ * @param [in,out] hp_size requested hugepage size, 0 for regular pages,
+ *                 page size used on return
+ * @param [out] mapped size of the mapping
+ *
+ * @return mapped memory
+ * @retval NULL on error
+ */
+static void *
+map_memory(const size_t s, size_t *hp_size, size_t *mapped)
+{
+        const int no_hugepages = (*hp_size == 0);
+        void *p = MAP_FAILED;
+
+#ifdef MAP_HUGETLB
+        while (*hp_size >= HUGEPAGE_2M) {
+                const int shift = (*hp_size == HUGEPAGE_1G) ? 30 : 21;
+
+                *mapped = (s + *hp_size - 1) & ~(*hp_size - 1);
+                p = mmap(NULL, *mapped, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                             (shift << MAP_HUGE_SHIFT),
+                         -1, 0);
+                if (p != MAP_FAILED)
+                        return p;
+
+                printf("- %zuMB hugepages not available\n",
+                       *hp_size / (1024 * 1024));
+                *hp_size = (*hp_size == HUGEPAGE_1G) ? HUGEPAGE_2M : 0;
+        }
+#endif
+        *hp_size = PAGE_SIZE;
+        *mapped = (s + PAGE_SIZE - 1) & ~((size_t)PAGE_SIZE - 1);
+        p = mmap(NULL, *mapped, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED)
+                return NULL;
+#ifdef MADV_NOHUGEPAGE
+        if (no_hugepages) {
+                (void)madvise(p, *mapped, MADV_NOHUGEPAGE);
+                return p;
+        }
+#endif
+#ifdef MADV_HUGEPAGE
+        (void)madvise(p, *mapped, MADV_HUGEPAGE);
+#endif
+        return p;
+}
+
+/**
+ * @brief Lists CPUs sharing NUMA node with \a cpu
+ *
+ * @param [in] cpu target CPU, always returned as the first entry
+ * @param [out] cpus table of CPUs
+ * @param [in] max size of the table
+ *
+ * @return number of CPUs in the table
+ */
+static unsigned
+node_cpus(const unsigned cpu, unsigned *cpus, const unsigned max)
+{
+        unsigned num = 0;
+#ifdef __linux__
+        char path[64];
+        char buf[256];
+        char *saveptr = NULL;
+        char *tok;
+        unsigned node;
+        FILE *fd = NULL;
+#endif
+
+        cpus[num++] = cpu;
+#ifdef __linux__
+
+        for (node = 0; node < 1024 && fd == NULL; node++) {
+                snprintf(path, sizeof(path),
+                         "/sys/devices/system/cpu/cpu%u/node%u", cpu, node);
+                if (access(path, F_OK) != 0)
+                        continue;
+                snprintf(path, sizeof(path),
+                         "/sys/devices/system/node/node%u/cpulist", node);
+                fd = fopen(path, "r");
+                if (fd == NULL)
+                        return num;
+        }
+        if (fd == NULL)
+                return num;
+
+        if (fgets(buf, sizeof(buf), fd) == NULL) {
+                fclose(fd);
+                return num;
+        }
+        fclose(fd);
+
+        for (tok = strtok_r(buf, ",\n", &saveptr); tok != NULL;
+             tok = strtok_r(NULL, ",\n", &saveptr)) {
+                unsigned first, last, i;
+                int n = sscanf(tok, "%u-%u", &first, &last);
+
+                if (n < 1)
+                        continue;
+                if (n == 1)
+                        last = first;
+                for (i = first; i <= last && num < max; i++)
+                        if (i != cpu)
+                                cpus[num++] = i;
+        }
+#else
+        (void)max;
+#endif
+        return num;
+}
+
+/**
+ * First-touch initialization work of a single thread
+ */
+struct init_arg {
+        char *p;       /* start of the memory slice */
+        size_t size;   /* size of the slice */
+        unsigned cpu;  /* CPU to touch the slice from */
+        uint64_t seed; /* initial value of the pattern */
+};
+
+/**
+ * @brief Initializes memory slice from a CPU of the target NUMA node
+ *
+ * Cache lines are filled with a xorshift pattern using non-temporal
+ * stores, so the memory does not have to be flushed afterwards.
+ *
+ * @param arg slice to initialize
+ *
+ * @return NULL
+ */
+static void *
+init_thread(void *arg)
+{
+        const struct init_arg *a = (const struct init_arg *)arg;
+        uint64_t val = a->seed | 1;
+        size_t off;
+
+        set_thread_affinity(a->cpu);
+
+        for (off = 0; off < a->size; off += CL_SIZE) {
+                val ^= val << 13;
+                val ^= val >> 7;
+                val ^= val << 17;
+#ifdef __x86_64__
+                cl_write_ntdq(a->p + off, val);
+#else
+                cl_write_nti(a->p + off, val);
+#endif
+        }
+        sb();
+
+        return NULL;
+}
+
+/**
+ * @brief Function to allocate memory and initialize it on the target node
+ *
+ * Memory is first touched in parallel from all CPUs of the NUMA node
+ * of \a cpu, so pages get allocated locally to it.
+ *
+ * @param s size of memory to allocate
+ * @param cpu target CPU
+ * @param hp_size requested hugepage size, 0 for regular pages
+ *
+ * @retval p allocated memory
+ * @retval NULL on error
+ */
+static void *
+alloc_and_init_memory(const size_t s, const unsigned cpu, size_t hp_size)
+{
+        unsigned cpus[MAX_INIT_THREADS];
+        struct init_arg args[MAX_INIT_THREADS];
+        pthread_t threads[MAX_INIT_THREADS];
+        struct timeval tv_s, tv_e;
+        unsigned num_cpus, num_threads = 0;
+        size_t slice, off = 0;
+        void *p;
+        unsigned i;
+
+        gettimeofday(&tv_s, NULL);
+
+        p = map_memory(s, &hp_size, &memchunk_mapped);
+        if (p == NULL) {
+                printf("ERROR: Failed to allocate %zu bytes\n", s);
+                return NULL;
+        }
+
+        num_cpus = node_cpus(cpu, cpus, MAX_INIT_THREADS);
+
+        /* Slices are page aligned so each page is touched by one thread */
+        slice = (s / num_cpus + hp_size - 1) & ~(hp_size - 1);
+
+        for (i = 0; i < num_cpus && off < s; i++) {
+                args[i].p = (char *)p + off;
+                args[i].size = (s - off < slice) ? s - off : slice;
+                args[i].cpu = cpus[i];
+                args[i].seed = ((uint64_t)rand() << 32) | (uint64_t)rand();
+                off += args[i].size;
+
+                /* Slice of the target CPU is initialized by this thread */
+                if (i == 0)
+                        continue;
+                if (pthread_create(&threads[num_threads], NULL, init_thread,
+                                   &args[i]) == 0)
+                        num_threads++;
+                else
+                        init_thread(&args[i]);
+        }
+        init_thread(&args[0]);
+
+        for (i = 0; i < num_threads; i++)
+                pthread_join(threads[i], NULL);
+
+        gettimeofday(&tv_e, NULL);
+        printf("- memory initialized in %ld ms, %u threads, %zuKB pages\n",
+               get_usec_diff(&tv_s, &tv_e) / 1000L, num_threads + 1,
+               hp_size / 1024);
+
+        return p;
+}
+
+/**
+ * @brief Function to release memory allocated by alloc_and_init_memory()
+ *
+ * @param p allocated memory
+ */
+static void
+free_memory(void *p)
+{
+        if (p != NULL)
+                munmap(p, memchunk_mapped);
+}
+
 int
 main(int argc, char **argv)
 {
         int cmd = EXIT_SUCCESS;
-        enum cl_type type = CL_TYPE_INVALID;
-        unsigned mem_bw = 0;
+        struct mem_phase base;
+        struct mem_phase phases[MAX_PHASES];
+        char *phase_spec[MAX_PHASES];
+        unsigned num_phases = 0;
+        struct mem_phase *ph;
+        struct timeval tv_phase;
+        unsigned cur = 0;
+        size_t hp_size = HUGEPAGE_2M;
         unsigned cpu = UINT_MAX;
+        unsigned i;
         int option_index;
         int ret;
         uint64_t features;
+        enum {
+                OPT_STRIDE = 256,
+                OPT_RANDOM,
+                OPT_WSS,
+                OPT_WRITE_RATIO,
+                OPT_PHASE,
+                OPT_HUGEPAGE
+        };
 
         /* clang-format off */
         struct option options[] = {
             {"bandwidth",       required_argument, 0, 'b'},
             {"cpu",             required_argument, 0, 'c'},
+            {"stride",          required_argument, 0, OPT_STRIDE},
+            {"random",          no_argument, 0, OPT_RANDOM},
+            {"wss",             required_argument, 0, OPT_WSS},
+            {"write-ratio",     required_argument, 0, OPT_WRITE_RATIO},
+            {"phase",           required_argument, 0, OPT_PHASE},
+            {"hugepage",        required_argument, 0, OPT_HUGEPAGE},
             {"prefetch-t0",     no_argument, 0, CL_TYPE_PREFETCH_T0},
             {"prefetch-t1",     no_argument, 0, CL_TYPE_PREFETCH_T1},
             {"prefetch-t2",     no_argument, 0, CL_TYPE_PREFETCH_T2},
@@ -1012,6 +1797,13 @@ main(int argc, char **argv)
         };
         /* clang-format on */
 
+        memset(&base, 0, sizeof(base));
+        base.rd_type = CL_TYPE_INVALID;
+        base.wr_type = CL_TYPE_INVALID;
+        base.write_ratio = RATIO_UNSET;
+        base.stride = 1;
+        base.wss = MEMCHUNK_SIZE;
+
         /* Process command line arguments */
         while ((cmd = getopt_long_only(argc, argv, "b:c:", options,
                                        &option_index)) != -1) {
@@ -1025,12 +1817,57 @@ main(int argc, char **argv)
                         }
                         break;
                 case 'b':
-                        ret = str_to_uint(optarg, 10, &mem_bw);
-                        if (ret != 0 || mem_bw == 0 || mem_bw > MAX_MEM_BW) {
+                        ret = str_to_uint(optarg, 10, &base.bw);
+                        if (ret != 0 || base.bw == 0 || base.bw > MAX_MEM_BW) {
                                 printf("Invalid B/W specified!\n");
                                 return EXIT_FAILURE;
                         }
                         break;
+                case OPT_STRIDE:
+                        ret = str_to_uint(optarg, 10, &base.stride);
+                        if (ret != 0 || base.stride == 0) {
+                                printf("Invalid stride specified!\n");
+                                return EXIT_FAILURE;
+                        }
+                        break;
+                case OPT_RANDOM:
+                        base.random = 1;
+                        break;
+                case OPT_WSS:
+                        ret = str_to_size(optarg, &base.wss);
+                        if (ret != 0) {
+                                printf("Invalid working set size "
+                                       "specified!\n");
+                                return EXIT_FAILURE;
+                        }
+                        break;
+                case OPT_WRITE_RATIO:
+                        ret = str_to_uint(optarg, 10, &base.write_ratio);
+                        if (ret != 0 || base.write_ratio > MIX_PERIOD) {
+                                printf("Invalid write ratio specified!\n");
+                                return EXIT_FAILURE;
+                        }
+                        break;
+                case OPT_PHASE:
+                        if (num_phases >= MAX_PHASES) {
+                                printf("Too many phases, maximum is %u!\n",
+                                       MAX_PHASES);
+                                return EXIT_FAILURE;
+                        }
+                        phase_spec[num_phases++] = optarg;
+                        break;
+                case OPT_HUGEPAGE:
+                        if (strcasecmp(optarg, "2M") == 0)
+                                hp_size = HUGEPAGE_2M;
+                        else if (strcasecmp(optarg, "1G") == 0)
+                                hp_size = HUGEPAGE_1G;
+                        else if (strcasecmp(optarg, "none") == 0)
+                                hp_size = 0;
+                        else {
+                                printf("Invalid hugepage size specified!\n");
+                                return EXIT_FAILURE;
+                        }
+                        break;
                 case CL_TYPE_PREFETCH_T0:
                 case CL_TYPE_PREFETCH_T1:
                 case CL_TYPE_PREFETCH_T2:
@@ -1056,7 +1893,7 @@ main(int argc, char **argv)
                 case CL_TYPE_WRITE_NT512:
                 case CL_TYPE_WRITE_NTDQ:
 #endif
-                        type = (enum cl_type)cmd;
+                        phase_set_op(&base, (enum cl_type)cmd);
                         break;
                 default:
                         usage(argv);
@@ -1065,65 +1902,69 @@ main(int argc, char **argv)
                 }
         }
 
+        /* Build phase schedule, phases inherit command line settings */
+        if (num_phases == 0) {
+                phases[0] = base;
+                num_phases = 1;
+        } else {
+                for (i = 0; i < num_phases; i++) {
+                        phases[i] = base;
+                        ret = phase_parse(options, phase_spec[i], &phases[i]);
+                        if (ret != 0)
+                                return EXIT_FAILURE;
+                        if (phases[i].duration == 0 && num_phases > 1) {
+                                printf("Phase %u requires time parameter!\n",
+                                       i);
+                                return EXIT_FAILURE;
+                        }
+                }
+        }
+
         /* Check if user has supplied all required arguments */
-        if (type == CL_TYPE_INVALID || cpu == UINT_MAX || !mem_bw ||
-            optind < argc) {
+        if (cpu == UINT_MAX || optind < argc) {
                 usage(argv);
                 return EXIT_FAILURE;
         }
+        for (i = 0; i < num_phases; i++)
+                if (phases[i].bw == 0 ||
+                    (phases[i].rd_type == CL_TYPE_INVALID &&
+                     phases[i].wr_type == CL_TYPE_INVALID)) {
+                        usage(argv);
+                        return EXIT_FAILURE;
+                }
 
         features = cpu_feature_detect();
 
-        switch (type) {
-        case CL_TYPE_READ_WB_DQA:
-#ifdef __x86_64__
-        case CL_TYPE_WRITE_DQA:
-        case CL_TYPE_WRITE_DQA_FLUSH:
-        case CL_TYPE_WRITE_NTDQ:
-#endif
-                if (!(features & CPU_FEATURE_SSE4_2)) {
-                        printf("No CPU support for SSE4.2 instructions!\n");
-                        return EXIT_FAILURE;
-                }
-                break;
-        case CL_TYPE_WRITE_NTI_CLWB:
-        case CL_TYPE_WRITE_WB_CLWB:
-                if (!(features & CPU_FEATURE_CLWB)) {
-                        printf("No CPU support for CLWB instruction!\n");
+        for (i = 0; i < num_phases; i++)
+                if (phase_prepare(&phases[i], features) != 0)
                         return EXIT_FAILURE;
-                }
-                break;
-#ifdef __x86_64__
-        case CL_TYPE_WRITE_NT512:
-        case CL_TYPE_WRITE_WB_AVX512:
-                if (!(features & CPU_FEATURE_AVX512F)) {
-                        printf("No CPU support for AVX512 instructions!\n");
-                        return EXIT_FAILURE;
-                }
-                break;
-#endif
-        default:
-                break;
-        }
 
         printf("- THREAD logical core id: %u, "
                " memory bandwidth [MB]: %u, starting...\n",
-               cpu, mem_bw);
+               cpu, phases[0].bw);
+        for (i = 0; i < num_phases; i++)
+                printf("- PHASE %u: memory bandwidth [MB]: %u, "
+                       "working set [KB]: %zu, %s stride: %u, "
+                       "write ratio [%%]: %u, time [s]: %u\n",
+                       i, phases[i].bw, phases[i].wss / 1024,
+                       phases[i].random ? "random" : "linear",
+                       phases[i].stride, phases[i].write_ratio,
+                       phases[i].duration);
 
         /* Bind thread to cpu */
         set_thread_affinity(cpu);
 
         /* Allocate memory */
-        memchunk = malloc_and_init_memory(MEMCHUNK_SIZE);
+        memchunk = alloc_and_init_memory(MEMCHUNK_SIZE, cpu, hp_size);
         if (memchunk == NULL) {
                 printf("Failed to allocate memory!\n");
                 return EXIT_FAILURE;
         }
 
-        /* Calculate memory bandwidth to use */
-        mem_bw *= (((1024 * 1024) / CL_SIZE)) / CHUNKS;
-
         /* Stress memory bandwidth */
+        ph = &phases[0];
+        gettimeofday(&tv_phase, NULL);
+
         while (stop_loop == 0) {
                 struct timeval tv_s, tv_e;
                 long usec_diff;
@@ -1133,7 +1974,7 @@ main(int argc, char **argv)
                 gettimeofday(&tv_s, NULL);
 
                 /* Execute operation */
-                mem_execute(mem_bw, type);
+                mem_execute(ph);
 
                 /* Get time after executing operation */
                 gettimeofday(&tv_e, NULL);
@@ -1144,10 +1985,21 @@ main(int argc, char **argv)
                         /* Sleep before executing operation again */
                         nano_sleep(interval, usec_diff);
                 }
+
+                /* Move to the next phase of the schedule */
+                if (ph->duration > 0 &&
+                    get_usec_diff(&tv_phase, &tv_e) >=
+                        (long)ph->duration * 1000000L) {
+                        cur = (cur + 1) % num_phases;
+                        ph = &phases[cur];
+                        tv_phase = tv_e;
+                }
         }
 
         /* Terminate thread */
-        free(memchunk);
+        for (i = 0; i < num_phases; i++)
+                free(phases[i].perm);
+        free_memory(memchunk);
         printf("\nexiting...\n");
 
         return 0;
@@ -0,0 +1,596 @@
+#!/usr/bin/env python3
+
+################################################################################
+# BSD LICENSE
+#
+# Copyright(c) 2020 Intel Corporation. All rights reserved.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#   * Neither the name of Intel Corporation nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+
+"""
+Offline cache-aware tenant placement advisor.
+
+Reads tenant profiles (LLC miss rate curve, core count and memory bandwidth
+demand) and host descriptions (L3 domains as reported by libpqos) and
+computes a placement of tenants onto L3 domains together with a per-domain
+CAT/MBA plan. The plan is printed as JSON or as pqos/rdtset command lines.
+
+Placement uses first-fit decreasing vector bin packing: tenants are sorted
+by their dominant resource share and each one is put into the best fitting
+(or, with --spread, the least loaded) domain. Spare cache ways in each
+domain are then handed out one at a time to the tenant with the largest
+miss rate reduction from its curve.
+"""
+
+import argparse
+import heapq
+import json
+import sys
+
+DEFAULT_MBA_STEP = 10
+
+
+class Tenant:
+    """
+    Tenant profile
+    """
+    # pylint: disable=too-few-public-methods
+
+    def __init__(self, data, tolerance):
+        self.name = str(data['name'])
+        self.cores = int(data['cores'])
+        self.mrc = [float(miss) for miss in data['mrc']]
+        self.mem_bw = float(data.get('mem_bw', 0))
+        self.command = data.get('command')
+
+        if self.cores <= 0 or not self.mrc:
+            raise ValueError("Tenant {}: invalid cores or mrc".format(
+                self.name))
+
+        # smallest allocation within tolerance of the best miss rate
+        best = min(self.mrc)
+        limit = best + tolerance * (max(self.mrc) - best)
+        self.ways = next(i + 1 for i, miss in enumerate(self.mrc)
+                         if miss <= limit)
+
+
+    def gain(self, ways):
+        """
+        Miss rate reduction from growing allocation by one way
+
+        Parameters:
+            ways: current number of ways
+
+        Returns:
+            miss rate reduction
+        """
+        if ways >= len(self.mrc):
+            return 0.0
+
+        return self.mrc[ways - 1] - self.mrc[ways]
+
+
+class Domain:
+    """
+    L3 cache domain with its allocation state
+    """
+    # pylint: disable=too-many-instance-attributes
+
+    def __init__(self, host, data, reserved_ways, bw_overcommit):
+        self.host = host
+        self.socket = int(data.get('socket', 0))
+        self.l3cat_id = int(data.get('l3cat_id', self.socket))
+        self.mba_id = data.get('mba_id')
+        self.cores = [int(core) for core in data['cores']]
+        self.num_ways = int(data['l3_ways'])
+        self.mem_bw = float(data.get('mem_bw', 0))
+        self.mba_step = int(data.get('mba_step', DEFAULT_MBA_STEP))
+        # COS0 keeps at least one way
+        self.reserved_ways = max(1, min(reserved_ways, self.num_ways - 1))
+
+        num_cos = int(data['l3_cos'])
+        if self.mba_id is not None:
+            num_cos = min(num_cos, int(data.get('mba_cos', num_cos)))
+
+        # COS0 is left for everything not placed by the advisor
+        self.free_cos = num_cos - 1
+        self.free_cores = len(self.cores)
+        self.free_ways = self.num_ways - self.reserved_ways
+        self.free_bw = self.mem_bw * bw_overcommit
+        self.tenants = []
+        self.ways = {}
+
+
+    def fits(self, tenant, ways):
+        """
+        Checks if tenant fits into the domain
+
+        Parameters:
+            tenant: tenant to check
+            ways: number of ways to allocate
+
+        Returns:
+            True if tenant fits
+        """
+        if self.free_cos < 1 or self.free_cores < tenant.cores or \
+                self.free_ways < ways:
+            return False
+
+        return self.mem_bw == 0 or self.free_bw >= tenant.mem_bw
+
+
+    def slack(self, tenant, ways):
+        """
+        Normalized resources left after placing the tenant
+
+        Parameters:
+            tenant: tenant to place
+            ways: number of ways to allocate
+
+        Returns:
+            sum of free resource fractions
+        """
+        slack = float(self.free_cores - tenant.cores) / len(self.cores)
+        slack += float(self.free_ways - ways) / self.num_ways
+        if self.mem_bw:
+            slack += (self.free_bw - tenant.mem_bw) / self.mem_bw
+
+        return slack
+
+
+    def place(self, tenant, ways):
+        """
+        Places tenant in the domain
+
+        Parameters:
+            tenant: tenant to place
+            ways: number of ways to allocate
+        """
+        self.tenants.append(tenant)
+        self.ways[tenant] = ways
+        self.free_cos -= 1
+        self.free_cores -= tenant.cores
+        self.free_ways -= ways
+        self.free_bw -= tenant.mem_bw
+
+
+    def grow(self):
+        """
+        Distributes free ways to tenants with the largest miss rate gain
+        """
+        heap = [(-tenant.gain(self.ways[tenant]), i)
+                for i, tenant in enumerate(self.tenants)]
+        heapq.heapify(heap)
+
+        while self.free_ways > 0 and heap:
+            gain, i = heapq.heappop(heap)
+            if gain >= 0:
+                break
+
+            tenant = self.tenants[i]
+            self.ways[tenant] += 1
+            self.free_ways -= 1
+            heapq.heappush(heap, (-tenant.gain(self.ways[tenant]), i))
+
+
+    def plan(self):
+        """
+        Builds CAT/MBA plan for the domain
+
+        Returns:
+            dictionary describing domain classes
+        """
+        mba = 100
+        demand = sum(tenant.mem_bw for tenant in self.tenants)
+        if self.mba_id is not None and self.mem_bw and demand > self.mem_bw:
+            mba = int(100 * self.mem_bw / demand) // self.mba_step
+            mba = max(mba * self.mba_step, self.mba_step)
+
+        classes = []
+        core = 0
+        bit = 0
+        for cos, tenant in enumerate(self.tenants, 1):
+            ways = self.ways[tenant]
+            cls = {
+                'cos': cos,
+                'tenant': tenant.name,
+                'cores': self.cores[core:core + tenant.cores],
+                'l3_mask': hex(((1 << ways) - 1) << bit)
+            }
+            rdtset = "l3={};".format(cls['l3_mask'])
+            if self.mba_id is not None:
+                cls['mba'] = mba
+                rdtset += "mba={};".format(mba)
+            cpus = cpu_list(cls['cores'])
+            cls['rdtset'] = "rdtset -t '{}cpu={}' -c {}".format(rdtset, cpus,
+                                                               cpus)
+            if tenant.command:
+                cls['rdtset'] += " " + tenant.command
+            classes.append(cls)
+            core += tenant.cores
+            bit += ways
+
+        # remaining ways, including reserved ones, stay with COS0
+        classes.insert(0, {
+            'cos': 0,
+            'cores': self.cores[core:],
+            'l3_mask': hex(((1 << self.num_ways) - 1) & ~((1 << bit) - 1))
+        })
+
+        return {
+            'socket': self.socket,
+            'l3cat_id': self.l3cat_id,
+            'mba_id': self.mba_id,
+            'classes': classes
+        }
+
+
+def cpu_list(cores):
+    """
+    Converts list of cores to cpu list string
+
+    Parameters:
+        cores: list of cores
+
+    Returns:
+        cpu list string, e.g. "0-3,8"
+    """
+    ranges = []
+    for core in sorted(cores):
+        if ranges and ranges[-1][1] == core - 1:
+            ranges[-1][1] = core
+        else:
+            ranges.append([core, core])
+
+    return ",".join(str(a) if a == b else "{}-{}".format(a, b)
+                    for a, b in ranges)
+
+
+def load_json(path):
+    """
+    Loads JSON file
+
+    Parameters:
+        path: file path, "-" for stdin
+
+    Returns:
+        parsed JSON data
+    """
+    if path == '-':
+        return json.load(sys.stdin)
+
+    with open(path) as json_file:
+        return json.load(json_file)
+
+
+def load_tenants(paths, tolerance):
+    """
+    Loads tenant profiles
+
+    Parameters:
+        paths: list of profile files
+        tolerance: miss rate tolerance used to size target allocation
+
+    Returns:
+        list of tenants
+    """
+    tenants = []
+    for path in paths:
+        data = load_json(path)
+        for item in data.get('tenants', [data]):
+            tenants.append(Tenant(item, tolerance))
+
+    return tenants
+
+
+def load_domains(paths, args):
+    """
+    Loads host descriptions
+
+    Parameters:
+        paths: list of host description files
+        args: command line arguments
+
+    Returns:
+        list of L3 domains of all hosts
+    """
+    domains = []
+    for path in paths:
+        data = load_json(path)
+        for host in data.get('hosts', [data]):
+            for item in host['domains']:
+                domains.append(Domain(host['name'], item, args.reserved_ways,
+                                      args.bw_overcommit))
+
+    return domains
+
+
+def dominant_share(tenant, domain):
+    """
+    Tenant's largest resource share relative to a domain
+
+    Parameters:
+        tenant: tenant
+        domain: reference domain
+
+    Returns:
+        dominant resource share
+    """
+    share = max(float(tenant.cores) / len(domain.cores),
+                float(tenant.ways) / domain.num_ways)
+    if domain.mem_bw:
+        share = max(share, tenant.mem_bw / domain.mem_bw)
+
+    return share
+
+
+def solve(tenants, domains, spread):
+    """
+    Places tenants onto domains
+
+    Parameters:
+        tenants: list of tenants
+        domains: list of domains
+        spread: place on least loaded domain instead of best fitting one
+
+    Returns:
+        list of tenants that could not be placed
+    """
+    if not domains:
+        return list(tenants)
+
+    reference = max(domains, key=lambda domain: len(domain.cores))
+    order = sorted(tenants, key=lambda tenant: dominant_share(tenant,
+                                                              reference),
+                   reverse=True)
+
+    unplaced = []
+    for tenant in order:
+        selected = None
+        # fall back to single way when target allocation does not fit
+        for ways in sorted({tenant.ways, 1}, reverse=True):
+            feasible = [domain for domain in domains
+                        if domain.fits(tenant, ways)]
+            if not feasible:
+                continue
+
+            if spread:
+                selected = max(feasible,
+                               key=lambda domain: domain.slack(tenant, ways))
+            else:
+                selected = min(feasible,
+                               key=lambda domain: domain.slack(tenant, ways))
+            selected.place(tenant, ways)
+            break
+
+        if selected is None:
+            unplaced.append(tenant.name)
+
+    for domain in domains:
+        domain.grow()
+
+    return unplaced
+
+
+def build_plan(domains, unplaced):
+    """
+    Builds placement plan
+
+    Parameters:
+        domains: list of domains
+        unplaced: list of tenants that could not be placed
+
+    Returns:
+        plan dictionary
+    """
+    hosts = {}
+    for domain in domains:
+        if domain.host not in hosts:
+            hosts[domain.host] = {'name': domain.host, 'domains': []}
+        hosts[domain.host]['domains'].append(domain.plan())
+
+    for host in hosts.values():
+        classes = []
+        assoc = []
+        for domain in host['domains']:
+            for cls in domain['classes']:
+                classes.append("llc@{}:{}={}".format(
+                    domain['l3cat_id'], cls['cos'], cls['l3_mask']))
+                if 'mba' in cls:
+                    classes.append("mba@{}:{}={}".format(
+                        domain['mba_id'], cls['cos'], cls['mba']))
+                if 'tenant' not in cls:
+                    continue
+
+                assoc.append("core:{}={}".format(cls['cos'],
+                                                 cpu_list(cls['cores'])))
+
+        host['pqos'] = ['-e', ";".join(classes)]
+        if assoc:
+            host['pqos'] += ['-a', ";".join(assoc)]
+
+    return {'hosts': list(hosts.values()), 'unplaced': unplaced}
+
+
+def print_commands(plan):
+    """
+    Prints plan as pqos/rdtset command lines
+
+    Parameters:
+        plan: plan dictionary
+    """
+    for host in plan['hosts']:
+        print("# host {}".format(host['name']))
+        print("pqos -R")
+        print("pqos {}".format(" ".join(
+            "'{}'".format(arg) if arg[0] != '-' else arg
+            for arg in host['pqos'])))
+        for domain in host['domains']:
+            for cls in domain['classes']:
+                if 'rdtset' in cls:
+                    print("# {}: {}".format(cls['tenant'], cls['rdtset']))
+        print("")
+
+    for name in plan['unplaced']:
+        print("# unplaced: {}".format(name))
+
+
+def dump_host(args):
+    """
+    Prints description of the local host using libpqos
+
+    Parameters:
+        args: command line arguments
+    """
+    # pylint: disable=import-outside-toplevel
+    import socket
+    from pqos import Pqos
+    from pqos.capability import PqosCap
+    from pqos.cpuinfo import PqosCpuInfo
+    from pqos.error import PqosErrorResource
+
+    pqos = Pqos()
+    pqos.init('OS' if args.iface_os else 'MSR')
+    try:
+        cap = PqosCap()
+        cpu = PqosCpuInfo()
+        l3ca = cap.get_type('l3ca')
+        try:
+            mba = cap.get_type('mba')
+        except PqosErrorResource:
+            mba = None
+
+        domains = {}
+        for socket_id in cpu.get_sockets():
+            for core in cpu.get_cores(socket_id):
+                info = cpu.get_core_info(core)
+                if info.l3cat_id not in domains:
+                    domains[info.l3cat_id] = {
+                        'socket': info.socket,
+                        'l3cat_id': info.l3cat_id,
+                        'cores': [],
+                        'l3_ways': l3ca.num_ways,
+                        'l3_cos': l3ca.num_classes,
+                        'mem_bw': args.mem_bw
+                    }
+                    if mba is not None:
+                        domains[info.l3cat_id].update({
+                            'mba_id': info.mba_id,
+                            'mba_cos': mba.num_classes,
+                            'mba_step': mba.throttle_step
+                        })
+                domains[info.l3cat_id]['cores'].append(core)
+    finally:
+        pqos.fini()
+
+    host = {
+        'name': args.name if args.name else socket.gethostname(),
+        'domains': [domains[key] for key in sorted(domains)]
+    }
+    json.dump({'hosts': [host]}, sys.stdout, indent=2)
+    print("")
+
+
+def parse_args():
+    """
+    Parses command line arguments
+
+    Returns:
+        parsed arguments
+    """
+    parser = argparse.ArgumentParser(
+        description="Cache-aware tenant placement advisor")
+    parser.add_argument('-p', '--profiles', nargs='+', default=[],
+                        metavar='FILE', help="tenant profile files")
+    parser.add_argument('-H', '--hosts', nargs='+', default=[],
+                        metavar='FILE', help="host description files")
+    parser.add_argument('-f', '--format', choices=['json', 'pqos'],
+                        default='json', help="output format")
+    parser.add_argument('-t', '--tolerance', type=float, default=0.1,
+                        help="miss rate tolerance used to size target "
+                        "allocations (default 0.1)")
+    parser.add_argument('-r', '--reserved-ways', type=int, default=1,
+                        help="ways left to COS0 on each domain, at least 1 "
+                        "(default 1)")
+    parser.add_argument('-b', '--bw-overcommit', type=float, default=1.0,
+                        help="memory bandwidth overcommit factor; "
+                        "oversubscribed domains are throttled with MBA "
+                        "(default 1.0)")
+    parser.add_argument('-s', '--spread', action='store_true',
+                        help="place tenants on least loaded domains instead "
+                        "of packing them")
+    parser.add_argument('-d', '--dump-host', action='store_true',
+                        help="print description of the local host")
+    parser.add_argument('-n', '--name', help="host name for --dump-host")
+    parser.add_argument('-m', '--mem-bw', type=int, default=0,
+                        help="memory bandwidth per domain [MB/s] for "
+                        "--dump-host")
+    parser.add_argument('-I', '--iface-os', action='store_true',
+                        help="use OS interface for --dump-host")
+
+    args = parser.parse_args()
+    if not args.dump_host and (not args.profiles or not args.hosts):
+        parser.error("--profiles and --hosts are required")
+    if args.reserved_ways < 1:
+        parser.error("--reserved-ways must be at least 1")
+
+    return args
+
+
+def main():
+    """
+    Main entry point
+    """
+    args = parse_args()
+
+    if args.dump_host:
+        dump_host(args)
+        return 0
+
+    try:
+        tenants = load_tenants(args.profiles, args.tolerance)
+        domains = load_domains(args.hosts, args)
+    except (IOError, ValueError, KeyError, TypeError) as ex:
+        print("Failed to load input: {}".format(ex), file=sys.stderr)
+        return 1
+
+    unplaced = solve(tenants, domains, args.spread)
+    plan = build_plan(domains, unplaced)
+
+    if args.format == 'json':
+        json.dump(plan, sys.stdout, indent=2)
+        print("")
+    else:
+        print_commands(plan)
+
+    return 0 if not unplaced else 2
+
+
+if __name__ == '__main__':
+    sys.exit(main())
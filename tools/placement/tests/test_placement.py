@@ -0,0 +1,143 @@
+################################################################################
+# BSD LICENSE
+#
+# Copyright(c) 2020 Intel Corporation. All rights reserved.
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions
+# are met:
+#
+#   * Redistributions of source code must retain the above copyright
+#     notice, this list of conditions and the following disclaimer.
+#   * Redistributions in binary form must reproduce the above copyright
+#     notice, this list of conditions and the following disclaimer in
+#     the documentation and/or other materials provided with the
+#     distribution.
+#   * Neither the name of Intel Corporation nor the names of its
+#     contributors may be used to endorse or promote products derived
+#     from this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+################################################################################
+
+
+"""
+Unit tests for placement advisor.
+"""
+
+import sys
+
+import pytest
+
+import placement
+
+
+def make_domain(num_ways=4, reserved_ways=1, num_cos=4):
+    """
+    Creates single L3 domain with 4 cores
+    """
+    data = {
+        'socket': 0,
+        'cores': [0, 1, 2, 3],
+        'l3_ways': num_ways,
+        'l3_cos': num_cos
+    }
+
+    return placement.Domain('node0', data, reserved_ways, 1.0)
+
+
+def make_tenant(name, ways):
+    """
+    Creates tenant with 1 core reaching its best miss rate at given ways
+    """
+    mrc = [float(ways - i) for i in range(ways)]
+
+    return placement.Tenant({'name': name, 'cores': 1, 'mrc': mrc}, 0.0)
+
+
+class TestDomain:
+    """
+    Tests for L3 domain allocation state
+    """
+
+    @pytest.mark.parametrize("reserved_ways", [0, -1])
+    def test_reserved_ways_min(self, reserved_ways):
+        domain = make_domain(reserved_ways=reserved_ways)
+
+        assert domain.reserved_ways == 1
+        assert domain.free_ways == 3
+
+
+    def test_reserved_ways_max(self):
+        domain = make_domain(reserved_ways=8)
+
+        assert domain.reserved_ways == 3
+        assert domain.free_ways == 1
+
+
+    def test_single_way(self):
+        domain = make_domain(num_ways=1)
+
+        assert domain.free_ways == 0
+        assert not domain.fits(make_tenant('t0', 1), 1)
+
+
+    def test_plan_cos0_mask(self):
+        domain = make_domain(reserved_ways=0)
+        tenant = make_tenant('t0', 4)
+
+        assert domain.fits(tenant, 3)
+        assert not domain.fits(tenant, 4)
+        domain.place(tenant, 3)
+        domain.grow()
+
+        plan = domain.plan()
+        masks = {cls['cos']: int(cls['l3_mask'], 16)
+                 for cls in plan['classes']}
+        assert masks == {0: 0x8, 1: 0x7}
+
+
+    def test_plan_grow(self):
+        domain = make_domain(num_ways=8, reserved_ways=2)
+        tenants = [make_tenant('t0', 4), make_tenant('t1', 2)]
+        for tenant in tenants:
+            domain.place(tenant, 1)
+        domain.grow()
+
+        plan = domain.plan()
+        masks = {cls['cos']: int(cls['l3_mask'], 16)
+                 for cls in plan['classes']}
+        assert masks == {0: 0xc0, 1: 0xf, 2: 0x30}
+
+
+class TestArgs:
+    """
+    Tests for command line parsing
+    """
+
+    @pytest.mark.parametrize("reserved_ways", ['0', '-2'])
+    def test_reserved_ways_invalid(self, monkeypatch, reserved_ways):
+        monkeypatch.setattr(sys, 'argv', ['placement.py', '-p', 'p.json',
+                                          '-H', 'h.json', '-r',
+                                          reserved_ways])
+
+        with pytest.raises(SystemExit):
+            placement.parse_args()
+
+
+    def test_reserved_ways(self, monkeypatch):
+        monkeypatch.setattr(sys, 'argv', ['placement.py', '-p', 'p.json',
+                                          '-H', 'h.json', '-r', '2'])
+
+        assert placement.parse_args().reserved_ways == 2
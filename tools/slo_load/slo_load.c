@@ -0,0 +1,434 @@
+/*
+ * BSD LICENSE
+ *
+ * Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in
+ *     the documentation and/or other materials provided with the
+ *     distribution.
+ *   * Neither the name of Intel Corporation nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Synthetic latency-sensitive load generator for rdtset SLO mode
+ *
+ * Each request is a dependent pointer chase over a private working set,
+ * so its latency is dominated by cache and memory access times. Request
+ * latencies are sent to the rdtset SLO controller over a Unix datagram
+ * socket as ASCII microsecond values.
+ */
+
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+#include <getopt.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+/**
+ * MACROS
+ */
+
+#define CL_SIZE         (64)
+#define DEF_SOCKET      "/var/run/rdtset_slo.sock"
+#define DEF_WSS         (16)   /* working set size [MB] */
+#define DEF_ACCESSES    (1000) /* pointer chase accesses per request */
+#define SEND_INTERVAL   (100000000ULL)  /* [ns] */
+#define REPORT_INTERVAL (1000000000ULL) /* [ns] */
+#define MAX_DGRAM       (4000)
+#define MAX_SAMPLES     (1024 * 1024)
+
+/**
+ * Cache line sized element of pointer chase
+ */
+struct node {
+        struct node *next;
+        char pad[CL_SIZE - sizeof(struct node *)];
+};
+
+static volatile int stop_loop = 0;
+
+/**
+ * @brief Prints usage information
+ *
+ * @param [in] argv command line arguments
+ */
+static void
+usage(char **argv)
+{
+        printf("Usage: %s [-s <socket>] [-w <wss>] [-a <accesses>] "
+               "[-r <rate>] [-d <duration>]\n"
+               "  -s, --socket <path>     rdtset SLO socket "
+               "(default " DEF_SOCKET ")\n"
+               "  -w, --wss <MB>          working set size in MB "
+               "(default %u)\n"
+               "  -a, --accesses <num>    memory accesses per request "
+               "(default %u)\n"
+               "  -r, --rate <req/s>      request rate, 0 for closed loop "
+               "(default 0)\n"
+               "  -d, --duration <s>      run time in seconds, 0 for "
+               "unlimited (default 0)\n"
+               "  -h, --help              display this help\n",
+               argv[0], DEF_WSS, DEF_ACCESSES);
+}
+
+/**
+ * @brief Signal handler to stop the load generator
+ *
+ * @param [in] signum signal number
+ */
+static void
+signal_handler(int signum)
+{
+        (void)signum;
+        stop_loop = 1;
+}
+
+/**
+ * @brief Converts string to unsigned integer
+ *
+ * @param [in] str string to convert
+ * @param [out] value conversion result
+ *
+ * @return Operation status
+ * @retval 0 on success
+ * @retval -EINVAL on error
+ */
+static int
+str_to_uint(const char *str, unsigned *value)
+{
+        char *str_end = NULL;
+        unsigned long tmp;
+
+        if (NULL == str || NULL == value)
+                return -EINVAL;
+
+        while (isblank(*str))
+                str++;
+
+        if (!isdigit(*str))
+                return -EINVAL;
+
+        errno = 0;
+        tmp = strtoul(str, &str_end, 10);
+        if (errno != 0 || *str_end != '\0' || tmp > UINT_MAX)
+                return -EINVAL;
+
+        *value = (unsigned)tmp;
+        return 0;
+}
+
+/**
+ * @brief Returns monotonic time in nanoseconds
+ */
+static uint64_t
+get_time_ns(void)
+{
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * @brief Allocates working set and links it into a random cyclic chain
+ *
+ * Sattolo's algorithm gives a single cycle covering all cache lines so
+ * hardware prefetchers cannot predict the access pattern.
+ *
+ * @param [in] num number of cache lines
+ *
+ * @return pointer to the first node or NULL on error
+ */
+static struct node *
+chain_alloc(const size_t num)
+{
+        struct node *nodes;
+        size_t *idx;
+        size_t i;
+
+        if (posix_memalign((void **)&nodes, CL_SIZE, num * sizeof(*nodes)))
+                return NULL;
+
+        idx = malloc(num * sizeof(*idx));
+        if (idx == NULL) {
+                free(nodes);
+                return NULL;
+        }
+
+        for (i = 0; i < num; i++)
+                idx[i] = i;
+
+        for (i = num - 1; i > 0; i--) {
+                const size_t j = (size_t)rand() % i;
+                const size_t tmp = idx[i];
+
+                idx[i] = idx[j];
+                idx[j] = tmp;
+        }
+
+        for (i = 0; i < num; i++)
+                nodes[idx[i]].next = &nodes[idx[(i + 1) % num]];
+
+        free(idx);
+        return nodes;
+}
+
+/**
+ * @brief Executes single request
+ *
+ * @param [in] start chain position to start from
+ * @param [in] accesses number of dependent loads
+ *
+ * @return chain position to continue from
+ */
+static struct node *
+request_execute(struct node *start, const unsigned accesses)
+{
+        struct node *volatile pos = start;
+        unsigned i;
+
+        for (i = 0; i < accesses; i++)
+                pos = pos->next;
+
+        return pos;
+}
+
+/**
+ * @brief Comparison function for qsort
+ */
+static int
+cmp_u32(const void *a, const void *b)
+{
+        const uint32_t x = *(const uint32_t *)a;
+        const uint32_t y = *(const uint32_t *)b;
+
+        return (x > y) - (x < y);
+}
+
+/**
+ * @brief Sends batch of latency samples to rdtset
+ *
+ * @param [in] fd socket descriptor
+ * @param [in] addr socket address
+ * @param [in] buf batch of samples
+ * @param [in] len batch length
+ */
+static void
+batch_send(const int fd,
+           const struct sockaddr_un *addr,
+           const char *buf,
+           const size_t len)
+{
+        if (len == 0)
+                return;
+
+        /* rdtset may not be running yet, samples are simply dropped */
+        (void)sendto(fd, buf, len, 0, (const struct sockaddr *)addr,
+                     sizeof(*addr));
+}
+
+int
+main(int argc, char **argv)
+{
+        const char *socket_path = DEF_SOCKET;
+        unsigned wss = DEF_WSS;
+        unsigned accesses = DEF_ACCESSES;
+        unsigned rate = 0;
+        unsigned duration = 0;
+        struct sockaddr_un addr;
+        struct node *chain, *pos;
+        uint32_t *samples;
+        unsigned num_samples = 0;
+        char batch[MAX_DGRAM + 16];
+        size_t batch_len = 0;
+        uint64_t t_start, t_send, t_report, t_next;
+        int fd;
+        int cmd;
+
+        /* clang-format off */
+        struct option options[] = {
+            {"socket",   required_argument, 0, 's'},
+            {"wss",      required_argument, 0, 'w'},
+            {"accesses", required_argument, 0, 'a'},
+            {"rate",     required_argument, 0, 'r'},
+            {"duration", required_argument, 0, 'd'},
+            {"help",     no_argument,       0, 'h'},
+            {0, 0, 0, 0}
+        };
+        /* clang-format on */
+
+        while ((cmd = getopt_long(argc, argv, "s:w:a:r:d:h", options,
+                                  NULL)) != -1) {
+                int ret = 0;
+
+                switch (cmd) {
+                case 's':
+                        socket_path = optarg;
+                        break;
+                case 'w':
+                        ret = str_to_uint(optarg, &wss);
+                        if (ret == 0 && wss == 0)
+                                ret = -EINVAL;
+                        break;
+                case 'a':
+                        ret = str_to_uint(optarg, &accesses);
+                        if (ret == 0 && accesses == 0)
+                                ret = -EINVAL;
+                        break;
+                case 'r':
+                        ret = str_to_uint(optarg, &rate);
+                        break;
+                case 'd':
+                        ret = str_to_uint(optarg, &duration);
+                        break;
+                case 'h':
+                        usage(argv);
+                        return EXIT_SUCCESS;
+                default:
+                        usage(argv);
+                        return EXIT_FAILURE;
+                }
+
+                if (ret != 0) {
+                        printf("Invalid value for option -%c!\n", cmd);
+                        return EXIT_FAILURE;
+                }
+        }
+
+        if (optind < argc) {
+                usage(argv);
+                return EXIT_FAILURE;
+        }
+
+        if (strlen(socket_path) >= sizeof(addr.sun_path)) {
+                printf("Socket path too long!\n");
+                return EXIT_FAILURE;
+        }
+
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, socket_path, sizeof(addr.sun_path) - 1);
+
+        fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+        if (fd < 0) {
+                perror("socket");
+                return EXIT_FAILURE;
+        }
+
+        samples = malloc(MAX_SAMPLES * sizeof(*samples));
+        chain = chain_alloc(((size_t)wss << 20) / CL_SIZE);
+        if (samples == NULL || chain == NULL) {
+                printf("Failed to allocate memory!\n");
+                free(samples);
+                close(fd);
+                return EXIT_FAILURE;
+        }
+
+        signal(SIGINT, signal_handler);
+        signal(SIGTERM, signal_handler);
+
+        printf("- working set [MB]: %u, accesses per request: %u, "
+               "rate [req/s]: %u, starting...\n",
+               wss, accesses, rate);
+
+        pos = chain;
+        t_start = get_time_ns();
+        t_send = t_start;
+        t_report = t_start;
+        t_next = t_start;
+
+        while (stop_loop == 0) {
+                uint64_t t_sched = 0, t_req, t_now, lat;
+
+                if (rate != 0) {
+                        t_now = get_time_ns();
+                        t_sched = t_next;
+                        if (t_now < t_next) {
+                                const uint64_t wait = t_next - t_now;
+                                struct timespec ts = {
+                                    .tv_sec = (time_t)(wait / 1000000000ULL),
+                                    .tv_nsec = (long)(wait % 1000000000ULL)};
+
+                                nanosleep(&ts, NULL);
+                                t_sched = 0;
+                        }
+                        t_next += 1000000000ULL / rate;
+                }
+
+                t_req = get_time_ns();
+                pos = request_execute(pos, accesses);
+                t_now = get_time_ns();
+
+                /* Request running behind schedule accounts queueing delay */
+                if (t_sched != 0)
+                        t_req = t_sched;
+                lat = (t_now - t_req + 500) / 1000;
+                if (lat > UINT32_MAX)
+                        lat = UINT32_MAX;
+
+                if (num_samples < MAX_SAMPLES)
+                        samples[num_samples++] = (uint32_t)lat;
+
+                batch_len += snprintf(batch + batch_len,
+                                      sizeof(batch) - batch_len, "%u ",
+                                      (unsigned)lat);
+                if (batch_len >= MAX_DGRAM || t_now - t_send >= SEND_INTERVAL) {
+                        batch_send(fd, &addr, batch, batch_len);
+                        batch_len = 0;
+                        t_send = t_now;
+                }
+
+                if (t_now - t_report >= REPORT_INTERVAL) {
+                        qsort(samples, num_samples, sizeof(*samples), cmp_u32);
+                        printf("requests: %u, p50 [us]: %u, p99 [us]: %u\n",
+                               num_samples, samples[num_samples / 2],
+                               samples[(num_samples * 99) / 100]);
+                        fflush(stdout);
+                        num_samples = 0;
+                        t_report = t_now;
+                }
+
+                if (duration != 0 &&
+                    t_now - t_start >= (uint64_t)duration * 1000000000ULL)
+                        break;
+        }
+
+        batch_send(fd, &addr, batch, batch_len);
+
+        free(chain);
+        free(samples);
+        close(fd);
+        printf("\nexiting...\n");
+
+        return 0;
+}
@@ -0,0 +1,119 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Unit tests of symlink checking fopen() wrapper
+ *
+ * Files are created in the build directory of the tests.
+ */
+
+#include "../lib/common.c"
+
+#include "test.h"
+
+#define TEST_FILE    "test_common.file"
+#define TEST_SYMLINK "test_common.link"
+
+static void
+test_open_missing(void)
+{
+        unlink(TEST_FILE);
+
+        /* nonexistent files are not created */
+        CHECK(fopen_check_symlink(TEST_FILE, "w") == NULL);
+        CHECK(fopen_check_symlink(TEST_FILE, "a") == NULL);
+        CHECK(access(TEST_FILE, F_OK) != 0);
+}
+
+static void
+test_open_existing(void)
+{
+        FILE *fp = fopen(TEST_FILE, "w");
+
+        CHECK(fp != NULL);
+        fclose(fp);
+
+        fp = fopen_check_symlink(TEST_FILE, "w");
+        CHECK(fp != NULL);
+        if (fp != NULL)
+                fclose(fp);
+        unlink(TEST_FILE);
+}
+
+static void
+test_open_symlink(void)
+{
+        FILE *fp = fopen(TEST_FILE, "w");
+
+        CHECK(fp != NULL);
+        fclose(fp);
+        unlink(TEST_SYMLINK);
+        CHECK_EQ(symlink(TEST_FILE, TEST_SYMLINK), 0);
+
+        CHECK(fopen_check_symlink(TEST_SYMLINK, "r") == NULL);
+        unlink(TEST_SYMLINK);
+        unlink(TEST_FILE);
+}
+
+static void
+test_open_fini(void)
+{
+        FILE *fp = fopen_check_symlink("/proc/stat", "r");
+        unsigned i;
+
+        CHECK(fp != NULL);
+        if (fp != NULL)
+                fclose(fp);
+
+        fopen_check_symlink_fini();
+        for (i = 0; i < DIM(m_roots); i++)
+                CHECK_EQ(m_roots[i].fd, -1);
+
+        /* roots are reopened on next use */
+        fp = fopen_check_symlink("/proc/stat", "r");
+        CHECK(fp != NULL);
+        if (fp != NULL)
+                fclose(fp);
+        fopen_check_symlink_fini();
+}
+
+int
+main(void)
+{
+        RUN_TEST(test_open_missing);
+        RUN_TEST(test_open_existing);
+        RUN_TEST(test_open_symlink);
+        RUN_TEST(test_open_fini);
+
+        return TEST_RESULT();
+}
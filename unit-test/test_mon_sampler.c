@@ -0,0 +1,359 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Unit tests of adaptive monitoring sampler
+ *
+ * Monitoring reads and the clock are stubbed, group values are set by
+ * the tests before each poll.
+ */
+
+#include "../lib/mon_sampler.c"
+
+#include <limits.h>
+
+#include "test.h"
+
+static uint64_t stub_now = 0;           /**< current time [ns] */
+static unsigned stub_next = 0;          /**< time to the next due group */
+static unsigned stub_polled = 0;        /**< groups read by the last poll */
+static struct pqos_mon_data *stub_polled_group[4];
+
+uint64_t
+mon_timestamp(void)
+{
+        return stub_now;
+}
+
+int
+pqos_mon_poll_snapshot(struct pqos_mon_data **groups,
+                       const unsigned num_groups,
+                       struct pqos_mon_snapshot *snapshot)
+{
+        unsigned i;
+
+        (void)snapshot;
+
+        stub_polled = num_groups;
+        for (i = 0; i < num_groups && i < DIM(stub_polled_group); i++)
+                stub_polled_group[i] = groups[i];
+
+        return PQOS_RETVAL_OK;
+}
+
+static void
+group_init(struct pqos_mon_data *group, const uint64_t llc)
+{
+        stub_next = 0;
+        memset(group, 0, sizeof(*group));
+        group->event = PQOS_MON_EVENT_L3_OCCUP;
+        group->values.llc = llc;
+}
+
+/**
+ * @brief Polls the sampler \a n times, each time at the next due time
+ */
+static void
+sampler_run(struct pqos_mon_sampler *sampler, const unsigned n)
+{
+        unsigned i;
+
+        for (i = 0; i < n; i++) {
+                stub_now += (uint64_t)stub_next * 1000;
+                CHECK_EQ(pqos_mon_sampler_poll(sampler, NULL, &stub_next),
+                         PQOS_RETVAL_OK);
+        }
+}
+
+static void
+test_sampler_create_param(void)
+{
+        struct pqos_mon_sampler_config cfg = {10, 100, 0, 0, 0};
+        struct pqos_mon_data group;
+        struct pqos_mon_data *groups[] = {&group};
+        struct pqos_mon_data *null_groups[] = {NULL};
+        struct pqos_mon_sampler *sampler = NULL;
+
+        group_init(&group, 0);
+
+        CHECK_EQ(pqos_mon_sampler_create(NULL, groups, 1, &sampler),
+                 PQOS_RETVAL_PARAM);
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 0, &sampler),
+                 PQOS_RETVAL_PARAM);
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, null_groups, 1, &sampler),
+                 PQOS_RETVAL_PARAM);
+
+        cfg.min_interval = 0;
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 1, &sampler),
+                 PQOS_RETVAL_PARAM);
+        cfg.min_interval = 200;
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 1, &sampler),
+                 PQOS_RETVAL_PARAM);
+
+        CHECK(sampler == NULL);
+        CHECK_EQ(pqos_mon_sampler_destroy(NULL), PQOS_RETVAL_PARAM);
+}
+
+static void
+test_sampler_stable_grows(void)
+{
+        /* interval of 1us has to grow as well */
+        struct pqos_mon_sampler_config cfg = {1, 1000, 0, 0, 0};
+        struct pqos_mon_data group;
+        struct pqos_mon_data *groups[] = {&group};
+        struct pqos_mon_sampler *sampler = NULL;
+        unsigned interval = 0;
+
+        group_init(&group, 1000000);
+
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 1, &sampler),
+                 PQOS_RETVAL_OK);
+        if (sampler == NULL)
+                return;
+
+        sampler_run(sampler, 3);
+        CHECK_EQ(pqos_mon_sampler_get_interval(sampler, &group, &interval),
+                 PQOS_RETVAL_OK);
+        CHECK(interval > 1);
+
+        /* keeps growing up to the limit */
+        sampler_run(sampler, 50);
+        CHECK_EQ(pqos_mon_sampler_get_interval(sampler, &group, &interval),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(interval, cfg.max_interval);
+
+        pqos_mon_sampler_destroy(sampler);
+}
+
+static void
+test_sampler_volatile_shrinks(void)
+{
+        struct pqos_mon_sampler_config cfg = {10, 1000, 0, 0, 0};
+        struct pqos_mon_data group;
+        struct pqos_mon_data *groups[] = {&group};
+        struct pqos_mon_sampler *sampler = NULL;
+        unsigned interval = 0, i;
+
+        group_init(&group, 1000000);
+
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 1, &sampler),
+                 PQOS_RETVAL_OK);
+        if (sampler == NULL)
+                return;
+
+        sampler_run(sampler, 50);
+        CHECK_EQ(pqos_mon_sampler_get_interval(sampler, &group, &interval),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(interval, cfg.max_interval);
+
+        for (i = 0; i < 10; i++) {
+                group.values.llc = (i % 2) ? 100000 : 4000000;
+                sampler_run(sampler, 1);
+        }
+        CHECK_EQ(pqos_mon_sampler_get_interval(sampler, &group, &interval),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(interval, cfg.min_interval);
+
+        pqos_mon_sampler_destroy(sampler);
+}
+
+static void
+test_sampler_threshold(void)
+{
+        struct pqos_mon_sampler_config cfg = {10, 1000, 0, 2000000, 0};
+        struct pqos_mon_data group;
+        struct pqos_mon_data *groups[] = {&group};
+        struct pqos_mon_sampler *sampler = NULL;
+        unsigned interval = 0;
+
+        group_init(&group, 1000000);
+
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 1, &sampler),
+                 PQOS_RETVAL_OK);
+        if (sampler == NULL)
+                return;
+
+        sampler_run(sampler, 50);
+        CHECK_EQ(pqos_mon_sampler_get_interval(sampler, &group, &interval),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(interval, cfg.max_interval);
+
+        /* stable, but close to the threshold */
+        group.values.llc = 1900000;
+        sampler_run(sampler, 1);
+        CHECK_EQ(pqos_mon_sampler_get_interval(sampler, &group, &interval),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(interval, cfg.min_interval);
+
+        pqos_mon_sampler_destroy(sampler);
+}
+
+static void
+test_sampler_due_groups(void)
+{
+        struct pqos_mon_sampler_config cfg = {100, 100000, 0, 0, 0};
+        struct pqos_mon_data stable, busy;
+        struct pqos_mon_data *groups[] = {&stable, &busy};
+        struct pqos_mon_sampler *sampler = NULL;
+        unsigned polled = 0, next = 0, i;
+
+        group_init(&stable, 1000000);
+        group_init(&busy, 1000000);
+
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 2, &sampler),
+                 PQOS_RETVAL_OK);
+        if (sampler == NULL)
+                return;
+
+        /* first poll reads all groups */
+        CHECK_EQ(pqos_mon_sampler_poll(sampler, &polled, &next),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(polled, 2);
+        CHECK(next >= cfg.min_interval);
+
+        /* busy group is read more often than the stable one */
+        for (i = 0; i < 20; i++) {
+                busy.values.llc = (i % 2) ? 100000 : 4000000;
+                stub_now += (uint64_t)next * 1000;
+                CHECK_EQ(pqos_mon_sampler_poll(sampler, &polled, &next),
+                         PQOS_RETVAL_OK);
+        }
+        CHECK_EQ(polled, 1);
+        CHECK(stub_polled_group[0] == &busy);
+
+        /* nothing due */
+        CHECK_EQ(pqos_mon_sampler_poll(sampler, &polled, &next),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(polled, 0);
+        CHECK(next > 0);
+
+        pqos_mon_sampler_destroy(sampler);
+}
+
+static void
+test_sampler_budget(void)
+{
+        /* 4 groups read every 1ms would be 4000 reads/s */
+        struct pqos_mon_sampler_config cfg = {1000, 100000, 400, 0, 0};
+        struct pqos_mon_data group[4];
+        struct pqos_mon_data *groups[4];
+        struct pqos_mon_sampler *sampler = NULL;
+        unsigned next = 0, i;
+
+        for (i = 0; i < DIM(group); i++) {
+                group_init(&group[i], 1000000);
+                groups[i] = &group[i];
+        }
+
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 4, &sampler),
+                 PQOS_RETVAL_OK);
+        if (sampler == NULL)
+                return;
+
+        CHECK_EQ(pqos_mon_sampler_poll(sampler, NULL, &next),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(next, 10000);
+        CHECK(!sampler->over_budget);
+
+        pqos_mon_sampler_destroy(sampler);
+}
+
+static void
+test_sampler_budget_exceeded(void)
+{
+        /* budget needs 10ms intervals, but they are limited to 2ms */
+        struct pqos_mon_sampler_config cfg = {1000, 2000, 400, 0, 0};
+        struct pqos_mon_data group[4];
+        struct pqos_mon_data *groups[4];
+        struct pqos_mon_sampler *sampler = NULL;
+        unsigned polled = 0, next = 0, i;
+
+        for (i = 0; i < DIM(group); i++) {
+                group_init(&group[i], 1000000);
+                groups[i] = &group[i];
+        }
+
+        CHECK_EQ(pqos_mon_sampler_create(&cfg, groups, 4, &sampler),
+                 PQOS_RETVAL_OK);
+        if (sampler == NULL)
+                return;
+
+        CHECK_EQ(pqos_mon_sampler_poll(sampler, NULL, &next),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(next, cfg.max_interval);
+        CHECK(sampler->over_budget);
+
+        /* state covers the whole round, not only groups read now */
+        CHECK_EQ(pqos_mon_sampler_poll(sampler, &polled, &next),
+                 PQOS_RETVAL_OK);
+        CHECK_EQ(polled, 0);
+        CHECK(sampler->over_budget);
+
+        pqos_mon_sampler_destroy(sampler);
+}
+
+static void
+test_sampler_max_interval_wrap(void)
+{
+        struct pqos_mon_sampler_config cfg = {1, UINT_MAX - 1, 0, 0, 0};
+        struct pqos_mon_data group;
+        struct sampler_group sg;
+
+        group_init(&group, 1000000);
+        memset(&sg, 0, sizeof(sg));
+        sg.group = &group;
+        sg.num_reads = 2;
+        sg.llc.mean = 1000000;
+        sg.interval = UINT_MAX / 4 * 3;
+
+        /* stable group stops at max_interval instead of wrapping around */
+        sampler_group_adapt(&cfg, &sg);
+        CHECK_EQ(sg.interval, cfg.max_interval);
+        sampler_group_adapt(&cfg, &sg);
+        CHECK_EQ(sg.interval, cfg.max_interval);
+}
+
+int
+main(void)
+{
+        RUN_TEST(test_sampler_create_param);
+        RUN_TEST(test_sampler_stable_grows);
+        RUN_TEST(test_sampler_volatile_shrinks);
+        RUN_TEST(test_sampler_threshold);
+        RUN_TEST(test_sampler_due_groups);
+        RUN_TEST(test_sampler_budget);
+        RUN_TEST(test_sampler_budget_exceeded);
+        RUN_TEST(test_sampler_max_interval_wrap);
+
+        return TEST_RESULT();
+}
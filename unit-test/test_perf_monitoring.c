@@ -0,0 +1,281 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Unit tests of LLC miss sample aggregation in perf_monitoring.c
+ */
+
+#include "../lib/perf_monitoring.c"
+
+#include <stdlib.h>
+
+#include "test.h"
+
+/**
+ * Fake perf ring buffer, metadata page followed by data pages
+ */
+struct ring {
+        void *buf;
+        size_t page;
+        uint64_t size;
+        uint64_t head;
+};
+
+struct sample_rec {
+        struct perf_event_header hdr;
+        uint64_t ip;
+        uint64_t addr;
+};
+
+/**
+ * @brief Sets up empty ring with data head \a back bytes before its end
+ */
+static void
+ring_init(struct ring *ring, const uint64_t back)
+{
+        struct perf_event_mmap_page *meta;
+
+        ring->page = (size_t)sysconf(_SC_PAGESIZE);
+        ring->size = (uint64_t)PERF_LLC_MISS_SAMPLE_PAGES * ring->page;
+        ring->buf = calloc(1, perf_mon_sample_buf_size());
+        ring->head = ring->size - back;
+
+        meta = (struct perf_event_mmap_page *)ring->buf;
+        meta->data_tail = ring->head;
+        meta->data_head = ring->head;
+}
+
+static void
+ring_write(struct ring *ring, const void *rec, const size_t len)
+{
+        uint8_t *data = (uint8_t *)ring->buf + ring->page;
+        size_t i;
+
+        /* byte by byte to wrap records around the end of the ring */
+        for (i = 0; i < len; i++)
+                data[(ring->head + i) % ring->size] = ((const uint8_t *)rec)[i];
+        ring->head += len;
+        ((struct perf_event_mmap_page *)ring->buf)->data_head = ring->head;
+}
+
+static void
+ring_sample(struct ring *ring, const uint64_t ip, const uint64_t addr)
+{
+        struct sample_rec rec;
+
+        memset(&rec, 0, sizeof(rec));
+        rec.hdr.type = PERF_RECORD_SAMPLE;
+        rec.hdr.size = sizeof(rec);
+        rec.ip = ip;
+        rec.addr = addr;
+        ring_write(ring, &rec, sizeof(rec));
+}
+
+static void
+ring_lost(struct ring *ring, const uint64_t lost)
+{
+        struct sample_rec rec;
+
+        memset(&rec, 0, sizeof(rec));
+        rec.hdr.type = PERF_RECORD_LOST;
+        rec.hdr.size = sizeof(rec);
+        rec.ip = 1; /* event id */
+        rec.addr = lost;
+        ring_write(ring, &rec, sizeof(rec));
+}
+
+static uint64_t
+table_count(const struct pqos_mon_sample *table,
+            const unsigned num,
+            const uint64_t addr)
+{
+        unsigned i;
+
+        for (i = 0; i < num; i++)
+                if (table[i].addr == addr)
+                        return table[i].count;
+
+        return 0;
+}
+
+static void
+test_sample_drain(void)
+{
+        struct pqos_mon_samples samples;
+        struct ring ring;
+
+        memset(&samples, 0, sizeof(samples));
+        /* start close to the end so records wrap around */
+        ring_init(&ring, sizeof(struct sample_rec) + 12);
+
+        ring_sample(&ring, 0x401000, 0x7f0000001234);
+        ring_sample(&ring, 0x401000, 0x7f0000001fff);
+        ring_lost(&ring, 5);
+        ring_sample(&ring, 0x402000, 0);
+        ring_lost(&ring, 2);
+
+        perf_mon_sample_drain(ring.buf, &samples);
+
+        CHECK_EQ(samples.total, 3);
+        CHECK_EQ(samples.lost, 7);
+        CHECK_EQ(samples.num_ips, 2);
+        CHECK_EQ(table_count(samples.ips, samples.num_ips, 0x401000), 2);
+        CHECK_EQ(table_count(samples.ips, samples.num_ips, 0x402000), 1);
+        /* addresses are aggregated by 4K page, missing address skipped */
+        CHECK_EQ(samples.num_pages, 1);
+        CHECK_EQ(samples.pages[0].addr, 0x7f0000001000);
+        CHECK_EQ(samples.pages[0].count, 2);
+        CHECK_EQ(((struct perf_event_mmap_page *)ring.buf)->data_tail,
+                 ring.head);
+
+        /* drained records are not counted again */
+        perf_mon_sample_drain(ring.buf, &samples);
+        CHECK_EQ(samples.total, 3);
+        CHECK_EQ(samples.lost, 7);
+
+        free(ring.buf);
+}
+
+static void
+test_sample_drain_discard(void)
+{
+        struct ring ring;
+
+        ring_init(&ring, 0);
+        ring_sample(&ring, 0x401000, 0x7f0000001000);
+        ring_lost(&ring, 1);
+
+        /* group without sample tables only consumes the records */
+        perf_mon_sample_drain(ring.buf, NULL);
+        CHECK_EQ(((struct perf_event_mmap_page *)ring.buf)->data_tail,
+                 ring.head);
+
+        free(ring.buf);
+}
+
+static void
+test_sample_table_bounded(void)
+{
+        struct pqos_mon_sample table[PQOS_MON_SAMPLE_MAX];
+        uint64_t truth[4 * PQOS_MON_SAMPLE_MAX];
+        const uint64_t hot = 1000;
+        unsigned num = 0;
+        uint64_t total = 0, min;
+        unsigned i, round;
+
+        memset(table, 0, sizeof(table));
+        memset(truth, 0, sizeof(truth));
+
+        /**
+         * Many distinct cold addresses interleaved with one hot address,
+         * more addresses than the table can hold
+         */
+        for (round = 0; round < 8; round++)
+                for (i = 0; i < DIM(truth); i++) {
+                        perf_mon_sample_add(table, &num, i);
+                        truth[i]++;
+                        total++;
+                        perf_mon_sample_add(table, &num, hot);
+                        total++;
+                }
+
+        CHECK_EQ(num, PQOS_MON_SAMPLE_MAX);
+
+        /* counts of the table add up to the number of samples */
+        min = table[0].count;
+        for (i = 0; i < num; i++) {
+                total -= table[i].count;
+                if (table[i].count < min)
+                        min = table[i].count;
+        }
+        CHECK_EQ(total, 0);
+
+        /**
+         * Space-saving bound: reported count never underestimates and
+         * overestimates by at most the count of the least sampled entry
+         */
+        for (i = 0; i < num; i++) {
+                const uint64_t addr = table[i].addr;
+                const uint64_t real =
+                    (addr == hot) ? 8 * DIM(truth) : truth[addr];
+
+                CHECK(table[i].count >= real);
+                CHECK(table[i].count - real <= min);
+        }
+
+        /* frequent address is never evicted */
+        CHECK_EQ(table_count(table, num, hot), 8 * DIM(truth));
+}
+
+static void
+test_sample_sort(void)
+{
+        struct pqos_mon_sample table[] = {
+            {0x1, 3}, {0x2, 10}, {0x3, 1}, {0x4, 7}};
+        unsigned i;
+
+        qsort(table, DIM(table), sizeof(table[0]), perf_mon_sample_cmp);
+
+        for (i = 1; i < DIM(table); i++)
+                CHECK(table[i - 1].count >= table[i].count);
+        CHECK_EQ(table[0].addr, 0x2);
+}
+
+static void
+test_sample_event_vendor(void)
+{
+        struct pqos_cpuinfo cpu;
+        enum pqos_mon_event events = (enum pqos_mon_event)0;
+
+        memset(&cpu, 0, sizeof(cpu));
+        cpu.vendor = PQOS_VENDOR_AMD;
+        events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].supported = 1;
+
+        set_sample_event(&cpu, &events);
+
+        CHECK(!events_tab[OS_MON_EVT_IDX_LLC_MISS_SAMPLE].supported);
+        CHECK(!perf_mon_is_event_supported(PQOS_PERF_EVENT_LLC_MISS_SAMPLE));
+        CHECK_EQ(events, 0);
+}
+
+int
+main(void)
+{
+        RUN_TEST(test_sample_drain);
+        RUN_TEST(test_sample_drain_discard);
+        RUN_TEST(test_sample_table_bounded);
+        RUN_TEST(test_sample_sort);
+        RUN_TEST(test_sample_event_vendor);
+
+        return TEST_RESULT();
+}
@@ -0,0 +1,138 @@
+/*
+ *   BSD LICENSE
+ *
+ *   Copyright(c) 2020 Intel Corporation. All rights reserved.
+ *   All rights reserved.
+ *
+ *   Redistribution and use in source and binary forms, with or without
+ *   modification, are permitted provided that the following conditions
+ *   are met:
+ *
+ *     * Redistributions of source code must retain the above copyright
+ *       notice, this list of conditions and the following disclaimer.
+ *     * Redistributions in binary form must reproduce the above copyright
+ *       notice, this list of conditions and the following disclaimer in
+ *       the documentation and/or other materials provided with the
+ *       distribution.
+ *     * Neither the name of Intel Corporation nor the names of its
+ *       contributors may be used to endorse or promote products derived
+ *       from this software without specific prior written permission.
+ *
+ *   THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *   "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *   LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ *   A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ *   OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ *   SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ *   LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ *   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ *   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ *   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ *   OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @brief Unit tests of configuration change trace
+ *
+ * Trace file is placed in the build directory of the tests.
+ */
+
+#define TRACEFILE "test_trace.ring"
+
+#include <sys/stat.h>
+
+#include "../lib/trace.c"
+
+#include "test.h"
+
+static unsigned
+trace_read(struct pqos_trace_entry *entries, const unsigned max_num)
+{
+        unsigned num = 0;
+
+        CHECK_EQ(trace_get(max_num, &num, entries), PQOS_RETVAL_OK);
+
+        return num;
+}
+
+static void
+test_trace_file_shared(void)
+{
+        unlink(TRACEFILE);
+
+        CHECK_EQ(trace_init(), PQOS_RETVAL_OK);
+        CHECK_EQ(m_shared, 1);
+        trace_fini();
+        unlink(TRACEFILE);
+}
+
+static void
+test_trace_file_writable(void)
+{
+        int fd;
+
+        unlink(TRACEFILE);
+        fd = open(TRACEFILE, O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+        CHECK(fd >= 0);
+        CHECK_EQ(fchmod(fd, S_IRUSR | S_IWUSR | S_IWGRP | S_IWOTH), 0);
+        close(fd);
+
+        /* file writable by others falls back to the private ring */
+        CHECK_EQ(trace_init(), PQOS_RETVAL_OK);
+        CHECK_EQ(m_shared, 0);
+        trace_fini();
+        unlink(TRACEFILE);
+}
+
+static void
+test_trace_file_symlink(void)
+{
+        unlink(TRACEFILE);
+        CHECK_EQ(symlink("test_trace.target", TRACEFILE), 0);
+
+        CHECK_EQ(trace_init(), PQOS_RETVAL_OK);
+        CHECK_EQ(m_shared, 0);
+        CHECK(access("test_trace.target", F_OK) != 0);
+        trace_fini();
+        unlink(TRACEFILE);
+}
+
+static void
+test_trace_read(void)
+{
+        struct pqos_trace_entry entries[4];
+        unsigned num;
+
+        unlink(TRACEFILE);
+        CHECK_EQ(trace_init(), PQOS_RETVAL_OK);
+
+        trace_add(PQOS_TRACE_MBA, 1, 2, 100, 50);
+        trace_add(PQOS_TRACE_L3CA, 0, 3, 0xf, 0xff);
+        num = trace_read(entries, DIM(entries));
+        CHECK_EQ(num, 2);
+        CHECK_EQ(entries[0].type, PQOS_TRACE_MBA);
+        CHECK_EQ(entries[0].id, 1);
+        CHECK_EQ(entries[0].class_id, 2);
+        CHECK_EQ(entries[0].old_value, 100);
+        CHECK_EQ(entries[0].new_value, 50);
+        CHECK_EQ(entries[1].type, PQOS_TRACE_L3CA);
+
+        /* most recent entries are returned */
+        num = trace_read(entries, 1);
+        CHECK_EQ(num, 1);
+        CHECK_EQ(entries[0].type, PQOS_TRACE_L3CA);
+
+        trace_fini();
+        unlink(TRACEFILE);
+}
+
+int
+main(void)
+{
+        RUN_TEST(test_trace_file_shared);
+        RUN_TEST(test_trace_file_writable);
+        RUN_TEST(test_trace_file_symlink);
+        RUN_TEST(test_trace_read);
+
+        return TEST_RESULT();
+}